@@ -0,0 +1,95 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    @brief Runs the registered benchmarks and reports their timings.
+
+    Each benchmark is run `repetitions` times. The setup function is run before each repetition
+    and is not timed, so that the benchmarked function always starts from the same state.
+    The results are written in the JSON format of Google Benchmark (mean, median, min and stddev aggregates),
+    so that the results of two commits can be compared with its tools/compare.py script.
+    real_time is the wall clock time (std::chrono::steady_clock). The processors run on several threads,
+    so cpu_time is the CPU time of all the threads of the process, which can exceed real_time.
+    A failed benchmark is reported with its error message instead of the aggregates.
+  */
+  class BenchmarkRunner
+  {
+  public:
+    struct Benchmark
+    {
+      std::string name;
+      std::function<void()> setup;
+      std::function<void()> run;
+      double items_per_run = 0; ///< processed items (injections, rows...) by one run, reported as items_per_second
+    };
+
+    struct Result
+    {
+      std::string name;
+      std::string aggregate_name;
+      size_t repetitions = 0;
+      double real_time = 0; ///< in milliseconds
+      double cpu_time = 0; ///< in milliseconds
+      double items_per_second = 0;
+      std::string error_message; ///< not empty if the benchmark failed, the timings are then not set
+    };
+
+    void add(const Benchmark& benchmark) { benchmarks_.push_back(benchmark); }
+
+    /**
+      @brief Runs the benchmarks whose name matches the filter (ECMAScript regex, all if empty).
+
+      @param[in] repetitions Number of timed runs of each benchmark
+      @param[in] filter Regex on the benchmark names
+      @param[out] log Progress and console report
+      @return false if a benchmark failed
+    */
+    bool run(size_t repetitions, const std::string& filter, std::ostream& log);
+
+    const std::vector<Result>& getResults() const { return results_; }
+
+    /**
+      @brief Writes the results in the Google Benchmark JSON format.
+
+      @param[in] context Key/values added to the "context" object (sizes of the generated sequences...)
+    */
+    bool writeJSON(const std::filesystem::path& filename, const std::map<std::string, std::string>& context) const;
+
+    static std::string escapeJSON(const std::string& s);
+
+  protected:
+    std::vector<Benchmark> benchmarks_;
+    std::vector<Result> results_;
+  };
+}
@@ -0,0 +1,91 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <SmartPeak/core/SequenceHandler.h>
+
+#include <string>
+
+namespace SmartPeak
+{
+  /**
+    @brief Synthesizes in-memory sequences of configurable size, to benchmark the processing
+      without depending on the content of example data files.
+
+    MRM: each component group has a light and a heavy transition, each injection gets one chromatogram
+      per transition and the picked features of each component group.
+      Each sequence segment starts with its calibration standards,
+      the other injections are unknowns spread over the sample groups.
+    FIAMS: each injection gets full scan profile spectra along the acquisition time.
+    DDA: each injection gets MS1 profile spectra, each one followed by MS2 spectra of its most intense peaks.
+
+    The same options and seed always generate the same sequence.
+  */
+  class SyntheticSequenceGenerator
+  {
+  public:
+    enum class Type
+    {
+      MRM,
+      FIAMS,
+      DDA
+    };
+
+    struct Options
+    {
+      Type type = Type::MRM;
+      size_t n_injections = 24;          ///< number of injections of the sequence
+      size_t n_transitions = 200;        ///< MRM: number of transitions, FIAMS and DDA: number of MS1 spectra per injection
+      size_t n_peaks = 3;                ///< number of peaks per chromatogram or spectrum
+      size_t n_points = 300;             ///< number of points per chromatogram or spectrum
+      size_t n_standards = 6;            ///< number of calibration levels at the start of each sequence segment
+      size_t n_sequence_segments = 1;
+      size_t n_sample_groups = 4;
+      size_t n_ms2_per_ms1 = 3;          ///< DDA: number of MS2 spectra following each MS1 spectrum
+      unsigned int seed = 42;
+    };
+
+    explicit SyntheticSequenceGenerator(const Options& options) : options_(options) {}
+
+    /**
+      @brief Fills the sequence handler with the synthetic injections.
+
+      The sequence handler is expected to be empty.
+    */
+    void generate(SequenceHandler& sequence_handler) const;
+
+    /**
+      @brief A short label of the size of the generated sequence, "MRM/24x200x3" for instance.
+    */
+    std::string getLabel() const;
+
+    const Options& getOptions() const { return options_; }
+
+    static std::string typeToString(Type type);
+    static Type stringToType(const std::string& type);
+
+  protected:
+    Options options_;
+  };
+}
@@ -0,0 +1,215 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/benchmarks/BenchmarkRunner.h>
+#include <SmartPeak/core/ProcessorProfiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+namespace SmartPeak
+{
+  namespace
+  {
+    double mean(const std::vector<double>& values)
+    {
+      return values.empty() ? 0.0 : std::accumulate(values.cbegin(), values.cend(), 0.0) / values.size();
+    }
+
+    double median(std::vector<double> values)
+    {
+      if (values.empty()) return 0.0;
+      std::sort(values.begin(), values.end());
+      const size_t middle = values.size() / 2;
+      return (values.size() % 2) ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    }
+
+    double stddev(const std::vector<double>& values)
+    {
+      if (values.size() < 2) return 0.0;
+      const double m = mean(values);
+      double sum = 0.0;
+      for (const double v : values) sum += (v - m) * (v - m);
+      return std::sqrt(sum / (values.size() - 1));
+    }
+  }
+
+  bool BenchmarkRunner::run(size_t repetitions, const std::string& filter, std::ostream& log)
+  {
+    repetitions = std::max<size_t>(1, repetitions);
+    const std::regex filter_regex(filter.empty() ? ".*" : filter);
+    results_.clear();
+    bool success = true;
+    for (const Benchmark& benchmark : benchmarks_) {
+      if (!std::regex_search(benchmark.name, filter_regex)) {
+        continue;
+      }
+      std::vector<double> real_times;
+      std::vector<double> cpu_times;
+      std::string error_message;
+      for (size_t r = 0; r < repetitions && error_message.empty(); ++r) {
+        try {
+          if (benchmark.setup) benchmark.setup();
+          const double cpu_start = ProcessorProfiler::getProcessCPUTimeMs();
+          const auto start = std::chrono::steady_clock::now();
+          benchmark.run();
+          const auto end = std::chrono::steady_clock::now();
+          cpu_times.push_back(ProcessorProfiler::getProcessCPUTimeMs() - cpu_start);
+          real_times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        catch (const std::exception& e) {
+          error_message = e.what();
+        }
+        catch (const char* e) {
+          error_message = e;
+        }
+        catch (...) {
+          error_message = "unknown exception";
+        }
+      }
+      if (!error_message.empty()) {
+        log << benchmark.name << " FAILED: " << error_message << std::endl;
+        Result result;
+        result.name = benchmark.name;
+        result.repetitions = repetitions;
+        result.error_message = error_message;
+        results_.push_back(result);
+        success = false;
+        continue;
+      }
+
+      const auto addResult = [&](const std::string& aggregate_name, double real_time, double cpu_time) {
+        Result result;
+        result.name = benchmark.name;
+        result.aggregate_name = aggregate_name;
+        result.repetitions = repetitions;
+        result.real_time = real_time;
+        result.cpu_time = cpu_time;
+        result.items_per_second = (benchmark.items_per_run > 0 && real_time > 0)
+          ? benchmark.items_per_run * 1000.0 / real_time
+          : 0.0;
+        results_.push_back(result);
+      };
+      addResult("mean", mean(real_times), mean(cpu_times));
+      addResult("median", median(real_times), median(cpu_times));
+      addResult("min", *std::min_element(real_times.cbegin(), real_times.cend()), *std::min_element(cpu_times.cbegin(), cpu_times.cend()));
+      addResult("stddev", stddev(real_times), stddev(cpu_times));
+
+      const Result& median_result = results_[results_.size() - 3];
+      log << std::left << std::setw(64) << benchmark.name
+        << std::right << std::setw(12) << std::fixed << std::setprecision(2) << median_result.real_time << " ms";
+      if (median_result.items_per_second > 0) {
+        log << std::setw(12) << median_result.items_per_second << " items/s";
+      }
+      log << std::endl;
+    }
+    return success;
+  }
+
+  bool BenchmarkRunner::writeJSON(const std::filesystem::path& filename, const std::map<std::string, std::string>& context) const
+  {
+    std::ofstream out(filename);
+    if (!out) {
+      return false;
+    }
+
+    const std::time_t now = std::time(nullptr);
+    std::ostringstream date;
+    date << std::put_time(std::localtime(&now), "%Y-%m-%dT%H:%M:%S");
+
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << date.str() << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"";
+#else
+    out << "    \"library_build_type\": \"debug\"";
+#endif
+    for (const auto& [key, value] : context) {
+      out << ",\n    \"" << escapeJSON(key) << "\": \"" << escapeJSON(value) << "\"";
+    }
+    out << "\n  },\n  \"benchmarks\": [";
+    out << std::setprecision(6) << std::fixed;
+    for (size_t i = 0; i < results_.size(); ++i) {
+      const Result& result = results_[i];
+      out << (i ? ",\n" : "\n");
+      out << "    {\n";
+      if (!result.error_message.empty()) {
+        out << "      \"name\": \"" << escapeJSON(result.name) << "\",\n";
+        out << "      \"run_name\": \"" << escapeJSON(result.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"repetitions\": " << result.repetitions << ",\n";
+        out << "      \"threads\": 1,\n";
+        out << "      \"error_occurred\": true,\n";
+        out << "      \"error_message\": \"" << escapeJSON(result.error_message) << "\"\n";
+        out << "    }";
+        continue;
+      }
+      out << "      \"name\": \"" << escapeJSON(result.name + "_" + result.aggregate_name) << "\",\n";
+      out << "      \"run_name\": \"" << escapeJSON(result.name) << "\",\n";
+      out << "      \"run_type\": \"aggregate\",\n";
+      out << "      \"repetitions\": " << result.repetitions << ",\n";
+      out << "      \"threads\": 1,\n";
+      out << "      \"aggregate_name\": \"" << result.aggregate_name << "\",\n";
+      out << "      \"iterations\": " << result.repetitions << ",\n";
+      out << "      \"real_time\": " << result.real_time << ",\n";
+      out << "      \"cpu_time\": " << result.cpu_time << ",\n";
+      out << "      \"time_unit\": \"ms\"";
+      if (result.items_per_second > 0) {
+        out << ",\n      \"items_per_second\": " << result.items_per_second;
+      }
+      out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+  }
+
+  std::string BenchmarkRunner::escapeJSON(const std::string& s)
+  {
+    std::ostringstream os;
+    for (const char c : s) {
+      switch (c) {
+        case '"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\t': os << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+          }
+          else {
+            os << c;
+          }
+      }
+    }
+    return os.str();
+  }
+}
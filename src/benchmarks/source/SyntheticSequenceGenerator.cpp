@@ -0,0 +1,432 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/benchmarks/SyntheticSequenceGenerator.h>
+#include <SmartPeak/core/MetaDataHandler.h>
+#include <SmartPeak/core/SampleType.h>
+
+#include <OpenMS/ANALYSIS/MRM/ReactionMonitoringTransition.h>
+#include <OpenMS/ANALYSIS/QUANTITATION/AbsoluteQuantitationMethod.h>
+#include <OpenMS/ANALYSIS/QUANTITATION/AbsoluteQuantitationStandards.h>
+#include <OpenMS/ANALYSIS/TARGETED/TargetedExperiment.h>
+#include <OpenMS/KERNEL/MRMFeature.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace SmartPeak
+{
+  namespace
+  {
+    constexpr double RT_MAX = 600.0;          ///< MRM: chromatogram length, in seconds
+    constexpr double PEAK_WIDTH = 4.0;        ///< MRM: standard deviation of the chromatographic peaks, in seconds
+    constexpr double ACQUISITION_END = 30.0;  ///< FIAMS and DDA: acquisition length, in seconds
+    constexpr double MZ_MIN = 50.0;
+    constexpr double MZ_MAX = 1500.0;
+    constexpr double IS_CONCENTRATION = 1.0;
+    constexpr double RESPONSE_FACTOR = 1e4;   ///< intensity of the light component per concentration unit
+    constexpr double SQRT_2_PI = 2.5066282746310002;
+
+    struct Component
+    {
+      std::string group_name;
+      std::string light_name;
+      std::string heavy_name;
+      double rt;
+      double precursor_mz;
+      double light_product_mz;
+      double heavy_product_mz;
+    };
+
+    std::vector<Component> makeComponents(size_t n_transitions, std::mt19937& rng)
+    {
+      std::uniform_real_distribution<double> rt_distribution(PEAK_WIDTH * 5, RT_MAX - PEAK_WIDTH * 5);
+      std::uniform_real_distribution<double> mz_distribution(MZ_MIN + 10, MZ_MAX / 2);
+      const size_t n_components = std::max<size_t>(1, n_transitions / 2);
+      std::vector<Component> components;
+      components.reserve(n_components);
+      for (size_t c = 0; c < n_components; ++c) {
+        const std::string group_name = "cmp" + std::to_string(c);
+        Component component;
+        component.group_name = group_name;
+        component.light_name = group_name + "." + group_name + "_1.Light";
+        component.heavy_name = group_name + "." + group_name + "_1.Heavy";
+        component.rt = rt_distribution(rng);
+        component.precursor_mz = mz_distribution(rng);
+        component.light_product_mz = component.precursor_mz / 2;
+        component.heavy_product_mz = component.precursor_mz / 2 + 3;
+        components.push_back(component);
+      }
+      return components;
+    }
+
+    OpenMS::TargetedExperiment makeTargetedExperiment(const std::vector<Component>& components)
+    {
+      OpenMS::TargetedExperiment targeted_exp;
+      std::vector<OpenMS::TargetedExperiment::Peptide> peptides;
+      std::vector<OpenMS::ReactionMonitoringTransition> transitions;
+      peptides.reserve(components.size());
+      transitions.reserve(components.size() * 2);
+      for (const Component& component : components) {
+        OpenMS::TargetedExperiment::Peptide peptide;
+        peptide.id = component.group_name;
+        peptide.setChargeState(1);
+        peptide.setRetentionTime(component.rt);
+        peptides.push_back(peptide);
+
+        OpenMS::ReactionMonitoringTransition transition;
+        transition.setPeptideRef(component.group_name);
+        transition.setPrecursorMZ(component.precursor_mz);
+        transition.setDetectingTransition(true);
+        transition.setIdentifyingTransition(false);
+        transition.setQuantifyingTransition(true);
+        transition.setNativeID(component.light_name);
+        transition.setProductMZ(component.light_product_mz);
+        transitions.push_back(transition);
+        transition.setNativeID(component.heavy_name);
+        transition.setProductMZ(component.heavy_product_mz);
+        transitions.push_back(transition);
+      }
+      targeted_exp.setPeptides(peptides);
+      targeted_exp.setTransitions(transitions);
+      return targeted_exp;
+    }
+
+    double gaussian(double x, double center, double sigma, double height)
+    {
+      const double d = (x - center) / sigma;
+      return height * std::exp(-0.5 * d * d);
+    }
+
+    /// The main peak at the component retention time, the other peaks are interferences
+    OpenMS::MSChromatogram makeChromatogram(
+      const std::string& native_id,
+      double precursor_mz,
+      double product_mz,
+      double rt,
+      double height,
+      size_t n_peaks,
+      size_t n_points,
+      std::mt19937& rng)
+    {
+      std::uniform_real_distribution<double> rt_distribution(0, RT_MAX);
+      std::uniform_real_distribution<double> height_distribution(0.05, 0.5);
+      std::normal_distribution<double> noise_distribution(0, height * 0.01 + 1.0);
+      std::vector<std::pair<double, double>> peaks{ { rt, height } };
+      for (size_t p = 1; p < n_peaks; ++p) {
+        peaks.emplace_back(rt_distribution(rng), height * height_distribution(rng));
+      }
+
+      OpenMS::MSChromatogram chromatogram;
+      chromatogram.setNativeID(native_id);
+      OpenMS::Precursor precursor;
+      precursor.setMZ(precursor_mz);
+      chromatogram.setPrecursor(precursor);
+      OpenMS::Product product;
+      product.setMZ(product_mz);
+      chromatogram.setProduct(product);
+      chromatogram.reserve(n_points);
+      const double step = RT_MAX / std::max<size_t>(1, n_points - 1);
+      for (size_t i = 0; i < n_points; ++i) {
+        const double x = i * step;
+        double intensity = std::abs(noise_distribution(rng));
+        for (const auto& peak : peaks) {
+          intensity += gaussian(x, peak.first, PEAK_WIDTH, peak.second);
+        }
+        chromatogram.push_back(OpenMS::ChromatogramPeak(x, intensity));
+      }
+      return chromatogram;
+    }
+
+    OpenMS::MSSpectrum makeSpectrum(
+      double rt,
+      unsigned int ms_level,
+      const std::vector<std::pair<double, double>>& peaks,
+      size_t n_points,
+      double mz_min,
+      double mz_max,
+      std::mt19937& rng)
+    {
+      std::normal_distribution<double> noise_distribution(0, 10.0);
+      OpenMS::MSSpectrum spectrum;
+      spectrum.setRT(rt);
+      spectrum.setMSLevel(ms_level);
+      spectrum.setType(OpenMS::SpectrumSettings::SpectrumType::PROFILE);
+      spectrum.reserve(n_points);
+      const double step = (mz_max - mz_min) / std::max<size_t>(1, n_points - 1);
+      const double peak_width = std::max(step, 0.01);
+      for (size_t i = 0; i < n_points; ++i) {
+        const double mz = mz_min + i * step;
+        double intensity = std::abs(noise_distribution(rng));
+        for (const auto& peak : peaks) {
+          intensity += gaussian(mz, peak.first, peak_width, peak.second);
+        }
+        spectrum.push_back(OpenMS::Peak1D(mz, intensity));
+      }
+      return spectrum;
+    }
+
+    /// The ions of an injection, shared by all its spectra
+    std::vector<std::pair<double, double>> makeIons(size_t n_peaks, std::mt19937& rng)
+    {
+      std::uniform_real_distribution<double> mz_distribution(MZ_MIN, MZ_MAX);
+      std::uniform_real_distribution<double> height_distribution(1e3, 1e6);
+      std::vector<std::pair<double, double>> ions;
+      ions.reserve(n_peaks);
+      for (size_t p = 0; p < n_peaks; ++p) {
+        ions.emplace_back(mz_distribution(rng), height_distribution(rng));
+      }
+      return ions;
+    }
+
+    OpenMS::MSExperiment makeFIAMSExperiment(
+      const SyntheticSequenceGenerator::Options& options,
+      std::mt19937& rng)
+    {
+      const auto ions = makeIons(options.n_peaks, rng);
+      OpenMS::MSExperiment experiment;
+      const size_t n_spectra = std::max<size_t>(1, options.n_transitions);
+      for (size_t s = 0; s < n_spectra; ++s) {
+        const double rt = ACQUISITION_END * s / n_spectra;
+        experiment.addSpectrum(makeSpectrum(rt, 1, ions, options.n_points, MZ_MIN, MZ_MAX, rng));
+      }
+      return experiment;
+    }
+
+    OpenMS::MSExperiment makeDDAExperiment(
+      const SyntheticSequenceGenerator::Options& options,
+      std::mt19937& rng)
+    {
+      auto ions = makeIons(options.n_peaks, rng);
+      std::sort(ions.begin(), ions.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+      std::uniform_real_distribution<double> fragment_distribution(0.1, 0.9);
+      OpenMS::MSExperiment experiment;
+      const size_t n_ms1 = std::max<size_t>(1, options.n_transitions);
+      const size_t n_ms2 = std::min(options.n_ms2_per_ms1, ions.size());
+      const double cycle_time = ACQUISITION_END / n_ms1;
+      for (size_t s = 0; s < n_ms1; ++s) {
+        const double rt = cycle_time * s;
+        experiment.addSpectrum(makeSpectrum(rt, 1, ions, options.n_points, MZ_MIN, MZ_MAX, rng));
+        for (size_t p = 0; p < n_ms2; ++p) {
+          const double precursor_mz = ions[p].first;
+          std::vector<std::pair<double, double>> fragments;
+          for (size_t f = 0; f < options.n_peaks; ++f) {
+            fragments.emplace_back(precursor_mz * fragment_distribution(rng), ions[p].second * fragment_distribution(rng));
+          }
+          OpenMS::MSSpectrum ms2 = makeSpectrum(
+            rt + cycle_time * (p + 1) / (n_ms2 + 1), 2, fragments, options.n_points, MZ_MIN, precursor_mz, rng);
+          OpenMS::Precursor precursor;
+          precursor.setMZ(precursor_mz);
+          precursor.setIntensity(ions[p].second);
+          ms2.setPrecursors({ precursor });
+          experiment.addSpectrum(ms2);
+        }
+      }
+      return experiment;
+    }
+
+    OpenMS::Feature makeSubordinate(const std::string& native_id, double rt, double mz, double intensity)
+    {
+      OpenMS::Feature subordinate;
+      subordinate.setMetaValue("native_id", native_id);
+      subordinate.setMetaValue("peak_apex_int", intensity);
+      subordinate.setMetaValue("leftWidth", rt - 3 * PEAK_WIDTH);
+      subordinate.setMetaValue("rightWidth", rt + 3 * PEAK_WIDTH);
+      subordinate.setRT(rt);
+      subordinate.setMZ(mz);
+      subordinate.setIntensity(intensity * PEAK_WIDTH * SQRT_2_PI);
+      return subordinate;
+    }
+  }
+
+  void SyntheticSequenceGenerator::generate(SequenceHandler& sequence_handler) const
+  {
+    std::mt19937 rng(options_.seed);
+    std::uniform_real_distribution<double> rt_shift_distribution(-1.0, 1.0);
+    std::uniform_real_distribution<double> response_distribution(0.9, 1.1);
+    std::uniform_real_distribution<double> unknown_concentration_distribution(0.01, 10.0);
+
+    const std::vector<Component> components = makeComponents(options_.n_transitions, rng);
+    const size_t n_segments = std::max<size_t>(1, std::min(options_.n_sequence_segments, options_.n_injections));
+    const size_t n_sample_groups = std::max<size_t>(1, options_.n_sample_groups);
+
+    std::vector<std::vector<OpenMS::AbsoluteQuantitationStandards::runConcentration>> standards_concentrations(n_segments);
+    for (size_t i = 0; i < options_.n_injections; ++i) {
+      const size_t segment = i * n_segments / options_.n_injections;
+      const size_t segment_start = (segment * options_.n_injections + n_segments - 1) / n_segments;
+      const size_t position_in_segment = i - segment_start;
+      const bool is_standard = (options_.type == Type::MRM) && (position_in_segment < options_.n_standards);
+
+      const std::string sample_name = "synthetic_" + std::to_string(i);
+      const std::string segment_name = "segment" + std::to_string(segment);
+      MetaDataHandler meta_data;
+      meta_data.setSampleName(sample_name);
+      meta_data.setFilename(sample_name + ".mzML");
+      meta_data.setSequenceSegmentName(segment_name);
+      if (is_standard) {
+        const std::string group_name = segment_name + "_level" + std::to_string(position_in_segment);
+        meta_data.setSampleGroupName(group_name);
+        meta_data.setReplicateGroupName(group_name);
+        meta_data.setSampleType(SampleType::Standard);
+      }
+      else {
+        const std::string group_name = "group" + std::to_string(i % n_sample_groups);
+        meta_data.setSampleGroupName(group_name);
+        meta_data.setReplicateGroupName(group_name);
+        meta_data.setSampleType(SampleType::Unknown);
+      }
+      meta_data.acq_method_name = "synthetic";
+      meta_data.inj_number = static_cast<int>(i + 1);
+      meta_data.inj_volume = 10.0;
+      meta_data.inj_volume_units = "uL";
+      meta_data.batch_name = "benchmark";
+      meta_data.scan_polarity = "negative";
+      meta_data.scan_mass_low = MZ_MIN;
+      meta_data.scan_mass_high = MZ_MAX;
+      meta_data.dilution_factor = 1.0;
+
+      if (options_.type != Type::MRM) {
+        sequence_handler.addSampleToSequence(meta_data, OpenMS::FeatureMap());
+        RawDataHandler& raw_data = sequence_handler.getSequence().back().getRawData();
+        raw_data.setExperiment(options_.type == Type::FIAMS
+          ? makeFIAMSExperiment(options_, rng)
+          : makeDDAExperiment(options_, rng));
+        continue;
+      }
+
+      // Chromatograms and the corresponding picked features
+      const double level_concentration = 0.01 * std::pow(2.0, static_cast<double>(position_in_segment));
+      OpenMS::MSExperiment chromatogram_map;
+      std::vector<OpenMS::MSChromatogram> chromatograms;
+      chromatograms.reserve(components.size() * 2);
+      OpenMS::FeatureMap feature_map;
+      feature_map.reserve(components.size());
+      for (const Component& component : components) {
+        const double concentration = is_standard ? level_concentration : unknown_concentration_distribution(rng);
+        const double rt = component.rt + rt_shift_distribution(rng);
+        const double light_height = RESPONSE_FACTOR * concentration * response_distribution(rng);
+        const double heavy_height = RESPONSE_FACTOR * IS_CONCENTRATION * response_distribution(rng);
+        chromatograms.push_back(makeChromatogram(component.light_name, component.precursor_mz, component.light_product_mz,
+          rt, light_height, options_.n_peaks, options_.n_points, rng));
+        chromatograms.push_back(makeChromatogram(component.heavy_name, component.precursor_mz + 3, component.heavy_product_mz,
+          rt, heavy_height, options_.n_peaks, options_.n_points, rng));
+
+        OpenMS::Feature light = makeSubordinate(component.light_name, rt, component.light_product_mz, light_height);
+        OpenMS::Feature heavy = makeSubordinate(component.heavy_name, rt, component.heavy_product_mz, heavy_height);
+        if (!is_standard) {
+          light.setMetaValue("calculated_concentration", concentration);
+          light.setMetaValue("concentration_units", "uM");
+        }
+        OpenMS::MRMFeature feature;
+        feature.setMetaValue("PeptideRef", component.group_name);
+        feature.setRT(rt);
+        feature.setMZ(component.precursor_mz);
+        feature.setIntensity(light.getIntensity() + heavy.getIntensity());
+        feature.setSubordinates({ light, heavy });
+        feature_map.push_back(feature);
+
+        if (is_standard) {
+          OpenMS::AbsoluteQuantitationStandards::runConcentration run;
+          run.sample_name = sample_name;
+          run.component_name = component.light_name;
+          run.IS_component_name = component.heavy_name;
+          run.actual_concentration = concentration;
+          run.IS_actual_concentration = IS_CONCENTRATION;
+          run.concentration_units = "uM";
+          run.dilution_factor = 1.0;
+          standards_concentrations[segment].push_back(run);
+        }
+      }
+      feature_map.setPrimaryMSRunPath({ meta_data.getFilename() });
+      chromatogram_map.setChromatograms(chromatograms);
+
+      sequence_handler.addSampleToSequence(meta_data, feature_map);
+      sequence_handler.getSequence().back().getRawData().setChromatogramMap(chromatogram_map);
+    }
+
+    if (options_.type != Type::MRM || sequence_handler.getSequence().empty()) {
+      return;
+    }
+
+    // Shared by all the injections
+    sequence_handler.getSequence().front().getRawData().getTargetedExperiment() = makeTargetedExperiment(components);
+
+    // Calibration of each sequence segment
+    OpenMS::Param model_params;
+    model_params.setValue("slope", 1.0);
+    model_params.setValue("intercept", 0.0);
+    model_params.setValue("x_weight", "ln(x)");
+    model_params.setValue("y_weight", "ln(y)");
+    model_params.setValue("x_datum_min", -1e12);
+    model_params.setValue("x_datum_max", 1e12);
+    model_params.setValue("y_datum_min", -1e12);
+    model_params.setValue("y_datum_max", 1e12);
+    std::vector<OpenMS::AbsoluteQuantitationMethod> quantitation_methods;
+    quantitation_methods.reserve(components.size());
+    for (const Component& component : components) {
+      OpenMS::AbsoluteQuantitationMethod quantitation_method;
+      quantitation_method.setComponentName(component.light_name);
+      quantitation_method.setISName(component.heavy_name);
+      quantitation_method.setFeatureName("peak_apex_int");
+      quantitation_method.setConcentrationUnits("uM");
+      quantitation_method.setTransformationModel("linear");
+      quantitation_method.setTransformationModelParams(model_params);
+      quantitation_methods.push_back(quantitation_method);
+    }
+    for (SequenceSegmentHandler& sequence_segment : sequence_handler.getSequenceSegments()) {
+      const size_t segment = std::stoul(sequence_segment.getSequenceSegmentName().substr(std::string("segment").size()));
+      sequence_segment.getQuantitationMethods() = quantitation_methods; // shared with the raw data handlers
+      sequence_segment.setStandardsConcentrations(standards_concentrations.at(segment));
+    }
+  }
+
+  std::string SyntheticSequenceGenerator::getLabel() const
+  {
+    return typeToString(options_.type) + "/"
+      + std::to_string(options_.n_injections) + "x"
+      + std::to_string(options_.n_transitions) + "x"
+      + std::to_string(options_.n_peaks);
+  }
+
+  std::string SyntheticSequenceGenerator::typeToString(Type type)
+  {
+    switch (type) {
+      case Type::MRM: return "MRM";
+      case Type::FIAMS: return "FIAMS";
+      case Type::DDA: return "DDA";
+    }
+    return "";
+  }
+
+  SyntheticSequenceGenerator::Type SyntheticSequenceGenerator::stringToType(const std::string& type)
+  {
+    if (type == "MRM") return Type::MRM;
+    if (type == "FIAMS") return Type::FIAMS;
+    if (type == "DDA") return Type::DDA;
+    throw std::invalid_argument("Unknown synthetic sequence type: " + type);
+  }
+}
@@ -0,0 +1,435 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/benchmarks/BenchmarkRunner.h>
+#include <SmartPeak/benchmarks/SyntheticSequenceGenerator.h>
+#include <SmartPeak/core/FeatureMetadata.h>
+#include <SmartPeak/core/Filenames.h>
+#include <SmartPeak/core/SampleType.h>
+#include <SmartPeak/core/SequenceHandler.h>
+#include <SmartPeak/core/SequenceProcessor.h>
+#include <SmartPeak/core/SessionHandler.h>
+#include <SmartPeak/core/Utilities.h>
+#include <SmartPeak/core/RawDataProcessors/MergeSpectra.h>
+#include <SmartPeak/core/RawDataProcessors/Pick2DFeatures.h>
+#include <SmartPeak/core/RawDataProcessors/PickMRMFeatures.h>
+#include <SmartPeak/core/SampleGroupProcessors/MergeInjections.h>
+#include <SmartPeak/core/SequenceSegmentProcessors/LoadStandardsConcentrations.h>
+#include <SmartPeak/core/SequenceSegmentProcessors/OptimizeCalibration.h>
+#include <SmartPeak/core/SequenceSegmentProcessors/StoreStandardsConcentrations.h>
+#include <SmartPeak/io/SequenceParser.h>
+
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace SmartPeak;
+
+namespace
+{
+  struct Arguments
+  {
+    SyntheticSequenceGenerator::Options options;
+    std::vector<SyntheticSequenceGenerator::Type> types = {
+      SyntheticSequenceGenerator::Type::MRM,
+      SyntheticSequenceGenerator::Type::FIAMS,
+      SyntheticSequenceGenerator::Type::DDA
+    };
+    size_t repetitions = 5;
+    int n_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string filter;
+    std::string output;
+  };
+
+  void printUsage()
+  {
+    std::cout <<
+      "Usage: smartpeak_benchmarks [options]\n"
+      "  --injections=N              number of injections (default 24)\n"
+      "  --transitions=N             MRM: number of transitions, FIAMS and DDA: number of MS1 spectra (default 200)\n"
+      "  --peaks=N                   number of peaks per chromatogram or spectrum (default 3)\n"
+      "  --points=N                  number of points per chromatogram or spectrum (default 300)\n"
+      "  --segments=N                number of sequence segments (default 1)\n"
+      "  --groups=N                  number of sample groups of the unknowns (default 4)\n"
+      "  --types=MRM,FIAMS,DDA       types of sequences to generate (default all)\n"
+      "  --seed=N                    seed of the generator (default 42)\n"
+      "  --threads=N                 number of threads of the sequence processors (default: all cores)\n"
+      "  --benchmark_repetitions=N   number of timed runs of each benchmark (default 5)\n"
+      "  --benchmark_filter=REGEX    only run the benchmarks whose name matches\n"
+      "  --benchmark_out=FILE        write the results in the Google Benchmark JSON format\n";
+  }
+
+  bool parseArguments(int argc, char** argv, Arguments& arguments)
+  {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      const auto equal_pos = arg.find('=');
+      const std::string key = arg.substr(0, equal_pos);
+      const std::string value = (equal_pos == std::string::npos) ? "" : arg.substr(equal_pos + 1);
+      try {
+        if (key == "--injections") arguments.options.n_injections = std::stoul(value);
+        else if (key == "--transitions") arguments.options.n_transitions = std::stoul(value);
+        else if (key == "--peaks") arguments.options.n_peaks = std::stoul(value);
+        else if (key == "--points") arguments.options.n_points = std::stoul(value);
+        else if (key == "--segments") arguments.options.n_sequence_segments = std::stoul(value);
+        else if (key == "--groups") arguments.options.n_sample_groups = std::stoul(value);
+        else if (key == "--seed") arguments.options.seed = static_cast<unsigned int>(std::stoul(value));
+        else if (key == "--threads") arguments.n_threads = std::stoi(value);
+        else if (key == "--benchmark_repetitions") arguments.repetitions = std::stoul(value);
+        else if (key == "--benchmark_filter") arguments.filter = value;
+        else if (key == "--benchmark_out") arguments.output = value;
+        else if (key == "--types") {
+          arguments.types.clear();
+          std::stringstream types(value);
+          std::string type;
+          while (std::getline(types, type, ',')) {
+            arguments.types.push_back(SyntheticSequenceGenerator::stringToType(type));
+          }
+        }
+        else {
+          printUsage();
+          return false;
+        }
+      }
+      catch (const std::exception&) {
+        std::cerr << "Invalid argument: " << arg << std::endl;
+        printUsage();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Filenames makeMethodsFilenames(const std::filesystem::path& work_dir)
+  {
+    Filenames filenames;
+    filenames.setTagValue(Filenames::Tag::MAIN_DIR, work_dir.generic_string());
+    filenames.setTagValue(Filenames::Tag::MZML_INPUT_PATH, work_dir.generic_string());
+    filenames.setTagValue(Filenames::Tag::FEATURES_INPUT_PATH, work_dir.generic_string());
+    filenames.setTagValue(Filenames::Tag::FEATURES_OUTPUT_PATH, work_dir.generic_string());
+    return filenames;
+  }
+
+  std::map<std::string, Filenames> makeFilenames(const std::vector<std::string>& names, const Filenames& methods_filenames)
+  {
+    std::map<std::string, Filenames> filenames;
+    for (const std::string& name : names) {
+      Filenames& item_filenames = filenames[name];
+      item_filenames = methods_filenames;
+      item_filenames.setTagValue(Filenames::Tag::INPUT_MZML_FILENAME, name);
+      item_filenames.setTagValue(Filenames::Tag::INPUT_INJECTION_NAME, name);
+      item_filenames.setTagValue(Filenames::Tag::OUTPUT_INJECTION_NAME, name);
+      item_filenames.setTagValue(Filenames::Tag::INPUT_GROUP_NAME, name);
+      item_filenames.setTagValue(Filenames::Tag::OUTPUT_GROUP_NAME, name);
+    }
+    return filenames;
+  }
+
+  std::vector<std::string> getInjectionNames(const SequenceHandler& sequence_handler)
+  {
+    std::vector<std::string> names;
+    for (const InjectionHandler& injection : sequence_handler.getSequence()) {
+      names.push_back(injection.getMetaData().getInjectionName());
+    }
+    return names;
+  }
+
+  std::vector<std::string> getSequenceSegmentNames(const SequenceHandler& sequence_handler)
+  {
+    std::vector<std::string> names;
+    for (const SequenceSegmentHandler& sequence_segment : sequence_handler.getSequenceSegments()) {
+      names.push_back(sequence_segment.getSequenceSegmentName());
+    }
+    return names;
+  }
+
+  std::vector<std::string> getSampleGroupNames(const SequenceHandler& sequence_handler)
+  {
+    std::vector<std::string> names;
+    for (const SampleGroupHandler& sample_group : sequence_handler.getSampleGroups()) {
+      names.push_back(sample_group.getSampleGroupName());
+    }
+    return names;
+  }
+
+  std::set<SampleType> allSampleTypes()
+  {
+    std::set<SampleType> sample_types;
+    for (const auto& sample_type : sampleTypeToString) sample_types.insert(sample_type.first);
+    return sample_types;
+  }
+
+  /// State shared by the benchmarks of one generated sequence
+  struct BenchmarkData
+  {
+    SyntheticSequenceGenerator generator;
+    std::unique_ptr<SequenceHandler> sequence_handler;
+    std::vector<OpenMS::AbsoluteQuantitationMethod> quantitation_methods;
+    std::unique_ptr<SessionHandler> session_handler;
+    SessionHandler::GenericTableData table_data;
+
+    explicit BenchmarkData(const SyntheticSequenceGenerator::Options& options) : generator(options) {}
+
+    SequenceHandler& regenerate()
+    {
+      sequence_handler = std::make_unique<SequenceHandler>();
+      generator.generate(*sequence_handler);
+      if (!sequence_handler->getSequenceSegments().empty()) {
+        quantitation_methods = sequence_handler->getSequenceSegments().front().getQuantitationMethods();
+      }
+      return *sequence_handler;
+    }
+
+    SequenceHandler& get()
+    {
+      return sequence_handler ? *sequence_handler : regenerate();
+    }
+  };
+
+  void saveSession(SequenceHandler& sequence_handler, const std::filesystem::path& session_db)
+  {
+    Filenames filenames;
+    filenames.getSessionDB().setDBFilePath(session_db);
+    StoreSequence store_sequence(sequence_handler);
+    store_sequence.getFilenames(filenames);
+    store_sequence.process(filenames);
+    StoreStandardsConcentrations store_standards_concentrations;
+    store_standards_concentrations.getFilenames(filenames);
+    for (SequenceSegmentHandler& sequence_segment : sequence_handler.getSequenceSegments()) {
+      store_standards_concentrations.process(sequence_segment, sequence_handler, {}, filenames);
+    }
+  }
+
+  void addRawDataBenchmarks(
+    BenchmarkRunner& runner,
+    const std::shared_ptr<BenchmarkData>& data,
+    const Arguments& arguments,
+    const Filenames& methods_filenames)
+  {
+    std::shared_ptr<RawDataProcessor> method;
+    switch (data->generator.getOptions().type) {
+      case SyntheticSequenceGenerator::Type::MRM: method = std::make_shared<PickMRMFeatures>(); break;
+      case SyntheticSequenceGenerator::Type::FIAMS: method = std::make_shared<MergeSpectra>(); break;
+      case SyntheticSequenceGenerator::Type::DDA: method = std::make_shared<Pick2DFeatures>(); break;
+    }
+    const std::string label = data->generator.getLabel();
+    const int n_threads = arguments.n_threads;
+    runner.add({
+      "ProcessSequence/" + method->getName() + "/" + label,
+      [data]() { data->regenerate(); },
+      [data, method, n_threads, methods_filenames]() {
+        SequenceHandler& sequence_handler = data->get();
+        ProcessSequence process_sequence(sequence_handler);
+        process_sequence.filenames_ = makeFilenames(getInjectionNames(sequence_handler), methods_filenames);
+        process_sequence.raw_data_processing_methods_ = { method };
+        process_sequence.number_of_threads_ = n_threads;
+        Filenames filenames = methods_filenames;
+        process_sequence.process(filenames);
+      },
+      static_cast<double>(data->generator.getOptions().n_injections)
+    });
+  }
+
+  void addMRMBenchmarks(
+    BenchmarkRunner& runner,
+    const std::shared_ptr<BenchmarkData>& data,
+    const Arguments& arguments,
+    const Filenames& methods_filenames,
+    const std::filesystem::path& work_dir)
+  {
+    const std::string label = data->generator.getLabel();
+    const int n_threads = arguments.n_threads;
+    const double n_injections = static_cast<double>(data->generator.getOptions().n_injections);
+
+    runner.add({
+      "ProcessSequenceSegments/OPTIMIZE_CALIBRATION/" + label,
+      [data]() {
+        // start each run from the same calibration models
+        for (SequenceSegmentHandler& sequence_segment : data->get().getSequenceSegments()) {
+          sequence_segment.getQuantitationMethods() = data->quantitation_methods;
+        }
+      },
+      [data, n_threads, methods_filenames]() {
+        SequenceHandler& sequence_handler = data->get();
+        ProcessSequenceSegments process_sequence_segments(sequence_handler);
+        process_sequence_segments.filenames_ = makeFilenames(getSequenceSegmentNames(sequence_handler), methods_filenames);
+        process_sequence_segments.sequence_segment_processing_methods_ = { std::make_shared<OptimizeCalibration>() };
+        process_sequence_segments.number_of_threads_ = n_threads;
+        Filenames filenames = methods_filenames;
+        process_sequence_segments.process(filenames);
+      },
+      static_cast<double>(data->generator.getOptions().n_sequence_segments)
+    });
+
+    runner.add({
+      "ProcessSampleGroups/MERGE_INJECTIONS/" + label,
+      nullptr,
+      [data, n_threads, methods_filenames]() {
+        SequenceHandler& sequence_handler = data->get();
+        ProcessSampleGroups process_sample_groups(sequence_handler);
+        process_sample_groups.filenames_ = makeFilenames(getSampleGroupNames(sequence_handler), methods_filenames);
+        process_sample_groups.sample_group_processing_methods_ = { std::make_shared<MergeInjections>() };
+        process_sample_groups.number_of_threads_ = n_threads;
+        Filenames filenames = methods_filenames;
+        process_sample_groups.process(filenames);
+      },
+      n_injections
+    });
+
+    // Session database: the sequence and the standards concentrations of all the segments
+    const std::filesystem::path session_db = work_dir / "benchmark_session.db";
+    runner.add({
+      "SessionDB/Save/" + label,
+      [session_db]() { std::filesystem::remove(session_db); },
+      [data, session_db]() { saveSession(data->get(), session_db); },
+      n_injections
+    });
+    runner.add({
+      "SessionDB/Load/" + label,
+      [data, session_db]() {
+        if (!std::filesystem::exists(session_db)) saveSession(data->get(), session_db);
+      },
+      [session_db]() {
+        SequenceHandler sequence_handler;
+        Filenames filenames;
+        filenames.getSessionDB().setDBFilePath(session_db);
+        LoadSequence load_sequence(sequence_handler);
+        load_sequence.process(filenames);
+        LoadStandardsConcentrations load_standards_concentrations;
+        for (SequenceSegmentHandler& sequence_segment : sequence_handler.getSequenceSegments()) {
+          load_standards_concentrations.process(sequence_segment, sequence_handler, {}, filenames);
+        }
+      },
+      n_injections
+    });
+
+    // Reports
+    const std::vector<FeatureMetadata> report_metadata = {
+      FeatureMetadata::peak_apex_intensity,
+      FeatureMetadata::retention_time,
+      FeatureMetadata::calculated_concentration
+    };
+    const std::filesystem::path report = work_dir / "benchmark_report.csv";
+    runner.add({
+      "Report/FeatureDB/" + label,
+      nullptr,
+      [data, report, report_metadata]() {
+        SequenceParser::writeDataTableFromMetaValue(data->get(), report, report_metadata, allSampleTypes());
+      },
+      n_injections
+    });
+    runner.add({
+      "Report/PivotTable/" + label,
+      nullptr,
+      [data, report, report_metadata]() {
+        SequenceParser::writeDataMatrixFromMetaValue(data->get(), report, report_metadata, allSampleTypes());
+      },
+      n_injections
+    });
+
+    // Session tables, each run on a new session handler
+    runner.add({
+      "SessionHandler/setMinimalDataAndFilters/" + label,
+      [data]() { data->session_handler = std::make_unique<SessionHandler>(); },
+      [data]() { data->session_handler->setMinimalDataAndFilters(data->get()); },
+      n_injections
+    });
+    runner.add({
+      "SessionHandler/setSequenceTable/" + label,
+      [data]() { data->session_handler = std::make_unique<SessionHandler>(); },
+      [data]() { data->session_handler->setSequenceTable(data->get(), data->session_handler->sequence_table); },
+      n_injections
+    });
+    runner.add({
+      "SessionHandler/setFeatureTable/" + label,
+      [data]() {
+        data->session_handler = std::make_unique<SessionHandler>();
+        data->session_handler->setMinimalDataAndFilters(data->get());
+      },
+      [data]() { data->session_handler->setFeatureTable(data->get(), data->table_data); },
+      n_injections
+    });
+    runner.add({
+      "SessionHandler/setFeatureMatrix/" + label,
+      [data]() {
+        data->session_handler = std::make_unique<SessionHandler>();
+        SessionHandler& session_handler = *data->session_handler;
+        session_handler.setMinimalDataAndFilters(data->get());
+        for (int i = 0; i < session_handler.feature_table.body_.dimension(0); ++i) {
+          if (session_handler.feature_table.body_(i, 0) == "peak_apex_int") session_handler.feature_explorer_data.checkbox_body(i, 0) = true;
+        }
+      },
+      [data]() { data->session_handler->setFeatureMatrix(data->get()); },
+      n_injections
+    });
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Arguments arguments;
+  if (!parseArguments(argc, argv, arguments)) {
+    return 1;
+  }
+
+  const std::filesystem::path work_dir = std::filesystem::temp_directory_path() / "smartpeak_benchmarks";
+  std::filesystem::create_directories(work_dir);
+  const Filenames methods_filenames = makeMethodsFilenames(work_dir);
+
+  BenchmarkRunner runner;
+  for (const auto type : arguments.types) {
+    SyntheticSequenceGenerator::Options options = arguments.options;
+    options.type = type;
+    addRawDataBenchmarks(runner, std::make_shared<BenchmarkData>(options), arguments, methods_filenames);
+    if (type == SyntheticSequenceGenerator::Type::MRM) {
+      // the benchmarks of the picked features do not share the sequence modified by the raw data processing
+      addMRMBenchmarks(runner, std::make_shared<BenchmarkData>(options), arguments, methods_filenames, work_dir);
+    }
+  }
+
+  const bool success = runner.run(arguments.repetitions, arguments.filter, std::cout);
+
+  if (!arguments.output.empty()) {
+    const auto& options = arguments.options;
+    const std::map<std::string, std::string> context = {
+      { "smartpeak_version", Utilities::getSmartPeakVersion() },
+      { "injections", std::to_string(options.n_injections) },
+      { "transitions", std::to_string(options.n_transitions) },
+      { "peaks", std::to_string(options.n_peaks) },
+      { "points", std::to_string(options.n_points) },
+      { "sequence_segments", std::to_string(options.n_sequence_segments) },
+      { "sample_groups", std::to_string(options.n_sample_groups) },
+      { "seed", std::to_string(options.seed) },
+      { "threads", std::to_string(arguments.n_threads) }
+    };
+    if (!runner.writeJSON(arguments.output, context)) {
+      std::cerr << "Failed to write " << arguments.output << std::endl;
+      return 1;
+    }
+  }
+  std::filesystem::remove_all(work_dir);
+  return success ? 0 : 1;
+}
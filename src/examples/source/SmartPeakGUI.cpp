@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <chrono>
 #include <string>
+#include <utility>
 #include <vector>
 #include <SmartPeak/core/ApplicationHandler.h>
 #include <SmartPeak/core/SequenceProcessor.h>
@@ -109,6 +110,7 @@ int main(int argc, char** argv)
   bool workflow_is_done_ = true;
   bool file_loading_is_done_ = true;
   bool exceeding_table_size_ = false;
+  size_t feature_matrix_version_ = 0; // version of the feature matrix data displayed in the feature matrix table
   bool ran_integrity_check_ = false;
   bool integrity_check_failed_ = false;
   bool RawDataAndFeatures_loaded_ = false;
@@ -184,6 +186,7 @@ int main(int argc, char** argv)
   auto calibrators_line_plot_ = std::make_shared<CalibratorsPlotWidget>(
     session_handler_,
     application_handler_.sequenceHandler_,
+    *application_handler_.data_preparation_pool_,
     injections_explorer_window_,
     chromatogram_plot_widget_,
     event_dispatcher,
@@ -191,7 +194,7 @@ int main(int argc, char** argv)
   auto transitions_explorer_window_ = std::make_shared<ExplorerWidget>("TransitionsExplorerWindow", "Transitions", *statistics_, &event_dispatcher);
   auto features_explorer_window_ = std::make_shared<ExplorerWidget>("FeaturesExplorerWindow", "Features", *statistics_, &event_dispatcher);
   auto sequence_main_window_ = std::make_shared<SequenceTableWidget>("SequenceMainWindow", "Sequence",
-    &session_handler_, &application_handler_.sequenceHandler_);
+    &session_handler_, &application_handler_.sequenceHandler_, *application_handler_.data_preparation_pool_);
   auto transitions_main_window_ = std::make_shared<GenericTableWidget>("TransitionsMainWindow", "Transitions Table");
   auto spectrum_main_window_ = std::make_shared<GenericTableWidget>("SpectrumMainWindow", "Scans Table");
   auto quant_method_main_window_ = std::make_shared<SequenceSegmentWidget>("QuantMethodMainWindow", "Quantitation Method",
@@ -492,6 +495,8 @@ split_window.default_layout_ =
 
     if ((!workflow_is_done_) && workflow_manager_.isWorkflowDone()) // workflow just finished
     {
+      // the views may be preparing their data from the sequence being replaced
+      auto data_lock = application_handler_.data_preparation_pool_->lockData();
       workflow_manager_.updateApplicationHandler(application_handler_);
     }
     workflow_is_done_ = workflow_manager_.isWorkflowDone();
@@ -663,7 +668,7 @@ split_window.default_layout_ =
         ImGui::MenuItem("Main window (Plots)", NULL, false, false);
         // TODO work on generalization of visualization.
         if (application_handler_.sequenceHandler_.getSequence().size() > 0 && 
-            application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getChromatogramMap().getChromatograms().size() > 0)
+            std::as_const(application_handler_.sequenceHandler_).getSequence().at(0).getRawData().getChromatogramMap().getChromatograms().size() > 0)
         {
           if (ImGui::MenuItem("Chromatogram", NULL, &chromatogram_plot_widget_->visible_)) {}
         }
@@ -715,14 +720,16 @@ split_window.default_layout_ =
         }
         showQuickHelpToolTip("run_workflow");
         
-        if (ImGui::MenuItem("Cancel Workflow"))
+        if (ImGui::MenuItem("Cancel Queued Workflow", NULL, false, run_on_server))
         {
-          if (run_on_server) {
-            if (workflow_client_.isChannelSet()) {
-              workflow_client_.stopRunningWorkflow();
-            }
+          if (workflow_client_.isChannelSet()) {
+            workflow_client_.cancelQueuedWorkflow();
           }
         }
+        if (ImGui::IsItemHovered())
+        {
+          ImGui::SetTooltip("Cancels the workflow sent to the server while it waits for a free slot, a running workflow cannot be stopped.");
+        }
         
         if (ImGui::BeginMenu("Integrity checks"))
         {
@@ -794,6 +801,7 @@ split_window.default_layout_ =
           workflow_client_.setChannel(grpc::CreateChannel(
             run_workflow_widget_->server_url,
             grpc::InsecureChannelCredentials()));
+          workflow_client_.createJobId();
 
           runworkflow_future_ = std::async(
             std::launch::async,
@@ -865,7 +873,11 @@ split_window.default_layout_ =
     if (feature_matrix_main_window_->visible_)
     {
         session_handler_.setFeatureMatrix(application_handler_.sequenceHandler_);
-        feature_matrix_main_window_->table_data_ = session_handler_.feature_pivot_table;
+        if (feature_matrix_version_ != session_handler_.getFeatureMatrixVersion())
+        {
+          feature_matrix_main_window_->setTableData(session_handler_.feature_pivot_table);
+          feature_matrix_version_ = session_handler_.getFeatureMatrixVersion();
+        }
         feature_matrix_main_window_->checked_rows_ = Eigen::Tensor<bool, 1>();
     }
 
@@ -40,6 +40,14 @@ public:
   
   bool isChannelSet();
 
+  /**
+    Creates the id of the next job. It is sent with runWorkflow and used by
+    getProgressInfo, getEvent and cancelQueuedWorkflow to refer to that job.
+  */
+  std::string createJobId();
+
+  const std::string& getJobId() const { return job_id_; }
+
   std::string runWorkflow(
     const std::string& dataset_path,
     const std::string& username,
@@ -57,23 +65,23 @@ public:
     SmartPeak::ISequenceObserver* sequence_observer,
     SmartPeak::ITransitionsObserver* transition_observer);
   
-  void stopRunningWorkflow();
+  /**
+    Cancels the job if it is still waiting in the server queue: a job that has started runs to completion.
+    @return true if the job was cancelled.
+  */
+  bool cancelQueuedWorkflow();
 
 private:
   std::unique_ptr<SmartPeakServer::Workflow::Stub> stub_;
   bool channel_set = false;
+  std::string job_id_;
 };
 
 // server-side
 class WorkflowService final : public SmartPeakServer::Workflow::Service
 {
-  enum class WorkflowStatus {
-    IDLE,
-    RUNNING
-  };
-  
 public:
-  explicit WorkflowService() : is_logger_init_(false)
+  explicit WorkflowService() : is_logger_init_(false), job_queue_(getMaxRunningJobs())
   {
     auto [logfilepath, logdir_created] = SmartPeak::Utilities::getLogFilepath("smartpeak_log");
     console_handler_ = &SmartPeak::ConsoleHandler::get_instance();
@@ -82,7 +90,21 @@ public:
     console_handler_->set_severity(plog::debug);
     console_handler_->initialize("Starting SmartPeak Server version " + SmartPeak::Utilities::getSmartPeakVersion());
     is_logger_init_ = true;
+    threads_per_job_ = getThreadsPerJob(job_queue_.getMaxRunningJobs());
+    LOGI << "Running up to " << job_queue_.getMaxRunningJobs() << " jobs concurrently, " << threads_per_job_ << " threads per job";
   }
+
+  /**
+    Maximum number of workflows run concurrently, read from SMARTPEAK_SERVER_MAX_JOBS.
+    By default one job is run per 8 cores.
+  */
+  static size_t getMaxRunningJobs();
+
+  /**
+    Number of threads given to each workflow, read from SMARTPEAK_SERVER_THREADS_PER_JOB.
+    By default the cores are split between the concurrent jobs.
+  */
+  static int getThreadsPerJob(size_t max_running_jobs);
   
   virtual bool validateCredentials(const std::string& username, const std::string& password);
   
@@ -112,14 +134,23 @@ public:
     ::grpc::ServerWriter<::SmartPeakServer::LogStream>* writer) override;
   
 private:
+  /**
+    @brief returns the job id sent by the client in the metadata, or an empty string.
+  */
+  static std::string getJobId(const ::grpc::ServerContext* context);
+
+  std::shared_ptr<SmartPeak::serv::ServerManager> getServerManager(const std::string& job_id);
+
   bool is_logger_init_;
-  std::string session_id_ = "";
   SmartPeak::ConsoleHandler* console_handler_;
-  SmartPeak::serv::ServerManager server_manager_;
-  std::future<bool> handle_workflow_future_;
-  ::SmartPeakServer::ProgressInfo progress_info_;
-  WorkflowStatus workflow_status_ = WorkflowStatus::IDLE;
-  bool workflow_process_interrupted = false;
+  SmartPeak::serv::JobQueue job_queue_;
+  int threads_per_job_ = 0;
+  std::mutex jobs_mutex_;
+  std::mutex events_mutex_;
+  std::map<std::string, std::shared_ptr<SmartPeak::serv::ServerManager>> server_managers_; ///< job id -> running or queued job
+  std::map<std::string, std::string> job_results_; ///< job id -> "YES"/"NO"/"CANCELLED" for the finished jobs
+  std::deque<std::string> finished_job_ids_; ///< keys of job_results_, oldest first
+  static constexpr size_t max_job_results_ = 1000; ///< results of older jobs are forgotten
 };
 
 void runSmartPeakServer(std::string server_address);
@@ -137,6 +168,12 @@ bool WorkflowClient::isChannelSet()
   return channel_set;
 }
 
+std::string WorkflowClient::createJobId()
+{
+  job_id_ = SmartPeak::Utilities::makeUniqueStringFromTime();
+  return job_id_;
+}
+
 std::string WorkflowClient::runWorkflow(
   const std::string& dataset_path,
   const std::string& username,
@@ -151,6 +188,10 @@ std::string WorkflowClient::runWorkflow(
   context.AddMetadata("smartpeak_version", SmartPeak::Utilities::getSmartPeakVersion());
   context.AddMetadata("id", username);
   context.AddMetadata("password", password);
+  if (!job_id_.empty())
+  {
+    context.AddMetadata("job_id", job_id_);
+  }
   
   grpc::Status status = stub_->runWorkflow(&context, workflow_parameters, &workflow_status);
   
@@ -217,6 +258,7 @@ std::string WorkflowClient::getProgressInfo()
   SmartPeakServer::WorkflowParameters workflow_parameters;
   SmartPeakServer::ProgressInfo progress_info;
   grpc::ClientContext context;
+  context.AddMetadata("job_id", job_id_);
 
   grpc::Status status = stub_->getProgressInfo(&context, workflow_parameters, &progress_info);
   if (status.ok())
@@ -242,6 +284,7 @@ void WorkflowClient::getEvent(
   SmartPeakServer::WorkflowEvent workflow_event;
 
   grpc::ClientContext context;
+  context.AddMetadata("job_id", job_id_);
 
   grpc::Status status = stub_->getWorkflowEvent(&context, workflow_parameters, &workflow_event);
   if (status.ok())
@@ -344,12 +387,22 @@ void WorkflowClient::getEvent(
   }
  }
 
-void WorkflowClient::stopRunningWorkflow()
+bool WorkflowClient::cancelQueuedWorkflow()
 {
   SmartPeakServer::Interrupter intr_request;
   SmartPeakServer::Interrupter intr_response;
   grpc::ClientContext context;
+  context.AddMetadata("job_id", job_id_);
   stub_->stopRunningWorkflow(&context, intr_request, &intr_response);
+  if (intr_response.is_interrupted())
+  {
+    LOGI << "Job " << job_id_ << " cancelled";
+  }
+  else
+  {
+    LOGW << "Job " << job_id_ << " is not queued anymore, a running workflow cannot be cancelled";
+  }
+  return intr_response.is_interrupted();
 }
 
 bool WorkflowService::validateCredentials(const std::string& username, const std::string& password)
@@ -400,12 +453,68 @@ bool WorkflowService::validateCredentials(const std::string& username, const std
   return credentials_matched;
 }
 
+size_t WorkflowService::getMaxRunningJobs()
+{
+  std::string max_jobs;
+  SmartPeak::Utilities::getEnvVariable("SMARTPEAK_SERVER_MAX_JOBS", &max_jobs);
+  try
+  {
+    if (!max_jobs.empty()) return std::max(std::stoi(max_jobs), 1);
+  }
+  catch (const std::exception& e)
+  {
+    LOGW << "Invalid SMARTPEAK_SERVER_MAX_JOBS: " << max_jobs;
+  }
+  const size_t nb_cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  return std::max<size_t>(nb_cores / 8, 1);
+}
+
+int WorkflowService::getThreadsPerJob(size_t max_running_jobs)
+{
+  std::string threads_per_job;
+  SmartPeak::Utilities::getEnvVariable("SMARTPEAK_SERVER_THREADS_PER_JOB", &threads_per_job);
+  try
+  {
+    if (!threads_per_job.empty()) return std::max(std::stoi(threads_per_job), 1);
+  }
+  catch (const std::exception& e)
+  {
+    LOGW << "Invalid SMARTPEAK_SERVER_THREADS_PER_JOB: " << threads_per_job;
+  }
+  const int nb_cores = std::max<int>(std::thread::hardware_concurrency(), 1);
+  return std::max<int>(nb_cores / max_running_jobs, 1);
+}
+
+std::string WorkflowService::getJobId(const ::grpc::ServerContext* context)
+{
+  const auto& client_metadata = context->client_metadata();
+  const auto job_id = client_metadata.find("job_id");
+  if (job_id == client_metadata.end())
+  {
+    return "";
+  }
+  return std::string(job_id->second.data(), job_id->second.size());
+}
+
+std::shared_ptr<SmartPeak::serv::ServerManager> WorkflowService::getServerManager(const std::string& job_id)
+{
+  std::lock_guard<std::mutex> lock(jobs_mutex_);
+  const auto it = server_managers_.find(job_id);
+  return (it == server_managers_.end()) ? nullptr : it->second;
+}
+
 ::grpc::Status WorkflowService::stopRunningWorkflow(
   ::grpc::ServerContext* context,
   const ::SmartPeakServer::Interrupter* request,
   ::SmartPeakServer::Interrupter* response)
 {
-  workflow_process_interrupted = true;
+  const auto job_id = getJobId(context);
+  // only the jobs waiting in the queue can be stopped
+  response->set_is_interrupted(job_queue_.cancel(job_id));
+  if (!response->is_interrupted())
+  {
+    LOGW << "Job " << job_id << " is not queued, it cannot be stopped";
+  }
   return grpc::Status(grpc::StatusCode::CANCELLED, "CANCELLED");
 }
 
@@ -415,9 +524,7 @@ bool WorkflowService::validateCredentials(const std::string& username, const std
   ::SmartPeakServer::WorkflowResult* response)
 {
   std::string started_at = SmartPeak::Utilities::getCurrentTime();
-  session_id_ = SmartPeak::Utilities::makeUniqueStringFromTime();
-  server_manager_.dataset_path = request->dataset_path();
-  bool export_all;
+  bool export_all = false;
   if (SmartPeakServer::WorkflowParameters_ExportReport_ALL == request->export_()) export_all = true;
   
   auto client_metadata = context->client_metadata();
@@ -429,75 +536,89 @@ bool WorkflowService::validateCredentials(const std::string& username, const std
     LOGW << "Username not provided! Aborting ..";
     return grpc::Status(grpc::StatusCode::UNAUTHENTICATED, "UNAUTHORIZED");
   }
-  if (username == client_metadata.end())
+  if (password == client_metadata.end())
   {
     LOGW << "Password not provided! Aborting ..";
     return grpc::Status(grpc::StatusCode::UNAUTHENTICATED, "UNAUTHORIZED");
   }
   
-  if (validateCredentials(username->second.data(), password->second.data()))
+  if (!validateCredentials(username->second.data(), password->second.data()))
   {
-    LOGI << "Successfully logged in as: " << username->second.data() << " ...";
-    if (workflow_status_ == WorkflowStatus::IDLE || workflow_process_interrupted) {
-      
-      if (workflow_process_interrupted)
-      {
-        server_manager_.reset();
-      }
-      
-      workflow_status_ = WorkflowStatus::RUNNING;
-      handle_workflow_future_ = std::async(
-        std::launch::async,
-        &SmartPeak::serv::handleWorkflowRequest,
-        &server_manager_,
-        export_all
-      );
-      
-      if (workflow_process_interrupted)
-      {
-        workflow_process_interrupted = false;
-        return grpc::Status(grpc::StatusCode::CANCELLED, "CANCELLED");
-      }
-      
-      if (handle_workflow_future_.valid())
-      {
-        response->set_status_code(handle_workflow_future_.get() ? "YES" : "NO");
-        progress_info_.set_status_code(response->status_code());
-      }
-      
-      const auto app_hand = server_manager_.get_application_handler();
-      const auto seq_hand = app_hand.sequenceHandler_;
-        
-      LOGD << "Writing to serversession in : " << app_hand.main_dir_.string();
-      SmartPeak::Utilities::writeToServerSessionFile(
-        app_hand.main_dir_.string(),
-        username->second.data(), app_hand.main_dir_.string(),
-        response->status_code(),
-        started_at, SmartPeak::Utilities::getCurrentTime(),
-        app_hand.main_dir_.string()+"/"+"exports",
-        console_handler_->get_log_filepath());
-      
-      if (response->status_code() == "NO")
-      {
-        return grpc::Status(grpc::StatusCode::ABORTED, "ABORTED");
-      }
-      
-      response->set_session_id(session_id_);
-      response->set_path_to_results(app_hand.main_dir_.string()+"/"+"exports");
-      server_manager_.reset();
-      workflow_status_ = WorkflowStatus::IDLE;
-      return grpc::Status::OK;
+    return grpc::Status(grpc::StatusCode::UNAUTHENTICATED, "UNAUTHORIZED");
+  }
+  LOGI << "Successfully logged in as: " << username->second.data() << " ...";
+
+  std::string job_id = getJobId(context);
+  if (job_id.empty())
+  {
+    job_id = SmartPeak::Utilities::makeUniqueStringFromTime();
+  }
+  auto server_manager = std::make_shared<SmartPeak::serv::ServerManager>();
+  server_manager->dataset_path = request->dataset_path();
+  server_manager->nb_threads = threads_per_job_;
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    if (server_managers_.count(job_id) || job_results_.count(job_id))
+    {
+      LOGW << "Job id already used: " << job_id;
+      return grpc::Status(grpc::StatusCode::ALREADY_EXISTS, "JOB ID ALREADY USED");
     }
-    else
+    server_managers_.emplace(job_id, server_manager);
+  }
+
+  auto job_result = job_queue_.submit(job_id, [server_manager, export_all]()
+  {
+    return SmartPeak::serv::handleWorkflowRequest(server_manager.get(), export_all);
+  });
+  if (!job_result.valid())
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    server_managers_.erase(job_id);
+    return grpc::Status(grpc::StatusCode::UNAVAILABLE, "BUSY");
+  }
+
+  const bool job_done = job_result.get();
+  const bool job_cancelled = (job_queue_.getStatus(job_id) == SmartPeak::serv::JobQueue::JobStatus::CANCELLED);
+  response->set_status_code(job_done ? "YES" : "NO");
+  response->set_session_id(job_id);
+
+  const auto& app_hand = server_manager->get_application_handler();
+  if (!job_cancelled)
+  {
+    LOGD << "Writing to serversession in : " << app_hand.main_dir_.string();
+    SmartPeak::Utilities::writeToServerSessionFile(
+      app_hand.main_dir_.string(),
+      username->second.data(), app_hand.main_dir_.string(),
+      response->status_code(),
+      started_at, SmartPeak::Utilities::getCurrentTime(),
+      app_hand.main_dir_.string()+"/"+"exports",
+      console_handler_->get_log_filepath());
+    response->set_path_to_results(app_hand.main_dir_.string()+"/"+"exports");
+  }
+
+  {
+    // the session data of the finished job are released, only its result is kept
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    server_managers_.erase(job_id);
+    job_results_[job_id] = job_cancelled ? "CANCELLED" : response->status_code();
+    finished_job_ids_.push_back(job_id);
+    job_queue_.forget(job_id);
+    if (finished_job_ids_.size() > max_job_results_)
     {
-      LOGW << "SERVER BUSY -- NOT PROCESSING : " << server_manager_.dataset_path;
-      return grpc::Status(grpc::StatusCode::UNAVAILABLE, "BUSY");
+      job_results_.erase(finished_job_ids_.front());
+      finished_job_ids_.pop_front();
     }
   }
-  else
+
+  if (job_cancelled)
   {
-    return grpc::Status(grpc::StatusCode::UNAUTHENTICATED, "UNAUTHORIZED");
+    return grpc::Status(grpc::StatusCode::CANCELLED, "CANCELLED");
+  }
+  if (!job_done)
+  {
+    return grpc::Status(grpc::StatusCode::ABORTED, "ABORTED");
   }
+  return grpc::Status::OK;
 }
 
 ::grpc::Status WorkflowService::getProgressInfo(
@@ -505,7 +626,30 @@ bool WorkflowService::validateCredentials(const std::string& username, const std
   const ::SmartPeakServer::WorkflowParameters* request,
   ::SmartPeakServer::ProgressInfo* response)
 {
-  response->set_status_code(progress_info_.status_code());
+  const auto job_id = getJobId(context);
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    const auto job_result = job_results_.find(job_id);
+    if (job_result != job_results_.end())
+    {
+      response->set_status_code(job_result->second);
+      return grpc::Status::OK;
+    }
+  }
+  switch (job_queue_.getStatus(job_id))
+  {
+  case SmartPeak::serv::JobQueue::JobStatus::QUEUED:
+    response->set_status_code("QUEUED");
+    break;
+  case SmartPeak::serv::JobQueue::JobStatus::RUNNING:
+    response->set_status_code("RUNNING");
+    break;
+  case SmartPeak::serv::JobQueue::JobStatus::CANCELLED:
+    response->set_status_code("CANCELLED");
+    break;
+  default:
+    return grpc::Status(grpc::StatusCode::NOT_FOUND, "UNKNOWN JOB");
+  }
   return grpc::Status::OK;
 }
 
@@ -514,9 +658,16 @@ bool WorkflowService::validateCredentials(const std::string& username, const std
   const ::SmartPeakServer::WorkflowParameters* request,
   ::SmartPeakServer::WorkflowEvent* response)
 {
-  auto &event_dispatcher = server_manager_.get_event_dispatcher();
+  auto server_manager = getServerManager(getJobId(context));
+  if (!server_manager)
+  {
+    return grpc::Status::CANCELLED;
+  }
+  // events are dispatched and consumed by one request at a time
+  std::lock_guard<std::mutex> lock(events_mutex_);
+  auto &event_dispatcher = server_manager->get_event_dispatcher();
   event_dispatcher.dispatchEvents();
-  auto& server_event_dispatcher_observer = server_manager_.get_server_event_dispatcher_observer();
+  auto& server_event_dispatcher_observer = server_manager->get_server_event_dispatcher_observer();
   if (server_event_dispatcher_observer.events_.empty())
   {
     return grpc::Status::CANCELLED;
@@ -528,7 +679,6 @@ bool WorkflowService::validateCredentials(const std::string& username, const std
     response->set_event_name(event_name);
     response->set_event_index(event_index);
     response->set_item_name(item_name);
-    google::protobuf::RepeatedField<std::string> data(commands_list.begin(), commands_list.end());
     response->mutable_command_list()->Add(commands_list.begin(), commands_list.end());
   }
   return grpc::Status::OK;
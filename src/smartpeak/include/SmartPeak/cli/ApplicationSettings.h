@@ -111,6 +111,8 @@ public:
     std::string mzml_dir;
     std::string reports_out_dir;
     int nb_threads;
+    std::string profile;
+    int memory_budget;
 
 public:
     void validate_report() const;
@@ -23,11 +23,15 @@
 
 #pragma once
 
+#include <SmartPeak/core/DataPreparation.h>
 #include <SmartPeak/core/Filenames.h>
+#include <SmartPeak/core/ProcessorProfiler.h>
 #include <SmartPeak/core/RawDataProcessor.h>
+#include <SmartPeak/core/RawDataResidency.h>
 #include <SmartPeak/core/SequenceSegmentProcessor.h>
 #include <SmartPeak/core/SampleGroupProcessor.h>
 #include <SmartPeak/core/SessionLoaderGenerator.h>
+#include <SmartPeak/core/ThreadPool.h>
 #include <map>
 #include <string>
 #include <vector>
@@ -93,6 +97,12 @@ namespace SmartPeak
     */
     void closeSession();
 
+    /**
+    * @brief returns a copy of the application handler, the raw data of the injections
+    * being shared until modified (see SequenceHandler::snapshot)
+    */
+    ApplicationHandler snapshot() const;
+
     /**
     * @brief check if one session is currently opened
     */
@@ -125,6 +135,10 @@ namespace SmartPeak
     std::vector<std::shared_ptr<IFilenamesHandler>> loading_processors_;
     std::vector<std::shared_ptr<IFilenamesHandler>> storing_processors_;
     SessionLoaderGenerator session_loader_generator;
+    std::shared_ptr<ThreadPool> thread_pool_; ///< Worker threads reused by all the workflows, shared by the copies of the handler
+    std::shared_ptr<ProcessorProfiler> processor_profiler_; ///< Measurements of the processors run by the workflows, shared by the copies of the handler
+    std::shared_ptr<DataPreparationPool> data_preparation_pool_; ///< Worker threads the views prepare their data on, shared by the copies of the handler
+    RawDataResidency::Options raw_data_residency_options_; ///< Memory budget of the raw MS data while the workflows run
 
   protected:
     std::map<std::string, bool> saved_files_;
@@ -0,0 +1,235 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <SmartPeak/core/ThreadPool.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+
+namespace SmartPeak
+{
+  /**
+    Worker threads the data displayed by the views (plots, tables) are prepared on.
+
+    The preparations read the sequence while the UI thread keeps drawing: the sequence must
+    only be replaced or modified while holding lockData(), which waits for the running
+    preparations and defers the next ones.
+  */
+  class DataPreparationPool
+  {
+  public:
+    /**
+      @param[in] capacity maximum number of worker threads.
+    */
+    explicit DataPreparationPool(size_t capacity = 2);
+
+    DataPreparationPool(const DataPreparationPool&) = delete;
+    DataPreparationPool& operator=(const DataPreparationPool&) = delete;
+
+    ThreadPool& getThreadPool() { return thread_pool_; }
+
+    /**
+      @brief Exclusive lock on the data read by the preparations, to hold while modifying them.
+    */
+    std::unique_lock<std::shared_mutex> lockData();
+
+    /**
+      @brief Runs a preparation task on the calling thread, holding the data shared.
+      @return false if the task has thrown, the error being logged.
+    */
+    bool runTask(const std::function<void()>& task);
+
+  protected:
+    ThreadPool thread_pool_;
+    std::shared_mutex data_mutex_;
+  };
+
+  /**
+    Prepares the data of a view on a DataPreparationPool, double buffered.
+
+    The UI thread submits the request of the data to display, as a task filling a Result.
+    Only the last request is computed: a request submitted while another one is running
+    replaces the pending one, and the result of a request which has been superseded or cancelled
+    while it was running is dropped.
+
+    The worker fills the back buffer, the UI thread swaps it with its front buffer in publish()
+    once complete: the UI thread never waits for the computation and draws the last complete result
+    in the meantime. The task is given the buffer of an older result, that it has to reset.
+  */
+  template<typename Result>
+  class DataPreparation
+  {
+  public:
+    using Task = std::function<void(Result&)>;
+
+    explicit DataPreparation(DataPreparationPool& pool) : pool_(pool) {}
+
+    /**
+      @brief Cancels the pending request and waits for the running one.
+    */
+    ~DataPreparation();
+
+    DataPreparation(const DataPreparation&) = delete;
+    DataPreparation& operator=(const DataPreparation&) = delete;
+
+    /**
+      @brief Submits a request, superseding the previous ones.
+      @return the generation of the request, increasing with each request.
+    */
+    size_t submit(Task task);
+
+    /**
+      @brief Swaps front with the result of the last request, if it is complete.
+      @return true if front has been updated.
+    */
+    bool publish(Result& front);
+
+    /**
+      @brief Drops the pending request, the result of the running one is not published.
+    */
+    void cancel();
+
+    /**
+      @brief Waits until no request is running.
+      Must not be called while holding DataPreparationPool::lockData().
+    */
+    void wait();
+
+    /**
+      @brief true until the result of the last request is published, or the request is cancelled.
+    */
+    bool isPending() const;
+
+    /**
+      @brief Generation of the last published result, 0 if none.
+    */
+    size_t getGeneration() const;
+
+  protected:
+    void run();
+
+    DataPreparationPool& pool_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    Task pending_task_;
+    size_t request_generation_ = 0; ///< generation of the last submitted (or cancelled) request
+    size_t ready_generation_ = 0; ///< generation of the complete result in back_, 0 if none
+    size_t published_generation_ = 0;
+    bool running_ = false;
+    Result back_;
+  };
+
+  template<typename Result>
+  DataPreparation<Result>::~DataPreparation()
+  {
+    cancel();
+    wait();
+  }
+
+  template<typename Result>
+  size_t DataPreparation<Result>::submit(Task task)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_task_ = std::move(task);
+    ++request_generation_;
+    if (!running_)
+    {
+      running_ = true;
+      ThreadPool& thread_pool = pool_.getThreadPool();
+      thread_pool.reserve(thread_pool.capacity()); // the views prepare their data concurrently
+      thread_pool.submit([this]() { run(); });
+    }
+    return request_generation_;
+  }
+
+  template<typename Result>
+  bool DataPreparation<Result>::publish(Result& front)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ready_generation_ == 0)
+    {
+      return false;
+    }
+    // the worker does not write to back_ until it resets ready_generation_
+    std::swap(front, back_);
+    published_generation_ = ready_generation_;
+    ready_generation_ = 0;
+    return true;
+  }
+
+  template<typename Result>
+  void DataPreparation<Result>::cancel()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_task_ = nullptr;
+    ++request_generation_;
+    ready_generation_ = 0;
+  }
+
+  template<typename Result>
+  void DataPreparation<Result>::wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return !running_; });
+  }
+
+  template<typename Result>
+  bool DataPreparation<Result>::isPending() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ || ready_generation_ != 0;
+  }
+
+  template<typename Result>
+  size_t DataPreparation<Result>::getGeneration() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return published_generation_;
+  }
+
+  template<typename Result>
+  void DataPreparation<Result>::run()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (pending_task_)
+    {
+      Task task = std::move(pending_task_);
+      pending_task_ = nullptr;
+      const size_t generation = request_generation_;
+      ready_generation_ = 0;
+      lock.unlock();
+      const bool done = pool_.runTask([this, &task]() { task(back_); });
+      lock.lock();
+      if (done && generation == request_generation_)
+      {
+        ready_generation_ = generation;
+      }
+    }
+    running_ = false;
+    idle_cv_.notify_all();
+  }
+}
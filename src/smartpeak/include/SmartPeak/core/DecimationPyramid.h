@@ -0,0 +1,85 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    Multi-resolution min/max representation of a plot series, used to draw a series with about two points per pixel.
+
+    Level k of the pyramid splits the series in buckets of 2^k consecutive points and keeps the index of the lowest
+    and of the highest point of each bucket, so that the decimated series keeps every peak and valley at any zoom level.
+  */
+  class DecimationPyramid
+  {
+  public:
+    struct Extent
+    {
+      float x_min;
+      float x_max;
+      float y_min;
+      float y_max;
+    };
+
+    DecimationPyramid() = default;
+
+    /**
+      @param[in] x_data The x values, sorted in ascending order
+      @param[in] y_data The y values
+    */
+    DecimationPyramid(std::vector<float> x_data, std::vector<float> y_data);
+
+    size_t size() const { return x_data_.size(); }
+    size_t getNbLevels() const { return levels_.size() + 1; }
+
+    /**
+      @brief The [first, last) indices of the points whose x value is within [x_min, x_max]
+    */
+    std::pair<size_t, size_t> getIndexRange(float x_min, float x_max) const;
+
+    /**
+      @brief Decimates the points [first, last) to at most max_nb_points points (all points if 0),
+      keeping the lowest and highest point of each bucket in their x order.
+    */
+    void decimate(size_t first, size_t last, size_t max_nb_points, std::vector<float>& x_out, std::vector<float>& y_out) const;
+
+    /**
+      @brief The extent of the points [first, last), if any
+    */
+    std::optional<Extent> getExtent(size_t first, size_t last) const;
+
+  protected:
+    using Bucket = std::pair<uint32_t, uint32_t>; ///< indices of the lowest and of the highest point
+    Bucket getBucket(size_t level, size_t bucket, size_t first, size_t last) const;
+
+    std::vector<float> x_data_;
+    std::vector<float> y_data_;
+    std::vector<std::vector<Bucket>> levels_; ///< levels_[k - 1] holds the buckets of 2^k points
+  };
+}
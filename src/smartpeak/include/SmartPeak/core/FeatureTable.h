@@ -0,0 +1,123 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/FeatureMap.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    Columnar copy of the used features of a FeatureMap.
+
+    Each row is a used subordinate (or a used feature without subordinates),
+    identified by the interned ids of its component group name and component name.
+    Each requested meta value is stored as a contiguous column of floats, resolved with the
+    same rules as SequenceHandler::getMetaValue. Non float values are stored as NaN,
+    except "validation" which is encoded as 1 (TP), -1 (FP) or -2.
+
+    Strings are interned once for the whole process, so ids can be compared across tables
+    (and across injections) without string comparisons.
+  */
+  class FeatureTable
+  {
+  public:
+    using Id = uint32_t;
+
+    FeatureTable() = default;
+
+    /**
+      @param[in] feature_map features to copy. Features and subordinates with "used_" = false are skipped
+      @param[in] meta_values names of the meta values to extract as columns
+    */
+    FeatureTable(const OpenMS::FeatureMap& feature_map, const std::vector<std::string>& meta_values);
+
+    /**
+      @brief returns the id of the string, registering it if needed. Thread safe.
+    */
+    static Id intern(const std::string& str);
+
+    /**
+      @brief returns the string of an id returned by intern(). Thread safe.
+    */
+    static const std::string& getString(Id id);
+
+    size_t size() const { return component_group_ids_.size(); }
+    bool empty() const { return component_group_ids_.empty(); }
+
+    const std::vector<Id>& getComponentGroupIds() const { return component_group_ids_; }
+    /**
+      @brief component name ids; the id of "" for the features without subordinates
+    */
+    const std::vector<Id>& getComponentIds() const { return component_ids_; }
+    /**
+      @brief for each row, true if the row is a subordinate, false if it is a feature without subordinates
+    */
+    const std::vector<bool>& getIsSubordinate() const { return is_subordinate_; }
+
+    bool hasColumn(const std::string& meta_value) const;
+    /**
+      @brief returns the column of a meta value, or nullptr if it was not requested at construction
+    */
+    const std::vector<float>* getColumn(const std::string& meta_value) const;
+    const std::vector<std::string>& getMetaValues() const { return meta_values_; }
+
+  protected:
+    std::vector<Id> component_group_ids_;
+    std::vector<Id> component_ids_;
+    std::vector<bool> is_subordinate_;
+    std::vector<std::string> meta_values_;
+    std::vector<std::vector<float>> columns_;
+  };
+
+  /**
+    Keeps the last FeatureTable built from a FeatureMap, to be reset each time the FeatureMap changes.
+
+    A copy shares the table of the original (tables are immutable).
+  */
+  class FeatureTableCache
+  {
+  public:
+    FeatureTableCache() = default;
+    FeatureTableCache(const FeatureTableCache& other);
+    FeatureTableCache& operator=(const FeatureTableCache& other);
+
+    /**
+      @brief returns the cached table if it contains all the requested meta values,
+      otherwise builds (and caches) a new table with the previous and the requested meta values.
+    */
+    std::shared_ptr<const FeatureTable> get(const OpenMS::FeatureMap& feature_map, const std::vector<std::string>& meta_values) const;
+
+    void reset();
+
+  protected:
+    mutable std::mutex mutex_;
+    mutable std::shared_ptr<const FeatureTable> table_;
+  };
+}
@@ -48,8 +48,27 @@ public:
     const RawDataHandler& getRawData() const;
     std::shared_ptr<RawDataHandler>& getRawDataShared();
 
+    /**
+      @brief Returns a copy of the injection sharing its raw data with this one.
+
+      The raw data handler of the snapshot is copied the first time it is accessed for modification
+      (non const getRawData() or getRawDataShared()), the raw data of this injection is left untouched.
+      The copy still shares the MS data and feature maps, which are only copied once modified.
+    */
+    InjectionHandler snapshot() const;
+
+    /**
+      @brief Copies the raw data still shared with the injection this one is a snapshot of.
+
+      Not thread safe: called for all the injections before they are accessed from several threads
+      (see SequenceHandler::detachRawData), the non const accessors then no longer modify the injection.
+    */
+    void detachRawData();
+
 private:
+
     std::shared_ptr<MetaDataHandler> meta_data_ = nullptr;
     std::shared_ptr<RawDataHandler> raw_data_ = nullptr;
+    bool raw_data_copy_on_write_ = false;  ///< raw_data_ may still be shared with the injection this one is a snapshot of
   };
 }
@@ -0,0 +1,99 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <unsupported/Eigen/CXX11/Tensor>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    Selection of the names of an explorer (sample names, transitions, feature meta values...).
+
+    The names of the rows are interned, rows with the same name (e.g. the transitions of a component group)
+    sharing the same id, and the selected names are kept as a dense bitset over the ids.
+    A name is selected if any of its rows is checked: the number of checked rows of each name is kept,
+    so that checking or unchecking a row is done in constant time.
+  */
+  class NameSelection
+  {
+  public:
+    /**
+      @brief Interns the names of a column of a table, ids are given in the order of first appearance.
+      Empty names are not interned. No name is selected.
+
+      @param[in] table The table, a missing column gives no names
+      @param[in] column The column holding the names
+    */
+    void setNames(const Eigen::Tensor<std::string, 2>& table, int column);
+
+    /**
+      @brief Selects the names of the checked rows, only the rows whose checkbox has changed are updated
+
+      @param[in] checkbox_body The checkboxes of the explorer, one row per row of the names table
+      @param[in] column The checkbox column
+      @returns true if the selection has changed
+    */
+    bool setChecked(const Eigen::Tensor<bool, 2>& checkbox_body, int column);
+
+    size_t getNbRows() const { return row_ids_.size(); }
+    size_t getNbNames() const { return names_.size(); }
+    const std::string& getName(size_t id) const { return names_.at(id); }
+    std::optional<size_t> getId(const std::string& name) const;
+
+    bool isSelected(size_t id) const { return (bits_[id / 64] >> (id % 64)) & 1; }
+    bool isSelected(const std::string& name) const;
+    size_t getNbSelected() const;
+
+    /**
+      @brief The selected names, in the order of their first row
+    */
+    std::vector<std::string> getSelectedNames() const;
+
+    /**
+      @brief Incremented each time the names or the selection change
+    */
+    size_t getVersion() const { return version_; }
+
+  protected:
+    static constexpr size_t no_id = static_cast<size_t>(-1);
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, size_t> ids_;
+    /**
+      @brief Updates the checked rows count of the name of the row, returns true if its selection has changed
+    */
+    bool updateRow(size_t row, bool checked);
+
+    std::vector<size_t> row_ids_; ///< id of the name of each row, no_id for empty names
+    std::vector<bool> checked_rows_; ///< checkbox of each row
+    std::vector<size_t> nb_checked_rows_; ///< number of checked rows of each name, by id
+    std::vector<uint64_t> bits_;
+    size_t version_ = 0;
+  };
+}
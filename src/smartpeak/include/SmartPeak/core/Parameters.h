@@ -26,7 +26,10 @@
 
 #include <SmartPeak/core/CastValue.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <memory>
@@ -223,6 +226,7 @@ namespace SmartPeak
 
   protected:
     friend class Utilities;
+    friend class ParameterSetView;
     const CastValue& getValue() const { return value_; };
 
   private:
@@ -340,6 +344,8 @@ namespace SmartPeak
     std::vector<Parameter> parameters_;
   };
 
+  class ParameterSetView;
+
   class ParameterSet
   {
   public:
@@ -348,6 +354,13 @@ namespace SmartPeak
     */
     ParameterSet() = default;
     /**
+    @brief copy and move, the cached views are not transfered
+    */
+    ParameterSet(const ParameterSet& other) : function_parameters_(other.function_parameters_) {};
+    ParameterSet(ParameterSet&& other) : function_parameters_(std::move(other.function_parameters_)) {};
+    ParameterSet& operator=(const ParameterSet& other);
+    ParameterSet& operator=(ParameterSet&& other);
+    /**
     @brief construct from from map/vector/map structure
     */
     ParameterSet(const std::map<std::string, std::vector<std::map<std::string, std::string>>>& functions_map);
@@ -399,21 +412,83 @@ namespace SmartPeak
     bool operator==(const ParameterSet& other) const;
     inline bool operator!=(const ParameterSet& other) const { return !operator==(other); };
 
+    /**
+    @brief Returns this ParameterSet completed with a schema, with the values resolved and indexed.
+
+    The view is built on the first call for a given key, then kept until this ParameterSet is modified
+    (any non const accessor drops the views). Processors called on each injection with the same
+    parameters therefore complete and resolve them once.
+
+    @param[in] key identifies the schema, typically the name of the processor
+    @param[in] make_schema builds the schema, only called if the view is not cached
+    */
+    std::shared_ptr<const ParameterSetView> getView(const std::string& key, const std::function<ParameterSet()>& make_schema) const;
+
     // underlying map accessors
     void clear();
-    FunctionParameters& at(const std::string& function_name) { return function_parameters_.at(function_name); };
+    FunctionParameters& at(const std::string& function_name) { invalidateViews(); return function_parameters_.at(function_name); };
     const FunctionParameters& at(const std::string& function_name) const { return function_parameters_.at(function_name); };
     size_t count(const std::string& function_name) const { return function_parameters_.count(function_name); };
     bool empty() const { return function_parameters_.empty(); };
     size_t size() const { return function_parameters_.size(); };
-    FunctionParameters& operator[](const std::string& function_name) { return function_parameters_[function_name]; };
-    std::map<std::string, FunctionParameters>::iterator begin() { return function_parameters_.begin(); };
-    std::map<std::string, FunctionParameters>::iterator end() { return function_parameters_.end(); };
+    FunctionParameters& operator[](const std::string& function_name) { invalidateViews(); return function_parameters_[function_name]; };
+    std::map<std::string, FunctionParameters>::iterator begin() { invalidateViews(); return function_parameters_.begin(); };
+    std::map<std::string, FunctionParameters>::iterator end() { invalidateViews(); return function_parameters_.end(); };
     std::map<std::string, FunctionParameters>::const_iterator begin() const { return function_parameters_.begin(); };
     std::map<std::string, FunctionParameters>::const_iterator end() const { return function_parameters_.end(); };
 
   protected:
+    void invalidateViews();
+
     std::map<std::string, FunctionParameters> function_parameters_;
+    mutable std::mutex views_mutex_;
+    mutable std::map<std::string, std::shared_ptr<const ParameterSetView>> views_;
+  };
+
+  /**
+    Read-only ParameterSet completed with a schema (see ParameterSet::getView).
+
+    Parameters are indexed by function and parameter name. The value of a parameter is the user value,
+    or the schema value when the user did not set it. Values not matching the schema constraints
+    are reported once, when the view is built.
+  */
+  class ParameterSetView
+  {
+  public:
+    ParameterSetView(const ParameterSet& user_parameters, const ParameterSet& schema);
+
+    ParameterSetView(const ParameterSetView&) = delete;
+    ParameterSetView& operator=(const ParameterSetView&) = delete;
+
+    /**
+    @brief the user parameters merged with the schema
+    */
+    const ParameterSet& getParameterSet() const { return parameters_; };
+
+    const Parameter* findParameter(const std::string& function_name, const std::string& parameter_name) const;
+
+    /**
+    @brief returns the resolved value of a parameter, nullptr if the parameter does not exist
+    */
+    const CastValue* findValue(const std::string& function_name, const std::string& parameter_name) const;
+
+    /**
+    @brief returns the resolved values of the parameters of a function (empty if the function does not exist)
+    */
+    const std::unordered_map<std::string, CastValue>& getValues(const std::string& function_name) const;
+
+    /**
+    @brief typed accessors, return default_value if the parameter does not exist or cannot be converted
+    */
+    bool getValue(const std::string& function_name, const std::string& parameter_name, bool default_value) const;
+    int getValue(const std::string& function_name, const std::string& parameter_name, int default_value) const;
+    float getValue(const std::string& function_name, const std::string& parameter_name, float default_value) const;
+    std::string getValue(const std::string& function_name, const std::string& parameter_name, const std::string& default_value) const;
+
+  protected:
+    ParameterSet parameters_;
+    std::unordered_map<std::string, std::unordered_map<std::string, const Parameter*>> index_;
+    std::unordered_map<std::string, std::unordered_map<std::string, CastValue>> values_;
   };
   
 }
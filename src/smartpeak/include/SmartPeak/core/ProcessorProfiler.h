@@ -0,0 +1,125 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <SmartPeak/iface/IProcessorProfileObserver.h>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    Collects the ProcessorProfileRecord sent by the workflows and aggregates them per processor.
+
+    Memory figures are the resident set size of the process (no allocator hook), they are
+    meaningful for the processors that run alone but are shared between the concurrent ones.
+  */
+  class ProcessorProfiler : public IProcessorProfileObserver
+  {
+  public:
+    /**
+      Distribution of one measurement over the runs of a processor
+    */
+    struct Distribution
+    {
+      double total = 0.0;
+      double mean = 0.0;
+      double p50 = 0.0;
+      double p90 = 0.0;
+      double p99 = 0.0;
+      double max = 0.0;
+    };
+
+    struct Summary
+    {
+      std::string processor_name;
+      size_t count = 0;
+      Distribution wall_time_ms;
+      Distribution cpu_time_ms;
+      long max_rss_delta_kb = 0;
+      long peak_rss_kb = 0;
+      size_t total_item_count = 0;
+    };
+
+    /**
+      State of the calling thread when a processor starts, see makeRecord
+    */
+    struct Snapshot
+    {
+      std::chrono::steady_clock::time_point wall_time;
+      double cpu_time_ms = 0.0;
+      long rss_kb = 0;
+    };
+
+    /**
+      IProcessorProfileObserver
+    */
+    void onProcessorProfile(const ProcessorProfileRecord& record) override;
+
+    std::vector<ProcessorProfileRecord> getRecords() const;
+
+    /**
+      @brief Per processor statistics, sorted by decreasing total wall time
+    */
+    std::vector<Summary> getSummaries() const;
+
+    size_t size() const;
+    void clear();
+
+    /**
+      @brief The records and the summaries as a JSON document
+    */
+    std::string toJSON() const;
+    bool writeJSON(const std::filesystem::path& pathname) const;
+
+    static Snapshot takeSnapshot();
+    static ProcessorProfileRecord makeRecord(
+      const Snapshot& start,
+      const std::string& processor_name,
+      const std::string& item_name,
+      ProcessorProfileRecord::ItemType item_type,
+      size_t item_count);
+
+    /**
+      @brief Nearest-rank percentile of sorted values, p in [0, 100]
+    */
+    static double percentile(const std::vector<double>& sorted_values, double p);
+    static std::string itemTypeToString(ProcessorProfileRecord::ItemType item_type);
+
+    static double getThreadCPUTimeMs();
+    /**
+      @brief CPU time of all the threads of the process
+    */
+    static double getProcessCPUTimeMs();
+    static long getCurrentRSSKb();
+    static long getPeakRSSKb();
+
+  protected:
+    mutable std::mutex records_mutex_;
+    std::vector<ProcessorProfileRecord> records_;
+  };
+}
@@ -151,6 +151,7 @@ namespace SmartPeak
     const std::vector<std::string>& errors() const { return errors_; };
 
   private:
+    void startRunningBatch(const size_t nb_items);
     void onRunningBatchEndItem(const std::string& item_name);
 
   protected:
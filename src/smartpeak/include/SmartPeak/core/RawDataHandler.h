@@ -33,9 +33,17 @@
 
 #include <SmartPeak/core/MetaDataHandler.h>
 #include <SmartPeak/core/CastValue.h>
+#include <SmartPeak/core/FeatureTable.h>
 #include <SmartPeak/core/Parameters.h>
+#include <SmartPeak/core/SpectraLibraryIndex.h>
 
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace SmartPeak
@@ -46,10 +54,28 @@ namespace SmartPeak
 public:
     RawDataHandler(); ///< constructor required to initialize shared_ptr members
 
+    /**
+      The raw MS data members, see spillMSData
+    */
+    enum class MSDataType
+    {
+      Experiment,
+      ChromatogramMap,
+      SWATH
+    };
+
     void setFeatureMap(const OpenMS::FeatureMap& feature_map);
     OpenMS::FeatureMap& getFeatureMap();
     const OpenMS::FeatureMap& getFeatureMap() const;
 
+    /**
+    @brief Identifies the state of the feature map: the version changes each time the feature map may have been modified
+      (set, accessed through the non-const getter, made from the history or cleared).
+
+      Versions are unique among all the raw data handlers, a copy of a raw data handler keeps the version of the original.
+    */
+    uint64_t getFeatureMapVersion() const;
+
     void setFeatureMap(const std::string& name, const OpenMS::FeatureMap& feature_map);
     OpenMS::FeatureMap& getFeatureMap(const std::string& name);
     const OpenMS::FeatureMap& getFeatureMap(const std::string& name) const;
@@ -138,10 +164,39 @@ public:
     const OpenMS::MSExperiment& getSpectraLibrary() const;
     std::shared_ptr<OpenMS::MSExperiment>& getSpectraLibraryShared();
 
+    /**
+    @brief The index of the spectra library: the loaded library and its binned spectra, shared between all raw data handlers in the sequence.
+      Accessing the library through the non-const getter clears the index.
+    */
+    void setSpectraLibraryIndex(std::shared_ptr<SpectraLibraryIndex>& spectra_library_index);
+    SpectraLibraryIndex& getSpectraLibraryIndex() const;
+    std::shared_ptr<SpectraLibraryIndex>& getSpectraLibraryIndexShared();
+
     void setFeatureMapHistory(const OpenMS::FeatureMap& feature_map_history);
     OpenMS::FeatureMap& getFeatureMapHistory();
     const OpenMS::FeatureMap& getFeatureMapHistory() const;
 
+    /**
+    @brief Defer the loading of the feature map history until the feature maps are first accessed.
+
+      On first access, the loader fills the feature map history, the feature map is made from the history
+      and the primary MS run path of the history is copied to the feature map.
+      `clear` and `clearNonSharedData` discard a loader that has not been called yet.
+    */
+    void setFeatureMapHistoryLoader(const std::function<void(OpenMS::FeatureMap&)>& loader);
+
+    /**
+    @brief Returns true if the feature maps are waiting to be loaded by the feature map history loader.
+    */
+    bool isFeatureMapHistoryLoadPending() const;
+
+    /**
+    @brief Columnar copy of the used features of the feature map history, with the float values of the given meta values.
+
+      The table is built on the first request and kept until the feature map history is modified.
+    */
+    std::shared_ptr<const FeatureTable> getFeatureTable(const std::vector<std::string>& meta_values) const;
+
     void setExperiment(const OpenMS::MSExperiment& experiment);
     OpenMS::MSExperiment& getExperiment();
     const OpenMS::MSExperiment& getExperiment() const;
@@ -166,6 +221,37 @@ public:
     OpenMS::MzTab& getMzTab();
     const OpenMS::MzTab& getMzTab() const;
 
+    /**
+    @brief Release the memory of the experiment, the chromatogram map or the SWATH data.
+
+      If `pathname` is not empty, the data are written to this mzML file first (with 64 bit m/z and intensities,
+      so that they are loaded back unchanged) and are loaded back on first access
+      (the file is removed once loaded back, or when the last copy of the handler is destroyed).
+      Otherwise the data are dropped.
+
+    @param[in] type The MS data to release
+    @param[in] pathname The mzML file to write, or empty to drop the data
+    @param[in] spill_dir Kept alive as long as the file exists, e.g. to remove its directory with the last spilled file
+
+    @return the estimated number of bytes released
+    */
+    size_t spillMSData(MSDataType type, const std::filesystem::path& pathname, const std::shared_ptr<const void>& spill_dir = nullptr);
+
+    /**
+    @brief Returns false if the data have been spilled and are waiting to be loaded back.
+    */
+    bool isMSDataResident(MSDataType type) const;
+
+    /**
+    @brief Estimated memory used by the resident data, 0 if spilled.
+    */
+    size_t getMSDataMemoryUsage(MSDataType type) const;
+
+    /**
+    @brief Number of spectra and chromatograms of the resident data, 0 if spilled (the data are not loaded back).
+    */
+    size_t getMSDataSize(MSDataType type) const;
+
     void clear();
     void clearNonSharedData();
 
@@ -187,15 +273,106 @@ public:
     void makeFeatureMapFromHistory();
 
 private:
+    /**
+    @brief Calls the pending feature map history loader, if any.
+    */
+    void loadFeatureMaps() const;
+
+    static void makeFeatureMapFromHistory(OpenMS::FeatureMap& feature_map_history, OpenMS::FeatureMap& feature_map);
+
+    /**
+    @brief Payload shared between the copies of a RawDataHandler until one of them modifies it.
+
+    get() reads the shared value; getMutable() first copies it when another handler still refers to it,
+    so that copying a RawDataHandler (see InjectionHandler::snapshot) does not copy its MS data and feature maps.
+    */
+    template<typename T>
+    class CopyOnWrite
+    {
+    public:
+      CopyOnWrite() : value_(std::make_shared<T>()) {}
+      CopyOnWrite& operator=(const T& value)
+      {
+        value_ = std::make_shared<T>(value);
+        return *this;
+      }
+      const T& get() const { return *value_; }
+      T& getMutable()
+      {
+        if (value_.use_count() > 1)
+        {
+          value_ = std::make_shared<T>(*value_);
+        }
+        return *value_;
+      }
+      /**
+      @brief Replaces the value by an empty one; the value still referred to by other handlers is left untouched.
+      */
+      void reset() { value_ = std::make_shared<T>(); }
+    private:
+      std::shared_ptr<T> value_;
+    };
+    using FeatureMapPayload = CopyOnWrite<OpenMS::FeatureMap>;
+    using MSDataPayload = CopyOnWrite<OpenMS::MSExperiment>;
+
+    template<typename T>
+    class DeferredLoader
+    {
+    public:
+      DeferredLoader() = default;
+      DeferredLoader(const DeferredLoader& other)
+      {
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        pending_ = other.pending_.load();
+        load_ = other.load_;
+      }
+      DeferredLoader& operator=(const DeferredLoader& other)
+      {
+        if (this != &other)
+        {
+          bool pending;
+          std::function<void(T&)> load;
+          {
+            std::lock_guard<std::mutex> lock(other.mutex_);
+            pending = other.pending_;
+            load = other.load_;
+          }
+          std::lock_guard<std::mutex> lock(mutex_);
+          pending_ = pending;
+          load_ = load;
+        }
+        return *this;
+      }
+
+      mutable std::mutex mutex_;
+      std::atomic_bool pending_{ false };
+      std::function<void(T&)> load_;
+    };
+    using FeatureMapLoader = DeferredLoader<OpenMS::FeatureMap>;
+    using MSDataLoader = DeferredLoader<OpenMS::MSExperiment>;
+
+    /**
+    @brief Calls the pending loader of the spilled data, if any.
+    */
+    void loadMSData(MSDataPayload& data, MSDataLoader& loader) const;
+    void discardMSDataLoader(MSDataLoader& loader);
+    std::pair<MSDataPayload*, MSDataLoader*> getMSData(MSDataType type) const;
+
     // input
-    OpenMS::MSExperiment experiment_;  ///< Raw MS data derived from the mzML file
-    OpenMS::MSExperiment chromatogram_map_;  ///< MS data annotated with transition information derived from the TraML file
+    mutable MSDataPayload experiment_;  ///< Raw MS data derived from the mzML file; loaded on first access when spilled
+    mutable MSDataPayload chromatogram_map_;  ///< MS data annotated with transition information derived from the TraML file; loaded on first access when spilled
     OpenMS::TransformationDescription trafo_;  ///< Mapping of retention time values; currently not used (maybe shared between all raw data handlers)
-    OpenMS::MSExperiment swath_;
+    mutable MSDataPayload swath_;  ///< loaded on first access when spilled
+    mutable MSDataLoader experiment_loader_; ///< Deferred loading of experiment_, see spillMSData
+    mutable MSDataLoader chromatogram_map_loader_; ///< Deferred loading of chromatogram_map_, see spillMSData
+    mutable MSDataLoader swath_loader_; ///< Deferred loading of swath_, see spillMSData
 
     // output
-    OpenMS::FeatureMap feature_map_; ///< The most recently generated set of features for the experiment
-    OpenMS::FeatureMap feature_map_history_; ///< A record of all changes that have occured to the features in the experiment
+    mutable FeatureMapPayload feature_map_; ///< The most recently generated set of features for the experiment; loaded on first access when a loader is pending
+    mutable FeatureMapPayload feature_map_history_; ///< A record of all changes that have occured to the features in the experiment; loaded on first access when a loader is pending
+    mutable FeatureMapLoader feature_map_loader_; ///< Deferred loading of feature_map_history_
+    uint64_t feature_map_version_ = 0; ///< See getFeatureMapVersion
+    FeatureTableCache feature_table_; ///< Columnar copy of feature_map_history_, reset when the history is modified
     std::shared_ptr<MetaDataHandler> meta_data_;  ///< sample meta data; shared between the injection handler and the raw data handler
     std::map<std::string, float> validation_metrics_;
     OpenMS::MzTab mz_tab_;
@@ -215,5 +392,6 @@ private:
     std::shared_ptr<OpenMS::MRMFeatureQC> feature_rsd_estimations_ = nullptr;  ///< Percent RSD estimations; shared between all raw data handlers in the sequence segment
     std::shared_ptr<OpenMS::MRMFeatureQC> feature_background_estimations_ = nullptr;  ///< Background interference estimations; shared between all raw data handlers in the sequence segment
     std::shared_ptr<OpenMS::MSExperiment> spectra_library_;  ///< MS data derived from a (spectral) database used for annotation; shared between all raw data handlers in the sequence
+    std::shared_ptr<SpectraLibraryIndex> spectra_library_index_;  ///< Loaded library and binned spectra used for matching; shared between all raw data handlers in the sequence
   };
 }
@@ -25,6 +25,7 @@
 
 #include <SmartPeak/core/RawDataProcessor.h>
 
+#include <filesystem>
 #include <map>
 #include <vector>
 #include <regex>
@@ -52,6 +53,10 @@ namespace SmartPeak
 
     /* IFilenamesHandler */
     virtual void getFilenames(Filenames& filenames) const override;
+
+    /** Path of the binary feature cache (see FeatureMapBinaryFile) stored next to a featureXML file.
+    */
+    static std::filesystem::path getBinaryCachePath(const std::filesystem::path& featurexml_path);
   };
 
 }
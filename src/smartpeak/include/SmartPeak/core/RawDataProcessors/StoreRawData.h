@@ -39,6 +39,8 @@ namespace SmartPeak
     /* IProcessorDescription */
     virtual std::string getName() const override { return "STORE_RAW_DATA"; }
     virtual std::string getDescription() const override { return "Store the processed raw data mzML file to disk."; }
+    virtual std::set<std::string> getOutputs() const override;
+    virtual std::set<std::string> getInputs() const override;
 
     /** Store the processed raw data mzML file to disk.
     */
@@ -0,0 +1,131 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <SmartPeak/core/RawDataHandler.h>
+#include <SmartPeak/core/RawDataProcessor.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    Keeps the raw MS data (experiment, chromatogram map and SWATH) of the injections of a workflow
+    within a memory budget.
+
+    Workers acquire the raw data of an injection before processing it and release it afterwards with the
+    raw MS data the next steps of the workflow need (see getRequiredMSData). On release:
+    - the raw MS data that no next step needs are spilled to disk (or dropped, see Options::spill_to_disk),
+    - if the resident raw MS data exceed the budget, the least recently released injections are spilled.
+
+    Spilled data are loaded back transparently by the RawDataHandler getters, when a next step or a plot needs them.
+    Raw data being processed are never spilled, so the resident memory is driven by the number of threads
+    rather than by the number of injections.
+  */
+  class RawDataResidency
+  {
+  public:
+    enum MSData : unsigned
+    {
+      NoMSData = 0,
+      ExperimentData = 1 << 0,
+      ChromatogramMapData = 1 << 1,
+      SWATHData = 1 << 2,
+      AllMSData = ExperimentData | ChromatogramMapData | SWATHData
+    };
+
+    struct Options
+    {
+      size_t memory_budget_mb = 0; ///< resident raw MS data above which injections are spilled, 0 disables the residency management
+      bool spill_to_disk = true; ///< if false, the raw MS data no next step needs are dropped instead of spilled, and the budget is not enforced
+      std::filesystem::path spill_dir; ///< where the spilled data are written, the temporary directory if empty
+    };
+
+    explicit RawDataResidency(const Options& options);
+    ~RawDataResidency();
+    RawDataResidency(const RawDataResidency&) = delete;
+    RawDataResidency& operator=(const RawDataResidency&) = delete;
+
+    bool isEnabled() const { return options_.memory_budget_mb > 0; }
+
+    /**
+      @brief The raw MS data read by processors declaring these inputs (see IProcessorDescription::getInputs)
+    */
+    static unsigned getRequiredMSData(const std::set<std::string>& inputs);
+    static unsigned getRequiredMSData(const std::vector<std::shared_ptr<RawDataProcessor>>& methods);
+
+    /**
+      @brief Marks the raw data as being processed, waiting for it to be spilled if it is being spilled.
+    */
+    void acquire(RawDataHandler& raw_data);
+
+    /**
+      @brief Marks the raw data as processed, and releases the raw MS data according to the budget.
+
+      @param[in,out] raw_data The raw data processed
+      @param[in] name Name of the injection, used to name the spilled files
+      @param[in] needed_ms_data The raw MS data (MSData flags) the next steps of the workflow will read
+    */
+    void release(RawDataHandler& raw_data, const std::string& name, unsigned needed_ms_data);
+
+    size_t getResidentBytes() const;
+    size_t getPeakResidentBytes() const; ///< highest resident raw MS data seen on release
+    size_t getSpilledBytes() const;
+
+  protected:
+    struct Entry
+    {
+      std::string name;
+      size_t bytes = 0;
+      unsigned pins = 0;
+      bool evicting = false;
+      bool in_lru = false;
+      std::list<RawDataHandler*>::iterator lru_position;
+    };
+
+    size_t releaseMSData(RawDataHandler& raw_data, const std::string& name, unsigned ms_data, bool spill);
+    std::filesystem::path makeSpillPathname(const std::string& name, RawDataHandler::MSDataType type);
+    static size_t getMemoryUsage(const RawDataHandler& raw_data);
+
+    Options options_;
+    std::shared_ptr<const std::filesystem::path> spill_dir_; ///< removed with its content once the residency and all the spilled files are gone
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<const RawDataHandler*, Entry> entries_;
+    std::list<RawDataHandler*> lru_; ///< resident raw data not being processed, least recently released first
+    size_t resident_bytes_ = 0;
+    size_t peak_resident_bytes_ = 0;
+    size_t spilled_bytes_ = 0;
+    std::atomic_size_t spill_counter_ { 0 };
+  };
+}
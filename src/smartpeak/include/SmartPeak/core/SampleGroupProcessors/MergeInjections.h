@@ -53,39 +53,73 @@ namespace SmartPeak
     typedef std::tuple<std::string, std::pair<float, float>, float> mergeKeyType;
     typedef std::pair<std::string, std::string> componentKeyType;
 
+    /**
+      Sets of injections to merge. Injections are identified by their position in the sample group,
+      and sets by their position in `sets`: the first sets are the single injections, in the same order.
+    */
+    struct InjectionSets
+    {
+      size_t add(const std::set<size_t>& injections);
+      std::vector<std::set<size_t>> sets;
+      std::map<std::set<size_t>, size_t> indices;
+    };
+
+    /**
+      Value of each feature of each component for each set of injections.
+
+      Values are stored as [feature][injection set][component],
+      so that the merge rules run over contiguous arrays of components.
+    */
+    struct ComponentValues
+    {
+      void resize(size_t nb_injection_sets);
+      size_t offset(size_t feature, size_t injection_set) const { return (feature * nb_injection_sets_ + injection_set) * components.size(); }
+
+      std::vector<componentKeyType> components; ///< sorted, the merged features are made in this order
+      std::vector<std::string> features; ///< sorted feature names
+      std::vector<char> is_integer; ///< for each feature, true if its values were read from integer meta values
+      std::vector<float> values;
+      std::vector<char> has_values;
+
+    private:
+      size_t nb_injection_sets_ = 0;
+    };
+
     static bool selectDilutions(
       const ParameterSet& params,
       const Filenames& filenames_I,
-      const SequenceHandler& sequenceHandler_I,
-      std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values);
+      const std::vector<const InjectionHandler*>& injections,
+      ComponentValues& component_values);
 
-    static void getMergeKeysToInjections(const SampleGroupHandler& sampleGroupHandler_IO,
-      const SequenceHandler& sequenceHandler_I, 
+    static void getMergeKeysToInjections(const std::vector<const InjectionHandler*>& injections,
       std::set<std::string>& scan_polarities,
       std::set<std::pair<float, float>>& scan_mass_ranges,
       std::set<float>& dilution_factors,
-      std::map<mergeKeyType, std::vector<std::set<std::string>>>& merge_keys_to_injection_name);
+      InjectionSets& injection_sets,
+      std::map<mergeKeyType, std::vector<size_t>>& merge_keys_to_injection_sets);
 
     static void orderMergeKeysToInjections(std::set<std::string>& scan_polarities,
       const std::set<std::pair<float, float>>& scan_mass_ranges,
       const std::set<float>& dilution_factors,
-      std::map<mergeKeyType, std::vector<std::set<std::string>>>& merge_keys_to_injection_name);
+      InjectionSets& injection_sets,
+      std::map<mergeKeyType, std::vector<size_t>>& merge_keys_to_injection_sets);
 
-    static void getComponentsToFeaturesToInjectionsToValues(const SampleGroupHandler& sampleGroupHandler_IO,
-      const SequenceHandler& sequenceHandler_I,
+    static void getComponentsToFeaturesToInjectionsToValues(const std::vector<const InjectionHandler*>& injections,
       const bool& merge_subordinates,
-      std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values);
+      const size_t nb_injection_sets,
+      ComponentValues& component_values);
 
     static void mergeComponentsToFeaturesToInjectionsToValues(const std::string& feature_name, const std::string& merge_rule,
       const std::set<std::string>& scan_polarities,
       const std::set<std::pair<float, float>>& scan_mass_ranges,
       const std::set<float>& dilution_factors,
-      const std::map<mergeKeyType, std::vector<std::set<std::string>>>& merge_keys_to_injection_name,
-      std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values);
+      const InjectionSets& injection_sets,
+      const std::map<mergeKeyType, std::vector<size_t>>& merge_keys_to_injection_sets,
+      ComponentValues& component_values);
 
     static void makeFeatureMap(const bool& merge_subordinates,
-      std::set<std::string>& injection_names_set,
-      const std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values,
+      const InjectionSets& injection_sets,
+      const ComponentValues& component_values,
       OpenMS::FeatureMap& feature_map);
   };
 
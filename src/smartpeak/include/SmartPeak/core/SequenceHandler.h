@@ -36,6 +36,11 @@
 #include <SmartPeak/core/SequenceSegmentHandler.h>
 #include <SmartPeak/core/CastValue.h>
 
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
 namespace SmartPeak
 {
   class SequenceHandler : 
@@ -75,6 +80,33 @@ public:
       const std::set<std::string>& injection_names
     ) const;
 
+    /**
+      @brief Returns the position of the injection, sequence segment or sample group with the given name,
+        std::nullopt if there is none. The first one is returned when several have the same name.
+
+      The lookups are hash-indexed. The indices are kept up to date by addSampleToSequence and
+      rebuilt on the next lookup after the containers are set or accessed through the non-const getters.
+    */
+    std::optional<size_t> findInjectionIndex(const std::string& injection_name) const;
+    std::optional<size_t> findSequenceSegmentIndex(const std::string& sequence_segment_name) const;
+    std::optional<size_t> findSampleGroupIndex(const std::string& sample_group_name) const;
+
+    /**
+      @brief Returns a copy of the sequence whose injections share their raw data with this sequence.
+
+      Making the snapshot only copies pointers; the raw data of an injection is copied
+      when it is modified in the snapshot (see InjectionHandler::snapshot).
+    */
+    SequenceHandler snapshot() const;
+
+    /**
+      @brief Copies the raw data the injections still share with the sequence this one is a snapshot of.
+
+      To be called before the workers start: they access the raw data of the same injections
+      (e.g. the first one, for the targeted experiment) from several threads.
+    */
+    void detachRawData();
+
     static CastValue getMetaValue(
       const OpenMS::Feature& feature,
       const OpenMS::Feature& subordinate,
@@ -88,9 +120,50 @@ public:
     std::string getFilteredSelectedPeaksInfo() const;
 
 private:
+    /**
+      @brief Name to position index, built lazily from a container.
+    */
+    class NameIndex
+    {
+    public:
+      NameIndex() = default;
+      NameIndex(const NameIndex&) {} ///< copies are rebuilt on first lookup
+      NameIndex& operator=(const NameIndex&) { invalidate(); return *this; }
+
+      void invalidate();
+      /// records the position of the element appended to the container, if the index is up to date
+      void add(const std::string& name, size_t index);
+      template<typename Container, typename GetName>
+      std::optional<size_t> find(const std::string& name, const Container& container, GetName get_name) const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!valid_)
+        {
+          indices_.clear();
+          indices_.reserve(container.size());
+          for (size_t i = 0; i < container.size(); ++i)
+          {
+            indices_.emplace(get_name(container[i]), i);
+          }
+          valid_ = true;
+        }
+        const auto it = indices_.find(name);
+        if (it == indices_.end()) return std::nullopt;
+        return it->second;
+      }
+
+    private:
+      mutable std::mutex mutex_;
+      mutable std::unordered_map<std::string, size_t> indices_;
+      mutable bool valid_ = false;
+    };
+
     std::vector<InjectionHandler> sequence_;
     std::vector<SequenceSegmentHandler> sequence_segments_;
     std::vector<SampleGroupHandler> sample_groups_;
     std::vector<std::string> command_names_;
+    NameIndex injection_index_;
+    NameIndex sequence_segment_index_;
+    NameIndex sample_group_index_;
   };
 }
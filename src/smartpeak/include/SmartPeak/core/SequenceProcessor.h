@@ -28,9 +28,11 @@
 #include <SmartPeak/core/SequenceHandler.h>
 #include <SmartPeak/core/SequenceSegmentProcessor.h>
 #include <SmartPeak/core/SampleGroupProcessor.h>
+#include <SmartPeak/core/ProcessorProfileObservable.h>
 #include <SmartPeak/core/SampleGroupProcessorObservable.h>
 #include <SmartPeak/core/SequenceProcessorObservable.h>
 #include <SmartPeak/core/SequenceSegmentProcessorObservable.h>
+#include <SmartPeak/core/ThreadPool.h>
 #include <SmartPeak/iface/IProcessorDescription.h>
 #include <SmartPeak/iface/IFilenamesHandler.h>
 #include <SmartPeak/io/InputDataValidation.h>
@@ -45,6 +47,37 @@
 
 namespace SmartPeak
 {
+  /**
+    Error raised while processing an injection, a sequence segment or a sample group.
+    It carries the name of the item and of the processor that failed.
+  */
+  class WorkflowException : public std::exception
+  {
+  public:
+
+    explicit WorkflowException(const std::string& item, const std::string& processor, const std::string& message)
+      : item_(item), processor_(processor), msg_(message)  {}
+
+    virtual ~WorkflowException() noexcept {}
+
+    virtual const char* what() const noexcept override {
+      return msg_.c_str();
+    }
+
+    virtual const std::string item() const noexcept {
+      return item_;
+    }
+
+    virtual const std::string processor() const noexcept {
+      return processor_;
+    }
+
+  protected:
+    std::string item_;
+    std::string processor_;
+    std::string msg_;
+  };
+
   /**
     Multithreaded execution processor
   */
@@ -58,7 +91,18 @@ namespace SmartPeak
       @param[in] n_threads desired number of threads to use
     */
     size_t getNumWorkers(unsigned int n_threads) const;
-    
+
+    /**
+      Run a number of workers equal to the number of threads of execution
+      offered by the CPU (see getNumWorkers) on the thread pool.
+
+      If no thread pool is given, a temporary one is created for the call.
+
+      @param[in] n_threads desired number of threads to use
+      @param[in] thread_pool the pool providing the threads
+    */
+    void spawn_workers(unsigned int n_threads, ThreadPool* thread_pool = nullptr);
+
     virtual void run_processing() = 0;
   };
 
@@ -71,17 +115,9 @@ namespace SmartPeak
       std::vector<InjectionHandler>& injections,
       std::map<std::string, Filenames>& filenames,
       const std::vector<std::shared_ptr<RawDataProcessor>>& methods,
-      SequenceProcessorObservable* observable = nullptr
-    ) : injections_(injections), filenames_(filenames), methods_(methods), observable_(observable) {}
-
-    /**
-      Spawn a number of workers equal to the number of threads of execution
-      offered by the CPU
-
-      @note If the API is unable to fetch the required information, only a
-      single thread will be used
-    */
-    void spawn_workers(unsigned int n_threads);
+      SequenceProcessorObservable* observable = nullptr,
+      ProcessorProfileObservable* profile_observable = nullptr
+    ) : injections_(injections), filenames_(filenames), methods_(methods), observable_(observable), profile_observable_(profile_observable) {}
 
     /**
       Workers run this function. It implements a loop that runs the following steps:
@@ -93,7 +129,7 @@ namespace SmartPeak
 
       The loop ends when the worker fetches an index that is out of range.
     */
-    void run_processing();
+    void run_processing() override;
 
   private:
     std::atomic_size_t i_ { 0 }; ///< a worker works on the i_-th injection
@@ -101,6 +137,7 @@ namespace SmartPeak
     std::map<std::string, Filenames>& filenames_; ///< mapping from injections names to the associated filenames
     const std::vector<std::shared_ptr<RawDataProcessor>>& methods_; ///< methods to run on each injection
     SequenceProcessorObservable* observable_;
+    ProcessorProfileObservable* profile_observable_;
   };
 
   /**
@@ -113,22 +150,15 @@ namespace SmartPeak
       SequenceHandler& sequenceHandler_I,
       std::vector<std::shared_ptr<SequenceSegmentProcessor>>& sequence_segment_processing_methods_,
       std::map<std::string, Filenames>& filenames,
-      SequenceSegmentProcessorObservable* observable = nullptr
+      SequenceSegmentProcessorObservable* observable = nullptr,
+      ProcessorProfileObservable* profile_observable = nullptr
     ) : sequence_segment_(sequenceSegmentHandler_IO),
         sequenceHandler_IO(sequenceHandler_I),
         sequence_segment_processing_methods_(sequence_segment_processing_methods_),
         filenames_(filenames),
-        observable_(observable) {}
+        observable_(observable),
+        profile_observable_(profile_observable) {}
     
-    /**
-      Spawn a number of workers equal to the number of threads of execution
-      offered by the CPU
-
-      @note If the API is unable to fetch the required information, only a
-      single thread will be used
-    */
-    void spawn_workers(unsigned int n_threads);
-
     /**
       Workers run this function. It implements a loop that runs the following steps:
       - fetch sequence segments
@@ -139,7 +169,7 @@ namespace SmartPeak
 
       The loop ends when the worker fetches an index that is out of range.
     */
-    void run_processing();
+    void run_processing() override;
 
   private:
     std::atomic_size_t i_ { 0 }; ///< a worker works on the i_-th injection
@@ -148,6 +178,7 @@ namespace SmartPeak
     SequenceHandler& sequenceHandler_IO;
     std::vector<std::shared_ptr<SequenceSegmentProcessor>>& sequence_segment_processing_methods_;
     SequenceSegmentProcessorObservable* observable_;
+    ProcessorProfileObservable* profile_observable_;
   };
 
   /**
@@ -160,22 +191,15 @@ namespace SmartPeak
       SequenceHandler& sequenceHandler_I,
       std::vector<std::shared_ptr<SampleGroupProcessor>>& sample_group_processing_methods,
       std::map<std::string, Filenames>& filenames,
-      SampleGroupProcessorObservable* observable = nullptr
+      SampleGroupProcessorObservable* observable = nullptr,
+      ProcessorProfileObservable* profile_observable = nullptr
     ) : sample_group_(sequenceSegmentHandler_IO),
         sequenceHandler_IO(sequenceHandler_I),
         sample_group_processing_methods_(sample_group_processing_methods),
         filenames_(filenames),
-        observable_(observable) {}
+        observable_(observable),
+        profile_observable_(profile_observable) {}
     
-    /**
-      Spawn a number of workers equal to the number of threads of execution
-      offered by the CPU
-
-      @note If the API is unable to fetch the required information, only a
-      single thread will be used
-    */
-    void spawn_workers(unsigned int n_threads);
-
     /**
       Workers run this function. It implements a loop that runs the following steps:
       - fetch sequence segments
@@ -186,7 +210,7 @@ namespace SmartPeak
 
       The loop ends when the worker fetches an index that is out of range.
     */
-    void run_processing();
+    void run_processing() override;
 
   private:
     std::atomic_size_t i_ { 0 }; ///< a worker works on the i_-th injection
@@ -195,6 +219,7 @@ namespace SmartPeak
     SequenceHandler& sequenceHandler_IO;
     std::vector<std::shared_ptr<SampleGroupProcessor>>& sample_group_processing_methods_;
     SampleGroupProcessorObservable* observable_;
+    ProcessorProfileObservable* profile_observable_;
   };
 
   /**
@@ -203,11 +228,13 @@ namespace SmartPeak
     @param[in,out] injection The injection to process
     @param[in] filenames Used by the methods
     @param[in] methods Methods to process on the injection
+    @param[in] profile_observable If set, notified with the measurements of each method
   */
   void processInjection(
     InjectionHandler& injection,
     Filenames& filenames_I,
-    const std::vector<std::shared_ptr<RawDataProcessor>>& methods
+    const std::vector<std::shared_ptr<RawDataProcessor>>& methods,
+    ProcessorProfileObservable* profile_observable = nullptr
   );
 
   /**
@@ -217,11 +244,13 @@ namespace SmartPeak
     @param[in] SequenceHandler Sequence Segment IO
     @param[in] filenames Used by the methods
     @param[in] methods Methods to process on the sequence segment
+    @param[in] profile_observable If set, notified with the measurements of each method
   */
   void processSegment(SequenceSegmentHandler& sequence_segment,
                       SequenceHandler& sequenceHandler_IO,
                       Filenames& filenames,
-                      const std::vector<std::shared_ptr<SequenceSegmentProcessor>>& methods);
+                      const std::vector<std::shared_ptr<SequenceSegmentProcessor>>& methods,
+                      ProcessorProfileObservable* profile_observable = nullptr);
 
   /**
     Apply a processing workflow to a single sample group
@@ -230,11 +259,13 @@ namespace SmartPeak
     @param[in] SequenceHandler Sequence Segment IO
     @param[in] filenames Used by the methods
     @param[in] methods Methods to process on the sample group
+    @param[in] profile_observable If set, notified with the measurements of each method
   */
   void processSampleGroup(SampleGroupHandler& sample_group,
                           SequenceHandler& sequenceHandler_IO,
                           Filenames& filenames,
-                          const std::vector<std::shared_ptr<SampleGroupProcessor>>& methods);
+                          const std::vector<std::shared_ptr<SampleGroupProcessor>>& methods,
+                          ProcessorProfileObservable* profile_observable = nullptr);
 
   struct SequenceProcessor : IProcessorDescription, IFilenamesHandler {
     explicit SequenceProcessor(SequenceHandler& sh) : sequenceHandler_IO(&sh) {}
@@ -260,7 +291,7 @@ namespace SmartPeak
   /**
     Apply a processing workflow to all injections in a sequence
   */
-  struct ProcessSequence : SequenceProcessor, SequenceProcessorObservable {
+  struct ProcessSequence : SequenceProcessor, SequenceProcessorObservable, ProcessorProfileObservable {
     std::map<std::string, Filenames>               filenames_;                     /// Mapping from injection names to pathnames
     std::set<std::string>                          injection_names_;               /// Injections to select from the sequence (all if empty)
     std::vector<std::shared_ptr<RawDataProcessor>> raw_data_processing_methods_; /// Events to process
@@ -281,12 +312,13 @@ namespace SmartPeak
     virtual void getFilenames(Filenames& filenames) const override {};
 
     int number_of_threads_ = 1;
+    std::shared_ptr<ThreadPool> thread_pool_; /// Pool running the workers, a temporary one is used if not set
   };
 
   /**
     Apply a processing workflow to all injections in a sequence segment
   */
-  struct ProcessSequenceSegments : SequenceProcessor, SequenceSegmentProcessorObservable {
+  struct ProcessSequenceSegments : SequenceProcessor, SequenceSegmentProcessorObservable, ProcessorProfileObservable {
     std::map<std::string, Filenames>                       filenames_;                             /// Mapping from sequence groups names to pathnames
     std::set<std::string>                                  sequence_segment_names_;                /// Sequence groups to select from the sequence (all if empty)
     std::vector<std::shared_ptr<SequenceSegmentProcessor>> sequence_segment_processing_methods_; /// Events to process
@@ -303,12 +335,13 @@ namespace SmartPeak
     virtual std::string getDescription() const override { return "Apply a processing workflow to all injections in a sequence segment"; }
 
     int number_of_threads_ = 1;
+    std::shared_ptr<ThreadPool> thread_pool_; /// Pool running the workers, a temporary one is used if not set
   };
 
   /**
     Apply a processing workflow to all injections in a sample group
   */
-  struct ProcessSampleGroups : SequenceProcessor, SampleGroupProcessorObservable {
+  struct ProcessSampleGroups : SequenceProcessor, SampleGroupProcessorObservable, ProcessorProfileObservable {
     std::map<std::string, Filenames>                       filenames_;                     /// Mapping from sample groups names to pathnames
     std::set<std::string>                                  sample_group_names_;            /// sample groups to select from the sequence (all if empty)
     std::vector<std::shared_ptr<SampleGroupProcessor>> sample_group_processing_methods_; /// Events to process
@@ -325,6 +358,7 @@ namespace SmartPeak
     virtual std::string getDescription() const override { return "Apply a processing workflow to all injections in a sample group"; }
 
     int number_of_threads_ = 1;
+    std::shared_ptr<ThreadPool> thread_pool_; /// Pool running the workers, a temporary one is used if not set
   };
 
   struct LoadSequence : SequenceProcessor, IFilePickerHandler
@@ -26,6 +26,13 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/AbsoluteQuantitationMethod.h>
 #include <OpenMS/METADATA/AbsoluteQuantitationStandards.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMFeatureQC.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace SmartPeak
 {
@@ -128,7 +135,34 @@ public:
     std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>
       getFeatureConcentrationsPruned(const std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration> feature_concentrations) const;
 
+    /**
+    @brief Feature maps of a set of injections of the segment, shared by the processors of the segment.
+
+      The feature maps made by make_feature_maps are cached by sample indices, and returned by the next calls
+      for the same sample indices as long as the feature map versions are the same.
+
+      @param[in] sample_indices The injections
+      @param[in] feature_map_versions The current versions of the feature maps of the injections (see RawDataHandler::getFeatureMapVersion)
+      @param[in] make_feature_maps Called when the cached feature maps are missing or outdated
+    */
+    std::shared_ptr<const std::vector<OpenMS::FeatureMap>> getFeatureMaps(
+      const std::vector<size_t>& sample_indices,
+      const std::vector<uint64_t>& feature_map_versions,
+      const std::function<std::vector<OpenMS::FeatureMap>()>& make_feature_maps
+    );
+
+    /**
+    @brief Releases the feature maps cached by getFeatureMaps, once the processors of the segment are done.
+    */
+    void clearFeatureMaps();
+
   private:
+    struct CachedFeatureMaps
+    {
+      std::vector<uint64_t> feature_map_versions;
+      std::shared_ptr<const std::vector<OpenMS::FeatureMap>> feature_maps;
+    };
+
     std::string sequence_segment_name_;
     std::vector<size_t> sample_indices_;  ///< The indices of each injection; this could be replaced with `std::shared_ptr<InjectionHandler>` to save the map lookup
     std::vector<OpenMS::AbsoluteQuantitationStandards::runConcentration> standards_concentrations_;
@@ -143,5 +177,6 @@ public:
     std::shared_ptr<OpenMS::MRMFeatureQC> feature_background_estimations_ = nullptr;  ///< Background interference estimations; shared between all raw data handlers in the sequence segment
     std::map<std::string, std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>> components_to_concentrations_;
     std::map<std::string, std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>> excluded_components_to_concentrations_;
+    std::map<std::vector<size_t>, CachedFeatureMaps> cached_feature_maps_;  ///< Feature maps of the injections, by sample indices; only kept while the segment is processed
   };
 }
\ No newline at end of file
@@ -71,6 +71,23 @@ namespace SmartPeak
       std::vector<size_t>& sampleIndices
     );
 
+    /**
+      Return the feature maps of the given injections, as expected by the OpenMS estimators.
+
+      The feature maps are copied once and cached in the sequence segment handler: the next processors
+      of the segment reuse the copy as long as the feature maps of the injections are not modified.
+      The copies are released once the processing of the segment is done (see SequenceSegmentHandler::clearFeatureMaps).
+
+      @param[in,out] sequenceSegmentHandler Sequence segment handler
+      @param[in] sequenceHandler Sequence handler
+      @param[in] sampleIndices Injection indices
+    */
+    static std::shared_ptr<const std::vector<OpenMS::FeatureMap>> getFeatureMaps(
+      SequenceSegmentHandler& sequenceSegmentHandler,
+      const SequenceHandler& sequenceHandler,
+      const std::vector<size_t>& sampleIndices
+    );
+
     /* IFilenamesHandler */
     virtual void getFilenames(Filenames& filenames) const override { };
 
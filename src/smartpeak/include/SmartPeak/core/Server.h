@@ -48,6 +48,12 @@
 
 #include <iostream>
 #include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <thread>
 #include <algorithm>
 #include <vector>
 #include <memory>
@@ -190,6 +196,12 @@ namespace SmartPeak {
         application_handler_.sequenceHandler_.addSequenceObserver(&event_dispatcher_);
         event_dispatcher_.addTransitionsObserver(&session_handler_);
         event_dispatcher_.addSequenceObserver(&session_handler_);
+        event_dispatcher_.addApplicationProcessorObserver(&server_event_dispatcher_observer_);
+        event_dispatcher_.addSequenceProcessorObserver(&server_event_dispatcher_observer_);
+        event_dispatcher_.addSequenceSegmentProcessorObserver(&server_event_dispatcher_observer_);
+        event_dispatcher_.addSampleGroupProcessorObserver(&server_event_dispatcher_observer_);
+        event_dispatcher_.addSequenceObserver(&server_event_dispatcher_observer_);
+        event_dispatcher_.addTransitionsObserver(&server_event_dispatcher_observer_);
         progress_info_ptr_ = std::make_shared<ProgressInfo>(
             event_dispatcher_, event_dispatcher_, event_dispatcher_, event_dispatcher_);
       }
@@ -226,6 +238,7 @@ namespace SmartPeak {
       std::vector<std::string>  input_files;
       std::string               mzml_dir {"./mzML"};
       std::string               reports_out_dir {"exports"};
+      int                       nb_threads {0}; ///< number of threads used by the workflow, 0 means all the cores
       
     private:
       ApplicationHandler application_handler_;
@@ -238,6 +251,78 @@ namespace SmartPeak {
       std::shared_ptr<ServerAppender> server_appender_;
     };
 
+    /**
+      Queue of the workflow requests received by the server.
+
+      Jobs are identified by a job id and are started in submission order,
+      at most max_running_jobs at the same time.
+    */
+    class JobQueue {
+    public:
+      enum class JobStatus {
+        UNKNOWN,
+        QUEUED,
+        RUNNING,
+        DONE,
+        CANCELLED
+      };
+
+      /**
+        @param[in] max_running_jobs maximum number of jobs running concurrently (at least 1)
+      */
+      explicit JobQueue(size_t max_running_jobs = 1);
+      ~JobQueue();
+
+      JobQueue(const JobQueue&) = delete;
+      JobQueue& operator=(const JobQueue&) = delete;
+
+      /**
+        @brief Queues a job.
+
+        @param[in] job_id unique identifier of the job
+        @param[in] job the function running the job, returns true on success
+        @return the result of the job (false if it has been cancelled),
+          or an invalid future if the job id is already used.
+      */
+      std::shared_future<bool> submit(const std::string& job_id, std::function<bool()> job);
+
+      /**
+        @brief Cancels a job that has not started yet.
+        @return true if the job was queued and has been cancelled
+      */
+      bool cancel(const std::string& job_id);
+
+      /**
+        @brief Forgets a finished or cancelled job, its job id can then be used again.
+        @return true if the job was finished or cancelled and has been removed
+      */
+      bool forget(const std::string& job_id);
+
+      JobStatus getStatus(const std::string& job_id) const;
+      size_t getMaxRunningJobs() const { return max_running_jobs_; }
+      size_t getNbRunningJobs() const;
+      size_t getNbQueuedJobs() const;
+
+    private:
+      struct Job
+      {
+        std::string job_id;
+        std::function<bool()> run;
+        std::promise<bool> result;
+      };
+
+      void runJobs();
+
+      const size_t max_running_jobs_;
+      mutable std::mutex mutex_;
+      std::condition_variable cv_;
+      std::deque<std::shared_ptr<Job>> queued_jobs_;
+      std::map<std::string, JobStatus> status_;
+      std::vector<std::thread> runners_;
+      size_t nb_running_ = 0;
+      bool stop_ = false;
+    };
+
     void extractReportSampletypes(
       const std::vector<std::string>& application_settings,
       std::set<SmartPeak::SampleType>& report_sample_types);
@@ -25,7 +25,13 @@
 
 #include <SmartPeak/core/SequenceHandler.h>
 #include <SmartPeak/core/ApplicationHandler.h>
+#include <SmartPeak/core/DecimationPyramid.h>
+#include <SmartPeak/core/NameSelection.h>
 #include <unsupported/Eigen/CXX11/Tensor>
+#include <array>
+#include <functional>
+#include <limits>
+#include <mutex>
 
 namespace SmartPeak
 {
@@ -60,10 +66,12 @@ namespace SmartPeak
     {
       Eigen::Tensor<std::string, 1> headers_;
       Eigen::Tensor<std::string, 2> body_;
+      Eigen::Tensor<float, 2> values_; ///< optional numeric columns, following the body_ columns and only formatted when displayed
       void clear()
       {
         headers_.resize(0);
         body_.resize(0, 0);
+        values_.resize(0, 0);
       }
     };
 
@@ -127,12 +135,17 @@ namespace SmartPeak
     /*
     @brief Sets the Feature matrix data used for the matrix table, line plots, and heatmap
 
-    @param[in] sequence_handler
+    The matrix is only updated when the features, the sequence or the explorers selection have changed,
+    and only the columns of the samples whose features have changed are recomputed.
 
-    @returns true if all points were added and false if points were omitted due to performance
+    @param[in] sequence_handler
     */
     void setFeatureMatrix(const SequenceHandler& sequence_handler);
     /*
+    @brief Incremented each time the feature matrix data is updated
+    */
+    size_t getFeatureMatrixVersion() const { return feature_matrix_version_; }
+    /*
     @brief Graph Visualization Data structure
     */
     struct GraphVizData
@@ -227,6 +240,18 @@ namespace SmartPeak
 
     };
 
+    /*
+    @brief Part of a plot being displayed.
+      The series are decimated to about two points per pixel within the visible x range,
+      while the axes extents still cover the whole data.
+    */
+    struct PlotViewport
+    {
+      float x_min = std::numeric_limits<float>::lowest();
+      float x_max = std::numeric_limits<float>::max();
+      int pixel_width = 0; ///< 0 to get all the points
+    };
+
     /*
     @brief Gets the chromatogram data
 
@@ -235,12 +260,14 @@ namespace SmartPeak
     @param[in] range
     @param[in] sample_names
     @param[in] component_names
+    @param[in] viewport The part of the plot displayed, all the points are returned if not set
     */
     void getChromatogramScatterPlot(const SequenceHandler& sequence_handler, 
                                     GraphVizData& result,
                                     const std::pair<float, float>& range,
                                     const std::set<std::string>& sample_names,
-                                    const std::set<std::string>& component_names) const;
+                                    const std::set<std::string>& component_names,
+                                    const std::optional<PlotViewport>& viewport = std::nullopt) const;
 
     /*
     @brief Gets the TIC chromatogram data
@@ -249,11 +276,13 @@ namespace SmartPeak
     @param[out] result
     @param[in] range
     @param[in] sample_names
+    @param[in] viewport The part of the plot displayed, all the points are returned if not set
     */
     void getChromatogramTIC(const SequenceHandler& sequence_handler,
       GraphVizData& result,
       const std::pair<float, float>& range,
-      const std::set<std::string>& sample_names) const;
+      const std::set<std::string>& sample_names,
+      const std::optional<PlotViewport>& viewport = std::nullopt) const;
 
     /*
     @brief Gets the XIC chromatogram data
@@ -280,12 +309,14 @@ namespace SmartPeak
     @param[in] range
     @param[in] sample_names
     @param[in] component_group_names
+    @param[in] viewport The part of the plot displayed, all the points are returned if not set
     */
     void getSpectrumScatterPlot(const SequenceHandler& sequence_handler,
                                 GraphVizData& result,
                                 const std::pair<float, float>& range,
                                 const std::set<std::string>& sample_names,
-                                const std::set<std::string>& component_group_names) const;
+                                const std::set<std::string>& component_group_names,
+                                const std::optional<PlotViewport>& viewport = std::nullopt) const;
 
     /*
     @brief Gets MS1/MS2 spectrum data
@@ -325,12 +356,25 @@ namespace SmartPeak
       Eigen::Tensor<std::string, 1> selected_sample_names_;
       Eigen::Tensor<std::string, 1> selected_transitions_;
       Eigen::Tensor<std::string, 1> selected_transition_groups_;
+      size_t selection_version_ = 0; ///< plot selection version the data was made from
     };
     
     /*
     @brief fill the HeatMapData structure, given a feature name
     */
     void getHeatMap(const SequenceHandler& sequence_handler, HeatMapData& result, const std::string& feature_name);
+
+    /*
+    @brief fill the HeatMapData structure, given a feature name and the selected names
+
+    Only reads the sequence, the selection members of the result are not set.
+    */
+    void getHeatMap(const SequenceHandler& sequence_handler,
+                    HeatMapData& result,
+                    const std::string& feature_name,
+                    const std::set<std::string>& sample_names,
+                    const std::set<std::string>& component_names,
+                    const std::set<std::string>& component_group_names) const;
     
     /*
     @brief Calibration data structure, result of call to setCalibratorsScatterLinePlot
@@ -404,6 +448,21 @@ namespace SmartPeak
     Eigen::Tensor<std::string, 1> getSelectFeatureMetaValuesPlot();
     Eigen::Tensor<std::string, 1> getSelectSpectrumPlot();
 
+    /*
+    @brief Selections of the explorers, as bitsets over the interned names, synchronized with the checkboxes of the explorers
+    */
+    const NameSelection& getSampleNamesPlotSelection() const;
+    const NameSelection& getTransitionsPlotSelection() const;
+    const NameSelection& getTransitionGroupsPlotSelection() const;
+    const NameSelection& getTransitionsTableSelection() const;
+    const NameSelection& getTransitionGroupsTableSelection() const;
+    const NameSelection& getFeatureMetaValuesPlotSelection() const;
+    const NameSelection& getFeatureMetaValuesTableSelection() const;
+    /*
+    @brief Changes each time the injections, transitions or transition groups selected for plotting change
+    */
+    size_t getPlotSelectionVersion() const;
+
     int getNSelectedSampleNamesTable();
     int getNSelectedSampleNamesPlot();
     int getNSelectedTransitionsTable();
@@ -436,7 +495,77 @@ namespace SmartPeak
     float feat_line_sample_min, feat_line_sample_max, feat_value_min, feat_value_max;
     Eigen::Tensor<std::string, 1> feat_row_labels, feat_col_labels;
   private:
-    int feature_table_unique_samples_transitions_ = 0; // used to decide when to update the feature table data
-    int feature_matrix_unique_transitions_ = 0; // used to decide when to update the feature matrix data
+    /*
+    @brief Selection of the names of a table column, synchronized with a checkbox column of an explorer when queried
+    */
+    struct ExplorerNameSelection
+    {
+      NameSelection selection;
+      size_t table_version = 0; ///< version of the table the names were interned from
+    };
+    const NameSelection& syncSelection(ExplorerNameSelection& selection,
+                                       const GenericTableData& table,
+                                       size_t table_version,
+                                       int name_column,
+                                       const ExplorerData& explorer_data,
+                                       int checkbox_column) const;
+    size_t sequence_table_version_ = 0; // incremented each time the body of the sequence table is made
+    size_t transitions_table_version_ = 0; // incremented each time the body of the transitions table is made
+    size_t feature_explorer_version_ = 0; // incremented each time the body of the feature explorer is made
+    mutable ExplorerNameSelection sample_names_plot_selection_;
+    mutable ExplorerNameSelection transitions_plot_selection_;
+    mutable ExplorerNameSelection transition_groups_plot_selection_;
+    mutable ExplorerNameSelection transitions_table_selection_;
+    mutable ExplorerNameSelection transition_groups_table_selection_;
+    mutable ExplorerNameSelection feature_meta_values_plot_selection_;
+    mutable ExplorerNameSelection feature_meta_values_table_selection_;
+
+    /*
+    @brief Versions of the selected injections, transitions and feature meta values, used to decide when to update the feature table and matrix data
+    */
+    struct ExplorerSelection
+    {
+      size_t injections = 0;
+      size_t transitions = 0;
+      size_t feature_meta_values = 0;
+      bool operator==(const ExplorerSelection& other) const
+      {
+        return injections == other.injections && transitions == other.transitions && feature_meta_values == other.feature_meta_values;
+      }
+      bool operator!=(const ExplorerSelection& other) const { return !(*this == other); }
+    };
+    ExplorerSelection getExplorerSelection(const NameSelection& feature_meta_values) const;
+
+    /*
+    @brief Feature matrix data of one sample, kept until the features of the sample change
+    */
+    struct FeatureMatrixColumn
+    {
+      std::vector<std::shared_ptr<const FeatureTable>> feature_tables; ///< the tables of the sample injections the column was made from
+      std::vector<std::array<std::string, 3>> rows; ///< component name, component group name and feature meta value of each value
+      std::vector<float> values;
+    };
+
+    bool feature_table_dirty_ = true; // the features or the sequence have changed since the last update of the feature table data
+    ExplorerSelection feature_table_selection_;
+    bool feature_matrix_dirty_ = true; // the features or the sequence have changed since the last update of the feature matrix data
+    ExplorerSelection feature_matrix_selection_;
+    std::map<std::string, FeatureMatrixColumn> feature_matrix_columns_;
+    size_t feature_matrix_version_ = 0;
+
+    /*
+    @brief Adds a series to the plot data, decimated according to the viewport
+
+    @param[in] key Identifies the series in the cache of decimation pyramids
+    @param[in] make_series Makes the x and y values of the series, only called when the series is not cached yet
+    */
+    bool addPlotSeries(GraphVizData& result,
+                       const std::string& key,
+                       const std::function<void(std::vector<float>&, std::vector<float>&)>& make_series,
+                       const std::pair<float, float>& range,
+                       const std::optional<PlotViewport>& viewport,
+                       const std::string& series_name) const;
+    mutable std::map<std::string, std::shared_ptr<const DecimationPyramid>> plot_series_; ///< decimation pyramids of the plotted series, kept until the sequence changes
+    mutable std::mutex plot_series_mutex_;
   };
 }
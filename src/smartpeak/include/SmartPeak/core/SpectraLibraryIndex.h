@@ -0,0 +1,75 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/ANALYSIS/OPENSWATH/TargetedSpectraExtractor.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace SmartPeak
+{
+  /**
+    @brief Spectral library index shared by all the injections of a sequence.
+
+    The library loaded from a file is kept and handed over to the injections loading the same,
+    unchanged, file. The binned spectra used for matching are computed once per library
+    and the comparator is then used read-only by all the worker threads.
+  */
+  class SpectraLibraryIndex
+  {
+  public:
+    using Comparator = OpenMS::TargetedSpectraExtractor::BinnedSpectrumComparator;
+
+    /**
+      @brief Returns the library loaded from the file. `load` is only called if the file
+      has not been loaded yet, or has been modified since.
+    */
+    std::shared_ptr<OpenMS::MSExperiment> getLibrary(
+      const std::filesystem::path& filename,
+      const std::function<void(OpenMS::MSExperiment&)>& load);
+
+    /**
+      @brief Returns the comparator initialized with the spectra of the library, they are binned on first use.
+    */
+    std::shared_ptr<const Comparator> getComparator(const std::shared_ptr<OpenMS::MSExperiment>& library);
+
+    /**
+      @brief Drops the loaded library and the binned spectra, they will be recomputed on next use.
+    */
+    void clear();
+
+  protected:
+    std::mutex mutex_;
+    std::filesystem::path filename_;
+    std::filesystem::file_time_type last_write_time_;
+    std::shared_ptr<OpenMS::MSExperiment> library_;
+    std::weak_ptr<OpenMS::MSExperiment> binned_library_;
+    size_t binned_library_size_ = 0;
+    std::shared_ptr<const Comparator> comparator_;
+  };
+}
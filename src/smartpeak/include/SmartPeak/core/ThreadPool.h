@@ -0,0 +1,142 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    Persistent work-stealing thread pool.
+
+    Each worker owns a task queue. Tasks submitted from a worker are pushed on its own
+    queue, tasks submitted from other threads are dispatched round-robin. Idle workers
+    pop their own queue first (LIFO), then steal from the other workers (FIFO).
+
+    Threads are started lazily, up to the capacity given at construction,
+    and are kept alive until the pool is destroyed.
+  */
+  class ThreadPool
+  {
+  public:
+    /**
+      @param[in] capacity maximum number of worker threads. 0 means std::thread::hardware_concurrency().
+    */
+    explicit ThreadPool(size_t capacity = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+      @brief Maximum number of worker threads.
+    */
+    size_t capacity() const { return queues_.size(); }
+
+    /**
+      @brief Number of worker threads currently started.
+    */
+    size_t size() const { return nb_started_.load(); }
+
+    /**
+      @brief Starts worker threads so that at least n_threads are running (bounded by capacity()).
+    */
+    void reserve(size_t n_threads);
+
+    /**
+      @brief Submits a task to the pool.
+      @return a future holding the result, or the exception thrown by the task.
+    */
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task);
+
+    /**
+      @brief Runs func(i) for i in [0, n_tasks) on the pool and waits for completion.
+
+      The calling thread runs the indices of this call too, and only those: the workers pick
+      the remaining ones when they are idle. A nested call from a worker therefore completes
+      even when all the other workers are busy or blocked, and never runs an unrelated task
+      (which could be waiting for the caller).
+
+      The first exception thrown by a task (if any) is rethrown once all the tasks are done.
+    */
+    void parallelFor(size_t n_tasks, const std::function<void(size_t)>& func);
+
+    /**
+      @brief returns true if the calling thread is a worker of this pool.
+    */
+    bool isWorkerThread() const;
+
+    /**
+      @brief returns the pool of the calling worker thread, nullptr if the calling thread is not a worker.
+    */
+    static ThreadPool* current();
+
+  protected:
+    struct WorkerQueue
+    {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    void push(std::function<void()> task);
+    bool pop(size_t worker_index, std::function<void()>& task);
+    void workerLoop(size_t worker_index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex threads_mutex_;
+    std::atomic_size_t nb_started_{ 0 };
+    std::atomic_size_t next_queue_{ 0 };
+    std::atomic_size_t pending_tasks_{ 0 };
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stop_ = false;
+  };
+
+  template<typename F>
+  std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& task)
+  {
+    using R = std::invoke_result_t<F>;
+    auto packaged_task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+    std::future<R> future = packaged_task->get_future();
+    if (nb_started_.load() == 0)
+    {
+      reserve(1);
+    }
+    push([packaged_task]() { (*packaged_task)(); });
+    return future;
+  }
+}
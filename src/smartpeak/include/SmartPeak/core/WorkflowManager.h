@@ -42,8 +42,12 @@ namespace SmartPeak {
   class WorkflowManager {
   public:
     /**
-      Copies the passed application_handler and sets up the async run of the workflow. Only one
-      workflow is managed at a time
+      Takes a snapshot of the passed application_handler and sets up the async run of the workflow. Only one
+      workflow is managed at a time.
+
+      The snapshot shares the injections' raw data with the source; the raw data of an injection is copied
+      when the workflow modifies it, so the source can still be read while the workflow runs.
+      The results are moved back to the source by updateApplicationHandler (called here if blocking is true).
 
       @param[in,out] The application_handler that gets copied and then updated at the end of the workflow run
       @param[in] injection_names Injection names to use for Sequence Processing
@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <SmartPeak/core/ApplicationHandler.h>
+#include <SmartPeak/core/ApplicationProcessorObservable.h>
+#include <SmartPeak/core/RawDataResidency.h>
+#include <SmartPeak/core/SequenceProcessor.h>
+
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <string>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    Runs a workflow as a graph of tasks instead of a sequence of barriers.
+
+    Consecutive commands of the same type are grouped into a stage (as ProcessSequence,
+    ProcessSequenceSegments and ProcessSampleGroups would do). Each stage is split into one task
+    per injection, sequence segment or sample group. A task depends on the tasks of the previous
+    stages that touched the same injections (the sample indices of a segment or a group, plus the first
+    injection whose targeted experiment they read), so downstream steps start as soon as their own
+    injections are processed.
+
+    Workers (see ProcessorMultithread::spawn_workers) pick the ready task of the most downstream stage first.
+    Each processor run is measured and sent to the IProcessorProfileObserver, if any.
+  */
+  class WorkflowScheduler :
+    public ProcessorMultithread,
+    public SequenceProcessorObservable,
+    public SequenceSegmentProcessorObservable,
+    public SampleGroupProcessorObservable,
+    public ProcessorProfileObservable
+  {
+  public:
+    struct Stage
+    {
+      ApplicationHandler::Command::CommandType type;
+      size_t first_command_index = 0;
+      std::vector<std::shared_ptr<RawDataProcessor>> raw_data_methods;
+      std::vector<std::shared_ptr<SequenceSegmentProcessor>> sequence_segment_methods;
+      std::vector<std::shared_ptr<SampleGroupProcessor>> sample_group_methods;
+      std::map<std::string, Filenames> filenames;
+      std::vector<std::string> command_names;
+      unsigned next_ms_data = RawDataResidency::NoMSData; ///< raw MS data read by the raw data methods of the next stages
+      size_t nb_tasks = 0;
+      size_t nb_done = 0;
+      bool started = false;
+    };
+
+    struct Task
+    {
+      static constexpr size_t no_item = std::numeric_limits<size_t>::max(); ///< item_index of the task reporting a stage without any item
+
+      size_t stage_index;
+      size_t item_index; ///< index in the sequence, the sequence segments or the sample groups
+      std::vector<size_t> dependencies;
+      std::vector<size_t> dependents;
+    };
+
+    explicit WorkflowScheduler(
+      SequenceHandler& sequence_handler,
+      ApplicationProcessorObservable* application_processor_observable = nullptr
+    ) : sequence_handler_(sequence_handler), application_processor_observable_(application_processor_observable) {}
+
+    /**
+      Builds the stages and the task graph.
+
+      @param[in] commands Workflow steps
+      @param[in] injection_names Injections to process (all if empty)
+      @param[in] sequence_segment_names Sequence segments to process (all if empty)
+      @param[in] sample_group_names Sample groups to process (all if empty)
+
+      @throw std::invalid_argument if the filenames are not consistent with the number of items of a stage
+    */
+    void buildGraph(
+      const std::vector<ApplicationHandler::Command>& commands,
+      const std::set<std::string>& injection_names,
+      const std::set<std::string>& sequence_segment_names,
+      const std::set<std::string>& sample_group_names);
+
+    const std::vector<Stage>& getStages() const { return stages_; }
+    const std::vector<Task>& getTasks() const { return tasks_; }
+
+    /**
+      @brief Keeps the raw MS data of the injections within a memory budget while the workflow runs, if enabled.
+    */
+    void setRawDataResidency(RawDataResidency* raw_data_residency) { raw_data_residency_ = raw_data_residency; }
+
+    /**
+      Workers run this function. It implements a loop that runs the following steps:
+      - wait for a task whose dependencies are all processed
+      - process all methods of its stage on the task's item
+      - release the tasks depending on it
+
+      The loop ends when all the tasks are processed.
+    */
+    void run_processing() override;
+
+  protected:
+    std::vector<size_t> getTouchedInjections(const Task& task) const;
+    std::string getItemName(const Task& task) const;
+    void processTask(const Task& task);
+    void notifyStageStart(Stage& stage);
+    void notifyStageEnd(Stage& stage);
+    void notifyTaskStart(const Task& task);
+    void notifyTaskEnd(const Task& task);
+    void notifyTaskError(const Task& task, const WorkflowException& e);
+
+    SequenceHandler& sequence_handler_;
+    ApplicationProcessorObservable* application_processor_observable_;
+    RawDataResidency* raw_data_residency_ = nullptr;
+    std::vector<Stage> stages_;
+    std::vector<Task> tasks_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<size_t> remaining_dependencies_;
+    std::set<std::pair<size_t, size_t>> ready_tasks_; ///< (reversed stage index, task index), most downstream stage first
+    size_t nb_done_ = 0;
+  };
+}
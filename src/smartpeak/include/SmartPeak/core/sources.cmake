@@ -8,19 +8,26 @@ set(sources_list_h
 	ApplicationProcessorObservable.h
 	CastValue.h
 	ConsoleHandler.h
+	DataPreparation.h
+	DecimationPyramid.h
 	EventDispatcher.h
 	Filenames.h
 	FeaturesObservable.h
 	FeatureFiltersUtils.h
 	FeatureFiltersUtilsMode.h
 	FeatureMetadata.h
+	FeatureTable.h
 	InjectionHandler.h
 	MetaDataHandler.h
+	NameSelection.h
 	Parameters.h
 	ParametersObservable.h
+	ProcessorProfileObservable.h
+	ProcessorProfiler.h
 	ProgressInfo.h
 	RawDataHandler.h
 	RawDataProcessor.h
+	RawDataResidency.h
 	SampleGroupHandler.h
 	SampleGroupProcessor.h
 	SampleGroupProcessorObservable.h
@@ -37,11 +44,14 @@ set(sources_list_h
 	ServerAppender.h
 	SessionLoaderGenerator.h
 	SharedProcessors.h
+	ThreadPool.h
 	Server.h
+	SpectraLibraryIndex.h
 	SpectraLibraryObservable.h
 	TransitionsObservable.h
 	Utilities.h
 	WorkflowManager.h
+	WorkflowScheduler.h
 	WorkflowObservable.h
 )
 
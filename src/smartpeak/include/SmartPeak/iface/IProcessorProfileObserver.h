@@ -0,0 +1,56 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+
+namespace SmartPeak 
+{
+  /**
+    Measurements of one processor run on one injection, sequence segment or sample group
+  */
+  struct ProcessorProfileRecord
+  {
+    enum class ItemType
+    {
+      Injection,
+      SequenceSegment,
+      SampleGroup
+    };
+
+    std::string processor_name;
+    std::string item_name;
+    ItemType item_type = ItemType::Injection;
+    double wall_time_ms = 0.0;
+    double cpu_time_ms = 0.0;  ///< CPU time of the thread running the processor
+    long rss_delta_kb = 0;     ///< resident memory growth of the process during the run
+    long peak_rss_kb = 0;      ///< peak resident memory of the process at the end of the run
+    size_t item_count = 0;     ///< chromatograms and spectra of the injection, injections of the segment or group
+  };
+
+  struct IProcessorProfileObserver
+  {
+    virtual void onProcessorProfile(const ProcessorProfileRecord& record) = 0;
+  };
+}
@@ -8,6 +8,7 @@ set(sources_list_h
   IFilenamesHandler.h
   IFilePickerHandler.h
   IParametersObserver.h
+  IProcessorProfileObserver.h
   IProcessorDescription.h
   IPropertiesHandler.h
   ISampleGroupProcessorObserver.h
@@ -25,6 +25,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <vector>
 #include <optional>
 #include <plog/Log.h>
@@ -37,6 +38,10 @@ namespace SmartPeak
 
     based on the following:
         http://thispointer.com/how-to-write-data-in-a-csv-file-in-c/
+
+    The file is opened on the first written row and kept open, rows are written
+    through a large buffer. Rows are guaranteed to be on disk after `flush`, `close`
+    or the destruction of the writer.
   */
   class CSVWriter
   {
@@ -44,19 +49,19 @@ public:
     CSVWriter(const std::string& filename, const std::string& delm = ",") :
       filename_(filename), delimeter_(delm) {}
     CSVWriter()                            = default; ///< Default constructor
-    ~CSVWriter()                           = default; ///< Default destructor
-    CSVWriter(const CSVWriter&)            = default;
-    CSVWriter& operator=(const CSVWriter&) = default;
+    ~CSVWriter(); ///< Closes the file
+    CSVWriter(const CSVWriter&)            = delete;
+    CSVWriter& operator=(const CSVWriter&) = delete;
     CSVWriter(CSVWriter&&)                 = default;
-    CSVWriter& operator=(CSVWriter&&)      = default;
+    CSVWriter& operator=(CSVWriter&&);
 
-    void setFilename(const std::string& filename); ///< filename setter
+    void setFilename(const std::string& filename); ///< filename setter, closes the current file
     std::string getFilename() const; ///< filename getter
 
     void setDelimeter(const std::string& delimeter); ///< delimeter setter
     std::string getDelimeter() const; ///< delimeter getter
 
-    void setLineCount(const int line_count); ///< line_count setter
+    void setLineCount(const int line_count); ///< line_count setter, closes the current file
     int getLineCount() const; ///< line_count getter
 
     /**
@@ -69,13 +74,10 @@ public:
     template<typename T>
     std::optional<size_t> writeDataInRow(T first, T last)
     {
-      // Open the file in truncate mode if first line, else in append mode
-      std::ofstream ofs(filename_, line_count_ ? std::ios::app : std::ios::trunc);
-
-      if (!ofs.is_open()) {
-        LOGE << "Cannot open file: " << filename_;
+      if (!open()) {
         return std::nullopt;
       }
+      std::ostream& ofs = stream_->ofs;
 
       size_t cnt {0};
 
@@ -93,9 +95,37 @@ public:
       return cnt;
     }
 
+    /**
+      @brief Writes the buffered rows to the file
+
+      @returns false if the rows could not be written
+    */
+    bool flush();
+
+    /**
+      @brief Writes the buffered rows and closes the file. The next written row opens it again,
+        in append mode (the file is truncated only when the line count is 0).
+
+      @returns false if the rows could not be written
+    */
+    bool close();
+
 private:
+    /**
+      @brief Opens the file if needed, in truncate mode if first line, else in append mode
+    */
+    bool open();
+
+    struct Stream
+    {
+      std::vector<char> buffer; ///< declared first, to be released after the file
+      std::ofstream ofs;
+    };
+
+    static constexpr size_t buffer_size_ = 1 << 20;
     std::string filename_;
     std::string delimeter_;
     int line_count_ = 0;
+    std::unique_ptr<Stream> stream_;
   };
-}
\ No newline at end of file
+}
@@ -0,0 +1,146 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/FeatureMap.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace SmartPeak
+{
+  /**
+    @brief Compact binary storage of a FeatureMap, used as a cache of the featureXML files.
+
+    The file is made of a versioned header followed by contiguous blocks:
+    a string table (meta value names and string values), the features and their subordinates,
+    the convex hulls and their points, the meta values and the list values.
+    Features and subordinates share the same block: the first records are the features of the map,
+    each record refers to the range of its subordinates.
+
+    The file is mapped in memory when read, and only converted into a FeatureMap when materialized.
+    It is written to a temporary file renamed over the previous one, so that a mapped file is never modified.
+    The header records the size and modification time of the file the features come from (see SourceFile),
+    so that a cache can be checked against its featureXML file.
+
+    Peptide and protein identifications are not supported: `store` returns false for such feature maps.
+    Data processing information and meta value units are not stored.
+  */
+  class FeatureMapBinaryFile
+  {
+  public:
+    static constexpr uint32_t version = 2;
+
+    /**
+      @brief Size and modification time of the file a feature map has been read from.
+    */
+    struct SourceFile
+    {
+      uint64_t size = 0;
+      int64_t modification_time = 0;
+
+      /**
+        @brief Size and modification time of the given file, or an empty SourceFile if it does not exist.
+      */
+      static SourceFile fromPath(const std::filesystem::path& pathname);
+
+      bool operator==(const SourceFile& other) const { return size == other.size && modification_time == other.modification_time; }
+      bool operator!=(const SourceFile& other) const { return !(*this == other); }
+    };
+
+    /**
+      @brief A feature map file mapped in memory.
+    */
+    class MappedFile
+    {
+    public:
+      ~MappedFile();
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      /**
+        @brief Number of features (not including the subordinates)
+      */
+      size_t size() const;
+
+      /**
+        @brief The file the feature map has been read from, as given to `store`
+      */
+      SourceFile getSourceFile() const;
+
+      /**
+        @brief Convert the content of the file into a FeatureMap
+
+        @throws std::runtime_error if the content of the file is not consistent
+      */
+      void materialize(OpenMS::FeatureMap& feature_map) const;
+
+    private:
+      friend class FeatureMapBinaryFile;
+      MappedFile() = default;
+      const char* data_ = nullptr;
+      size_t size_ = 0;
+#ifdef _WIN32
+      void* file_handle_ = nullptr;
+      void* mapping_handle_ = nullptr;
+#endif
+    };
+
+    FeatureMapBinaryFile() = delete;
+    ~FeatureMapBinaryFile() = delete;
+    FeatureMapBinaryFile(const FeatureMapBinaryFile&) = delete;
+    FeatureMapBinaryFile& operator=(const FeatureMapBinaryFile&) = delete;
+    FeatureMapBinaryFile(FeatureMapBinaryFile&&) = delete;
+    FeatureMapBinaryFile& operator=(FeatureMapBinaryFile&&) = delete;
+
+    /**
+      @brief Store a feature map
+
+      @param[in] filename Output file
+      @param[in] feature_map
+      @param[in] source_file The file the feature map has been read from or stored to, if any
+
+      @returns false if the feature map holds data that the format does not support (nothing is written)
+
+      @throws std::runtime_error if the file cannot be written
+    */
+    static bool store(const std::string& filename, const OpenMS::FeatureMap& feature_map, const SourceFile& source_file = SourceFile());
+
+    /**
+      @brief Map a feature map file in memory
+
+      @throws std::runtime_error if the file cannot be read, or is not a feature map file of the current version
+    */
+    static std::shared_ptr<const MappedFile> map(const std::string& filename);
+
+    /**
+      @brief Read a feature map file
+
+      @throws std::runtime_error if the file cannot be read, or is not a feature map file of the current version
+    */
+    static void load(const std::string& filename, OpenMS::FeatureMap& feature_map);
+  };
+}
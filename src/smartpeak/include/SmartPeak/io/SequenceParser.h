@@ -154,6 +154,32 @@ public:
       const std::set<std::string>& component_names
     );
 
+    /*
+    @brief Feature table of one injection, with the validation metrics used for the "accuracy" and "n_features" meta values
+    */
+    struct InjectionFeatureTable
+    {
+      std::string sample_name;
+      std::shared_ptr<const FeatureTable> feature_table;
+      const std::map<std::string, float>* validation_metrics = nullptr;
+    };
+
+    /*
+    @brief make the data matrix of feature tables that were already selected, as makeDataMatrixFromMetaValue does
+      for the injections of the sequence
+
+    @param[in] feature_tables the feature tables, in sequence order (the first value of a sample is kept)
+    */
+    static void makeDataMatrixFromFeatureTables(
+      const std::vector<InjectionFeatureTable>& feature_tables,
+      Eigen::Tensor<float, 2>& data_out,
+      Eigen::Tensor<std::string, 1>& columns_out,
+      Eigen::Tensor<std::string, 2>& rows_out,
+      const std::vector<std::string>& meta_data,
+      const std::set<std::string>& component_group_names,
+      const std::set<std::string>& component_names
+    );
+
     // NOTE: Internally, to_string() rounds at 1e-6. Therefore, some precision might be lost.
     static bool writeDataMatrixFromMetaValue(
       const SequenceHandler& sequenceHandler,
@@ -29,6 +29,8 @@
 #include <map>
 #include <vector>
 #include <optional>
+#include <sstream>
+#include <type_traits>
 #include <plog/Log.h>
 #include <SmartPeak/iface/IPropertiesHandler.h>
 
@@ -44,6 +46,7 @@ namespace SmartPeak
       std::vector<std::string> columns;
       std::string table;
       sqlite3_stmt* stmt = nullptr;
+      bool in_transaction = false;
     };
 
     void setDBFilePath(std::filesystem::path session_file_name)
@@ -53,6 +56,23 @@ namespace SmartPeak
       session_info_logged_ = false;
     }
 
+    /**
+     * @brief Use the WAL journal mode when opening the Session DB file.
+     *
+     * Reduces the number of fsync when writing large sessions,
+     * at the cost of the -wal and -shm companion files next to the session file
+     * while it is open.
+     */
+    void setWALJournalMode(bool wal_journal_mode)
+    {
+      wal_journal_mode_ = wal_journal_mode;
+    }
+
+    bool getWALJournalMode() const
+    {
+      return wal_journal_mode_;
+    }
+
     const std::filesystem::path& getDBFilePath() const
     {
       return session_file_name_;
@@ -81,13 +101,27 @@ namespace SmartPeak
 
     void endRead(SessionDB::DBContext& db_context);
 
+    /**
+     * @brief Starts writing a table to the Session DB file.
+     *
+     * The table is (re)created and the INSERT statement is prepared once.
+     * All the subsequent writes until endWrite are done in a single transaction.
+     */
     template<typename Value, typename ...Args>
     std::optional<DBContext> beginWrite(const std::string& table_name, const Value& value, const char* value_type, const Args& ...args);
 
+    /**
+     * @brief Writes one row, binding the values to the prepared INSERT statement.
+     */
     template<typename Value, typename ...Args>
     void write(SessionDB::DBContext& db_context, const Value& value, const Args& ...args);
 
-    void endWrite(SessionDB::DBContext& db_context);
+    /**
+     * @brief Commits the written rows and closes the DB.
+     *
+     * @returns false if the commit failed, the transaction is then rolled back and the table is left unchanged.
+     */
+    bool endWrite(SessionDB::DBContext& db_context);
 
     int64_t getLastInsertedRowId(SessionDB::DBContext& db_context) const;
 
@@ -105,10 +139,10 @@ namespace SmartPeak
     void beginWrite(std::ostringstream& os, std::vector<std::string>& columns, const Value& value, const char* value_type);
 
     template<typename Value, typename ...Args>
-    void write(std::ostringstream& os, SessionDB::DBContext& db_context, const Value& value, const Args& ...args);
+    void bindRowToDB(SessionDB::DBContext& db_context, int column, const Value& value, const Args& ...args);
 
     template<typename Value>
-    void write(std::ostringstream& os, SessionDB::DBContext& db_context, const Value& value);
+    void bindRowToDB(SessionDB::DBContext& db_context, int column, const Value& value);
 
     template<typename Value, typename ...Args>
     void readRowFromDB(SessionDB::DBContext& db_context, int column, Value& value, Args& ...args);
@@ -122,6 +156,15 @@ namespace SmartPeak
 
     void updateSessionInfo(sqlite3* db);
 
+    bool beginTransaction(SessionDB::DBContext& db_context);
+
+    bool commitTransaction(SessionDB::DBContext& db_context);
+
+    /**
+     * @brief Rolls back the pending transaction (if any) and closes the DB.
+     */
+    void abortWrite(SessionDB::DBContext& db_context);
+
     void displaySessionInfo();
 
     void writeSessionInfo(sqlite3* db);
@@ -132,6 +175,7 @@ namespace SmartPeak
     std::filesystem::path session_file_name_;
     std::string smartpeak_version_ = "Unknown";
     bool session_info_logged_ = false;
+    bool wal_journal_mode_ = false;
   };
 
   template<typename Value, typename ...Args>
@@ -154,6 +198,13 @@ namespace SmartPeak
     db_context.table = table_name;
     db_context.db = *db;
 
+    // the whole table (drop, create and inserts) is written in one transaction
+    if (!beginTransaction(db_context))
+    {
+      closeSessionDB(*db);
+      return std::nullopt;
+    }
+
     // first, we delete table (to remove)
     os.str("");
     os << "DROP TABLE ";
@@ -162,6 +213,8 @@ namespace SmartPeak
     std::string sql = os.str();
     rc = sqlite3_exec(*db, sql.c_str(), NULL, 0, &zErrMsg);
     // -- ignore error
+    sqlite3_free(zErrMsg);
+    zErrMsg = nullptr;
 
     // create table
     os.str("");
@@ -177,6 +230,39 @@ namespace SmartPeak
     {
       logSQLError(zErrMsg, sql);
       sqlite3_free(zErrMsg);
+      abortWrite(db_context);
+      return std::nullopt;
+    }
+
+    // prepare the insert statement once, rows will only bind their values
+    os.str("");
+    os << "INSERT INTO ";
+    os << table_name;
+    os << " (";
+    for (size_t i = 0; i < db_context.columns.size(); ++i)
+    {
+      os << db_context.columns[i];
+      if (i < (db_context.columns.size() - 1))
+      {
+        os << ", ";
+      }
+    }
+    os << ") VALUES (";
+    for (size_t i = 0; i < db_context.columns.size(); ++i)
+    {
+      os << "?";
+      if (i < (db_context.columns.size() - 1))
+      {
+        os << ", ";
+      }
+    }
+    os << ");";
+    sql = os.str();
+    rc = sqlite3_prepare_v2(*db, sql.c_str(), sql.size(), &db_context.stmt, NULL);
+    if (rc != SQLITE_OK)
+    {
+      logSQLError(sqlite3_errmsg(*db), sql);
+      abortWrite(db_context);
       return std::nullopt;
     }
     return db_context;
@@ -203,46 +289,64 @@ namespace SmartPeak
   template<typename Value, typename ...Args>
   void SessionDB::write(SessionDB::DBContext& db_context, const Value& value, const Args& ...args)
   {
-    std::ostringstream os;
-    int rc;
-    char* zErrMsg = nullptr;
-
-    os << "INSERT INTO ";
-    os << db_context.table;
-    os << " (";
-    for (size_t i = 0; i < db_context.columns.size(); ++i)
+    if (!db_context.stmt)
     {
-      const auto& column = db_context.columns[i];
-      os << column;
-      if (i < (db_context.columns.size() - 1))
-      {
-        os << ", ";
-      }
+      LOGE << "SQL Error: no prepared statement to write into " << db_context.table;
+      return;
     }
-    os << ") ";
-    os << "VALUES (";
-    write(os, db_context, value, args...);
-    os << "); ";
-    std::string sql = os.str();
-    rc = sqlite3_exec(db_context.db, sql.c_str(), NULL, 0, &zErrMsg);
-    if (rc != SQLITE_OK) {
-      logSQLError(zErrMsg, sql);
-      sqlite3_free(zErrMsg);
+    bindRowToDB(db_context, 1, value, args...);
+    int rc = sqlite3_step(db_context.stmt);
+    if (rc != SQLITE_DONE)
+    {
+      logSQLError(sqlite3_errmsg(db_context.db), sqlite3_sql(db_context.stmt));
     }
+    sqlite3_reset(db_context.stmt);
   }
 
   template<typename Value, typename ...Args>
-  void SessionDB::write(std::ostringstream& os, SessionDB::DBContext& db_context, const Value& value, const Args& ...args)
+  void SessionDB::bindRowToDB(SessionDB::DBContext& db_context, int column, const Value& value, const Args& ...args)
   {
-    write(os, db_context, value);
-    os << ", ";
-    write(os, db_context, args...);
+    bindRowToDB(db_context, column, value);
+    bindRowToDB(db_context, column + 1, args...);
   }
 
   template<typename Value>
-  void SessionDB::write(std::ostringstream& os, SessionDB::DBContext& db_context, const Value& value)
+  void SessionDB::bindRowToDB(SessionDB::DBContext& db_context, int column, const Value& value)
   {
-    os << "'" << value << "'";
+    if constexpr (std::is_same_v<Value, bool>)
+    {
+      sqlite3_bind_int(db_context.stmt, column, value ? 1 : 0);
+    }
+    else if constexpr (std::is_integral_v<Value> || std::is_enum_v<Value>)
+    {
+      sqlite3_bind_int64(db_context.stmt, column, static_cast<sqlite3_int64>(value));
+    }
+    else if constexpr (std::is_floating_point_v<Value>)
+    {
+      sqlite3_bind_double(db_context.stmt, column, static_cast<double>(value));
+    }
+    else if constexpr (std::is_same_v<Value, std::string>)
+    {
+      // the statement is stepped before the bound string goes out of scope
+      sqlite3_bind_text(db_context.stmt, column, value.c_str(), static_cast<int>(value.size()), SQLITE_STATIC);
+    }
+    else if constexpr (std::is_convertible_v<const Value&, const char*>)
+    {
+      sqlite3_bind_text(db_context.stmt, column, value, -1, SQLITE_TRANSIENT);
+    }
+    else if constexpr (std::is_convertible_v<const Value&, std::string>)
+    {
+      // converted to a temporary, sqlite keeps its own copy
+      const std::string str = value;
+      sqlite3_bind_text(db_context.stmt, column, str.c_str(), static_cast<int>(str.size()), SQLITE_TRANSIENT);
+    }
+    else
+    {
+      std::ostringstream os;
+      os << value;
+      const std::string str = os.str();
+      sqlite3_bind_text(db_context.stmt, column, str.c_str(), static_cast<int>(str.size()), SQLITE_TRANSIENT);
+    }
   }
 
   template<typename Value, typename ...Args>
@@ -359,7 +463,4 @@ namespace SmartPeak
     readRowFromDB(db_context, column++, args...);
   }
 
-  template <>
-  void SessionDB::write<std::string>(std::ostringstream& os, SessionDB::DBContext& db_context, const std::string& value);
-
 }
@@ -10,6 +10,7 @@ set(sources_list_h
 	SequenceParser.h
 	SessionDB.h
 	InputDataValidation.h
+	FeatureMapBinaryFile.h
 )
 
 ### add path to the filenames
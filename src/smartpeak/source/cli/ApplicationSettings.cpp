@@ -78,6 +78,12 @@ void ApplicationSettings::define_options()
         "Override parameter. Ex: '-p MRMFeatureFinderScoring:TransitionGroupPicker:peak_integration=smoothed'.");
     m_parser.set_optional<int>("nt", "nb-threads", 0,
         "Number of threads used to run the workflow. 0 means use as many as possible.");
+    m_parser.set_optional<std::string>("pf", "profile", "",
+        "The path to a JSON file where to write the time and memory used by each processor on each injection, "
+        "sequence segment and sample group, with per processor percentiles. Nothing is written if empty.");
+    m_parser.set_optional<int>("mb", "memory-budget", 0,
+        "Memory budget in MB for the raw MS data of the injections. The raw MS data no next step needs, "
+        "and the least recently processed ones above the budget, are spilled to disk. 0 means no budget.");
     m_parser.run_and_exit_if_error();
 }
 
@@ -101,6 +107,8 @@ void ApplicationSettings::load_options()
     mzml_dir                = m_parser.get<std::string>("z");
     reports_out_dir         = m_parser.get<std::string>("ro");
     nb_threads              = m_parser.get<int>("nt");
+    profile                 = m_parser.get<std::string>("pf");
+    memory_budget           = m_parser.get<int>("mb");
 }
 
 void ApplicationSettings::process_options()
@@ -31,6 +31,7 @@
 #include <SmartPeak/core/ApplicationProcessors/BuildCommandsFromNames.h>
 #include <SmartPeak/core/ApplicationProcessors/LoadSession.h>
 
+#include <algorithm>
 #include <filesystem>
 
 
@@ -380,6 +381,7 @@ namespace SmartPeak {
         {
           number_of_threads = std::thread::hardware_concurrency();
         }
+        application_handler.raw_data_residency_options_.memory_budget_mb = std::max(application_settings.memory_budget, 0);
         workflow_manager.addWorkflow(
           application_handler,
           injection_names,
@@ -403,6 +405,12 @@ namespace SmartPeak {
             std::this_thread::sleep_for(rate);
             show_progress(progress_info, 40);
           }
+          workflow_manager.updateApplicationHandler(application_handler);
+        }
+
+        if (!application_settings.profile.empty())
+        {
+          application_handler.processor_profiler_->writeJSON(application_settings.profile);
         }
       }
       catch (const std::exception& e)
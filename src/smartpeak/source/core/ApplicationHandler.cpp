@@ -56,7 +56,10 @@
 
 namespace SmartPeak
 {
-  ApplicationHandler::ApplicationHandler()
+  ApplicationHandler::ApplicationHandler() :
+    thread_pool_(std::make_shared<ThreadPool>()),
+    processor_profiler_(std::make_shared<ProcessorProfiler>()),
+    data_preparation_pool_(std::make_shared<DataPreparationPool>())
   {
     sequenceHandler_.addParametersObserver(this);
     sequenceHandler_.addWorkflowObserver(this);
@@ -135,6 +138,13 @@ namespace SmartPeak
     session_loader_generator.clear();
   }
   
+  ApplicationHandler ApplicationHandler::snapshot() const
+  {
+    ApplicationHandler application_handler(*this);
+    application_handler.sequenceHandler_ = sequenceHandler_.snapshot();
+    return application_handler;
+  }
+
   bool ApplicationHandler::sessionIsOpened() const
   {
     return !filenames_.getFileIds().empty();
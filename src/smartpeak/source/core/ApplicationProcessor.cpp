@@ -22,7 +22,8 @@
 // --------------------------------------------------------------------------
 
 #include <SmartPeak/core/ApplicationProcessor.h>
-#include <SmartPeak/core/SequenceProcessor.h>
+#include <SmartPeak/core/WorkflowScheduler.h>
+#include <algorithm>
 
 namespace SmartPeak
 {
@@ -45,26 +46,6 @@ namespace SmartPeak
 
   namespace ApplicationProcessors {
 
-  template<typename COMMANDS_LIST_TYPE>
-  void notifyStartCommands(ApplicationProcessorObservable& observable, size_t start_index, const COMMANDS_LIST_TYPE& commands)
-  {
-    for (const auto command : commands)
-    {
-      observable.notifyApplicationProcessorCommandStart(start_index, command->getName());
-      start_index++;
-    }
-  }
-
-  template<typename COMMANDS_LIST_TYPE>
-  void notifyEndCommands(ApplicationProcessorObservable& observable, size_t start_index, const COMMANDS_LIST_TYPE& commands)
-  {
-    for (const auto command : commands)
-    {
-      observable.notifyApplicationProcessorCommandEnd(start_index, command->getName());
-      start_index++;
-    }
-  }
-
   void processCommands(ApplicationHandler& application_handler,
     std::vector<ApplicationHandler::Command> commands,
     const std::set<std::string>& injection_names, 
@@ -86,101 +67,25 @@ namespace SmartPeak
     }
     observable.notifyApplicationProcessorStart(commands_names);
 
-    size_t i = 0;
-    while (i < commands.size()) {
-      const ApplicationHandler::Command::CommandType type = commands[i].type;
-      size_t j = i + 1;
-      for (; j < commands.size() && type == commands[j].type; ++j) {
-        // empty body
-      }
-      const ApplicationHandler::Command& cmd = commands[i];
-      if (cmd.type == ApplicationHandler::Command::RawDataMethod) {
-        std::vector<std::shared_ptr<RawDataProcessor>> raw_methods;
-        std::map<std::string, Filenames> filenames;
-        std::for_each(commands.begin() + i, commands.begin() + j,
-          [&](const ApplicationHandler::Command& command) 
-        { 
-          raw_methods.push_back(command.raw_data_method);
-          for (const auto& filename_to_merge : command.dynamic_filenames)
-          {
-            if (filenames.find(filename_to_merge.first) == filenames.end())
-            {
-              filenames.emplace(filename_to_merge.first, filename_to_merge.second);
-            }
-            else
-            {
-              filenames.at(filename_to_merge.first).merge(filename_to_merge.second);
-            }
-          }
-        });
-        ProcessSequence ps(application_handler.sequenceHandler_, sequence_processor_observer);
-        ps.filenames_ = filenames;
-        ps.raw_data_processing_methods_ = raw_methods;
-        ps.injection_names_ = injection_names;
-        ps.number_of_threads_ = number_of_threads;
-        notifyStartCommands<decltype(raw_methods)>(observable, i, raw_methods);
-        ps.process(application_handler.filenames_);
-        notifyEndCommands<decltype(raw_methods)>(observable, i, raw_methods);
-      } else if (cmd.type == ApplicationHandler::Command::SequenceSegmentMethod) {
-        std::vector<std::shared_ptr<SequenceSegmentProcessor>> seq_seg_methods;
-        std::map<std::string, Filenames> filenames;
-        std::for_each(commands.begin() + i, commands.begin() + j,
-          [&](const ApplicationHandler::Command& command)
-        {
-          seq_seg_methods.push_back(command.seq_seg_method);
-          for (const auto& filename_to_merge : command.dynamic_filenames)
-          {
-            if (filenames.find(filename_to_merge.first) == filenames.end())
-            {
-              filenames.emplace(filename_to_merge.first, filename_to_merge.second);
-            }
-            else
-            {
-              filenames.at(filename_to_merge.first).merge(filename_to_merge.second);
-            }
-          }
-        });
-        ProcessSequenceSegments pss(application_handler.sequenceHandler_, sequence_segment_processor_observer);
-        pss.filenames_ = filenames;
-        pss.sequence_segment_processing_methods_ = seq_seg_methods;
-        pss.sequence_segment_names_ = sequence_segment_names;
-        pss.number_of_threads_ = number_of_threads;
-        notifyStartCommands<decltype(seq_seg_methods)>(observable, i, seq_seg_methods);
-        pss.process(application_handler.filenames_);
-        notifyEndCommands<decltype(seq_seg_methods)>(observable, i, seq_seg_methods);
-      } else if (cmd.type == ApplicationHandler::Command::SampleGroupMethod) {
-        std::vector<std::shared_ptr<SampleGroupProcessor>> sample_group_methods;
-        std::map<std::string, Filenames> filenames;
-        std::for_each(commands.begin() + i, commands.begin() + j,
-          [&](const ApplicationHandler::Command& command)
-        {
-          sample_group_methods.push_back(command.sample_group_method);
-          for (const auto& filename_to_merge : command.dynamic_filenames)
-          {
-            if (filenames.find(filename_to_merge.first) == filenames.end())
-            {
-              filenames.emplace(filename_to_merge.first, filename_to_merge.second);
-            }
-            else
-            {
-              filenames.at(filename_to_merge.first).merge(filename_to_merge.second);
-            }
-          }
-        });
-        ProcessSampleGroups psg(application_handler.sequenceHandler_, sample_group_processor_observer);
-        psg.filenames_ = filenames;
-        psg.sample_group_processing_methods_ = sample_group_methods;
-        psg.sample_group_names_ = sample_group_names;
-        psg.number_of_threads_ = number_of_threads;
-        notifyStartCommands<decltype(sample_group_methods)>(observable, i, sample_group_methods);
-        psg.process(application_handler.filenames_);
-        notifyEndCommands<decltype(sample_group_methods)>(observable, i, sample_group_methods);
-      }
-      else 
-      {
-        LOGW << "Skipping a command: " << cmd.type << "\n";
-      }
-      i = j;
+    WorkflowScheduler scheduler(application_handler.sequenceHandler_, &observable);
+    scheduler.addSequenceProcessorObserver(sequence_processor_observer);
+    scheduler.addSequenceSegmentProcessorObserver(sequence_segment_processor_observer);
+    scheduler.addSampleGroupProcessorObserver(sample_group_processor_observer);
+    scheduler.addProcessorProfileObserver(application_handler.processor_profiler_.get());
+    RawDataResidency raw_data_residency(application_handler.raw_data_residency_options_);
+    scheduler.setRawDataResidency(&raw_data_residency);
+    application_handler.sequenceHandler_.detachRawData();
+    scheduler.buildGraph(commands, injection_names, sequence_segment_names, sample_group_names);
+    scheduler.spawn_workers(number_of_threads, application_handler.thread_pool_.get());
+    if (raw_data_residency.isEnabled())
+    {
+      LOGI << "Raw data residency: peak " << (raw_data_residency.getPeakResidentBytes() >> 20) << " MB resident, "
+        << (raw_data_residency.getSpilledBytes() >> 20) << " MB spilled";
+    }
+    const auto& stages = scheduler.getStages();
+    if (std::any_of(stages.begin(), stages.end(), [](const auto& stage) { return stage.type == ApplicationHandler::Command::SequenceSegmentMethod; }))
+    {
+      application_handler.sequenceHandler_.notifySequenceUpdated();
     }
     observable.notifyApplicationProcessorEnd();
   }
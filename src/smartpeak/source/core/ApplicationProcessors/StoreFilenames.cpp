@@ -48,7 +48,10 @@ namespace SmartPeak
         embedded
       );
     }
-    application_handler_.filenames_.getSessionDB().endWrite(*db_context);
+    if (!application_handler_.filenames_.getSessionDB().endWrite(*db_context))
+    {
+      return false;
+    }
 
     db_context = application_handler_.filenames_.getSessionDB().beginWrite(
       "filenames_tags",
@@ -67,8 +70,7 @@ namespace SmartPeak
         application_handler_.filenames_.getTagValue(tag_name.second)
       );
     }
-    application_handler_.filenames_.getSessionDB().endWrite(*db_context);
-    return true;
+    return application_handler_.filenames_.getSessionDB().endWrite(*db_context);
   }
 
 }
@@ -0,0 +1,154 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/DecimationPyramid.h>
+
+#include <algorithm>
+
+namespace SmartPeak
+{
+  DecimationPyramid::DecimationPyramid(std::vector<float> x_data, std::vector<float> y_data) :
+    x_data_(std::move(x_data)),
+    y_data_(std::move(y_data))
+  {
+    const size_t nb_points = std::min(x_data_.size(), y_data_.size());
+    x_data_.resize(nb_points);
+    y_data_.resize(nb_points);
+
+    // level 1 from the points, then each level from the previous one
+    std::vector<Bucket> level;
+    level.reserve((nb_points + 1) / 2);
+    for (size_t i = 0; i + 1 < nb_points; i += 2)
+    {
+      const auto lo = static_cast<uint32_t>(y_data_[i + 1] < y_data_[i] ? i + 1 : i);
+      const auto hi = static_cast<uint32_t>(y_data_[i + 1] > y_data_[i] ? i + 1 : i);
+      level.emplace_back(lo, hi);
+    }
+    if (nb_points % 2)
+    {
+      level.emplace_back(static_cast<uint32_t>(nb_points - 1), static_cast<uint32_t>(nb_points - 1));
+    }
+    while (nb_points > 2)
+    {
+      levels_.push_back(std::move(level));
+      const auto& previous = levels_.back();
+      if (previous.size() <= 1)
+      {
+        break;
+      }
+      level.clear();
+      level.reserve((previous.size() + 1) / 2);
+      for (size_t i = 0; i < previous.size(); i += 2)
+      {
+        Bucket bucket = previous[i];
+        if (i + 1 < previous.size())
+        {
+          const Bucket& next = previous[i + 1];
+          if (y_data_[next.first] < y_data_[bucket.first]) bucket.first = next.first;
+          if (y_data_[next.second] > y_data_[bucket.second]) bucket.second = next.second;
+        }
+        level.push_back(bucket);
+      }
+    }
+  }
+
+  std::pair<size_t, size_t> DecimationPyramid::getIndexRange(float x_min, float x_max) const
+  {
+    const auto first = std::lower_bound(x_data_.begin(), x_data_.end(), x_min);
+    const auto last = std::upper_bound(first, x_data_.end(), x_max);
+    return { static_cast<size_t>(first - x_data_.begin()), static_cast<size_t>(last - x_data_.begin()) };
+  }
+
+  DecimationPyramid::Bucket DecimationPyramid::getBucket(size_t level, size_t bucket, size_t first, size_t last) const
+  {
+    const size_t begin = bucket << level;
+    const size_t end = std::min(begin + (size_t(1) << level), x_data_.size());
+    if (begin >= first && end <= last)
+    {
+      return levels_.at(level - 1).at(bucket);
+    }
+    // bucket cut by the range bounds
+    Bucket result { static_cast<uint32_t>(std::max(begin, first)), static_cast<uint32_t>(std::max(begin, first)) };
+    for (size_t i = result.first + 1; i < std::min(end, last); ++i)
+    {
+      if (y_data_[i] < y_data_[result.first]) result.first = static_cast<uint32_t>(i);
+      if (y_data_[i] > y_data_[result.second]) result.second = static_cast<uint32_t>(i);
+    }
+    return result;
+  }
+
+  void DecimationPyramid::decimate(size_t first, size_t last, size_t max_nb_points, std::vector<float>& x_out, std::vector<float>& y_out) const
+  {
+    x_out.clear();
+    y_out.clear();
+    last = std::min(last, x_data_.size());
+    if (first >= last)
+    {
+      return;
+    }
+    if (max_nb_points == 0 || last - first <= max_nb_points || levels_.empty())
+    {
+      x_out.assign(x_data_.begin() + first, x_data_.begin() + last);
+      y_out.assign(y_data_.begin() + first, y_data_.begin() + last);
+      return;
+    }
+
+    // the finest level giving no more than max_nb_points points
+    size_t level = 1;
+    auto nb_buckets = [&](size_t level) { return ((last - 1) >> level) - (first >> level) + 1; };
+    while (level < levels_.size() && 2 * nb_buckets(level) > max_nb_points)
+    {
+      ++level;
+    }
+
+    x_out.reserve(2 * nb_buckets(level));
+    y_out.reserve(2 * nb_buckets(level));
+    for (size_t bucket = first >> level; bucket <= ((last - 1) >> level); ++bucket)
+    {
+      const auto [lo, hi] = getBucket(level, bucket, first, last);
+      const auto first_index = std::min(lo, hi);
+      const auto second_index = std::max(lo, hi);
+      x_out.push_back(x_data_[first_index]);
+      y_out.push_back(y_data_[first_index]);
+      if (second_index != first_index)
+      {
+        x_out.push_back(x_data_[second_index]);
+        y_out.push_back(y_data_[second_index]);
+      }
+    }
+  }
+
+  std::optional<DecimationPyramid::Extent> DecimationPyramid::getExtent(size_t first, size_t last) const
+  {
+    last = std::min(last, x_data_.size());
+    if (first >= last)
+    {
+      return std::nullopt;
+    }
+    // the decimated points keep the lowest and highest values
+    std::vector<float> x_decimated, y_decimated;
+    decimate(first, last, 1024, x_decimated, y_decimated);
+    const auto [y_min, y_max] = std::minmax_element(y_decimated.begin(), y_decimated.end());
+    return Extent{ x_data_[first], x_data_[last - 1], *y_min, *y_max };
+  }
+}
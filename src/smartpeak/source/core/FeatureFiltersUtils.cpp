@@ -111,7 +111,10 @@ namespace SmartPeak
             );
             inserted_rows.push_back(filenames.getSessionDB().getLastInsertedRowId(*db_context));
           }
-          filenames.getSessionDB().endWrite(*db_context);
+          if (!filenames.getSessionDB().endWrite(*db_context))
+          {
+            return;
+          }
           std::vector<const std::map<OpenMS::String, std::pair<double, double>>*> metadata_values;
           for (auto& comp : features_qc.component_qcs)
           {
@@ -190,7 +193,10 @@ namespace SmartPeak
             );
             inserted_rows.push_back(filenames.getSessionDB().getLastInsertedRowId(*db_context));
           }
-          filenames.getSessionDB().endWrite(*db_context);
+          if (!filenames.getSessionDB().endWrite(*db_context))
+          {
+            return;
+          }
           std::vector<const std::map<OpenMS::String, std::pair<double, double>>*> metadata_values;
           for (auto& comp : features_qc.component_group_qcs)
           {
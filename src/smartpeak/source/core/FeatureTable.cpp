@@ -0,0 +1,254 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/FeatureTable.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace SmartPeak
+{
+  namespace
+  {
+    struct StringInterner
+    {
+      std::mutex mutex;
+      std::unordered_map<std::string, FeatureTable::Id> ids;
+      std::vector<const std::string*> strings;
+    };
+
+    StringInterner& getStringInterner()
+    {
+      static StringInterner interner;
+      return interner;
+    }
+
+    // Meta values resolved once per table instead of once per feature (see SequenceHandler::getMetaValue)
+    enum class MetaValueKind { RT, MZ, INTENSITY, PEAK_AREA, VALIDATION, META, NOT_FLOAT };
+
+    struct MetaValueAccessor
+    {
+      MetaValueKind kind;
+      OpenMS::UInt index;
+    };
+
+    constexpr float nan_value = std::numeric_limits<float>::quiet_NaN();
+
+    MetaValueAccessor makeAccessor(const std::string& meta_value)
+    {
+      MetaValueAccessor accessor{ MetaValueKind::META, 0 };
+      if (meta_value == "RT") accessor.kind = MetaValueKind::RT;
+      else if (meta_value == "mz") accessor.kind = MetaValueKind::MZ;
+      else if (meta_value == "charge") accessor.kind = MetaValueKind::NOT_FLOAT;
+      else if (meta_value == "intensity") accessor.kind = MetaValueKind::INTENSITY;
+      else if (meta_value == "peak_area") accessor.kind = MetaValueKind::PEAK_AREA;
+      else if (meta_value == "validation") accessor.kind = MetaValueKind::VALIDATION;
+      if (accessor.kind == MetaValueKind::META || accessor.kind == MetaValueKind::VALIDATION)
+      {
+        accessor.index = OpenMS::MetaInfoInterface::metaRegistry().getIndex(meta_value);
+      }
+      return accessor;
+    }
+
+    float toFloat(const OpenMS::DataValue& value)
+    {
+      return (value.valueType() == OpenMS::DataValue::DOUBLE_VALUE) ? static_cast<float>(static_cast<double>(value)) : nan_value;
+    }
+
+    float getValue(
+      const MetaValueAccessor& accessor,
+      const OpenMS::Feature& feature,
+      const OpenMS::Feature& subordinate,
+      bool is_subordinate
+    )
+    {
+      switch (accessor.kind)
+      {
+      case MetaValueKind::RT: return static_cast<float>(feature.getRT());
+      case MetaValueKind::MZ: return static_cast<float>(feature.getMZ());
+      case MetaValueKind::INTENSITY: return static_cast<float>(feature.getIntensity());
+      case MetaValueKind::PEAK_AREA: return static_cast<float>(subordinate.getIntensity());
+      case MetaValueKind::VALIDATION:
+      {
+        // encoded for the subordinates only, as done by the data matrix exports
+        if (!is_subordinate) return nan_value;
+        if (!subordinate.metaValueExists(accessor.index)) return -2.0f;
+        const OpenMS::DataValue& validation = subordinate.getMetaValue(accessor.index);
+        if (validation.valueType() != OpenMS::DataValue::STRING_VALUE) return -2.0f;
+        const std::string validation_str = validation.toString();
+        if (validation_str == "TP") return 1.0f;
+        if (validation_str == "FP") return -1.0f;
+        return -2.0f;
+      }
+      case MetaValueKind::META:
+      {
+        // Prioritize the subordinate over the feature
+        if (subordinate.metaValueExists(accessor.index) && !subordinate.getMetaValue(accessor.index).isEmpty())
+        {
+          return toFloat(subordinate.getMetaValue(accessor.index));
+        }
+        if (feature.metaValueExists(accessor.index) && !feature.getMetaValue(accessor.index).isEmpty())
+        {
+          return toFloat(feature.getMetaValue(accessor.index));
+        }
+        return nan_value;
+      }
+      default: return nan_value;
+      }
+    }
+
+    bool isUsed(const OpenMS::Feature& feature, OpenMS::UInt used_index)
+    {
+      if (!feature.metaValueExists(used_index)) return true;
+      const std::string used = feature.getMetaValue(used_index).toString();
+      return !(used.empty() || used[0] == 'f' || used[0] == 'F');
+    }
+  }
+
+  FeatureTable::Id FeatureTable::intern(const std::string& str)
+  {
+    StringInterner& interner = getStringInterner();
+    std::lock_guard<std::mutex> lock(interner.mutex);
+    const auto inserted = interner.ids.emplace(str, static_cast<Id>(interner.strings.size()));
+    if (inserted.second)
+    {
+      interner.strings.push_back(&inserted.first->first);
+    }
+    return inserted.first->second;
+  }
+
+  const std::string& FeatureTable::getString(Id id)
+  {
+    StringInterner& interner = getStringInterner();
+    std::lock_guard<std::mutex> lock(interner.mutex);
+    return *interner.strings.at(id);
+  }
+
+  FeatureTable::FeatureTable(const OpenMS::FeatureMap& feature_map, const std::vector<std::string>& meta_values)
+    : meta_values_(meta_values),
+      columns_(meta_values.size())
+  {
+    std::vector<MetaValueAccessor> accessors;
+    accessors.reserve(meta_values.size());
+    for (const auto& meta_value : meta_values)
+    {
+      accessors.push_back(makeAccessor(meta_value));
+    }
+    const OpenMS::UInt used_index = OpenMS::MetaInfoInterface::metaRegistry().getIndex("used_");
+    const OpenMS::UInt peptide_ref_index = OpenMS::MetaInfoInterface::metaRegistry().getIndex("PeptideRef");
+    const OpenMS::UInt native_id_index = OpenMS::MetaInfoInterface::metaRegistry().getIndex("native_id");
+    const Id no_component_id = intern("");
+
+    auto add_row = [&](const OpenMS::Feature& feature, const OpenMS::Feature& subordinate, Id component_group_id, Id component_id, bool is_subordinate)
+    {
+      component_group_ids_.push_back(component_group_id);
+      component_ids_.push_back(component_id);
+      is_subordinate_.push_back(is_subordinate);
+      for (size_t i = 0; i < accessors.size(); ++i)
+      {
+        columns_[i].push_back(getValue(accessors[i], feature, subordinate, is_subordinate));
+      }
+    };
+
+    for (const OpenMS::Feature& feature : feature_map)
+    {
+      if (!isUsed(feature, used_index))
+        continue;
+      const Id component_group_id = intern(feature.getMetaValue(peptide_ref_index).toString());
+      if (feature.getSubordinates().empty())
+      {
+        add_row(feature, feature, component_group_id, no_component_id, false);
+        continue;
+      }
+      for (const OpenMS::Feature& subordinate : feature.getSubordinates())
+      {
+        if (!isUsed(subordinate, used_index))
+          continue;
+        add_row(feature, subordinate, component_group_id, intern(subordinate.getMetaValue(native_id_index).toString()), true);
+      }
+    }
+  }
+
+  bool FeatureTable::hasColumn(const std::string& meta_value) const
+  {
+    return std::find(meta_values_.begin(), meta_values_.end(), meta_value) != meta_values_.end();
+  }
+
+  const std::vector<float>* FeatureTable::getColumn(const std::string& meta_value) const
+  {
+    const auto it = std::find(meta_values_.begin(), meta_values_.end(), meta_value);
+    return (it == meta_values_.end()) ? nullptr : &columns_[std::distance(meta_values_.begin(), it)];
+  }
+
+  FeatureTableCache::FeatureTableCache(const FeatureTableCache& other)
+  {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    table_ = other.table_;
+  }
+
+  FeatureTableCache& FeatureTableCache::operator=(const FeatureTableCache& other)
+  {
+    if (this != &other)
+    {
+      std::shared_ptr<const FeatureTable> table;
+      {
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        table = other.table_;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      table_ = table;
+    }
+    return *this;
+  }
+
+  std::shared_ptr<const FeatureTable> FeatureTableCache::get(const OpenMS::FeatureMap& feature_map, const std::vector<std::string>& meta_values) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> all_meta_values;
+    if (table_)
+    {
+      all_meta_values = table_->getMetaValues();
+    }
+    bool missing_meta_values = !table_;
+    for (const auto& meta_value : meta_values)
+    {
+      if (std::find(all_meta_values.begin(), all_meta_values.end(), meta_value) == all_meta_values.end())
+      {
+        all_meta_values.push_back(meta_value);
+        missing_meta_values = true;
+      }
+    }
+    if (missing_meta_values)
+    {
+      table_ = std::make_shared<const FeatureTable>(feature_map, all_meta_values);
+    }
+    return table_;
+  }
+
+  void FeatureTableCache::reset()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_.reset();
+  }
+}
@@ -33,6 +33,7 @@ namespace SmartPeak
 
   void InjectionHandler::clear()
   {
+    detachRawData();
     if (meta_data_!=nullptr) meta_data_->clear();
     if (raw_data_!=nullptr) raw_data_->clear();
   }
@@ -65,15 +66,18 @@ namespace SmartPeak
   void InjectionHandler::setRawData(const RawDataHandler& raw_data)
   {
     raw_data_.reset(new RawDataHandler(raw_data));
+    raw_data_copy_on_write_ = false;
   }
 
   void InjectionHandler::setRawData(std::shared_ptr<RawDataHandler>& raw_data)
   {
     raw_data_ = raw_data;
+    raw_data_copy_on_write_ = false;
   }
 
   RawDataHandler& InjectionHandler::getRawData()
   {
+    detachRawData();
     return *(raw_data_.get());
   }
 
@@ -81,8 +85,31 @@ namespace SmartPeak
   {
     return *(raw_data_.get());
   }
+
   std::shared_ptr<RawDataHandler>& InjectionHandler::getRawDataShared()
   {
+    detachRawData();
     return raw_data_;
   }
+
+  InjectionHandler InjectionHandler::snapshot() const
+  {
+    InjectionHandler injection(*this);
+    injection.raw_data_copy_on_write_ = true;
+    return injection;
+  }
+
+  void InjectionHandler::detachRawData()
+  {
+    if (!raw_data_copy_on_write_)
+    {
+      return;
+    }
+    // the raw data is only copied if the other injection is still alive
+    if (raw_data_ != nullptr && raw_data_.use_count() > 1)
+    {
+      raw_data_ = std::make_shared<RawDataHandler>(*raw_data_);
+    }
+    raw_data_copy_on_write_ = false;
+  }
 }
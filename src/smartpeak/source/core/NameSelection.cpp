@@ -0,0 +1,135 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/NameSelection.h>
+
+#include <algorithm>
+#include <bitset>
+
+namespace SmartPeak
+{
+  void NameSelection::setNames(const Eigen::Tensor<std::string, 2>& table, int column)
+  {
+    names_.clear();
+    ids_.clear();
+    row_ids_.clear();
+    if (column >= 0 && column < table.dimension(1))
+    {
+      row_ids_.resize(table.dimension(0), no_id);
+      for (int row = 0; row < table.dimension(0); ++row)
+      {
+        const std::string& name = table(row, column);
+        if (name.empty()) continue;
+        const auto inserted = ids_.emplace(name, names_.size());
+        if (inserted.second)
+        {
+          names_.push_back(name);
+        }
+        row_ids_[row] = inserted.first->second;
+      }
+    }
+    checked_rows_.assign(row_ids_.size(), false);
+    nb_checked_rows_.assign(names_.size(), 0);
+    bits_.assign((names_.size() + 63) / 64, 0);
+    ++version_;
+  }
+
+  bool NameSelection::setChecked(const Eigen::Tensor<bool, 2>& checkbox_body, int column)
+  {
+    const size_t n_rows = (column >= 0 && column < checkbox_body.dimension(1))
+      ? std::min<size_t>(row_ids_.size(), checkbox_body.dimension(0))
+      : 0;
+    bool changed = false;
+    for (size_t row = 0; row < row_ids_.size(); ++row)
+    {
+      const bool checked = (row < n_rows) && checkbox_body(row, column);
+      if (checked != checked_rows_[row])
+      {
+        changed |= updateRow(row, checked);
+      }
+    }
+    if (changed)
+    {
+      ++version_;
+    }
+    return changed;
+  }
+
+  bool NameSelection::updateRow(size_t row, bool checked)
+  {
+    checked_rows_[row] = checked;
+    const size_t id = row_ids_[row];
+    if (id == no_id)
+    {
+      return false;
+    }
+    size_t& nb_checked_rows = nb_checked_rows_[id];
+    nb_checked_rows = checked ? nb_checked_rows + 1 : nb_checked_rows - 1;
+    // the selection of the name changes with its first checked row and its last unchecked one
+    if (nb_checked_rows != (checked ? 1 : 0))
+    {
+      return false;
+    }
+    bits_[id / 64] ^= uint64_t(1) << (id % 64);
+    return true;
+  }
+
+  std::optional<size_t> NameSelection::getId(const std::string& name) const
+  {
+    const auto found = ids_.find(name);
+    if (found == ids_.end())
+    {
+      return std::nullopt;
+    }
+    return found->second;
+  }
+
+  bool NameSelection::isSelected(const std::string& name) const
+  {
+    const auto id = getId(name);
+    return id && isSelected(*id);
+  }
+
+  size_t NameSelection::getNbSelected() const
+  {
+    size_t nb_selected = 0;
+    for (const auto word : bits_)
+    {
+      nb_selected += std::bitset<64>(word).count();
+    }
+    return nb_selected;
+  }
+
+  std::vector<std::string> NameSelection::getSelectedNames() const
+  {
+    std::vector<std::string> selected_names;
+    for (size_t id = 0; id < names_.size(); ++id)
+    {
+      if (isSelected(id))
+      {
+        selected_names.push_back(names_[id]);
+      }
+    }
+    return selected_names;
+  }
+}
@@ -824,8 +824,29 @@ namespace SmartPeak
     }
   }
 
+  ParameterSet& ParameterSet::operator=(const ParameterSet& other)
+  {
+    if (this != &other)
+    {
+      invalidateViews();
+      function_parameters_ = other.function_parameters_;
+    }
+    return *this;
+  }
+
+  ParameterSet& ParameterSet::operator=(ParameterSet&& other)
+  {
+    if (this != &other)
+    {
+      invalidateViews();
+      function_parameters_ = std::move(other.function_parameters_);
+    }
+    return *this;
+  }
+
   void ParameterSet::merge(const ParameterSet& other)
   {
+    invalidateViews();
     for (auto& function_parameter : other)
     {
       if (function_parameters_.count(function_parameter.second.getFunctionName()))
@@ -841,6 +862,7 @@ namespace SmartPeak
 
   Parameter* ParameterSet::findParameter(const std::string& function_name, const std::string& parameter_name)
   {
+    invalidateViews();
     if (!function_parameters_.count(function_name))
     {
       return nullptr;
@@ -865,11 +887,13 @@ namespace SmartPeak
 
   void ParameterSet::clear()
   {
+    invalidateViews();
     function_parameters_.clear();
   }
 
   void ParameterSet::addParameter(const std::string& function_name, Parameter& parameter)
   {
+    invalidateViews();
     if (function_parameters_.count(function_name))
     {
       function_parameters_.at(function_name).addParameter(parameter);
@@ -884,11 +908,13 @@ namespace SmartPeak
 
   void ParameterSet::addFunctionParameters(FunctionParameters function_parameter)
   {
+    invalidateViews();
     function_parameters_[function_parameter.getFunctionName()] = function_parameter;
   }
 
   void ParameterSet::setAsSchema(bool is_schema)
   {
+    invalidateViews();
     for (auto& function_parameters : function_parameters_) {
       function_parameters.second.setAsSchema(is_schema);
     }
@@ -899,4 +925,154 @@ namespace SmartPeak
     return function_parameters_ == other.function_parameters_;
   }
 
+  std::shared_ptr<const ParameterSetView> ParameterSet::getView(const std::string& key, const std::function<ParameterSet()>& make_schema) const
+  {
+    std::lock_guard<std::mutex> lock(views_mutex_);
+    auto& view = views_[key];
+    if (!view)
+    {
+      view = std::make_shared<const ParameterSetView>(*this, make_schema());
+    }
+    return view;
+  }
+
+  void ParameterSet::invalidateViews()
+  {
+    std::lock_guard<std::mutex> lock(views_mutex_);
+    views_.clear();
+  }
+
+  ParameterSetView::ParameterSetView(const ParameterSet& user_parameters, const ParameterSet& schema)
+    : parameters_(user_parameters)
+  {
+    parameters_.merge(schema);
+    const ParameterSet& merged_parameters = parameters_;
+    for (const auto& function_parameters : merged_parameters)
+    {
+      auto& function_index = index_[function_parameters.first];
+      auto& function_values = values_[function_parameters.first];
+      for (const auto& parameter : function_parameters.second)
+      {
+        function_index[parameter.getName()] = &parameter;
+        const Parameter* schema_parameter = parameter.getSchema();
+        if (parameter.getValue().getTag() == CastValue::Type::UNINITIALIZED && schema_parameter)
+        {
+          function_values[parameter.getName()] = schema_parameter->getValue();
+        }
+        else
+        {
+          function_values[parameter.getName()] = parameter.getValue();
+          if (schema_parameter && !parameter.isValid())
+          {
+            LOGW << "Parameter " << function_parameters.first << ":" << parameter.getName()
+                 << " value " << parameter.getValueAsString() << " is not valid (" << parameter.getRestrictionsAsString() << ")";
+          }
+        }
+      }
+    }
+  }
+
+  const Parameter* ParameterSetView::findParameter(const std::string& function_name, const std::string& parameter_name) const
+  {
+    const auto function_index = index_.find(function_name);
+    if (function_index == index_.end())
+    {
+      return nullptr;
+    }
+    const auto parameter = function_index->second.find(parameter_name);
+    return (parameter == function_index->second.end()) ? nullptr : parameter->second;
+  }
+
+  const CastValue* ParameterSetView::findValue(const std::string& function_name, const std::string& parameter_name) const
+  {
+    const auto function_values = values_.find(function_name);
+    if (function_values == values_.end())
+    {
+      return nullptr;
+    }
+    const auto value = function_values->second.find(parameter_name);
+    return (value == function_values->second.end()) ? nullptr : &value->second;
+  }
+
+  const std::unordered_map<std::string, CastValue>& ParameterSetView::getValues(const std::string& function_name) const
+  {
+    static const std::unordered_map<std::string, CastValue> no_values;
+    const auto function_values = values_.find(function_name);
+    return (function_values == values_.end()) ? no_values : function_values->second;
+  }
+
+  bool ParameterSetView::getValue(const std::string& function_name, const std::string& parameter_name, bool default_value) const
+  {
+    const CastValue* value = findValue(function_name, parameter_name);
+    if (!value) return default_value;
+    switch (value->getTag())
+    {
+    case CastValue::Type::BOOL: return value->b_;
+    case CastValue::Type::INT: return value->i_ != 0;
+    case CastValue::Type::STRING:
+    {
+      std::string lowercase_value = value->s_;
+      std::transform(lowercase_value.begin(), lowercase_value.end(), lowercase_value.begin(), ::tolower);
+      if (lowercase_value == "true") return true;
+      if (lowercase_value == "false") return false;
+      return default_value;
+    }
+    default: return default_value;
+    }
+  }
+
+  int ParameterSetView::getValue(const std::string& function_name, const std::string& parameter_name, int default_value) const
+  {
+    const CastValue* value = findValue(function_name, parameter_name);
+    if (!value) return default_value;
+    switch (value->getTag())
+    {
+    case CastValue::Type::INT: return value->i_;
+    case CastValue::Type::LONG_INT: return static_cast<int>(value->li_);
+    case CastValue::Type::FLOAT: return static_cast<int>(value->f_);
+    case CastValue::Type::BOOL: return value->b_ ? 1 : 0;
+    case CastValue::Type::STRING:
+      try
+      {
+        return std::stoi(value->s_);
+      }
+      catch (const std::exception& e)
+      {
+        LOGE << function_name << ":" << parameter_name << " " << e.what();
+        return default_value;
+      }
+    default: return default_value;
+    }
+  }
+
+  float ParameterSetView::getValue(const std::string& function_name, const std::string& parameter_name, float default_value) const
+  {
+    const CastValue* value = findValue(function_name, parameter_name);
+    if (!value) return default_value;
+    switch (value->getTag())
+    {
+    case CastValue::Type::FLOAT: return value->f_;
+    case CastValue::Type::INT: return static_cast<float>(value->i_);
+    case CastValue::Type::LONG_INT: return static_cast<float>(value->li_);
+    case CastValue::Type::STRING:
+      try
+      {
+        return std::stof(value->s_);
+      }
+      catch (const std::exception& e)
+      {
+        LOGE << function_name << ":" << parameter_name << " " << e.what();
+        return default_value;
+      }
+    default: return default_value;
+    }
+  }
+
+  std::string ParameterSetView::getValue(const std::string& function_name, const std::string& parameter_name, const std::string& default_value) const
+  {
+    const CastValue* value = findValue(function_name, parameter_name);
+    if (!value || value->getTag() == CastValue::Type::UNINITIALIZED) return default_value;
+    return (value->getTag() == CastValue::Type::STRING) ? value->s_ : std::string(*value);
+  }
+
 }
@@ -0,0 +1,368 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/ProcessorProfiler.h>
+
+#include <plog/Log.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+#endif
+
+namespace SmartPeak
+{
+  namespace
+  {
+    std::string escapeJSON(const std::string& str)
+    {
+      std::ostringstream out;
+      for (const char c : str)
+      {
+        switch (c)
+        {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+          {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+          }
+          else
+          {
+            out << c;
+          }
+        }
+      }
+      return out.str();
+    }
+
+    ProcessorProfiler::Distribution makeDistribution(std::vector<double>& values)
+    {
+      ProcessorProfiler::Distribution distribution;
+      if (values.empty())
+      {
+        return distribution;
+      }
+      std::sort(values.begin(), values.end());
+      for (const double value : values)
+      {
+        distribution.total += value;
+      }
+      distribution.mean = distribution.total / values.size();
+      distribution.p50 = ProcessorProfiler::percentile(values, 50.0);
+      distribution.p90 = ProcessorProfiler::percentile(values, 90.0);
+      distribution.p99 = ProcessorProfiler::percentile(values, 99.0);
+      distribution.max = values.back();
+      return distribution;
+    }
+
+    void writeDistribution(std::ostream& out, const std::string& name, const ProcessorProfiler::Distribution& distribution)
+    {
+      out << "\"" << name << "\": {"
+        << "\"total\": " << distribution.total << ", "
+        << "\"mean\": " << distribution.mean << ", "
+        << "\"p50\": " << distribution.p50 << ", "
+        << "\"p90\": " << distribution.p90 << ", "
+        << "\"p99\": " << distribution.p99 << ", "
+        << "\"max\": " << distribution.max << "}";
+    }
+  }
+
+  void ProcessorProfiler::onProcessorProfile(const ProcessorProfileRecord& record)
+  {
+    std::lock_guard<std::mutex> lock(records_mutex_);
+    records_.push_back(record);
+  }
+
+  std::vector<ProcessorProfileRecord> ProcessorProfiler::getRecords() const
+  {
+    std::lock_guard<std::mutex> lock(records_mutex_);
+    return records_;
+  }
+
+  size_t ProcessorProfiler::size() const
+  {
+    std::lock_guard<std::mutex> lock(records_mutex_);
+    return records_.size();
+  }
+
+  void ProcessorProfiler::clear()
+  {
+    std::lock_guard<std::mutex> lock(records_mutex_);
+    records_.clear();
+  }
+
+  std::vector<ProcessorProfiler::Summary> ProcessorProfiler::getSummaries() const
+  {
+    struct Values
+    {
+      std::vector<double> wall_times;
+      std::vector<double> cpu_times;
+      Summary summary;
+    };
+    std::map<std::string, Values> values_per_processor;
+    {
+      std::lock_guard<std::mutex> lock(records_mutex_);
+      for (const auto& record : records_)
+      {
+        auto& values = values_per_processor[record.processor_name];
+        values.wall_times.push_back(record.wall_time_ms);
+        values.cpu_times.push_back(record.cpu_time_ms);
+        values.summary.max_rss_delta_kb = std::max(values.summary.max_rss_delta_kb, record.rss_delta_kb);
+        values.summary.peak_rss_kb = std::max(values.summary.peak_rss_kb, record.peak_rss_kb);
+        values.summary.total_item_count += record.item_count;
+      }
+    }
+
+    std::vector<Summary> summaries;
+    summaries.reserve(values_per_processor.size());
+    for (auto& [processor_name, values] : values_per_processor)
+    {
+      Summary summary = values.summary;
+      summary.processor_name = processor_name;
+      summary.count = values.wall_times.size();
+      summary.wall_time_ms = makeDistribution(values.wall_times);
+      summary.cpu_time_ms = makeDistribution(values.cpu_times);
+      summaries.push_back(summary);
+    }
+    std::stable_sort(summaries.begin(), summaries.end(), [](const Summary& a, const Summary& b) {
+      return a.wall_time_ms.total > b.wall_time_ms.total;
+    });
+    return summaries;
+  }
+
+  std::string ProcessorProfiler::toJSON() const
+  {
+    const auto records = getRecords();
+    const auto summaries = getSummaries();
+    std::ostringstream out;
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n  \"summaries\": [";
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+      const auto& summary = summaries[i];
+      out << (i ? ",\n" : "\n")
+        << "    {\"processor\": \"" << escapeJSON(summary.processor_name) << "\", "
+        << "\"count\": " << summary.count << ", ";
+      writeDistribution(out, "wall_time_ms", summary.wall_time_ms);
+      out << ", ";
+      writeDistribution(out, "cpu_time_ms", summary.cpu_time_ms);
+      out << ", \"max_rss_delta_kb\": " << summary.max_rss_delta_kb
+        << ", \"peak_rss_kb\": " << summary.peak_rss_kb
+        << ", \"item_count\": " << summary.total_item_count << "}";
+    }
+    out << "\n  ],\n  \"records\": [";
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+      const auto& record = records[i];
+      out << (i ? ",\n" : "\n")
+        << "    {\"processor\": \"" << escapeJSON(record.processor_name) << "\", "
+        << "\"item\": \"" << escapeJSON(record.item_name) << "\", "
+        << "\"item_type\": \"" << itemTypeToString(record.item_type) << "\", "
+        << "\"wall_time_ms\": " << record.wall_time_ms << ", "
+        << "\"cpu_time_ms\": " << record.cpu_time_ms << ", "
+        << "\"rss_delta_kb\": " << record.rss_delta_kb << ", "
+        << "\"peak_rss_kb\": " << record.peak_rss_kb << ", "
+        << "\"item_count\": " << record.item_count << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+  }
+
+  bool ProcessorProfiler::writeJSON(const std::filesystem::path& pathname) const
+  {
+    std::ofstream stream(pathname);
+    if (!stream.is_open())
+    {
+      LOGE << "Cannot write processor profile to " << pathname.generic_string();
+      return false;
+    }
+    stream << toJSON();
+    LOGI << "Processor profile written to " << pathname.generic_string();
+    return true;
+  }
+
+  ProcessorProfiler::Snapshot ProcessorProfiler::takeSnapshot()
+  {
+    Snapshot snapshot;
+    snapshot.wall_time = std::chrono::steady_clock::now();
+    snapshot.cpu_time_ms = getThreadCPUTimeMs();
+    snapshot.rss_kb = getCurrentRSSKb();
+    return snapshot;
+  }
+
+  ProcessorProfileRecord ProcessorProfiler::makeRecord(
+    const Snapshot& start,
+    const std::string& processor_name,
+    const std::string& item_name,
+    ProcessorProfileRecord::ItemType item_type,
+    size_t item_count)
+  {
+    const Snapshot end = takeSnapshot();
+    ProcessorProfileRecord record;
+    record.processor_name = processor_name;
+    record.item_name = item_name;
+    record.item_type = item_type;
+    record.wall_time_ms = std::chrono::duration<double, std::milli>(end.wall_time - start.wall_time).count();
+    record.cpu_time_ms = end.cpu_time_ms - start.cpu_time_ms;
+    record.rss_delta_kb = end.rss_kb - start.rss_kb;
+    record.peak_rss_kb = getPeakRSSKb();
+    record.item_count = item_count;
+    return record;
+  }
+
+  double ProcessorProfiler::percentile(const std::vector<double>& sorted_values, double p)
+  {
+    if (sorted_values.empty())
+    {
+      return 0.0;
+    }
+    const double rank = std::ceil(p / 100.0 * sorted_values.size());
+    const size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+    return sorted_values[std::min(index, sorted_values.size() - 1)];
+  }
+
+  std::string ProcessorProfiler::itemTypeToString(ProcessorProfileRecord::ItemType item_type)
+  {
+    switch (item_type)
+    {
+    case ProcessorProfileRecord::ItemType::Injection: return "Injection";
+    case ProcessorProfileRecord::ItemType::SequenceSegment: return "SequenceSegment";
+    case ProcessorProfileRecord::ItemType::SampleGroup: return "SampleGroup";
+    default: return "";
+    }
+  }
+
+  double ProcessorProfiler::getThreadCPUTimeMs()
+  {
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+    {
+      return 0.0;
+    }
+    const auto to_100ns = [](const FILETIME& t) {
+      return (static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+    };
+    return (to_100ns(kernel_time) + to_100ns(user_time)) / 10000.0;
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    {
+      return 0.0;
+    }
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+  }
+
+  double ProcessorProfiler::getProcessCPUTimeMs()
+  {
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time))
+    {
+      return 0.0;
+    }
+    const auto to_100ns = [](const FILETIME& t) {
+      return (static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+    };
+    return (to_100ns(kernel_time) + to_100ns(user_time)) / 10000.0;
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+    {
+      return 0.0;
+    }
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+  }
+
+  long ProcessorProfiler::getCurrentRSSKb()
+  {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+      return 0;
+    }
+    return static_cast<long>(counters.WorkingSetSize / 1024);
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+    {
+      return 0;
+    }
+    return static_cast<long>(info.resident_size / 1024);
+#else
+    std::ifstream statm("/proc/self/statm");
+    long size = 0, resident = 0;
+    if (!(statm >> size >> resident))
+    {
+      return 0;
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+  }
+
+  long ProcessorProfiler::getPeakRSSKb()
+  {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+      return 0;
+    }
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+      return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<long>(usage.ru_maxrss / 1024); // bytes on macOS
+#else
+    return static_cast<long>(usage.ru_maxrss);
+#endif
+#endif
+  }
+}
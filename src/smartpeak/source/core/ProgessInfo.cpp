@@ -64,7 +64,7 @@ namespace SmartPeak
 
   void ProgressInfo::onSequenceProcessorStart(const size_t nb_injections)
   {
-    running_batch_ = std::make_shared<RunningBatch>(nb_injections);
+    startRunningBatch(nb_injections);
   }
 
   void ProgressInfo::onSequenceProcessorSampleStart(const std::string& sample_name)
@@ -88,7 +88,7 @@ namespace SmartPeak
 
   void ProgressInfo::onSequenceSegmentProcessorStart(const size_t nb_segments)
   {
-    running_batch_ = std::make_shared<RunningBatch>(nb_segments);
+    startRunningBatch(nb_segments);
   }
 
   void ProgressInfo::onSequenceSegmentProcessorSampleStart(const std::string& segment_name)
@@ -112,7 +112,7 @@ namespace SmartPeak
 
   void ProgressInfo::onSampleGroupProcessorStart(const size_t nb_groups)
   {
-    running_batch_ = std::make_shared<RunningBatch>(nb_groups);
+    startRunningBatch(nb_groups);
   }
 
   void ProgressInfo::onSampleGroupProcessorSampleStart(const std::string& group_name)
@@ -134,6 +134,19 @@ namespace SmartPeak
     errors_.push_back(group_name + ", " + processor_name + ": " + error);
   }
 
+  void ProgressInfo::startRunningBatch(const size_t nb_items)
+  {
+    if (running_batch_ && running_batch_->current_step_ < running_batch_->max_steps_)
+    {
+      // stages of the workflow can overlap, the new items are added to the running batch
+      running_batch_->max_steps_ += nb_items;
+    }
+    else
+    {
+      running_batch_ = std::make_shared<RunningBatch>(nb_items);
+    }
+  }
+
   void ProgressInfo::onRunningBatchEndItem(const std::string& item_name)
   {
     running_batch_->running_items_.erase(std::remove(running_batch_->running_items_.begin(),
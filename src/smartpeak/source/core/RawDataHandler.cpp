@@ -22,8 +22,12 @@
 // --------------------------------------------------------------------------
 
 #include <SmartPeak/core/RawDataHandler.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
 #include <ctime> // time format
 #include <chrono> // current time
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 
 namespace SmartPeak
 {
@@ -41,23 +45,132 @@ namespace SmartPeak
     feature_background_qc_(std::make_shared<OpenMS::MRMFeatureQC>(OpenMS::MRMFeatureQC())),
     feature_rsd_estimations_(std::make_shared<OpenMS::MRMFeatureQC>(OpenMS::MRMFeatureQC())),
     feature_background_estimations_(std::make_shared<OpenMS::MRMFeatureQC>(OpenMS::MRMFeatureQC())),
-    spectra_library_(std::make_shared<OpenMS::MSExperiment>(OpenMS::MSExperiment()))
+    spectra_library_(std::make_shared<OpenMS::MSExperiment>(OpenMS::MSExperiment())),
+    spectra_library_index_(std::make_shared<SpectraLibraryIndex>())
   {
   }
 
+  namespace
+  {
+    /**
+      Spilled MS data file, removed when the last loader referencing it is gone
+    */
+    struct SpillFile
+    {
+      SpillFile(const std::filesystem::path& pathname, const std::shared_ptr<const void>& spill_dir) : pathname_(pathname), spill_dir_(spill_dir) {}
+      ~SpillFile()
+      {
+        std::error_code ec;
+        std::filesystem::remove(pathname_, ec);
+      }
+      std::filesystem::path pathname_;
+      std::shared_ptr<const void> spill_dir_; ///< released after the file is removed
+    };
+
+    size_t estimateMemoryUsage(const OpenMS::MSExperiment& experiment)
+    {
+      size_t bytes = sizeof(OpenMS::MSExperiment);
+      for (const auto& spectrum : experiment.getSpectra())
+      {
+        bytes += sizeof(OpenMS::MSSpectrum) + spectrum.capacity() * sizeof(OpenMS::Peak1D);
+        for (const auto& float_data : spectrum.getFloatDataArrays()) bytes += float_data.capacity() * sizeof(float);
+        for (const auto& integer_data : spectrum.getIntegerDataArrays()) bytes += integer_data.capacity() * sizeof(OpenMS::Int);
+      }
+      for (const auto& chromatogram : experiment.getChromatograms())
+      {
+        bytes += sizeof(OpenMS::MSChromatogram) + chromatogram.capacity() * sizeof(OpenMS::ChromatogramPeak);
+        for (const auto& float_data : chromatogram.getFloatDataArrays()) bytes += float_data.capacity() * sizeof(float);
+        for (const auto& integer_data : chromatogram.getIntegerDataArrays()) bytes += integer_data.capacity() * sizeof(OpenMS::Int);
+      }
+      return bytes;
+    }
+
+    uint64_t nextFeatureMapVersion()
+    {
+      static std::atomic<uint64_t> version{ 0 };
+      return ++version;
+    }
+
+    /// registry indices of the meta values used by the feature map history, resolved once
+    struct HistoryMetaIndices
+    {
+      OpenMS::UInt used;
+      OpenMS::UInt timestamp;
+      OpenMS::UInt native_id;
+      OpenMS::UInt peptide_ref;
+    };
+
+    const HistoryMetaIndices& historyMetaIndices()
+    {
+      static const HistoryMetaIndices indices{
+        OpenMS::MetaInfoInterface::metaRegistry().getIndex("used_"),
+        OpenMS::MetaInfoInterface::metaRegistry().getIndex("timestamp_"),
+        OpenMS::MetaInfoInterface::metaRegistry().getIndex("native_id"),
+        OpenMS::MetaInfoInterface::metaRegistry().getIndex("PeptideRef")
+      };
+      return indices;
+    }
+
+    std::string currentTimestamp()
+    {
+      std::chrono::time_point<std::chrono::system_clock> time_now = std::chrono::system_clock::now();
+      std::time_t time_now_t = std::chrono::system_clock::to_time_t(time_now);
+      std::tm now_tm = *std::localtime(&time_now_t);
+      char timestamp_char[64];
+      std::strftime(timestamp_char, 64, "%Y-%m-%d-%H-%M-%S", &now_tm);
+      return std::string(timestamp_char);
+    }
+
+    /// "used_" is set to the string "true"
+    bool isUsedTrue(const OpenMS::Feature& feature, OpenMS::UInt used_index)
+    {
+      if (!feature.metaValueExists(used_index)) return false;
+      const OpenMS::DataValue& used = feature.getMetaValue(used_index);
+      return used.valueType() == OpenMS::DataValue::STRING_VALUE && std::strcmp(used.toChar(), "true") == 0;
+    }
+
+    void setUsed(OpenMS::Feature& feature, const OpenMS::DataValue& used, const OpenMS::DataValue& timestamp, const HistoryMetaIndices& indices)
+    {
+      feature.setMetaValue(indices.used, used);
+      feature.setMetaValue(indices.timestamp, timestamp);
+    }
+
+    /// copy of the feature with other subordinates, the subordinates of the feature itself are not copied
+    OpenMS::Feature copyWithSubordinates(const OpenMS::Feature& feature, std::vector<OpenMS::Feature>&& subordinates)
+    {
+      OpenMS::Feature copy;
+      static_cast<OpenMS::BaseFeature&>(copy) = feature;
+      copy.setQuality(0, feature.getQuality(0));
+      copy.setQuality(1, feature.getQuality(1));
+      copy.setConvexHulls(feature.getConvexHulls());
+      copy.getSubordinates() = std::move(subordinates);
+      return copy;
+    }
+  }
+
   void RawDataHandler::setFeatureMap(const OpenMS::FeatureMap& feature_map)
   {
+    loadFeatureMaps();
     feature_map_ = feature_map;
+    feature_map_version_ = nextFeatureMapVersion();
   }
 
   OpenMS::FeatureMap& RawDataHandler::getFeatureMap()
   {
-    return feature_map_;
+    loadFeatureMaps();
+    feature_map_version_ = nextFeatureMapVersion();
+    return feature_map_.getMutable();
   }
 
   const OpenMS::FeatureMap& RawDataHandler::getFeatureMap() const
   {
-    return feature_map_;
+    loadFeatureMaps();
+    return feature_map_.get();
+  }
+
+  uint64_t RawDataHandler::getFeatureMapVersion() const
+  {
+    return feature_map_version_;
   }
 
   void RawDataHandler::setFeatureMap(const std::string& name, const OpenMS::FeatureMap& feature_map)
@@ -413,6 +526,7 @@ namespace SmartPeak
 
   OpenMS::MSExperiment& RawDataHandler::getSpectraLibrary()
   {
+    spectra_library_index_->clear(); // the library may be modified
     return *(spectra_library_.get());
   }
 
@@ -426,49 +540,81 @@ namespace SmartPeak
     return spectra_library_;
   }
 
+  void RawDataHandler::setSpectraLibraryIndex(std::shared_ptr<SpectraLibraryIndex>& spectra_library_index)
+  {
+    spectra_library_index_ = spectra_library_index;
+  }
+
+  SpectraLibraryIndex& RawDataHandler::getSpectraLibraryIndex() const
+  {
+    return *(spectra_library_index_.get());
+  }
+
+  std::shared_ptr<SpectraLibraryIndex>& RawDataHandler::getSpectraLibraryIndexShared()
+  {
+    return spectra_library_index_;
+  }
+
   void RawDataHandler::setFeatureMapHistory(const OpenMS::FeatureMap& feature_map_history)
   {
+    loadFeatureMaps();
     feature_map_history_ = feature_map_history;
+    feature_table_.reset();
   }
 
   OpenMS::FeatureMap& RawDataHandler::getFeatureMapHistory()
   {
-    return feature_map_history_;
+    loadFeatureMaps();
+    feature_table_.reset();
+    return feature_map_history_.getMutable();
   }
 
   const OpenMS::FeatureMap& RawDataHandler::getFeatureMapHistory() const
   {
-    return feature_map_history_;
+    loadFeatureMaps();
+    return feature_map_history_.get();
+  }
+
+  std::shared_ptr<const FeatureTable> RawDataHandler::getFeatureTable(const std::vector<std::string>& meta_values) const
+  {
+    loadFeatureMaps();
+    return feature_table_.get(feature_map_history_.get(), meta_values);
   }
 
   void RawDataHandler::setExperiment(const OpenMS::MSExperiment& experiment)
   {
+    discardMSDataLoader(experiment_loader_);
     experiment_ = experiment;
   }
 
   OpenMS::MSExperiment& RawDataHandler::getExperiment()
   {
-    return experiment_;
+    loadMSData(experiment_, experiment_loader_);
+    return experiment_.getMutable();
   }
 
   const OpenMS::MSExperiment& RawDataHandler::getExperiment() const
   {
-    return experiment_;
+    loadMSData(experiment_, experiment_loader_);
+    return experiment_.get();
   }
 
   void RawDataHandler::setChromatogramMap(const OpenMS::MSExperiment& chromatogram_map)
   {
+    discardMSDataLoader(chromatogram_map_loader_);
     chromatogram_map_ = chromatogram_map;
   }
 
   OpenMS::MSExperiment& RawDataHandler::getChromatogramMap()
   {
-    return chromatogram_map_;
+    loadMSData(chromatogram_map_, chromatogram_map_loader_);
+    return chromatogram_map_.getMutable();
   }
 
   const OpenMS::MSExperiment& RawDataHandler::getChromatogramMap() const
   {
-    return chromatogram_map_;
+    loadMSData(chromatogram_map_, chromatogram_map_loader_);
+    return chromatogram_map_.get();
   }
 
   void RawDataHandler::setTransformationDescription(const OpenMS::TransformationDescription& trafo)
@@ -488,17 +634,20 @@ namespace SmartPeak
 
   void RawDataHandler::setSWATH(const OpenMS::MSExperiment& swath)
   {
+    discardMSDataLoader(swath_loader_);
     swath_ = swath;
   }
 
   OpenMS::MSExperiment& RawDataHandler::getSWATH()
   {
-    return swath_;
+    loadMSData(swath_, swath_loader_);
+    return swath_.getMutable();
   }
 
   const OpenMS::MSExperiment& RawDataHandler::getSWATH() const
   {
-    return swath_;
+    loadMSData(swath_, swath_loader_);
+    return swath_.get();
   }
 
   void RawDataHandler::setValidationMetrics(const std::map<std::string, float>& validation_metrics)
@@ -531,14 +680,116 @@ namespace SmartPeak
     return mz_tab_;
   }
 
+  std::pair<RawDataHandler::MSDataPayload*, RawDataHandler::MSDataLoader*> RawDataHandler::getMSData(MSDataType type) const
+  {
+    switch (type)
+    {
+    case MSDataType::Experiment:
+      return { &experiment_, &experiment_loader_ };
+    case MSDataType::ChromatogramMap:
+      return { &chromatogram_map_, &chromatogram_map_loader_ };
+    case MSDataType::SWATH:
+    default:
+      return { &swath_, &swath_loader_ };
+    }
+  }
+
+  size_t RawDataHandler::spillMSData(MSDataType type, const std::filesystem::path& pathname, const std::shared_ptr<const void>& spill_dir)
+  {
+    auto [data, loader] = getMSData(type);
+    std::lock_guard<std::mutex> lock(loader->mutex_);
+    if (loader->pending_ || (data->get().getSpectra().empty() && data->get().getChromatograms().empty()))
+    {
+      return 0;
+    }
+    const size_t released_bytes = estimateMemoryUsage(data->get());
+    if (!pathname.empty())
+    {
+      auto spill_file = std::make_shared<SpillFile>(pathname, spill_dir); // a partially written file is removed if storing fails
+      // the default options write 32 bit intensities, the data must be loaded back unchanged
+      OpenMS::MzMLFile mzml_file;
+      mzml_file.getOptions().setMz32Bit(false);
+      mzml_file.getOptions().setIntensity32Bit(false);
+      mzml_file.store(pathname.generic_string(), data->get());
+      loader->load_ = [spill_file](OpenMS::MSExperiment& experiment) {
+        OpenMS::MzMLFile().load(spill_file->pathname_.generic_string(), experiment);
+      };
+      loader->pending_ = true;
+    }
+    data->reset(); // releases the capacity, unless a copy of this handler still refers to the data
+    return released_bytes;
+  }
+
+  bool RawDataHandler::isMSDataResident(MSDataType type) const
+  {
+    return !getMSData(type).second->pending_;
+  }
+
+  size_t RawDataHandler::getMSDataMemoryUsage(MSDataType type) const
+  {
+    auto [data, loader] = getMSData(type);
+    std::lock_guard<std::mutex> lock(loader->mutex_);
+    return loader->pending_ ? 0 : estimateMemoryUsage(data->get());
+  }
+
+  size_t RawDataHandler::getMSDataSize(MSDataType type) const
+  {
+    auto [data, loader] = getMSData(type);
+    std::lock_guard<std::mutex> lock(loader->mutex_);
+    return loader->pending_ ? 0 : data->get().getNrSpectra() + data->get().getNrChromatograms();
+  }
+
+  void RawDataHandler::loadMSData(MSDataPayload& data, MSDataLoader& loader) const
+  {
+    if (!loader.pending_)
+    {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(loader.mutex_);
+    if (!loader.pending_)
+    {
+      return; // loaded by another thread in the meantime
+    }
+    const auto load = std::move(loader.load_);
+    loader.load_ = nullptr;
+    try
+    {
+      load(data.getMutable());
+    }
+    catch (...)
+    {
+      data.reset();
+      loader.pending_ = false;
+      throw;
+    }
+    loader.pending_ = false;
+  }
+
+  void RawDataHandler::discardMSDataLoader(MSDataLoader& loader)
+  {
+    std::lock_guard<std::mutex> lock(loader.mutex_);
+    loader.load_ = nullptr;
+    loader.pending_ = false;
+  }
+
   void RawDataHandler::clear()
   {
-    experiment_.clear(true);
-    chromatogram_map_.clear(true);
+    discardMSDataLoader(experiment_loader_);
+    discardMSDataLoader(chromatogram_map_loader_);
+    discardMSDataLoader(swath_loader_);
+    experiment_.reset();
+    chromatogram_map_.reset();
     trafo_ = OpenMS::TransformationDescription();
-    swath_.clear(true);
-    feature_map_.clear(true);
-    feature_map_history_.clear(true);
+    swath_.reset();
+    {
+      std::lock_guard<std::mutex> lock(feature_map_loader_.mutex_);
+      feature_map_loader_.load_ = nullptr;
+      feature_map_loader_.pending_ = false;
+    }
+    feature_map_.reset();
+    feature_map_history_.reset();
+    feature_table_.reset();
+    feature_map_version_ = nextFeatureMapVersion();
     if (meta_data_!=nullptr) meta_data_->clear();
     validation_metrics_.clear();
     mz_tab_ = OpenMS::MzTab();
@@ -557,42 +808,54 @@ namespace SmartPeak
 
   void RawDataHandler::clearNonSharedData()
   {
-    experiment_.clear(true);
-    chromatogram_map_.clear(true);
+    discardMSDataLoader(experiment_loader_);
+    discardMSDataLoader(chromatogram_map_loader_);
+    discardMSDataLoader(swath_loader_);
+    experiment_.reset();
+    chromatogram_map_.reset();
     trafo_ = OpenMS::TransformationDescription();
-    swath_.clear(true);
-    feature_map_.clear(true);
-    feature_map_history_.clear(true);
+    swath_.reset();
+    {
+      std::lock_guard<std::mutex> lock(feature_map_loader_.mutex_);
+      feature_map_loader_.load_ = nullptr;
+      feature_map_loader_.pending_ = false;
+    }
+    feature_map_.reset();
+    feature_map_history_.reset();
+    feature_table_.reset();
+    feature_map_version_ = nextFeatureMapVersion();
     validation_metrics_.clear();
     mz_tab_ = OpenMS::MzTab();
   }
 
   void RawDataHandler::updateFeatureMapHistory()
   {
+    loadFeatureMaps();
+    feature_table_.reset();
+    OpenMS::FeatureMap& feature_map_history = feature_map_history_.getMutable();
+    const OpenMS::FeatureMap& feature_map = feature_map_.get();
+    const HistoryMetaIndices& indices = historyMetaIndices();
     // Current time stamp
-    std::chrono::time_point<std::chrono::system_clock> time_now = std::chrono::system_clock::now();
-    std::time_t time_now_t = std::chrono::system_clock::to_time_t(time_now);
-    std::tm now_tm = *std::localtime(&time_now_t);
-    char timestamp_char[64];
-    std::strftime(timestamp_char, 64, "%Y-%m-%d-%H-%M-%S", &now_tm);
-    std::string timestamp(timestamp_char);
+    const OpenMS::DataValue timestamp(currentTimestamp());
+    const OpenMS::DataValue used_true("true");
+    const OpenMS::DataValue used_false("false");
 
     // Case 1: Copy the current featuremap and timestamp
-    if (feature_map_history_.empty()) {
-      feature_map_history_ = feature_map_; // ensures PrimaryMSRunPath is copied
-      for (OpenMS::Feature& feature_new : feature_map_history_) {
-        if (!feature_new.metaValueExists("used_")) { // prevents overwriting feature_maps with existing "used_" attributes
-          feature_new.setMetaValue("used_", "true");
+    if (feature_map_history.empty()) {
+      feature_map_history = feature_map; // ensures PrimaryMSRunPath is copied
+      for (OpenMS::Feature& feature_new : feature_map_history) {
+        if (!feature_new.metaValueExists(indices.used)) { // prevents overwriting feature_maps with existing "used_" attributes
+          feature_new.setMetaValue(indices.used, used_true);
         }
-        if (!feature_new.metaValueExists("timestamp_")) { // prevents overwriting feature_maps with existing "timestamp_" attributes
-          feature_new.setMetaValue("timestamp_", timestamp);
+        if (!feature_new.metaValueExists(indices.timestamp)) { // prevents overwriting feature_maps with existing "timestamp_" attributes
+          feature_new.setMetaValue(indices.timestamp, timestamp);
         }
         for (OpenMS::Feature& subordinate_new : feature_new.getSubordinates()) {
-          if (!subordinate_new.metaValueExists("used_")) { // prevents overwriting feature_maps with existing "used_" attributes
-            subordinate_new.setMetaValue("used_", "true");
+          if (!subordinate_new.metaValueExists(indices.used)) { // prevents overwriting feature_maps with existing "used_" attributes
+            subordinate_new.setMetaValue(indices.used, used_true);
           }
-          if (!subordinate_new.metaValueExists("timestamp_")) { // prevents overwriting feature_maps with existing "timestamp_" attributes
-            subordinate_new.setMetaValue("timestamp_", timestamp);
+          if (!subordinate_new.metaValueExists(indices.timestamp)) { // prevents overwriting feature_maps with existing "timestamp_" attributes
+            subordinate_new.setMetaValue(indices.timestamp, timestamp);
           }
         }
       }
@@ -601,159 +864,222 @@ namespace SmartPeak
     // Case 2: "Remove" filtered/non-selected features and "Add" new features via "used_" and "timestamp_" feature metadata attributes
     else 
     {
-      std::vector<OpenMS::Feature> new_features;
-      std::set<OpenMS::UInt64> unique_ids_feat_history, unique_ids_feat_select; // Get all feature IDs
-      for (const OpenMS::Feature& feature_copy : feature_map_history_) {
-        unique_ids_feat_history.insert(feature_copy.getUniqueId());
+      // Index the features by unique id, sorted by (unique id, position) so that
+      // the first matching feature of the current map is found first
+      std::vector<OpenMS::UInt64> unique_ids_feat_history;
+      unique_ids_feat_history.reserve(feature_map_history.size());
+      for (const OpenMS::Feature& feature_copy : feature_map_history) {
+        unique_ids_feat_history.push_back(feature_copy.getUniqueId());
+      }
+      std::sort(unique_ids_feat_history.begin(), unique_ids_feat_history.end());
+      std::vector<std::pair<OpenMS::UInt64, size_t>> unique_ids_feat_select;
+      unique_ids_feat_select.reserve(feature_map.size());
+      for (size_t i = 0; i < feature_map.size(); ++i) {
+        unique_ids_feat_select.emplace_back(feature_map[i].getUniqueId(), i);
       }
-      for (const OpenMS::Feature& feature_select : feature_map_) {
-        unique_ids_feat_select.insert(feature_select.getUniqueId());
-        if (unique_ids_feat_history.count(feature_select.getUniqueId())) {
+      std::sort(unique_ids_feat_select.begin(), unique_ids_feat_select.end());
+
+      std::vector<OpenMS::Feature> new_features;
+      for (const OpenMS::Feature& feature_select : feature_map) {
+        if (std::binary_search(unique_ids_feat_history.cbegin(), unique_ids_feat_history.cend(), feature_select.getUniqueId())) {
           continue;
         }
         // New Feature
         OpenMS::Feature new_feature = feature_select;
-        new_feature.setMetaValue("used_", "true");
-        new_feature.setMetaValue("timestamp_", timestamp);
+        setUsed(new_feature, used_true, timestamp, indices);
         for (OpenMS::Feature& subordinate_new : new_feature.getSubordinates()) {
-          subordinate_new.setMetaValue("used_", "true");
-          subordinate_new.setMetaValue("timestamp_", timestamp);
+          setUsed(subordinate_new, used_true, timestamp, indices);
         }
-        new_features.push_back(new_feature); // add the new feature to the list; we will add them to the history at the end
+        new_features.push_back(std::move(new_feature)); // add the new feature to the list; we will add them to the history at the end
       }
 
-      for (OpenMS::Feature& feature_copy : feature_map_history_) {
-        if (unique_ids_feat_select.count(feature_copy.getUniqueId()) == 0) { // Removed feature
-          feature_copy.setMetaValue("used_", "false");
-          feature_copy.setMetaValue("timestamp_", timestamp);
+      std::vector<std::string> native_ids_sub_history, native_ids_sub_select;
+      for (OpenMS::Feature& feature_copy : feature_map_history) {
+        const auto selected = std::equal_range(
+          unique_ids_feat_select.cbegin(), unique_ids_feat_select.cend(),
+          std::make_pair(feature_copy.getUniqueId(), size_t(0)),
+          [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        if (selected.first == selected.second) { // Removed feature
+          setUsed(feature_copy, used_false, timestamp, indices);
           for (OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
-            subordinate_copy.setMetaValue("used_", "false");
-            subordinate_copy.setMetaValue("timestamp_", timestamp);
+            setUsed(subordinate_copy, used_false, timestamp, indices);
           }
           continue; // move on to the next feature in the history
         }
-        for (const OpenMS::Feature& feature_select : feature_map_) {
-          // skip feature if any of the following is true:
-          // - unique ids differ
-          // - peptide refs differ
-          if (feature_select.getUniqueId() != feature_copy.getUniqueId() ||
-              feature_select.getMetaValue("PeptideRef") !=
-               feature_copy.getMetaValue("PeptideRef")) {
+        // skip features of the current map whose peptide refs differ
+        const auto matching = std::find_if(selected.first, selected.second, [&](const auto& select) {
+          return feature_map[select.second].getMetaValue(indices.peptide_ref) == feature_copy.getMetaValue(indices.peptide_ref);
+        });
+        if (matching == selected.second) {
+          continue;
+        }
+        const OpenMS::Feature& feature_select = feature_map[matching->second];
+
+        // Matching feature
+        bool update_feature = false;
+        std::vector<OpenMS::Feature> new_subordinates;
+        // get the subordinate names (and not unique ids!)
+        native_ids_sub_history.clear();
+        for (const OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
+          native_ids_sub_history.push_back(subordinate_copy.getMetaValue(indices.native_id));
+        }
+        native_ids_sub_select.clear();
+        for (const OpenMS::Feature& subordinate_select : feature_select.getSubordinates()) {
+          native_ids_sub_select.push_back(subordinate_select.getMetaValue(indices.native_id));
+        }
+        const auto contains = [](const std::vector<std::string>& native_ids, const std::string& native_id) {
+          return std::find(native_ids.cbegin(), native_ids.cend(), native_id) != native_ids.cend();
+        };
+        for (size_t s = 0; s < feature_select.getSubordinates().size(); ++s) {
+          if (contains(native_ids_sub_history, native_ids_sub_select[s])) {
             continue;
           }
+          // New subordinate
+          OpenMS::Feature new_subordinate = feature_select.getSubordinates()[s];
+          setUsed(new_subordinate, used_true, timestamp, indices);
+          // add the new subordinate to the list; we will add them to the feature subordinate list at the end
+          new_subordinates.push_back(std::move(new_subordinate));
+          update_feature = true;
+        }
 
-          // Matching feature
-          OpenMS::Feature feature_tmp = feature_select; // Make a temporary feature based on the selected feature that will be later swapped for the feature in the history
-          bool update_feature = false;
-          std::vector<OpenMS::Feature> new_subordinates;
-          // get the unique subordinate names (and not unique ids!)
-          std::set<std::string> unique_ids_sub_history, unique_ids_sub_select;
-          for (const OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
-            unique_ids_sub_history.insert(subordinate_copy.getMetaValue("native_id"));
-          }
-          for (const OpenMS::Feature& subordinate_select : feature_select.getSubordinates()) {
-            unique_ids_sub_select.insert(subordinate_select.getMetaValue("native_id"));
-            if (unique_ids_sub_history.count(subordinate_select.getMetaValue("native_id"))) {
-              continue;
-            }
-            // New subordinate
-            OpenMS::Feature new_subordinate = subordinate_select;
-            new_subordinate.setMetaValue("used_", "true");
-            new_subordinate.setMetaValue("timestamp_", timestamp);
-            // add the new subordinate to the list; we will add them to the feature subordinate list at the end
-            new_subordinates.push_back(new_subordinate);
+        // Check the subordinates for changes
+        for (size_t h = 0; h < feature_copy.getSubordinates().size(); ++h) {
+          OpenMS::Feature& subordinate_copy = feature_copy.getSubordinates()[h];
+          if (!contains(native_ids_sub_select, native_ids_sub_history[h])) { // Removed subordinate
+            setUsed(subordinate_copy, used_false, timestamp, indices);
             update_feature = true;
+            continue; // move on to the next subordinate from the history
           }
-
-          // Check the subordinates for changes
-          for (OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
-            if (unique_ids_sub_select.count(subordinate_copy.getMetaValue("native_id")) == 0) { // Removed subordinate
-              subordinate_copy.setMetaValue("used_", "false");
-              subordinate_copy.setMetaValue("timestamp_", timestamp);
+          for (size_t s = 0; s < feature_select.getSubordinates().size(); ++s) {
+            const OpenMS::Feature& subordinate_select = feature_select.getSubordinates()[s];
+            if (subordinate_select.getUniqueId() == subordinate_copy.getUniqueId() &&
+                native_ids_sub_select[s] == native_ids_sub_history[h]) { // Matching subordinate
+              subordinate_copy = subordinate_select; // copy over changed meta values from the current feature map subordinate
+              if (!subordinate_copy.metaValueExists(indices.used))  // overwrite "used_" only if it does not exist
+                subordinate_copy.setMetaValue(indices.used, used_true);
+              subordinate_copy.setMetaValue(indices.timestamp, timestamp);
               update_feature = true;
-              continue; // move on to the next subordinate from the history
-            } 
-            for (const OpenMS::Feature& subordinate_select : feature_select.getSubordinates()) {
-              if (subordinate_select.getUniqueId() == subordinate_copy.getUniqueId() &&
-                  subordinate_select.getMetaValue("native_id") == subordinate_copy.getMetaValue("native_id")) { // Matching subordinate
-                subordinate_copy = subordinate_select; // copy over changed meta values from the current feature map subordinate
-                if (!subordinate_copy.metaValueExists("used_"))  // overwrite "used_" only if it does not exist
-                  subordinate_copy.setMetaValue("used_", "true");
-                subordinate_copy.setMetaValue("timestamp_", timestamp);
-                update_feature = true;
-                break; // break the loop and move on to the next subordinate from the history
-              }
+              break; // break the loop and move on to the next subordinate from the history
             }
           }
-          
-          // Case of no subordinates
-          if (feature_select.getSubordinates().size() <= 0) {
-            update_feature = true;
-          }
+        }
+        
+        // Case of no subordinates
+        if (feature_select.getSubordinates().size() <= 0) {
+          update_feature = true;
+        }
 
-          if (update_feature) { // copy over the updated subordinates and change the feature to the updated version
-            feature_tmp.setSubordinates(feature_copy.getSubordinates());
-            feature_copy = feature_tmp;
-            feature_copy.setMetaValue("used_", "true");
-            feature_copy.setMetaValue("timestamp_", timestamp);
-          }
-          if (new_subordinates.size()) { // append new subordinates to the existing subordinates list
-            for (OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
-              new_subordinates.insert(new_subordinates.begin(), subordinate_copy);
-            }
-            feature_copy.setSubordinates(new_subordinates);
-          }
-          break; // break the loop and move on to the next feature in the history
+        if (update_feature) { // copy over the updated subordinates and change the feature to the updated version
+          feature_copy = copyWithSubordinates(feature_map[matching->second], std::move(feature_copy.getSubordinates()));
+          setUsed(feature_copy, used_true, timestamp, indices);
+        }
+        if (new_subordinates.size()) { // prepend the existing subordinates, in reverse order, to the new subordinates
+          std::vector<OpenMS::Feature>& subordinates_copy = feature_copy.getSubordinates();
+          new_subordinates.insert(new_subordinates.begin(),
+            std::make_move_iterator(subordinates_copy.rbegin()), std::make_move_iterator(subordinates_copy.rend()));
+          subordinates_copy = std::move(new_subordinates);
         }
       }
 
       // Add in the new features to the feature history
-      if (new_features.size()) {
-        for (OpenMS::Feature& feature_new : new_features) {
-          feature_map_history_.push_back(feature_new);
-        }
+      for (OpenMS::Feature& feature_new : new_features) {
+        feature_map_history.push_back(std::move(feature_new));
       }
     }
   }
+
   void RawDataHandler::makeFeatureMapFromHistory()
   {
+    loadFeatureMaps();
+    feature_table_.reset();
+    feature_map_version_ = nextFeatureMapVersion();
+    feature_map_.reset(); // rebuilt from the history, no need to copy a shared one
+    makeFeatureMapFromHistory(feature_map_history_.getMutable(), feature_map_.getMutable());
+  }
+
+  void RawDataHandler::setFeatureMapHistoryLoader(const std::function<void(OpenMS::FeatureMap&)>& loader)
+  {
+    std::lock_guard<std::mutex> lock(feature_map_loader_.mutex_);
+    feature_map_.reset();
+    feature_map_history_.reset();
+    feature_table_.reset();
+    feature_map_loader_.load_ = loader;
+    feature_map_loader_.pending_ = static_cast<bool>(loader);
+    feature_map_version_ = nextFeatureMapVersion();
+  }
+
+  bool RawDataHandler::isFeatureMapHistoryLoadPending() const
+  {
+    return feature_map_loader_.pending_;
+  }
+
+  void RawDataHandler::loadFeatureMaps() const
+  {
+    if (!feature_map_loader_.pending_)
+    {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(feature_map_loader_.mutex_);
+    if (!feature_map_loader_.pending_)
+    {
+      return; // loaded by another thread in the meantime
+    }
+    const auto load = std::move(feature_map_loader_.load_);
+    feature_map_loader_.load_ = nullptr;
+    try
+    {
+      load(feature_map_history_.getMutable());
+      feature_map_.reset(); // rebuilt from the history, no need to copy a shared one
+      makeFeatureMapFromHistory(feature_map_history_.getMutable(), feature_map_.getMutable());
+      OpenMS::StringList primary_ms_run_path;
+      feature_map_history_.get().getPrimaryMSRunPath(primary_ms_run_path);
+      feature_map_.getMutable().setPrimaryMSRunPath(primary_ms_run_path);
+    }
+    catch (...)
+    {
+      feature_map_history_.reset();
+      feature_map_.reset();
+      feature_map_loader_.pending_ = false;
+      throw;
+    }
+    feature_map_loader_.pending_ = false;
+  }
+
+  void RawDataHandler::makeFeatureMapFromHistory(OpenMS::FeatureMap& feature_map_history, OpenMS::FeatureMap& feature_map)
+  {
+    const HistoryMetaIndices& indices = historyMetaIndices();
     // Current time stamp
-    std::chrono::time_point<std::chrono::system_clock> time_now = std::chrono::system_clock::now();
-    std::time_t time_now_t = std::chrono::system_clock::to_time_t(time_now);
-    std::tm now_tm = *std::localtime(&time_now_t);
-    char timestamp_char[64];
-    std::strftime(timestamp_char, 64, "%Y-%m-%d-%H-%M-%S", &now_tm);
-    std::string timestamp(timestamp_char);
-
-    feature_map_.clear();
-    for (OpenMS::Feature& feature_new : feature_map_history_) {
+    const OpenMS::DataValue timestamp(currentTimestamp());
+    const OpenMS::DataValue used_true("true");
+
+    feature_map.clear();
+    feature_map.reserve(feature_map_history.size());
+    for (OpenMS::Feature& feature_new : feature_map_history) {
       std::vector<OpenMS::Feature> subs;
       bool copy_feature = false;
 
       // Case 1a: No subordinates
-      if (feature_new.metaValueExists("used_") && feature_new.getMetaValue("used_").toString() == "true" && feature_new.getSubordinates().size() <= 0) {
+      if (isUsedTrue(feature_new, indices.used) && feature_new.getSubordinates().size() <= 0) {
         copy_feature = true;
       }
       // Case 1b: No subordinates and missing "used_"
-      else if (!feature_new.metaValueExists("used_") && feature_new.getSubordinates().size() <= 0) 
+      else if (!feature_new.metaValueExists(indices.used) && feature_new.getSubordinates().size() <= 0) 
       {
-        feature_new.setMetaValue("used_", "true");
-        feature_new.setMetaValue("timestamp_", timestamp);
+        setUsed(feature_new, used_true, timestamp, indices);
         copy_feature = true;
       }
       else 
       {
         // Case 2a: Subordinates
         for (OpenMS::Feature& subordinate_new : feature_new.getSubordinates()) {
-          if (subordinate_new.metaValueExists("used_") && subordinate_new.getMetaValue("used_").toString() == "true") {
+          if (isUsedTrue(subordinate_new, indices.used)) {
             subs.push_back(subordinate_new);
             copy_feature = true;
           }
           // Case 2b: Subordinates and missing "used_
-          else if (!subordinate_new.metaValueExists("used_")) 
+          else if (!subordinate_new.metaValueExists(indices.used)) 
           {
-            subordinate_new.setMetaValue("used_", "true");
-            subordinate_new.setMetaValue("timestamp_", timestamp);
+            setUsed(subordinate_new, used_true, timestamp, indices);
             subs.push_back(subordinate_new);
             copy_feature = true;
           }
@@ -761,9 +1087,7 @@ namespace SmartPeak
       }
       // Add the feature to the featureMap
       if (copy_feature) {
-        OpenMS::Feature f = feature_new;
-        f.setSubordinates(subs);
-        feature_map_.push_back(f);
+        feature_map.push_back(copyWithSubordinates(feature_new, std::move(subs)));
       }
     }
   }  
@@ -103,9 +103,9 @@ namespace SmartPeak
   ) const
   {
     getFilenames(filenames_I);
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    const ParameterSet& params = params_view->getParameterSet();
 
     float start = 0, stop = 0;
     if (params.count("FIAMS") && params.at("FIAMS").size())
@@ -22,16 +22,19 @@
 // --------------------------------------------------------------------------
 #include <SmartPeak/core/RawDataProcessors/FitFeaturesEMG.h>
 #include <SmartPeak/core/Filenames.h>
+#include <SmartPeak/core/ThreadPool.h>
 #include <SmartPeak/core/Utilities.h>
 #include <SmartPeak/core/FeatureFiltersUtils.h>
 
 #include <OpenMS/MATH/MISC/EmgGradientDescent.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/PeakIntegrator.h>
+#include <OpenMS/METADATA/MetaInfoRegistry.h>
 
 #include <plog/Log.h>
 
 #include <algorithm>
 #include <exception>
+#include <unordered_map>
 
 namespace SmartPeak
 {
@@ -72,18 +75,22 @@ namespace SmartPeak
     const std::vector<OpenMS::MSChromatogram>& chromatograms {
       rawDataHandler_IO.getChromatogramMap().getChromatograms() };
 
-    auto getChromatogramByName = [&chromatograms](const OpenMS::String& name) -> const OpenMS::MSChromatogram&
+    // index the chromatograms by native ID once, the first one wins for duplicated IDs
+    std::unordered_map<std::string, const OpenMS::MSChromatogram*> chromatograms_by_name;
+    chromatograms_by_name.reserve(chromatograms.size());
+    for (const OpenMS::MSChromatogram& chromatogram : chromatograms) {
+      chromatograms_by_name.emplace(chromatogram.getNativeID(), &chromatogram);
+    }
+
+    // collect the subordinates to fit, all chromatograms are resolved before any feature is updated
+    struct EmgFit
     {
-      const std::vector<OpenMS::MSChromatogram>::const_iterator it =
-        std::find_if(chromatograms.cbegin(), chromatograms.cend(), [&name](const OpenMS::MSChromatogram& chrom){
-          return name == chrom.getNativeID();
-        });
-      if (it == chromatograms.cend()) {
-        throw std::string("Can't find a chromatogram with NativeID == ") + name;
-      }
-      return *it;
+      OpenMS::Feature* subfeature;
+      const OpenMS::MSChromatogram* chromatogram;
+      double left;
+      double right;
     };
-
+    std::vector<EmgFit> fits;
     for (OpenMS::Feature& feature : featureMap) {
       LOGD << "NEW FEATURE";
       const double left { feature.getMetaValue("leftWidth") };
@@ -92,77 +99,129 @@ namespace SmartPeak
       std::vector<OpenMS::Feature>& subordinates { feature.getSubordinates() };
       LOGD << "n. subordinates: " << subordinates.size();
       for (OpenMS::Feature& subfeature : subordinates) {
-        LOGD << "NEW SUBFEATURE";
         const OpenMS::String name = subfeature.getMetaValue("native_id");
-        LOGD << "Subordinate name: " << name;
-        const OpenMS::MSChromatogram& chromatogram = getChromatogramByName(name);
-        LOGD << "Chromatogram found!";
-        std::vector<double> x;
-        std::vector<double> y;
-        extractPointsIntoVectors(chromatogram, left, right, x, y);
-        LOGD << "Extracted n. points: " << x.size();
-
-        if (x.size() < 3) {
-          LOGD << "Less than 2 points. Skipping: " << name;
-          continue;
+        const auto chromatogram = chromatograms_by_name.find(name);
+        if (chromatogram == chromatograms_by_name.cend()) {
+          throw std::string("Can't find a chromatogram with NativeID == ") + name;
         }
+        fits.push_back({ &subfeature, chromatogram->second, left, right });
+      }
+    }
 
-        // EMG parameter estimation with gradient descent
-        double h, mu, sigma, tau;
-        LOGD << "Estimating EMG parameters...";
-        emg.estimateEmgParameters(x, y, h, mu, sigma, tau);
+    // the meta value names are resolved before the parallel fits: registering a name is not thread safe
+    struct MetaIndices
+    {
+      OpenMS::UInt native_id;
+      OpenMS::UInt peak_apex_position;
+      OpenMS::UInt peak_apex_int;
+      OpenMS::UInt area_background_level;
+      OpenMS::UInt noise_background_level;
+    };
+    OpenMS::MetaInfoRegistry& registry = OpenMS::MetaInfoInterface::metaRegistry();
+    const MetaIndices indices {
+      registry.registerName("native_id"),
+      registry.registerName("peak_apex_position"),
+      registry.registerName("peak_apex_int"),
+      registry.registerName("area_background_level"),
+      registry.registerName("noise_background_level")
+    };
 
-        // Estimate the intensities for each point
+    auto fitSubordinate = [this, &emg, &fits, &indices](size_t i) {
+      // scratch buffers, reused by all the fits running on the same thread
+      struct Scratch
+      {
+        std::vector<double> x;
+        std::vector<double> y;
         std::vector<double> out_xs;
         std::vector<double> out_ys;
-        LOGD << "Applying estimated parameters...";
-        emg.applyEstimatedParameters(x, h, mu, sigma, tau, out_xs, out_ys);
-
-        // integrate area and estimate background, update the subfeature
-
-        LOGD << "emg peak # points: " << out_xs.size();
-        OpenMS::ConvexHull2D::PointArrayType hull_points(out_xs.size());
+        OpenMS::ConvexHull2D::PointArrayType hull_points;
         OpenMS::MSChromatogram emg_chrom;
-        for (size_t i = 0; i < out_xs.size(); ++i) {
-          emg_chrom.push_back(OpenMS::ChromatogramPeak(out_xs[i], out_ys[i]));
-          hull_points[i][0] = out_xs[i];
-          hull_points[i][1] = out_ys[i];
-        }
-        OpenMS::ConvexHull2D hull;
-        hull.addPoints(hull_points);
-        // Bug in OpenMS Feature::getConvexHulls() returns the bounding box
-        // when more than a single convex hull is detected, which does not allow for plotting.
-        //subfeature.getConvexHulls().push_back(hull); 
-        std::vector<OpenMS::ConvexHull2D> hulls{ hull };
-        subfeature.setConvexHulls(hulls);
-
         OpenMS::PeakIntegrator pi;
-        LOGD << "Updating ranges...";
-        emg_chrom.updateRanges();
-        LOGD << "Ranges updated.";
-        const double emg_chrom_left { emg_chrom.getMinRT() };
-        const double emg_chrom_right { emg_chrom.getMaxRT() };
-        LOGD << "Positions calculated.";
-        OpenMS::PeakIntegrator::PeakArea pa = pi.integratePeak(emg_chrom, emg_chrom_left, emg_chrom_right);
-        LOGD << "Area calculated.";
-        OpenMS::PeakIntegrator::PeakBackground pb = pi.estimateBackground(emg_chrom, emg_chrom_left, emg_chrom_right, pa.apex_pos);
-        LOGD << "Background calculated.";
-        double peak_integral { pa.area - pb.area };
-        double peak_apex_int { pa.height - pb.height };
-        if (peak_integral < 0) { peak_integral = 0; }
-        if (peak_apex_int < 0) { peak_apex_int = 0; }
-
-        LOGD << "Intensity: " << (double)subfeature.getIntensity() << "\t" << peak_integral;
-        LOGD << "peak_apex_position: " << subfeature.getMetaValue("peak_apex_position").DOUBLE_VALUE << "\t" << pa.apex_pos;
-        LOGD << "peak_apex_int: " << subfeature.getMetaValue("peak_apex_int").DOUBLE_VALUE << "\t" << peak_apex_int;
-        LOGD << "area_background_level: " << subfeature.getMetaValue("area_background_level").DOUBLE_VALUE << "\t" << pb.area;
-        LOGD << "noise_background_level: " << subfeature.getMetaValue("noise_background_level").DOUBLE_VALUE << "\t" << pb.height;
-
-        subfeature.setIntensity(peak_integral);
-        subfeature.setMetaValue("peak_apex_position", pa.apex_pos);
-        subfeature.setMetaValue("peak_apex_int", peak_apex_int);
-        subfeature.setMetaValue("area_background_level", pb.area);
-        subfeature.setMetaValue("noise_background_level", pb.height);
+      };
+      thread_local Scratch scratch;
+
+      OpenMS::Feature& subfeature = *fits[i].subfeature;
+      const OpenMS::String name = subfeature.getMetaValue(indices.native_id);
+      LOGD << "Subordinate name: " << name;
+      extractPointsIntoVectors(*fits[i].chromatogram, fits[i].left, fits[i].right, scratch.x, scratch.y);
+      LOGD << "Extracted n. points: " << scratch.x.size();
+
+      if (scratch.x.size() < 3) {
+        LOGD << "Less than 2 points. Skipping: " << name;
+        return;
+      }
+
+      // EMG parameter estimation with gradient descent
+      double h, mu, sigma, tau;
+      LOGD << "Estimating EMG parameters...";
+      emg.estimateEmgParameters(scratch.x, scratch.y, h, mu, sigma, tau);
+
+      // Estimate the intensities for each point
+      scratch.out_xs.clear();
+      scratch.out_ys.clear();
+      LOGD << "Applying estimated parameters...";
+      emg.applyEstimatedParameters(scratch.x, h, mu, sigma, tau, scratch.out_xs, scratch.out_ys);
+
+      // integrate area and estimate background, update the subfeature
+
+      const std::vector<double>& out_xs = scratch.out_xs;
+      const std::vector<double>& out_ys = scratch.out_ys;
+      LOGD << "emg peak # points: " << out_xs.size();
+      OpenMS::ConvexHull2D::PointArrayType& hull_points = scratch.hull_points;
+      hull_points.resize(out_xs.size());
+      OpenMS::MSChromatogram& emg_chrom = scratch.emg_chrom;
+      emg_chrom.clear(true);
+      emg_chrom.reserve(out_xs.size());
+      for (size_t p = 0; p < out_xs.size(); ++p) {
+        emg_chrom.push_back(OpenMS::ChromatogramPeak(out_xs[p], out_ys[p]));
+        hull_points[p][0] = out_xs[p];
+        hull_points[p][1] = out_ys[p];
+      }
+      OpenMS::ConvexHull2D hull;
+      hull.addPoints(hull_points);
+      // Bug in OpenMS Feature::getConvexHulls() returns the bounding box
+      // when more than a single convex hull is detected, which does not allow for plotting.
+      //subfeature.getConvexHulls().push_back(hull); 
+      std::vector<OpenMS::ConvexHull2D> hulls{ hull };
+      subfeature.setConvexHulls(hulls);
+
+      const OpenMS::PeakIntegrator& pi = scratch.pi;
+      LOGD << "Updating ranges...";
+      emg_chrom.updateRanges();
+      LOGD << "Ranges updated.";
+      const double emg_chrom_left { emg_chrom.getMinRT() };
+      const double emg_chrom_right { emg_chrom.getMaxRT() };
+      LOGD << "Positions calculated.";
+      OpenMS::PeakIntegrator::PeakArea pa = pi.integratePeak(emg_chrom, emg_chrom_left, emg_chrom_right);
+      LOGD << "Area calculated.";
+      OpenMS::PeakIntegrator::PeakBackground pb = pi.estimateBackground(emg_chrom, emg_chrom_left, emg_chrom_right, pa.apex_pos);
+      LOGD << "Background calculated.";
+      double peak_integral { pa.area - pb.area };
+      double peak_apex_int { pa.height - pb.height };
+      if (peak_integral < 0) { peak_integral = 0; }
+      if (peak_apex_int < 0) { peak_apex_int = 0; }
+
+      LOGD << "Intensity: " << (double)subfeature.getIntensity() << "\t" << peak_integral;
+      LOGD << "peak_apex_position: " << subfeature.getMetaValue(indices.peak_apex_position).DOUBLE_VALUE << "\t" << pa.apex_pos;
+      LOGD << "peak_apex_int: " << subfeature.getMetaValue(indices.peak_apex_int).DOUBLE_VALUE << "\t" << peak_apex_int;
+      LOGD << "area_background_level: " << subfeature.getMetaValue(indices.area_background_level).DOUBLE_VALUE << "\t" << pb.area;
+      LOGD << "noise_background_level: " << subfeature.getMetaValue(indices.noise_background_level).DOUBLE_VALUE << "\t" << pb.height;
+
+      subfeature.setIntensity(peak_integral);
+      subfeature.setMetaValue(indices.peak_apex_position, pa.apex_pos);
+      subfeature.setMetaValue(indices.peak_apex_int, peak_apex_int);
+      subfeature.setMetaValue(indices.area_background_level, pb.area);
+      subfeature.setMetaValue(indices.noise_background_level, pb.height);
+    };
+
+    // subordinates are independent, fit them in parallel when running on the thread pool
+    ThreadPool* thread_pool = ThreadPool::current();
+    if (thread_pool && fits.size() > 1) {
+      thread_pool->parallelFor(fits.size(), fitSubordinate);
+    }
+    else {
+      for (size_t i = 0; i < fits.size(); ++i) {
+        fitSubordinate(i);
       }
     }
     rawDataHandler_IO.updateFeatureMapHistory();
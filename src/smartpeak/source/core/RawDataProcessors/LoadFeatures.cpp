@@ -21,10 +21,12 @@
 // $Authors: Douglas McCloskey, Pasquale Domenico Colaianni $
 // --------------------------------------------------------------------------
 #include <SmartPeak/core/RawDataProcessors/LoadFeatures.h>
+#include <SmartPeak/core/RawDataProcessors/StoreFeatures.h>
 #include <SmartPeak/core/Filenames.h>
 #include <SmartPeak/core/Utilities.h>
 #include <SmartPeak/core/FeatureFiltersUtils.h>
 #include <SmartPeak/io/InputDataValidation.h>
+#include <SmartPeak/io/FeatureMapBinaryFile.h>
 
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 
@@ -32,6 +34,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <filesystem>
 
 namespace SmartPeak
 {
@@ -63,6 +66,40 @@ namespace SmartPeak
       throw std::invalid_argument("Failed to load input file");
     }
 
+    // Use the binary cache written by StoreFeatures when it has been made from the current featureXML
+    // (same size and modification time): the file is mapped now and the feature maps are materialized on first access
+    if (!filenames_I.isEmbedded("featureXML_i"))
+    {
+      const auto featurexml_path = filenames_I.getFullPath("featureXML_i");
+      const auto binary_path = StoreFeatures::getBinaryCachePath(featurexml_path);
+      std::error_code binary_ec;
+      if (std::filesystem::exists(binary_path, binary_ec))
+      {
+        try
+        {
+          const auto mapped_file = FeatureMapBinaryFile::map(binary_path.generic_string());
+          if (mapped_file->getSourceFile() != FeatureMapBinaryFile::SourceFile::fromPath(featurexml_path))
+          {
+            throw std::runtime_error("the featureXML file has changed");
+          }
+          const std::string primary_ms_run_path = rawDataHandler_IO.getMetaData().getFilename();
+          rawDataHandler_IO.setFeatureMapHistoryLoader(
+            [mapped_file, primary_ms_run_path](OpenMS::FeatureMap& feature_map_history)
+            {
+              mapped_file->materialize(feature_map_history);
+              // NOTE: setPrimaryMSRunPath() is needed for calculate_calibration
+              feature_map_history.setPrimaryMSRunPath({ primary_ms_run_path });
+            });
+          LOGD << "Features mapped from " << binary_path.generic_string();
+          return;
+        }
+        catch (const std::exception& e)
+        {
+          LOGW << "Ignoring feature cache " << binary_path.generic_string() << ": " << e.what();
+        }
+      }
+    }
+
     try {
       OpenMS::FeatureXMLFile featurexml;
       featurexml.load(filenames_I.getFullPath("featureXML_i").generic_string(), rawDataHandler_IO.getFeatureMapHistory());
@@ -77,9 +77,9 @@ namespace SmartPeak
   {
     getFilenames(filenames_I);
 
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    const ParameterSet& params = params_view->getParameterSet();
 
     if (!InputDataValidation::prepareToLoad(filenames_I, "msp", true))
     {
@@ -87,11 +87,15 @@ namespace SmartPeak
     }
 
     try {
-      // Load spectral library for downstream spectral matching
-      OpenMS::MSPGenericFile msp_file;
-      OpenMS::MSExperiment library;
-      msp_file.load(filenames_I.getFullPath("msp").generic_string(), library);
-      library.sortSpectra();
+      // Load spectral library for downstream spectral matching,
+      // injections loading the same file share the same library
+      auto library = rawDataHandler_IO.getSpectraLibraryIndex().getLibrary(
+        filenames_I.getFullPath("msp"),
+        [&filenames_I](OpenMS::MSExperiment& library) {
+          OpenMS::MSPGenericFile msp_file;
+          msp_file.load(filenames_I.getFullPath("msp").generic_string(), library);
+          library.sortSpectra();
+        });
       rawDataHandler_IO.setSpectraLibrary(library);
       if (spectra_library_observable_) spectra_library_observable_->notifySpectraLibraryUpdated();
     }
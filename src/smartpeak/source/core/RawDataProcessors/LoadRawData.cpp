@@ -114,18 +114,14 @@ namespace SmartPeak
     // we don't want to complete user parameters with schema
     // as mZML parameter, if empty (not user defined), will means to use default behavior.
     // same for ChromatogramExtractor parameter
+    // The typed values are resolved once for all the injections sharing these parameters.
+    const auto params_view = params_I.getView(getName(), []() { return ParameterSet(); });
 
     // # load chromatograms
     OpenMS::MSExperiment chromatograms;
     if (!filenames_I.getFullPath("mzML_i").empty()) {
       if (params_I.at("mzML").size()) {
-        // # convert parameters
-        std::map<std::string, CastValue> mzML_params;
-        for (auto& param : params_I.at("mzML")) {
-          CastValue c;
-          Utilities::castString(param.getValueAsString(), param.getType(), c);
-          mzML_params.emplace(param.getName(), c);
-        }
+        const auto& mzML_params = params_view->getValues("mzML");
         // Deal with ChromeleonFile format
         if (mzML_params.count("format") && mzML_params.at("format").s_ == "ChromeleonFile") {
           const size_t pos = filenames_I.getFullPath("mzML_i").generic_string().rfind(".");
@@ -171,13 +167,7 @@ namespace SmartPeak
 
     OpenMS::TargetedExperiment& targeted_exp = rawDataHandler_IO.getTargetedExperiment();
     if (params_I.at("ChromatogramExtractor").size()) {
-      // # convert parameters
-      std::map<std::string, CastValue> chromatogramExtractor_params;
-      for (auto& param : params_I.at("ChromatogramExtractor")) {
-        CastValue c;
-        Utilities::castString(param.getValueAsString(), param.getType(), c);
-        chromatogramExtractor_params.emplace(param.getName(), c);
-      }
+      const auto& chromatogramExtractor_params = params_view->getValues("ChromatogramExtractor");
       // # exctract chromatograms
       OpenMS::MSExperiment chromatograms_copy = chromatograms;
       chromatograms.clear(true);
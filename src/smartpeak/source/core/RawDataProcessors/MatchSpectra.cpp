@@ -63,18 +63,16 @@ namespace SmartPeak
     Filenames& filenames_I
   ) const
   {
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    const ParameterSet& params = params_view->getParameterSet();
 
     OpenMS::TargetedSpectraExtractor targeted_spectra_extractor;
     Utilities::setUserParameters(targeted_spectra_extractor, params);
 
-    // Compare
-    OpenMS::TargetedSpectraExtractor::BinnedSpectrumComparator cmp;
-    std::map<OpenMS::String, OpenMS::DataValue> options;
-    cmp.init(rawDataHandler_IO.getSpectraLibrary().getSpectra(), options);
-    targeted_spectra_extractor.targetedMatching(rawDataHandler_IO.getChromatogramMap().getSpectra(), cmp, rawDataHandler_IO.getFeatureMap("extracted_spectra"));
+    // Compare, the library spectra are binned once and shared by all the injections
+    const auto cmp = rawDataHandler_IO.getSpectraLibraryIndex().getComparator(rawDataHandler_IO.getSpectraLibraryShared());
+    targeted_spectra_extractor.targetedMatching(rawDataHandler_IO.getChromatogramMap().getSpectra(), *cmp, rawDataHandler_IO.getFeatureMap("extracted_spectra"));
 
     rawDataHandler_IO.setFeatureMap(rawDataHandler_IO.getFeatureMap("extracted_spectra"));
     rawDataHandler_IO.updateFeatureMapHistory();
@@ -22,6 +22,7 @@
 // --------------------------------------------------------------------------
 #include <SmartPeak/core/RawDataProcessors/MergeSpectra.h>
 #include <SmartPeak/core/Filenames.h>
+#include <SmartPeak/core/ThreadPool.h>
 #include <SmartPeak/core/Utilities.h>
 #include <SmartPeak/core/FeatureFiltersUtils.h>
 #include <SmartPeak/io/InputDataValidation.h>
@@ -32,6 +33,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <iterator>
 
 namespace SmartPeak
 {
@@ -105,9 +107,9 @@ namespace SmartPeak
   {
     getFilenames(filenames_I);
 
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    const ParameterSet& params = params_view->getParameterSet();
 
     float resolution = 0, max_mz = 0, bin_step = 0;
     if (params.count("FIAMS") && params.at("FIAMS").size()) {
@@ -147,45 +149,79 @@ namespace SmartPeak
     int n_bins = max_mz / bin_step;
     std::vector<float> mzs;
     std::vector<float> bin_sizes;
-    std::vector<std::vector<OpenMS::MSSpectrum>> binned_spectrum;
     mzs.reserve(n_bins);
     bin_sizes.reserve(n_bins);
-    binned_spectrum.resize(n_bins);
     for (int i = 0; i < n_bins; i++) {
       mzs.push_back((i + 1) * bin_step);
       bin_sizes.push_back(mzs.at(i) / (resolution * 4.0));
-      binned_spectrum.at(i).resize(rawDataHandler_IO.getExperiment().getSpectra().size());
     }
 
-    // Divide the spectra into mass ranges
-    for (int s = 0; s < rawDataHandler_IO.getExperiment().getSpectra().size(); ++s) {
-      const OpenMS::MSSpectrum spectrum = rawDataHandler_IO.getExperiment().getSpectra().at(s);
-      for (auto it = spectrum.begin(); it != spectrum.end(); ++it) {
-        for (int i = 0; i < mzs.size() - 1; ++i) {
-          if (it->getMZ() >= mzs.at(i) && it->getMZ() < mzs.at(i + 1)) {
-            binned_spectrum.at(i).at(s).push_back(*it);
+    // Divide the spectra into mass ranges, peaks in [mzs[i], mzs[i + 1]) go to the bin i.
+    // Each bin only keeps the parts of the spectra that have peaks in its range, in the spectra order.
+    const auto& spectra = rawDataHandler_IO.getExperiment().getSpectra();
+    const size_t n_merged_bins = mzs.size() > 1 ? mzs.size() - 1 : 0;
+    std::vector<std::vector<OpenMS::MSSpectrum>> binned_spectrum(n_merged_bins);
+    std::vector<size_t> last_spectrum_in_bin(n_merged_bins, spectra.size());
+    for (size_t s = 0; s < spectra.size(); ++s) {
+      size_t bin = n_merged_bins;
+      for (const auto& peak : spectra[s]) {
+        const auto mz = peak.getMZ();
+        // peaks are usually sorted, try the bin of the previous peak before searching
+        if (bin >= n_merged_bins || !(mz >= mzs[bin] && mz < mzs[bin + 1])) {
+          bin = std::distance(mzs.cbegin(), std::upper_bound(mzs.cbegin(), mzs.cend(), mz));
+          if (bin == 0 || bin > n_merged_bins) {
+            bin = n_merged_bins;
+            continue;
           }
+          --bin;
+        }
+        if (last_spectrum_in_bin[bin] != s) {
+          last_spectrum_in_bin[bin] = s;
+          binned_spectrum[bin].emplace_back();
         }
+        binned_spectrum[bin].back().push_back(peak);
       }
     }
 
     // Merge spectra along time for each of the different mass ranges
-    OpenMS::MSSpectrum output;
-    for (int i = 0; i < mzs.size() - 1; ++i) {
-      OpenMS::MSSpectrum full_spectrum = OpenMS::SpectrumAddition::addUpSpectra(
-        binned_spectrum.at(i), bin_sizes.at(i), false
+    std::vector<OpenMS::MSSpectrum> merged_spectrum(n_merged_bins);
+    auto mergeBin = [&](size_t i) {
+      auto& bin_spectra = binned_spectrum[i];
+      // empty spectra do not contribute to the sum, but a single spectrum is only resampled
+      // when it was merged with others
+      if (bin_spectra.size() == 1 && spectra.size() > 1) {
+        bin_spectra.emplace_back();
+      }
+      merged_spectrum[i] = OpenMS::SpectrumAddition::addUpSpectra(
+        bin_spectra, bin_sizes.at(i), false
       );
-      for (auto it = full_spectrum.begin(); it != full_spectrum.end(); ++it) {
-        output.push_back(*it);
+      std::vector<OpenMS::MSSpectrum>().swap(bin_spectra);
+    };
+    ThreadPool* thread_pool = ThreadPool::current();
+    if (thread_pool && n_merged_bins > 1) {
+      thread_pool->parallelFor(n_merged_bins, mergeBin);
+    }
+    else {
+      for (size_t i = 0; i < n_merged_bins; ++i) {
+        mergeBin(i);
       }
     }
+
+    OpenMS::MSSpectrum output;
+    size_t n_peaks = 0;
+    for (const auto& full_spectrum : merged_spectrum) {
+      n_peaks += full_spectrum.size();
+    }
+    output.reserve(n_peaks);
+    for (const auto& full_spectrum : merged_spectrum) {
+      output.insert(output.end(), full_spectrum.begin(), full_spectrum.end());
+    }
     output.sortByPosition();
 
     // Update the metavalue and members
     output.setNativeID("MergeSpectra");
     OpenMS::Peak1D::CoordinateType lowest_observed = 0.0;
     OpenMS::Peak1D::CoordinateType highest_observed = 0.0;
-    const auto& spectra = rawDataHandler_IO.getExperiment().getSpectra();
     if (spectra.size())
     {
       output.setMSLevel(spectra.front().getMSLevel());
@@ -112,52 +112,13 @@ namespace SmartPeak
   {
     getFilenames(filenames_I);
 
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
-    
-    float sn_window = 0;
-    bool compute_peak_shape_metrics = false;
-    float min_intensity = 0;
-    bool write_convex_hull = false;
-    for (const auto& pms1f_params : params.at("Pick2DFeatures")) {
-      if (pms1f_params.getName() == "sne:window") {
-        try {
-          sn_window = std::stof(pms1f_params.getValueAsString());
-        }
-        catch (const std::exception& e) {
-          LOGE << e.what();
-        }
-      }
-      if (pms1f_params.getName() == "write_convex_hull") {
-        try {
-          std::string value = pms1f_params.getValueAsString();
-          std::transform(value.begin(), value.end(), value.begin(), ::tolower);
-          write_convex_hull = (value == "true")?true:false;
-        }
-        catch (const std::exception& e) {
-          LOGE << e.what();
-        }
-      }
-      if (pms1f_params.getName() == "compute_peak_shape_metrics") {
-        try {
-          std::string value = pms1f_params.getValueAsString();
-          std::transform(value.begin(), value.end(), value.begin(), ::tolower);
-          compute_peak_shape_metrics = (value == "true") ? true : false;
-        }
-        catch (const std::exception& e) {
-          LOGE << e.what();
-        }
-      }
-      if (pms1f_params.getName() == "min_intensity") {
-        try {
-          min_intensity = std::stof(pms1f_params.getValueAsString());
-        }
-        catch (const std::exception& e) {
-          LOGE << e.what();
-        }
-      }
-    }
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+
+    const float sn_window = params_view->getValue("Pick2DFeatures", "sne:window", 0.0f);
+    const bool compute_peak_shape_metrics = params_view->getValue("Pick2DFeatures", "compute_peak_shape_metrics", false);
+    const float min_intensity = params_view->getValue("Pick2DFeatures", "min_intensity", 0.0f);
+    const bool write_convex_hull = params_view->getValue("Pick2DFeatures", "write_convex_hull", false);
     if (sn_window == 0) {
       throw std::invalid_argument("Missing sne : window parameter for Pick2DFeatures. Not picking.");
     }
@@ -65,9 +65,9 @@ namespace SmartPeak
     getFilenames(filenames_I);
     LOGI << "SearchAccurateMass input size: " << rawDataHandler_IO.getFeatureMap().size();
 
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    ParameterSet params(params_view->getParameterSet());
     std::filesystem::path main_path(filenames_I.getTagValue(Filenames::Tag::MAIN_DIR));
     Utilities::prepareFileParameterList(params, "AccurateMassSearchEngine", "db:mapping", main_path);
     Utilities::prepareFileParameterList(params, "AccurateMassSearchEngine", "db:struct", main_path);
@@ -25,6 +25,7 @@
 #include <SmartPeak/core/Utilities.h>
 #include <SmartPeak/core/FeatureFiltersUtils.h>
 #include <SmartPeak/io/InputDataValidation.h>
+#include <SmartPeak/io/FeatureMapBinaryFile.h>
 
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 
@@ -32,6 +33,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <filesystem>
 
 namespace SmartPeak
 {
@@ -69,8 +71,37 @@ namespace SmartPeak
     }
 
     // Store outfile as featureXML
+    const auto featurexml_path = filenames_I.getFullPath("featureXML_o");
     OpenMS::FeatureXMLFile featurexml;
-    featurexml.store(filenames_I.getFullPath("featureXML_o").generic_string(), rawDataHandler_IO.getFeatureMapHistory());
+    featurexml.store(featurexml_path.generic_string(), rawDataHandler_IO.getFeatureMapHistory());
+
+    // Store the binary cache next to the featureXML, used by LoadFeatures as long as the featureXML is unchanged
+    // (a stale cache is removed when the features cannot be cached)
+    const auto binary_path = getBinaryCachePath(featurexml_path);
+    bool stored = false;
+    try
+    {
+      stored = FeatureMapBinaryFile::store(
+        binary_path.generic_string(),
+        rawDataHandler_IO.getFeatureMapHistory(),
+        FeatureMapBinaryFile::SourceFile::fromPath(featurexml_path));
+    }
+    catch (const std::exception& e)
+    {
+      LOGW << "Failed to store feature cache " << binary_path.generic_string() << ": " << e.what();
+    }
+    if (!stored)
+    {
+      std::error_code ec;
+      std::filesystem::remove(binary_path, ec);
+    }
+  }
+
+  std::filesystem::path StoreFeatures::getBinaryCachePath(const std::filesystem::path& featurexml_path)
+  {
+    auto binary_path = featurexml_path;
+    binary_path.replace_extension(".featureBin");
+    return binary_path;
   }
 
 }
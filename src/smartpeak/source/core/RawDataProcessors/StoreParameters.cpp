@@ -101,7 +101,10 @@ namespace SmartPeak
             );
         }
       }
-      filenames_I.getSessionDB().endWrite(*db_context);
+      if (!filenames_I.getSessionDB().endWrite(*db_context))
+      {
+        throw std::runtime_error("Failed to save in session database");
+      }
     }
     else
     {
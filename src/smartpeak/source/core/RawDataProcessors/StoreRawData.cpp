@@ -36,6 +36,16 @@
 namespace SmartPeak
 {
 
+  std::set<std::string> StoreRawData::getInputs() const
+  {
+    return { "Experiment", "Chromatogram" };
+  }
+
+  std::set<std::string> StoreRawData::getOutputs() const
+  {
+    return { };
+  }
+
   void StoreRawData::getFilenames(Filenames& filenames) const
   {
     filenames.addFileName("mzML_i", "${MZML_INPUT_PATH}/${INPUT_MZML_FILENAME}.mzML");
@@ -131,7 +131,10 @@ namespace SmartPeak
           ref.at("area").f_
           );
       }
-      filenames_I.getSessionDB().endWrite(*db_context);
+      if (!filenames_I.getSessionDB().endWrite(*db_context))
+      {
+        throw std::runtime_error("Failed to save in session database");
+      }
     }
     else
     {
@@ -73,9 +73,9 @@ namespace SmartPeak
   ) const
   {
     getFilenames(filenames_I);
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    const ParameterSet& params = params_view->getParameterSet();
 
     OpenMS::FeatureMap mapped_features;
     std::map<std::string, float> validation_metrics; // keys: accuracy, recall, precision
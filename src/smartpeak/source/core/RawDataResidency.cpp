@@ -0,0 +1,224 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/RawDataResidency.h>
+#include <SmartPeak/core/Utilities.h>
+
+#include <plog/Log.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace SmartPeak
+{
+  namespace
+  {
+    const std::vector<std::pair<RawDataHandler::MSDataType, unsigned>> s_ms_data_types = {
+      { RawDataHandler::MSDataType::Experiment, RawDataResidency::ExperimentData },
+      { RawDataHandler::MSDataType::ChromatogramMap, RawDataResidency::ChromatogramMapData },
+      { RawDataHandler::MSDataType::SWATH, RawDataResidency::SWATHData }
+    };
+  }
+
+  RawDataResidency::RawDataResidency(const Options& options) :
+    options_(options)
+  {
+    const std::filesystem::path spill_dir = options_.spill_dir.empty() ? std::filesystem::temp_directory_path() : options_.spill_dir;
+    // the spilled files still referenced by raw data handlers keep the directory alive
+    spill_dir_ = std::shared_ptr<const std::filesystem::path>(
+      new std::filesystem::path(spill_dir / ("SmartPeak_raw_data_" + Utilities::makeUniqueStringFromTime())),
+      [](const std::filesystem::path* path)
+      {
+        std::error_code ec;
+        std::filesystem::remove_all(*path, ec);
+        delete path;
+      });
+  }
+
+  RawDataResidency::~RawDataResidency() = default;
+
+  unsigned RawDataResidency::getRequiredMSData(const std::set<std::string>& inputs)
+  {
+    unsigned ms_data = NoMSData;
+    if (inputs.count("Experiment") || inputs.count("Spectra")) ms_data |= ExperimentData;
+    if (inputs.count("Chromatogram") || inputs.count("Extracted Spectra")) ms_data |= ChromatogramMapData;
+    if (inputs.count("SWATH")) ms_data |= SWATHData;
+    return ms_data;
+  }
+
+  unsigned RawDataResidency::getRequiredMSData(const std::vector<std::shared_ptr<RawDataProcessor>>& methods)
+  {
+    unsigned ms_data = NoMSData;
+    for (const auto& method : methods)
+    {
+      ms_data |= getRequiredMSData(method->getInputs());
+    }
+    return ms_data;
+  }
+
+  void RawDataResidency::acquire(RawDataHandler& raw_data)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Entry& entry = entries_[&raw_data];
+    cv_.wait(lock, [&entry]() { return !entry.evicting; });
+    if (entry.in_lru)
+    {
+      lru_.erase(entry.lru_position);
+      entry.in_lru = false;
+    }
+    ++entry.pins;
+  }
+
+  void RawDataResidency::release(RawDataHandler& raw_data, const std::string& name, unsigned needed_ms_data)
+  {
+    // what the next steps do not read is released straight away
+    releaseMSData(raw_data, name, AllMSData & ~needed_ms_data, options_.spill_to_disk);
+    const size_t bytes = getMemoryUsage(raw_data);
+
+    std::vector<RawDataHandler*> victims;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Entry& entry = entries_[&raw_data];
+      entry.name = name;
+      resident_bytes_ = resident_bytes_ + bytes - std::min(entry.bytes, resident_bytes_);
+      entry.bytes = bytes;
+      peak_resident_bytes_ = std::max(peak_resident_bytes_, resident_bytes_);
+      if (entry.pins > 0)
+      {
+        --entry.pins;
+      }
+      if (entry.pins == 0 && bytes > 0 && !entry.in_lru)
+      {
+        entry.lru_position = lru_.insert(lru_.end(), &raw_data);
+        entry.in_lru = true;
+      }
+
+      // then the least recently released raw data, until the budget is met
+      if (options_.spill_to_disk)
+      {
+        const size_t budget_bytes = options_.memory_budget_mb * 1024 * 1024;
+        size_t expected_bytes = resident_bytes_;
+        while (expected_bytes > budget_bytes && !lru_.empty())
+        {
+          RawDataHandler* victim = lru_.front();
+          lru_.pop_front();
+          Entry& victim_entry = entries_[victim];
+          victim_entry.in_lru = false;
+          victim_entry.evicting = true;
+          expected_bytes -= std::min(victim_entry.bytes, expected_bytes);
+          victims.push_back(victim);
+        }
+      }
+    }
+
+    for (RawDataHandler* victim : victims)
+    {
+      std::string victim_name;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        victim_name = entries_[victim].name;
+      }
+      releaseMSData(*victim, victim_name, AllMSData, true);
+      const size_t victim_bytes = getMemoryUsage(*victim);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& victim_entry = entries_[victim];
+        resident_bytes_ = resident_bytes_ + victim_bytes - std::min(victim_entry.bytes, resident_bytes_);
+        victim_entry.bytes = victim_bytes;
+        victim_entry.evicting = false;
+        if (victim_bytes > 0 && victim_entry.pins == 0)
+        {
+          // could not be spilled, kept as the most recently released
+          victim_entry.lru_position = lru_.insert(lru_.end(), victim);
+          victim_entry.in_lru = true;
+        }
+      }
+      cv_.notify_all();
+    }
+  }
+
+  size_t RawDataResidency::getResidentBytes() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resident_bytes_;
+  }
+
+  size_t RawDataResidency::getPeakResidentBytes() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_resident_bytes_;
+  }
+
+  size_t RawDataResidency::getSpilledBytes() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spilled_bytes_;
+  }
+
+  size_t RawDataResidency::releaseMSData(RawDataHandler& raw_data, const std::string& name, unsigned ms_data, bool spill)
+  {
+    size_t released_bytes = 0;
+    for (const auto& [type, flag] : s_ms_data_types)
+    {
+      if (!(ms_data & flag) || raw_data.getMSDataMemoryUsage(type) == 0)
+      {
+        continue;
+      }
+      try
+      {
+        const auto pathname = spill ? makeSpillPathname(name, type) : std::filesystem::path();
+        released_bytes += raw_data.spillMSData(type, pathname, spill_dir_);
+      }
+      catch (const std::exception& e)
+      {
+        LOGE << "Failed to spill the raw data of " << name << ", keeping them in memory: " << e.what();
+      }
+    }
+    if (spill && released_bytes)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      spilled_bytes_ += released_bytes;
+    }
+    return released_bytes;
+  }
+
+  std::filesystem::path RawDataResidency::makeSpillPathname(const std::string& name, RawDataHandler::MSDataType type)
+  {
+    std::filesystem::create_directories(*spill_dir_);
+    std::string file_name = name;
+    std::replace_if(file_name.begin(), file_name.end(), [](const char c) { return !std::isalnum(static_cast<unsigned char>(c)); }, '_');
+    const char* suffix = (type == RawDataHandler::MSDataType::Experiment) ? "experiment"
+      : (type == RawDataHandler::MSDataType::ChromatogramMap) ? "chromatogram_map" : "swath";
+    return *spill_dir_ / (file_name + "_" + std::to_string(spill_counter_++) + "_" + suffix + ".mzML");
+  }
+
+  size_t RawDataResidency::getMemoryUsage(const RawDataHandler& raw_data)
+  {
+    size_t bytes = 0;
+    for (const auto& ms_data_type : s_ms_data_types)
+    {
+      bytes += raw_data.getMSDataMemoryUsage(ms_data_type.first);
+    }
+    return bytes;
+  }
+}
@@ -25,6 +25,9 @@
 #include <SmartPeak/core/FeatureMetadata.h>
 #include <SmartPeak/io/SelectDilutionsParser.h>
 
+#include <cmath>
+#include <stdexcept>
+
 namespace SmartPeak
 {
   std::set<std::string> MergeInjections::getInputs() const
@@ -116,9 +119,9 @@ namespace SmartPeak
   {
     getFilenames(filenames_I);
 
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    const ParameterSet& params = params_view->getParameterSet();
 
     // Extract out the parameters
     std::string scan_polarity_merge_rule; // Sum, Min, Max, Mean, WeightedMean
@@ -181,28 +184,34 @@ namespace SmartPeak
       throw std::invalid_argument("Parameters not found");
     }
 
-    // Get the injection names for all the different scan polarities, mass ranges and dilutions
+    // Index the injections of the sample group by their position
+    std::vector<const InjectionHandler*> injections;
+    for (const std::size_t& index : sampleGroupHandler_IO.getSampleIndices()) {
+      injections.push_back(&sequenceHandler_I.getSequence().at(index));
+    }
+
+    // Get the injections for all the different scan polarities, mass ranges and dilutions
     std::set<std::string> scan_polarities;
     std::set<std::pair<float, float>> scan_mass_ranges;
     std::set<float> dilution_factors;
-    std::map<mergeKeyType, std::vector<std::set<std::string>>> merge_keys_to_injection_name;
-    getMergeKeysToInjections(sampleGroupHandler_IO, sequenceHandler_I, scan_polarities, scan_mass_ranges, dilution_factors, merge_keys_to_injection_name);
+    InjectionSets injection_sets;
+    std::map<mergeKeyType, std::vector<size_t>> merge_keys_to_injection_sets;
+    getMergeKeysToInjections(injections, scan_polarities, scan_mass_ranges, dilution_factors, injection_sets, merge_keys_to_injection_sets);
 
     // Determine the ordering of merge
-    orderMergeKeysToInjections(scan_polarities, scan_mass_ranges, dilution_factors, merge_keys_to_injection_name);
+    orderMergeKeysToInjections(scan_polarities, scan_mass_ranges, dilution_factors, injection_sets, merge_keys_to_injection_sets);
 
-    // Organize the injection `FeatureMaps` into a map of std::pair<PeptideRef, native_id> with a value of
-    // a map of `feature_name` with a value of
-    // a map of a set of injection names with a value of the feature metadata value
-    std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>> component_to_feature_to_injection_to_values;
-    getComponentsToFeaturesToInjectionsToValues(sampleGroupHandler_IO, sequenceHandler_I, merge_subordinates, component_to_feature_to_injection_to_values);
+    // Organize the injection `FeatureMaps` into the values of each feature (the metadata)
+    // of each component (std::pair<PeptideRef, native_id>) for each set of injections
+    ComponentValues component_values;
+    getComponentsToFeaturesToInjectionsToValues(injections, merge_subordinates, injection_sets.sets.size(), component_values);
 
     // Select preferred dilution.
     // If the select_preferred_dilutions parameter is set to true,
     // we will remove from the features all components that are listed
     // in the file set by the select_preferred_dilutions_file and to which the
     // injection dilution does not correspond to the value set in the select_preferred_dilutions_file.
-    if (!selectDilutions(params, filenames_I, sequenceHandler_I, component_to_feature_to_injection_to_values))
+    if (!selectDilutions(params, filenames_I, injections, component_values))
     {
       return;
     }
@@ -217,8 +226,9 @@ namespace SmartPeak
                                                   scan_polarities_keys_tup,
                                                   scan_mass_ranges_keys_tup,
                                                   dilution_factors_keys_tup, 
-                                                  merge_keys_to_injection_name,
-                                                  component_to_feature_to_injection_to_values);
+                                                  injection_sets,
+                                                  merge_keys_to_injection_sets,
+                                                  component_values);
 
     // pass 2: mass ranges
     scan_mass_ranges_keys_tup = std::set<std::pair<float, float>>({std::make_pair(-1,-1)});
@@ -227,8 +237,9 @@ namespace SmartPeak
                                                   scan_polarities_keys_tup,
                                                   scan_mass_ranges_keys_tup,
                                                   dilution_factors_keys_tup,
-                                                  merge_keys_to_injection_name,
-                                                  component_to_feature_to_injection_to_values);
+                                                  injection_sets,
+                                                  merge_keys_to_injection_sets,
+                                                  component_values);
 
     // pass 3: scan polarities
     scan_polarities_keys_tup = std::set<std::string>({ "" });
@@ -237,27 +248,41 @@ namespace SmartPeak
                                                   scan_polarities_keys_tup,
                                                   scan_mass_ranges_keys_tup,
                                                   dilution_factors_keys_tup,
-                                                  merge_keys_to_injection_name,
-                                                  component_to_feature_to_injection_to_values);
+                                                  injection_sets,
+                                                  merge_keys_to_injection_sets,
+                                                  component_values);
 
     // Make the final merged feature
-    std::set<std::string> injection_names_set;
-    for (const std::size_t& index : sampleGroupHandler_IO.getSampleIndices()) {
-      injection_names_set.insert(sequenceHandler_I.getSequence().at(index).getMetaData().getInjectionName() );
-    }
     OpenMS::FeatureMap fmap;
-    makeFeatureMap(merge_subordinates, injection_names_set, component_to_feature_to_injection_to_values, fmap);
+    makeFeatureMap(merge_subordinates, injection_sets, component_values, fmap);
 
     sampleGroupHandler_IO.setFeatureMap(fmap);
 
     LOGI << "MergeInjections output size: " << fmap.size();
   }
 
+  size_t MergeInjections::InjectionSets::add(const std::set<size_t>& injections)
+  {
+    const auto inserted = indices.emplace(injections, sets.size());
+    if (inserted.second) {
+      sets.push_back(injections);
+    }
+    return inserted.first->second;
+  }
+
+  void MergeInjections::ComponentValues::resize(size_t nb_injection_sets)
+  {
+    nb_injection_sets_ = nb_injection_sets;
+    is_integer.assign(features.size(), 0);
+    values.assign(features.size() * nb_injection_sets_ * components.size(), 0.0f);
+    has_values.assign(values.size(), 0);
+  }
+
   bool MergeInjections::selectDilutions(
     const ParameterSet& params,
     const Filenames& filenames_I,
-    const SequenceHandler& sequenceHandler_I,
-    std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values)
+    const std::vector<const InjectionHandler*>& injections,
+    ComponentValues& component_values)
   {
     if (params.at("MergeInjections").findParameter("select_preferred_dilutions")->getValueAsString() == "true")
     {
@@ -276,116 +301,100 @@ namespace SmartPeak
         LOGE << "Failed to read select dilutions file [" << dilution_file.generic_string() << "] : " << e.what();
         return false;
       }
-      std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>> new_component_to_feature_to_injection_to_values;
-      for (const auto& component_to_feature_to_injection_to_value : component_to_feature_to_injection_to_values)
+      // Values are only set for the single injections at this stage (the first injection sets)
+      const size_t nb_components = component_values.components.size();
+      std::vector<char> preferred_injections(injections.size());
+      for (size_t c = 0; c < nb_components; ++c)
       {
-        const auto& component_key = component_to_feature_to_injection_to_value.first;
-        const auto& component_name = component_key.second;
-        if (select_dilution_map.count(component_name))
+        const auto& component_name = component_values.components.at(c).second;
+        if (!select_dilution_map.count(component_name))
+        {
+          continue;
+        }
+        const float preferred_dilution = select_dilution_map.at(component_name);
+        for (size_t i = 0; i < injections.size(); ++i)
         {
-          float preferred_dilution = select_dilution_map.at(component_name);
-          const auto& feature_map = component_to_feature_to_injection_to_value.second;
-          // 1st pass: get selected injections
-          std::set<std::set<std::string>> selected_injections;
-          for (const auto& feature : feature_map)
+          preferred_injections[i] = std::abs(injections[i]->getMetaData().dilution_factor - preferred_dilution) < 1e-6;
+        }
+        // 1st pass: look for values of injections with the preferred dilution
+        bool has_preferred_injections = false;
+        for (size_t f = 0; f < component_values.features.size() && !has_preferred_injections; ++f)
+        {
+          for (size_t i = 0; i < injections.size(); ++i)
           {
-            const auto& feature_name = feature.first;
-            const auto& injections_set_to_value = feature.second;
-            for (const auto& injections_set : injections_set_to_value)
+            if (preferred_injections[i] && component_values.has_values[component_values.offset(f, i) + c])
             {
-              std::set<std::string> selected_injections_set;
-              for (const auto& injection_name : injections_set.first)
-              {
-                // look for dilution of this injection
-                for (const auto& sample : sequenceHandler_I.getSequence())
-                {
-                  if (sample.getMetaData().getInjectionName() == injection_name)
-                  {
-                    float dilution = sample.getMetaData().dilution_factor;
-                    if (std::abs(dilution - preferred_dilution) < 1e-6)
-                    {
-                      selected_injections_set.insert(injection_name);
-                    }
-                  }
-                }
-              }
-              if (!selected_injections_set.empty())
-              {
-                selected_injections.insert(selected_injections_set);
-              }
+              has_preferred_injections = true;
+              break;
             }
           }
-          // 2nd pass: reconstruct the injection map
-          std::map<std::string, std::map<std::set<std::string>, float>> new_feature_map;
-          if (selected_injections.empty())
-          {
-            // if we haven't found preferred injection among this map, we just let it as it was.
-            new_feature_map = feature_map;
-          }
-          else
+        }
+        // if we haven't found preferred injection for this component, we just let it as it was.
+        if (!has_preferred_injections)
+        {
+          continue;
+        }
+        // 2nd pass: remove the values of the other injections
+        for (size_t f = 0; f < component_values.features.size(); ++f)
+        {
+          for (size_t i = 0; i < injections.size(); ++i)
           {
-            for (const auto& feature : feature_map)
+            if (!preferred_injections[i])
             {
-              const auto& injections_set_to_value = feature.second;
-              std::map<std::set<std::string>, float> new_injections_set_to_value;
-              for (const auto& injections_set : injections_set_to_value)
-              {
-                if (selected_injections.count(injections_set.first))
-                {
-                  new_injections_set_to_value.insert(injections_set);
-                }
-              }
-              new_feature_map.emplace(feature.first, new_injections_set_to_value);
+              component_values.has_values[component_values.offset(f, i) + c] = 0;
             }
           }
-          new_component_to_feature_to_injection_to_values.emplace(component_key, new_feature_map);
-        }
-        else
-        {
-          new_component_to_feature_to_injection_to_values.insert(component_to_feature_to_injection_to_value);
         }
       }
-      component_to_feature_to_injection_to_values = std::move(new_component_to_feature_to_injection_to_values);
     }
     return true;
   }
 
-  void MergeInjections::getMergeKeysToInjections(const SampleGroupHandler& sampleGroupHandler_IO,
-                                                 const SequenceHandler& sequenceHandler_I,
+  void MergeInjections::getMergeKeysToInjections(const std::vector<const InjectionHandler*>& injections,
                                                  std::set<std::string>& scan_polarities,
                                                  std::set<std::pair<float, float>>& scan_mass_ranges,
                                                  std::set<float>& dilution_factors,
-                                                 std::map<mergeKeyType, std::vector<std::set<std::string>>>& merge_keys_to_injection_name)
+                                                 InjectionSets& injection_sets,
+                                                 std::map<mergeKeyType, std::vector<size_t>>& merge_keys_to_injection_sets)
   {
-    for (const std::size_t& index : sampleGroupHandler_IO.getSampleIndices())
+    for (size_t i = 0; i < injections.size(); ++i)
     {
-      const auto& injection_metadata = sequenceHandler_I.getSequence().at(index).getMetaData();
+      const auto& injection_metadata = injections[i]->getMetaData();
       const auto key = std::make_tuple(injection_metadata.scan_polarity,
                                        std::make_pair(injection_metadata.scan_mass_low, injection_metadata.scan_mass_high),
                                        injection_metadata.dilution_factor);
-      merge_keys_to_injection_name.emplace(key, std::vector<std::set<std::string>>());
-      std::set<std::string> value({ injection_metadata.getInjectionName() });
-      merge_keys_to_injection_name.at(key).push_back(value);
+      merge_keys_to_injection_sets[key].push_back(injection_sets.add({ i }));
       scan_polarities.insert(injection_metadata.scan_polarity);
       scan_mass_ranges.insert(std::make_pair(injection_metadata.scan_mass_low, injection_metadata.scan_mass_high));
       dilution_factors.insert(injection_metadata.dilution_factor);
     }
   }
+
   void MergeInjections::orderMergeKeysToInjections(std::set<std::string>& scan_polarities,
                                                    const std::set<std::pair<float, float>>& scan_mass_ranges,
                                                    const std::set<float>& dilution_factors,
-                                                   std::map<mergeKeyType, std::vector<std::set<std::string>>>& merge_keys_to_injection_name)
+                                                   InjectionSets& injection_sets,
+                                                   std::map<mergeKeyType, std::vector<size_t>>& merge_keys_to_injection_sets)
   {
+    // merge the injection sets from a previous merge
+    auto get_merged_injection_set = [&injection_sets, &merge_keys_to_injection_sets](const mergeKeyType& key) {
+      std::set<size_t> injections_prev_merge;
+      for (const size_t injection_set : merge_keys_to_injection_sets.at(key)) {
+        injections_prev_merge.insert(injection_sets.sets.at(injection_set).cbegin(), injection_sets.sets.at(injection_set).cend());
+      }
+      return injection_sets.add(injections_prev_merge);
+    };
+
     // pass 1: dilutions
     for (const auto& scan_polarity : scan_polarities) {
       for (const auto& scan_mass_range : scan_mass_ranges) {
         const auto key = std::make_tuple(scan_polarity, scan_mass_range, -1);
-        merge_keys_to_injection_name.emplace(key, std::vector<std::set<std::string>>());
+        auto& injection_sets_to_merge = merge_keys_to_injection_sets[key];
         for (const auto& dilution_factor : dilution_factors) {
           const auto key_tmp = std::make_tuple(scan_polarity, scan_mass_range, dilution_factor);
-          if (merge_keys_to_injection_name.count(key_tmp) <= 0) continue;
-          for (const auto& injection_name_set : merge_keys_to_injection_name.at(key_tmp)) {
-            merge_keys_to_injection_name.at(key).push_back(injection_name_set);
+          if (merge_keys_to_injection_sets.count(key_tmp) <= 0) continue;
+          for (const size_t injection_set : merge_keys_to_injection_sets.at(key_tmp)) {
+            injection_sets_to_merge.push_back(injection_set);
           }
         }
       }
@@ -394,249 +403,308 @@ namespace SmartPeak
     // pass 2: mass ranges
     for (const auto& scan_polarity : scan_polarities) {
       const auto key = std::make_tuple(scan_polarity, std::make_pair(-1, -1), -1);
-      merge_keys_to_injection_name.emplace(key, std::vector<std::set<std::string>>());
+      merge_keys_to_injection_sets.emplace(key, std::vector<size_t>());
       for (const auto& scan_mass_range : scan_mass_ranges) {
         const auto key_tmp = std::make_tuple(scan_polarity, scan_mass_range, -1);
-        if (merge_keys_to_injection_name.count(key_tmp) <= 0) continue;
-        // merge the injection name sets from the previous merge
-        std::set<std::string> injection_names_prev_merge;
-        for (const auto& injection_name_set : merge_keys_to_injection_name.at(key_tmp)) {
-          for (const auto& injection_name : injection_name_set) {
-            injection_names_prev_merge.insert(injection_name);
-          }
-        }
+        if (merge_keys_to_injection_sets.count(key_tmp) <= 0) continue;
         // add the new injections set to the merge list
-        merge_keys_to_injection_name.at(key).push_back(injection_names_prev_merge);
+        const size_t injection_set = get_merged_injection_set(key_tmp);
+        merge_keys_to_injection_sets.at(key).push_back(injection_set);
       }
     }
 
     // pass 3: scan polarities
     const auto key = std::make_tuple("", std::make_pair(-1, -1), -1);
-    merge_keys_to_injection_name.emplace(key, std::vector<std::set<std::string>>());
+    merge_keys_to_injection_sets.emplace(key, std::vector<size_t>());
     for (const auto& scan_polarity : scan_polarities) {
       const auto key_tmp = std::make_tuple(scan_polarity, std::make_pair(-1, -1), -1);
-      if (merge_keys_to_injection_name.count(key_tmp) <= 0) continue;
-      // merge the injection name sets from the previous merge
-      std::set<std::string> injection_names_prev_merge;
-      for (const auto& injection_name_set : merge_keys_to_injection_name.at(key_tmp)) {
-        for (const auto& injection_name : injection_name_set) {
-          injection_names_prev_merge.insert(injection_name);
-        }
-      }
+      if (merge_keys_to_injection_sets.count(key_tmp) <= 0) continue;
       // add the new injections set to the merge list
-      merge_keys_to_injection_name.at(key).push_back(injection_names_prev_merge);
+      const size_t injection_set = get_merged_injection_set(key_tmp);
+      merge_keys_to_injection_sets.at(key).push_back(injection_set);
     }
+    // the result of the last merge
+    get_merged_injection_set(key);
   }
 
-  void MergeInjections::getComponentsToFeaturesToInjectionsToValues(const SampleGroupHandler& sampleGroupHandler_IO,
-                                                                    const SequenceHandler& sequenceHandler_I,
+  void MergeInjections::getComponentsToFeaturesToInjectionsToValues(const std::vector<const InjectionHandler*>& injections,
                                                                     const bool& merge_subordinates,
-                                                                    std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values)
+                                                                    const size_t nb_injection_sets,
+                                                                    ComponentValues& component_values)
   {
-    // initialize our map of feature names to values
-    std::map<std::string, std::map<std::set<std::string>, float>> features_to_values;
+    // the feature names
+    std::set<std::string> feature_names;
     for (const auto& m : metadataFloatToString) {
-      features_to_values.emplace(m.second, std::map<std::set<std::string>, float>());
+      feature_names.insert(m.second);
     }
+    component_values.features.assign(feature_names.cbegin(), feature_names.cend());
 
-    // construct the map
-    for (const std::size_t& index : sampleGroupHandler_IO.getSampleIndices()) {
-      const OpenMS::FeatureMap& fmap = sequenceHandler_I.getSequence().at(index).getRawData().getFeatureMap();
-      const std::string injection_name = sequenceHandler_I.getSequence().at(index).getMetaData().getInjectionName();
-
-      // Get the features/subordinates
-      OpenMS::FeatureMap fmap_tmp;
+    // 1st pass: list the components, and the features/subordinates to read for each injection
+    std::map<componentKeyType, size_t> component_indices;
+    struct ComponentFeature
+    {
+      size_t injection;
+      const OpenMS::Feature* feature;
+      std::map<componentKeyType, size_t>::iterator component;
+    };
+    std::vector<ComponentFeature> component_features;
+    for (size_t i = 0; i < injections.size(); ++i) {
+      const OpenMS::FeatureMap& fmap = injections[i]->getRawData().getFeatureMap();
       for (const OpenMS::Feature& f : fmap) {
         // Feature level merge
         if (!merge_subordinates) {
           componentKeyType component(f.getMetaValue("PeptideRef").toString(), "");
-          component_to_feature_to_injection_to_values.emplace(component, features_to_values);
-          for (const auto& f_to_v : features_to_values) {
-            const CastValue& datum = SequenceHandler::getMetaValue(f, f, f_to_v.first);
-            if (datum.getTag() == CastValue::Type::UNINITIALIZED || datum.getTag() == CastValue::Type::STRING) {
-              //LOGD << "Feature name: " << f_to_v.first << " was not found in the FeatureMap."; // This will polute the log
-              continue;
-            }
-            component_to_feature_to_injection_to_values.at(component).at(f_to_v.first).emplace(std::set<std::string>({ injection_name }), datum.f_);
-          }
+          component_features.push_back({ i, &f, component_indices.emplace(component, 0).first });
         }
         // Subordinate level merge
-        else if (merge_subordinates) 
+        else
         {
           for (const OpenMS::Feature& s : f.getSubordinates()) {
             componentKeyType component(f.getMetaValue("PeptideRef").toString(), s.getMetaValue("native_id").toString());
-            component_to_feature_to_injection_to_values.emplace(component, features_to_values);
-            for (const auto& f_to_v : features_to_values) {
-              const CastValue& datum = SequenceHandler::getMetaValue(s, s, f_to_v.first);
-              if (datum.getTag() == CastValue::Type::UNINITIALIZED || datum.getTag() == CastValue::Type::STRING) {
-                //LOGD << "Feature name: " << f_to_v.first << " was not found in the FeatureMap."; // This will polute the log
-                continue;
-              }
-              component_to_feature_to_injection_to_values.at(component).at(f_to_v.first).emplace(std::set<std::string>({ injection_name }), datum.f_);
-            }
+            component_features.push_back({ i, &s, component_indices.emplace(component, 0).first });
           }
         }
       }
     }
+    for (auto& component_index : component_indices) {
+      component_index.second = component_values.components.size();
+      component_values.components.push_back(component_index.first);
+    }
+    component_values.resize(nb_injection_sets);
+
+    // 2nd pass: read the values
+    for (const auto& component_feature : component_features) {
+      const size_t c = component_feature.component->second;
+      for (size_t f = 0; f < component_values.features.size(); ++f) {
+        const CastValue& datum = SequenceHandler::getMetaValue(*component_feature.feature, *component_feature.feature, component_values.features[f]);
+        float value;
+        if (datum.getTag() == CastValue::Type::FLOAT) value = datum.f_;
+        else if (datum.getTag() == CastValue::Type::INT) {
+          value = static_cast<float>(datum.i_);
+          component_values.is_integer[f] = 1;
+        }
+        else if (datum.getTag() == CastValue::Type::LONG_INT) {
+          value = static_cast<float>(datum.li_);
+          component_values.is_integer[f] = 1;
+        }
+        else {
+          //LOGD << "Feature name: " << component_values.features[f] << " was not found in the FeatureMap."; // This will polute the log
+          continue;
+        }
+        // the first feature found for the component is kept
+        const size_t index = component_values.offset(f, component_feature.injection) + c;
+        if (!component_values.has_values[index]) {
+          component_values.values[index] = value;
+          component_values.has_values[index] = 1;
+        }
+      }
+    }
   }
+
   void MergeInjections::mergeComponentsToFeaturesToInjectionsToValues(const std::string& feature_name,
                                                                       const std::string& merge_rule,
                                                                       const std::set<std::string>& scan_polarities,
                                                                       const std::set<std::pair<float, float>>& scan_mass_ranges,
                                                                       const std::set<float>& dilution_factors,
-                                                                      const std::map<mergeKeyType, std::vector<std::set<std::string>>>& merge_keys_to_injection_names,
-                                                                      std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values)
+                                                                      const InjectionSets& injection_sets,
+                                                                      const std::map<mergeKeyType, std::vector<size_t>>& merge_keys_to_injection_sets,
+                                                                      ComponentValues& component_values)
   {
+    const auto feature_it = std::find(component_values.features.cbegin(), component_values.features.cend(), feature_name);
+    if (feature_it == component_values.features.cend()) {
+      //LOGD << "Feature name: " << feature_name << " was not found in the FeatureMap."; // This will polute the log
+      return;
+    }
+    const size_t merge_feature = std::distance(component_values.features.cbegin(), feature_it);
+    const bool is_sum = merge_rule == "Sum";
+    const bool is_min = merge_rule == "Min";
+    const bool is_max = merge_rule == "Max";
+    const bool is_mean = merge_rule == "Mean";
+    const bool is_weighted_mean = merge_rule == "WeightedMean";
+
+    const size_t nb_components = component_values.components.size();
+    std::vector<float>& values = component_values.values;
+    std::vector<char>& has_values = component_values.has_values;
+    std::vector<float> total_values(nb_components);
+    std::vector<float> merged_values(nb_components);
+    std::vector<float> weights; // [i-th value found][component]
+    std::vector<size_t> nb_weights(nb_components);
+    std::vector<size_t> max_or_min_injection_sets(nb_components);
+    std::vector<size_t> nb_values(nb_components);
+    std::vector<char> is_merged(nb_components);
+
     for (const auto& scan_polarity : scan_polarities) {
       for (const auto& scan_mass_range : scan_mass_ranges) {
         for (const auto& dilution_factor : dilution_factors) {
           const auto key = std::make_tuple(scan_polarity, scan_mass_range, dilution_factor);
-          for (auto& component_to_feature_to_injection_to_value : component_to_feature_to_injection_to_values) {
-            if (component_to_feature_to_injection_to_value.second.count(feature_name) <= 0) {
-              //LOGD << "Feature name: " << feature_name << " was not found in the FeatureMap."; // This will polute the log
-              continue;
-            }
-            if (merge_keys_to_injection_names.count(key) <= 0) continue;
-
-            // Find the total value for weighting
-            float total_value = 0;
-            for (const std::set<std::string>& injection_names_set : merge_keys_to_injection_names.at(key)) {
-              if (component_to_feature_to_injection_to_value.second.at(feature_name).count(injection_names_set) <= 0) continue;
-              total_value += component_to_feature_to_injection_to_value.second.at(feature_name).at(injection_names_set);
+          if (merge_keys_to_injection_sets.count(key) <= 0) continue;
+          const std::vector<size_t>& injection_sets_to_merge = merge_keys_to_injection_sets.at(key);
+
+          // record the injections
+          // Note: this is done before checking if the feature exists to ensure that all injections are propogated to the next iteration
+          std::set<size_t> injections;
+          for (const size_t injection_set : injection_sets_to_merge) {
+            injections.insert(injection_sets.sets.at(injection_set).cbegin(), injection_sets.sets.at(injection_set).cend());
+          }
+          const auto merged_injection_set_it = injection_sets.indices.find(injections);
+          if (merged_injection_set_it == injection_sets.indices.cend()) continue;
+          const size_t merged_injection_set = merged_injection_set_it->second;
+
+          // Find the total value for weighting
+          std::fill(total_values.begin(), total_values.end(), 0.0f);
+          for (const size_t injection_set : injection_sets_to_merge) {
+            const size_t offset = component_values.offset(merge_feature, injection_set);
+            for (size_t c = 0; c < nb_components; ++c) {
+              if (has_values[offset + c]) total_values[c] += values[offset + c];
             }
+          }
 
-            // Calculated the weights and representative merged value
-            float merged_value = 0;
-            std::vector<float> weights;
-            std::set<std::string> injections;
-            std::set<std::string> max_or_min_injections;
-            int cnt = 0;
-            for (const std::set<std::string>& injection_names_set : merge_keys_to_injection_names.at(key)) {
-
-              // record the injections
-              // Note: this is done before checking if the feature exists to ensure that all injections are propogated to the next iteration
-              for (const std::string& inj : injection_names_set) {
-                injections.insert(inj);
-              }
-
+          // Calculated the weights and representative merged value
+          std::fill(merged_values.begin(), merged_values.end(), 0.0f);
+          std::fill(nb_weights.begin(), nb_weights.end(), 0);
+          weights.assign(injection_sets_to_merge.size() * nb_components, 0.0f);
+          for (const size_t injection_set : injection_sets_to_merge) {
+            const size_t offset = component_values.offset(merge_feature, injection_set);
+            for (size_t c = 0; c < nb_components; ++c) {
               // check if the feature is in the FeatureMap
-              if (component_to_feature_to_injection_to_value.second.at(feature_name).count(injection_names_set) <= 0) continue;
-              float value = component_to_feature_to_injection_to_value.second.at(feature_name).at(injection_names_set);
-              weights.push_back(value / total_value); // add to the weights
+              if (!has_values[offset + c]) continue;
+              const float value = values[offset + c];
+              weights[nb_weights[c] * nb_components + c] = value / total_values[c]; // add to the weights
 
               // initializations
-              if (cnt == 0) 
-              {
-                max_or_min_injections = injection_names_set;
-                if (merge_rule == "Min" || merge_rule == "Max") 
-                {
-                  merged_value = value;
-                }
+              if (nb_weights[c] == 0) {
+                max_or_min_injection_sets[c] = injection_set;
+                if (is_min || is_max) merged_values[c] = value;
               }
 
               // calculations
-              if (merge_rule == "Sum") 
-              {
-                merged_value += value;
+              if (is_sum) {
+                merged_values[c] += value;
               }
-              else if (merge_rule == "Min") 
-              {
-                if (value < merged_value) {
-                  merged_value = value;
-                  max_or_min_injections = injection_names_set;
+              else if (is_min) {
+                if (value < merged_values[c]) {
+                  merged_values[c] = value;
+                  max_or_min_injection_sets[c] = injection_set;
                 }
               }
-              else if (merge_rule == "Max") 
-              {
-                if (value > merged_value) {
-                  merged_value = value;
-                  max_or_min_injections = injection_names_set;
+              else if (is_max) {
+                if (value > merged_values[c]) {
+                  merged_values[c] = value;
+                  max_or_min_injection_sets[c] = injection_set;
                 }
               }
-              else if (merge_rule == "Mean") 
-              {
-                merged_value += (value / merge_keys_to_injection_names.at(key).size());
+              else if (is_mean) {
+                merged_values[c] += (value / injection_sets_to_merge.size());
               }
-              else if (merge_rule == "WeightedMean") 
-              {
-                merged_value += (value * value / total_value);
+              else if (is_weighted_mean) {
+                merged_values[c] += (value * value / total_values[c]);
               }
-              ++cnt;
+              ++nb_weights[c];
             }
+          }
 
-            // Make the merged feature
-            if (weights.size() <= 0) continue; // Note: we use the weights to check instead of the injections as the weights will be empty if no features exist for any of the injections
-            component_to_feature_to_injection_to_value.second.at(feature_name).insert_or_assign(injections, merged_value);
+          // Make the merged feature
+          // Note: we use the weights to check instead of the injections as the weights will be empty if no features exist for any of the injections
+          const size_t merged_offset = component_values.offset(merge_feature, merged_injection_set);
+          for (size_t c = 0; c < nb_components; ++c) {
+            is_merged[c] = nb_weights[c] > 0;
+            if (!is_merged[c]) continue;
+            values[merged_offset + c] = merged_values[c];
+            has_values[merged_offset + c] = 1;
+          }
 
-            // If we are merging two or more injections, remove the feature associated with each of them
-            if (injections.size() > 1)
-            {
-              for (const auto& injection : injections)
-              {
-                std::set<std::string> injection_set({ injection });
-                component_to_feature_to_injection_to_value.second.at(feature_name).erase(injection_set);
+          // If we are merging two or more injections, remove the feature associated with each of them
+          auto remove_single_injections = [&](size_t feature, const std::vector<char>& is_component_merged) {
+            if (injections.size() <= 1) return;
+            for (const size_t injection : injections) {
+              // the first injection sets are the single injections
+              const size_t offset = component_values.offset(feature, injection);
+              for (size_t c = 0; c < nb_components; ++c) {
+                if (is_component_merged[c]) has_values[offset + c] = 0;
               }
             }
+          };
+          remove_single_injections(merge_feature, is_merged);
+
+          // Repeat for all other features
+          std::vector<char> is_feature_merged(nb_components);
+          for (size_t feature = 0; feature < component_values.features.size(); ++feature) {
+            if (feature == merge_feature) continue;
 
-            // Repeat for all other features
-            for (auto& feature_to_injection_to_value : component_to_feature_to_injection_to_value.second) {
-              if (feature_name == feature_to_injection_to_value.first) continue;
-              if (feature_to_injection_to_value.second.count(max_or_min_injections) <= 0) continue;
+            for (size_t c = 0; c < nb_components; ++c) {
+              is_feature_merged[c] = is_merged[c] && has_values[component_values.offset(feature, max_or_min_injection_sets[c]) + c];
+            }
 
-              // Calculated the merged value
-              float merged_value = 0;
-              if (merge_rule == "Min" || merge_rule == "Max") {
-                merged_value = feature_to_injection_to_value.second.at(max_or_min_injections);
+            // Calculated the merged value
+            std::fill(merged_values.begin(), merged_values.end(), 0.0f);
+            if (is_min || is_max) {
+              for (size_t c = 0; c < nb_components; ++c) {
+                if (is_feature_merged[c]) merged_values[c] = values[component_values.offset(feature, max_or_min_injection_sets[c]) + c];
               }
-              else 
-              {
-                int cnt = 0;
-                for (const std::set<std::string>& injection_names_set : merge_keys_to_injection_names.at(key)) {
-                  if (feature_to_injection_to_value.second.count(injection_names_set) <= 0) continue;
-                  float value = feature_to_injection_to_value.second.at(injection_names_set);
-                  if (merge_rule == "Sum") merged_value += value;
-                  else if (merge_rule == "Mean") merged_value += (value / weights.size());
-                  else if (merge_rule == "WeightedMean") merged_value += (value * weights.at(cnt));
-                  ++cnt;
+            }
+            else
+            {
+              std::fill(nb_values.begin(), nb_values.end(), 0);
+              for (const size_t injection_set : injection_sets_to_merge) {
+                const size_t offset = component_values.offset(feature, injection_set);
+                for (size_t c = 0; c < nb_components; ++c) {
+                  if (!is_feature_merged[c] || !has_values[offset + c]) continue;
+                  const float value = values[offset + c];
+                  if (is_sum) merged_values[c] += value;
+                  else if (is_mean) merged_values[c] += (value / nb_weights[c]);
+                  else if (is_weighted_mean) {
+                    if (nb_values[c] >= nb_weights[c]) {
+                      throw std::out_of_range("MergeInjections: no weight for the feature " + component_values.features[feature]);
+                    }
+                    merged_values[c] += (value * weights[nb_values[c] * nb_components + c]);
+                  }
+                  ++nb_values[c];
                 }
               }
+            }
 
-              // Make the merged feature
-              feature_to_injection_to_value.second.insert_or_assign(injections, merged_value);
-
-              // If we are merging two or more injections, remove the feature associated with each of them
-              if (injections.size() > 1)
-              {
-                for (const auto& injection : injections)
-                {
-                  std::set<std::string> injection_set({ injection });
-                  feature_to_injection_to_value.second.erase(injection_set);
-                }
-              }
+            // Make the merged feature
+            const size_t feature_merged_offset = component_values.offset(feature, merged_injection_set);
+            for (size_t c = 0; c < nb_components; ++c) {
+              if (!is_feature_merged[c]) continue;
+              values[feature_merged_offset + c] = merged_values[c];
+              has_values[feature_merged_offset + c] = 1;
             }
+
+            // If we are merging two or more injections, remove the feature associated with each of them
+            remove_single_injections(feature, is_feature_merged);
           }
         }
       }
     }
   }
+
   void MergeInjections::makeFeatureMap(const bool& merge_subordinates,
-                                       std::set<std::string>& injection_names_set,
-                                       const std::map<componentKeyType, std::map<std::string, std::map<std::set<std::string>, float>>>& component_to_feature_to_injection_to_values,
+                                       const InjectionSets& injection_sets,
+                                       const ComponentValues& component_values,
                                        OpenMS::FeatureMap& feature_map)
   {
+    // the values of the features merged from all the injections
+    std::set<size_t> all_injections;
+    for (size_t i = 0; i < injection_sets.sets.size() && injection_sets.sets.at(i).size() == 1; ++i) {
+      all_injections.insert(i);
+    }
+    const auto merged_injection_set = injection_sets.indices.find(all_injections);
+
     OpenMS::Feature f, s;
     std::vector<OpenMS::Feature> subs;
     std::string peptide_ref_cur = "";
-    for (const auto& component_to_feature_to_injection_to_value : component_to_feature_to_injection_to_values) {
+    for (size_t c = 0; c < component_values.components.size(); ++c) {
+      const componentKeyType& component = component_values.components[c];
 
       // Decide whether to make a new feature or continue adding subordinates
       if (merge_subordinates) {
         subs.push_back(s);
         s = OpenMS::Feature();
         s.setUniqueId();
-        s.setMetaValue("native_id", component_to_feature_to_injection_to_value.first.second);
+        s.setMetaValue("native_id", component.second);
       }
-      if (component_to_feature_to_injection_to_value.first.first != peptide_ref_cur) {
+      if (component.first != peptide_ref_cur) {
         if (merge_subordinates) {
           f.setSubordinates(subs);
           subs.clear();
@@ -652,67 +720,47 @@ namespace SmartPeak
         feature_map.push_back(f);
         f = OpenMS::Feature();
         f.setUniqueId();
-        f.setMetaValue("PeptideRef", component_to_feature_to_injection_to_value.first.first);
-        peptide_ref_cur = component_to_feature_to_injection_to_value.first.first;              
+        f.setMetaValue("PeptideRef", component.first);
+        peptide_ref_cur = component.first;              
       }
 
       // Get the metadata
-      for (const auto& feature_to_injection_to_value : component_to_feature_to_injection_to_value.second) {
-        if (feature_to_injection_to_value.second.count(injection_names_set) <= 0) continue;
-        float value = feature_to_injection_to_value.second.at(injection_names_set);
-        if (!merge_subordinates) {
-          if (feature_to_injection_to_value.first == "RT") 
-          {
-            f.setRT(value);
-          }
-          else if (feature_to_injection_to_value.first == "Intensity") 
-          {
-            f.setIntensity(value);
-          }
-          else if (feature_to_injection_to_value.first == "peak_area") 
-          {
-            f.setIntensity(value);
-          }
-          else if (feature_to_injection_to_value.first == "mz") 
-          {
-            f.setMZ(value);
-          }
-          else if (feature_to_injection_to_value.first == "charge") 
-          {
-            f.setCharge(static_cast<int>(value));
-          }
-          else 
-          {
-            f.setMetaValue(feature_to_injection_to_value.first, value);
-          }
+      if (merged_injection_set == injection_sets.indices.cend()) continue;
+      for (size_t feature = 0; feature < component_values.features.size(); ++feature) {
+        const size_t index = component_values.offset(feature, merged_injection_set->second) + c;
+        if (!component_values.has_values[index]) continue;
+        const std::string& feature_name = component_values.features[feature];
+        const float value = component_values.values[index];
+        OpenMS::Feature& merged_feature = merge_subordinates ? s : f;
+        if (feature_name == "RT") 
+        {
+          merged_feature.setRT(value);
         }
-        else if (merge_subordinates) 
+        else if (feature_name == "Intensity") 
         {
-          if (feature_to_injection_to_value.first == "RT") 
-          {
-            s.setRT(value);
-          }
-          else if (feature_to_injection_to_value.first == "Intensity") 
-          {
-            s.setIntensity(value);
-          }
-          else if (feature_to_injection_to_value.first == "peak_area") 
-          {
-            s.setIntensity(value);
-          }
-          else if (feature_to_injection_to_value.first == "mz") 
-          {
-            s.setMZ(value);
-          }
-          else if (feature_to_injection_to_value.first == "charge") 
-          {
-            s.setCharge(static_cast<int>(value));
-          }
-          else 
-          {
-            s.setMetaValue(feature_to_injection_to_value.first, value);
-          }
-        }             
+          merged_feature.setIntensity(value);
+        }
+        else if (feature_name == "peak_area") 
+        {
+          merged_feature.setIntensity(value);
+        }
+        else if (feature_name == "mz") 
+        {
+          merged_feature.setMZ(value);
+        }
+        else if (feature_name == "charge") 
+        {
+          merged_feature.setCharge(static_cast<int>(value));
+        }
+        else if (component_values.is_integer[feature])
+        {
+          // integer meta values stay integers, merged means are rounded
+          merged_feature.setMetaValue(feature_name, static_cast<int>(std::lround(value)));
+        }
+        else 
+        {
+          merged_feature.setMetaValue(feature_name, value);
+        }
       }
     }
 
@@ -26,26 +26,48 @@
 #include <SmartPeak/core/SequenceHandler.h>
 #include <SmartPeak/core/Utilities.h>
 #include <plog/Log.h>
+#include <algorithm>
 
 namespace SmartPeak
 {
   // """A class to manage the mapping of metadata and FeatureMaps
   //     (i.e., multiple samples in a run batch/sequence)"""
 
+  void SequenceHandler::NameIndex::invalidate()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    indices_.clear();
+    valid_ = false;
+  }
+
+  void SequenceHandler::NameIndex::add(const std::string& name, size_t index)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (valid_)
+    {
+      indices_.emplace(name, index);
+    }
+  }
+
   void SequenceHandler::clear()
   {
     sequence_.clear();
     sequence_segments_.clear();
     sample_groups_.clear();
+    injection_index_.invalidate();
+    sequence_segment_index_.invalidate();
+    sample_group_index_.invalidate();
   }
 
   void SequenceHandler::setSequence(const std::vector<InjectionHandler>& sequence)
   {
     sequence_ = sequence;
+    injection_index_.invalidate();
   }
 
   std::vector<InjectionHandler>& SequenceHandler::getSequence()
   {
+    injection_index_.invalidate();
     return sequence_;
   }
 
@@ -57,10 +79,12 @@ namespace SmartPeak
   void SequenceHandler::setSequenceSegments(const std::vector<SequenceSegmentHandler>& sequence_segments)
   {
     sequence_segments_ = sequence_segments;
+    sequence_segment_index_.invalidate();
   }
 
   std::vector<SequenceSegmentHandler>& SequenceHandler::getSequenceSegments()
   {
+    sequence_segment_index_.invalidate();
     return sequence_segments_;
   }
 
@@ -72,10 +96,12 @@ namespace SmartPeak
   void SequenceHandler::setSampleGroups(const std::vector<SampleGroupHandler>& sample_groups)
   {
     sample_groups_ = sample_groups;
+    sample_group_index_.invalidate();
   }
 
   std::vector<SampleGroupHandler>& SequenceHandler::getSampleGroups()
   {
+    sample_group_index_.invalidate();
     return sample_groups_;
   }
 
@@ -125,6 +151,8 @@ namespace SmartPeak
       rdh.setReferenceData(reference_data_ptr);
       auto spectra_library_ptr = sequence_.begin()->getRawDataShared()->getSpectraLibraryShared();
       rdh.setSpectraLibrary(spectra_library_ptr);
+      auto spectra_library_index_ptr = sequence_.begin()->getRawDataShared()->getSpectraLibraryIndexShared();
+      rdh.setSpectraLibraryIndex(spectra_library_index_ptr);
 
       // look up the sequence segment, 
       // add the sample index to the sequence segment list of injection indices
@@ -139,21 +167,19 @@ namespace SmartPeak
       auto feature_rsd_estimations_ptr = std::make_shared<OpenMS::MRMFeatureQC>(OpenMS::MRMFeatureQC());
       auto feature_background_estimations_ptr = std::make_shared<OpenMS::MRMFeatureQC>(OpenMS::MRMFeatureQC());
       bool found_seq_seg = false;
-      for (SequenceSegmentHandler& sequenceSegmentHandler : sequence_segments_) {
-        if (meta_data_I.getSequenceSegmentName() == sequenceSegmentHandler.getSequenceSegmentName()) {
-          absQuantMethods_ptr = sequenceSegmentHandler.getQuantitationMethodsShared();
-          feature_filters_ptr = sequenceSegmentHandler.getFeatureFilterShared();
-          feature_qc_ptr = sequenceSegmentHandler.getFeatureQCShared();
-          feature_rsd_filters_ptr = sequenceSegmentHandler.getFeatureRSDFilterShared();
-          feature_rsd_qc_ptr = sequenceSegmentHandler.getFeatureRSDQCShared();
-          feature_background_filters_ptr = sequenceSegmentHandler.getFeatureBackgroundFilterShared();
-          feature_background_qc_ptr = sequenceSegmentHandler.getFeatureBackgroundQCShared();
-          feature_rsd_estimations_ptr = sequenceSegmentHandler.getFeatureRSDEstimationsShared();
-          feature_background_estimations_ptr = sequenceSegmentHandler.getFeatureBackgroundEstimationsShared();
-          found_seq_seg = true;
-          sequenceSegmentHandler.getSampleIndices().push_back(sequence_.size()); // index = the size of the sequence
-          break;
-        }
+      if (const auto sequence_segment_index = findSequenceSegmentIndex(meta_data_I.getSequenceSegmentName())) {
+        SequenceSegmentHandler& sequenceSegmentHandler = sequence_segments_[*sequence_segment_index];
+        absQuantMethods_ptr = sequenceSegmentHandler.getQuantitationMethodsShared();
+        feature_filters_ptr = sequenceSegmentHandler.getFeatureFilterShared();
+        feature_qc_ptr = sequenceSegmentHandler.getFeatureQCShared();
+        feature_rsd_filters_ptr = sequenceSegmentHandler.getFeatureRSDFilterShared();
+        feature_rsd_qc_ptr = sequenceSegmentHandler.getFeatureRSDQCShared();
+        feature_background_filters_ptr = sequenceSegmentHandler.getFeatureBackgroundFilterShared();
+        feature_background_qc_ptr = sequenceSegmentHandler.getFeatureBackgroundQCShared();
+        feature_rsd_estimations_ptr = sequenceSegmentHandler.getFeatureRSDEstimationsShared();
+        feature_background_estimations_ptr = sequenceSegmentHandler.getFeatureBackgroundEstimationsShared();
+        found_seq_seg = true;
+        sequenceSegmentHandler.getSampleIndices().push_back(sequence_.size()); // index = the size of the sequence
       }
       if (found_seq_seg) {
         rdh.setQuantitationMethods(absQuantMethods_ptr);
@@ -181,6 +207,7 @@ namespace SmartPeak
         sequenceSegmentHandler.setFeatureRSDEstimations(feature_rsd_estimations_ptr);
         sequenceSegmentHandler.setFeatureBackgroundEstimations(feature_background_estimations_ptr);
         sequenceSegmentHandler.setSequenceSegmentName(meta_data_I.getSequenceSegmentName());
+        sequence_segment_index_.add(meta_data_I.getSequenceSegmentName(), sequence_segments_.size());
         sequence_segments_.push_back(sequenceSegmentHandler);
 
         rdh.setQuantitationMethods(absQuantMethods_ptr);
@@ -195,12 +222,9 @@ namespace SmartPeak
       }
 
       bool found_sample_group = false;
-      for (SampleGroupHandler& sampleGroupHandler : sample_groups_) {
-        if (meta_data_I.getSampleGroupName() == sampleGroupHandler.getSampleGroupName()) {
-          found_sample_group = true;
-          sampleGroupHandler.getSampleIndices().push_back(sequence_.size()); // index = the size of the sequence
-          break;
-        }
+      if (const auto sample_group_index = findSampleGroupIndex(meta_data_I.getSampleGroupName())) {
+        found_sample_group = true;
+        sample_groups_[*sample_group_index].getSampleIndices().push_back(sequence_.size()); // index = the size of the sequence
       }
       if (found_sample_group) {
         // Nothing yet...
@@ -211,6 +235,7 @@ namespace SmartPeak
         SampleGroupHandler sampleGroupHandler;
         sampleGroupHandler.setSampleIndices({ sequence_.size() }); // index = the size of the sequence
         sampleGroupHandler.setSampleGroupName(meta_data_I.getSampleGroupName());
+        sample_group_index_.add(meta_data_I.getSampleGroupName(), sample_groups_.size());
         sample_groups_.push_back(sampleGroupHandler);
       }
     }
@@ -238,6 +263,7 @@ namespace SmartPeak
       sequenceSegmentHandler.setFeatureRSDEstimations(feature_rsd_estimations_ptr);
       sequenceSegmentHandler.setFeatureBackgroundEstimations(feature_background_estimations_ptr);
       sequenceSegmentHandler.setSequenceSegmentName(meta_data_I.getSequenceSegmentName());
+      sequence_segment_index_.add(meta_data_I.getSequenceSegmentName(), sequence_segments_.size());
       sequence_segments_.push_back(sequenceSegmentHandler);
 
       rdh.setQuantitationMethods(absQuantMethods_ptr);
@@ -254,6 +280,7 @@ namespace SmartPeak
       SampleGroupHandler sampleGroupHandler;
       sampleGroupHandler.setSampleIndices({ 0 }); // first index of the sequence
       sampleGroupHandler.setSampleGroupName(meta_data_I.getSampleGroupName());
+      sample_group_index_.add(meta_data_I.getSampleGroupName(), sample_groups_.size());
       sample_groups_.push_back(sampleGroupHandler);
     }
 
@@ -262,6 +289,7 @@ namespace SmartPeak
     sh.setMetaData(meta_data_ptr);
     sh.setRawData(rdh);
 
+    injection_index_.add(meta_data_ptr->getInjectionName(), sequence_.size());
     sequence_.push_back(sh);
   }
 
@@ -272,23 +300,48 @@ namespace SmartPeak
     std::vector<InjectionHandler> samples;
 
     for (const std::string& name : injection_names) {
-      const std::vector<InjectionHandler>::const_iterator it =
-        find_if(
-          sequence_.cbegin(),
-          sequence_.cend(),
-          [&name](const InjectionHandler& injection)
-          {
-            return injection.getMetaData().getInjectionName() == name;
-          }
-        );
-      if (it != sequence_.cend()) {
-        samples.push_back(*it);
+      if (const auto index = findInjectionIndex(name)) {
+        samples.push_back(sequence_[*index]);
       }
     }
 
     return samples;
   }
 
+  std::optional<size_t> SequenceHandler::findInjectionIndex(const std::string& injection_name) const
+  {
+    return injection_index_.find(injection_name, sequence_,
+      [](const InjectionHandler& injection) { return injection.getMetaData().getInjectionName(); });
+  }
+
+  std::optional<size_t> SequenceHandler::findSequenceSegmentIndex(const std::string& sequence_segment_name) const
+  {
+    return sequence_segment_index_.find(sequence_segment_name, sequence_segments_,
+      [](const SequenceSegmentHandler& sequence_segment) { return sequence_segment.getSequenceSegmentName(); });
+  }
+
+  std::optional<size_t> SequenceHandler::findSampleGroupIndex(const std::string& sample_group_name) const
+  {
+    return sample_group_index_.find(sample_group_name, sample_groups_,
+      [](const SampleGroupHandler& sample_group) { return sample_group.getSampleGroupName(); });
+  }
+
+  SequenceHandler SequenceHandler::snapshot() const
+  {
+    SequenceHandler sequence_handler(*this);
+    std::transform(sequence_.cbegin(), sequence_.cend(), sequence_handler.sequence_.begin(),
+      [](const InjectionHandler& injection) { return injection.snapshot(); });
+    return sequence_handler;
+  }
+
+  void SequenceHandler::detachRawData()
+  {
+    for (InjectionHandler& injection : sequence_)
+    {
+      injection.detachRawData();
+    }
+  }
+
   CastValue SequenceHandler::getMetaValue(
     const OpenMS::Feature& feature,
     const OpenMS::Feature& subordinate,
@@ -27,6 +27,7 @@
 #include <SmartPeak/core/SequenceHandler.h>
 #include <SmartPeak/core/ApplicationHandler.h>
 #include <SmartPeak/core/SequenceProcessor.h>
+#include <SmartPeak/core/ProcessorProfiler.h>
 #include <SmartPeak/core/SequenceSegmentHandler.h>
 #include <SmartPeak/core/SequenceSegmentProcessor.h>
 #include <SmartPeak/io/InputDataValidation.h>
@@ -40,9 +41,8 @@
 
 #include <plog/Log.h>
 #include <atomic>
-#include <future>
-#include <list>
 #include <unordered_set>
+#include <utility>
 #include <filesystem>
 
 namespace SmartPeak
@@ -63,33 +63,6 @@ namespace SmartPeak
     LOGD << "END " << getName();
   }
 
-  class WorkflowException : public std::exception
-  {
-  public:
-
-    explicit WorkflowException(const std::string& item, const std::string& processor, const std::string& message)
-      : item_(item), processor_(processor), msg_(message)  {}
-
-    virtual ~WorkflowException() noexcept {}
-
-    virtual const char* what() const noexcept override {
-      return msg_.c_str();
-    }
-
-    virtual const std::string item() const noexcept {
-      return item_;
-    }
-
-    virtual const std::string processor() const noexcept {
-      return processor_;
-    }
-
-  protected:
-    std::string item_;
-    std::string processor_;
-    std::string msg_;
-  };
-
   void ProcessSequence::doProcess(Filenames& filenames_I)
   {
     // Check that there are raw data processing methods
@@ -97,7 +70,8 @@ namespace SmartPeak
       throw "no raw data processing methods given.\n";
     }
 
-    // Get the specified injections to process
+    // Get the specified injections to process, their copies sharing the raw data of the sequence
+    sequenceHandler_IO->detachRawData();
     std::vector<InjectionHandler> injections = injection_names_.empty()
       ? sequenceHandler_IO->getSequence()
       : sequenceHandler_IO->getSamplesInSequence(injection_names_);
@@ -113,14 +87,16 @@ namespace SmartPeak
       injections,
       filenames_,
       raw_data_processing_methods_,
+      this,
       this);
-    manager.spawn_workers(number_of_threads_);
+    manager.spawn_workers(number_of_threads_, thread_pool_.get());
     notifySequenceProcessorEnd();
   }
 
   void ProcessSequenceSegments::doProcess(Filenames& filenames_I)
   {
     std::vector<SequenceSegmentHandler> sequence_segments;
+    sequenceHandler_IO->detachRawData();
 
     if (sequence_segment_names_.empty()) { // select all
       sequence_segments = sequenceHandler_IO->getSequenceSegments();
@@ -147,8 +123,9 @@ namespace SmartPeak
       (*sequenceHandler_IO),
       sequence_segment_processing_methods_,
       filenames_,
+      this,
       this);
-    manager.spawn_workers(number_of_threads_);
+    manager.spawn_workers(number_of_threads_, thread_pool_.get());
     sequenceHandler_IO->setSequenceSegments(sequence_segments);
     sequenceHandler_IO->notifySequenceUpdated();
     notifySequenceSegmentProcessorEnd();
@@ -158,31 +135,46 @@ namespace SmartPeak
     SequenceSegmentHandler& sequence_segment,
     SequenceHandler& sequenceHandler_IO,
     Filenames& filenames,
-    const std::vector<std::shared_ptr<SequenceSegmentProcessor>>& methods)
+    const std::vector<std::shared_ptr<SequenceSegmentProcessor>>& methods,
+    ProcessorProfileObservable* profile_observable)
   {
+    const bool profile = profile_observable && profile_observable->hasProcessorProfileObservers();
     const size_t nr_methods = methods.size();
     LOGI << ">>Processing SequenceSegment [" << sequence_segment.getSequenceSegmentName() << "]\n";
     for (size_t i = 0; i < nr_methods; ++i) {
       LOGI << "[" << (i + 1) << "/" << nr_methods << "] steps in processing sequence segments";
       try
       {
+        const auto start = profile ? ProcessorProfiler::takeSnapshot() : ProcessorProfiler::Snapshot();
         methods[i]->process(
           sequence_segment,
           sequenceHandler_IO,
-          (sequenceHandler_IO)
+          std::as_const(sequenceHandler_IO)
             .getSequence()
             .at(sequence_segment.getSampleIndices().front())
             .getRawData()
             .getParameters(),
           filenames
         );
+        if (profile)
+        {
+          profile_observable->notifyProcessorProfile(ProcessorProfiler::makeRecord(
+            start,
+            methods[i]->getName(),
+            sequence_segment.getSequenceSegmentName(),
+            ProcessorProfileRecord::ItemType::SequenceSegment,
+            sequence_segment.getSampleIndices().size()));
+        }
       }
       catch (const std::exception& e)
       {
+        sequence_segment.clearFeatureMaps();
         WorkflowException we(sequence_segment.getSequenceSegmentName(), methods[i]->getName(), e.what());
         throw we;
       }
     }
+    // the copies of the feature maps are only shared by the steps above
+    sequence_segment.clearFeatureMaps();
   }
 
   void SequenceSegmentProcessorMultithread::run_processing()
@@ -197,20 +189,14 @@ namespace SmartPeak
       if (observable_) observable_->notifySequenceSegmentProcessorSampleStart(sequence_seg.getSequenceSegmentName());
       
       try {
-        std::future<void> f = std::async(
-        std::launch::async,
-        processSegment,
-        std::ref(sequence_seg),
-        std::ref(sequenceHandler_IO),
-        std::ref(filenames_.at( sequence_seg.getSequenceSegmentName())),
-        std::cref(sequence_segment_processing_methods_));
-          
-        LOGI << ">>SequenceSegment [" << sequence_seg.getSequenceSegmentName() << "]: waiting...";
-        f.wait();
-        LOGI << ">>SequenceSegment [" << sequence_seg.getSequenceSegmentName() << "]: done";
-          
         try {
-          f.get();
+          processSegment(
+            sequence_seg,
+            sequenceHandler_IO,
+            filenames_.at(sequence_seg.getSequenceSegmentName()),
+            sequence_segment_processing_methods_,
+            profile_observable_);
+          LOGI << ">>SequenceSegment [" << sequence_seg.getSequenceSegmentName() << "]: done";
         }
         catch (const WorkflowException& e)
         {
@@ -247,20 +233,14 @@ namespace SmartPeak
       if (observable_) observable_->notifySampleGroupProcessorSampleStart(sequence_seg.getSampleGroupName());
       
       try {
-        std::future<void> f = std::async(
-        std::launch::async,
-        processSampleGroup,
-        std::ref(sequence_seg),
-        std::ref(sequenceHandler_IO),
-        std::ref(filenames_.at( sequence_seg.getSampleGroupName())),
-        std::cref(sample_group_processing_methods_));
-          
-        LOGI << ">>SampleGroup [" << sequence_seg.getSampleGroupName() << "]: waiting...";
-        f.wait();
-        LOGI << ">>SampleGroup [" << sequence_seg.getSampleGroupName() << "]: done";
-          
         try {
-          f.get();
+          processSampleGroup(
+            sequence_seg,
+            sequenceHandler_IO,
+            filenames_.at(sequence_seg.getSampleGroupName()),
+            sample_group_processing_methods_,
+            profile_observable_);
+          LOGI << ">>SampleGroup [" << sequence_seg.getSampleGroupName() << "]: done";
         }
         catch (const WorkflowException& e)
         {
@@ -288,6 +268,7 @@ namespace SmartPeak
   void ProcessSampleGroups::doProcess(Filenames& filenames_I)
   {
     std::vector<SampleGroupHandler> sample_groups;
+    sequenceHandler_IO->detachRawData();
 
     if (sample_group_names_.empty()) { // select all
       sample_groups = sequenceHandler_IO->getSampleGroups();
@@ -311,8 +292,9 @@ namespace SmartPeak
       (*sequenceHandler_IO),
       sample_group_processing_methods_,
       filenames_,
+      this,
       this);
-    manager.spawn_workers(number_of_threads_);
+    manager.spawn_workers(number_of_threads_, thread_pool_.get());
     sequenceHandler_IO->setSampleGroups(sample_groups);
     notifySampleGroupProcessorEnd();
   }
@@ -321,23 +303,35 @@ namespace SmartPeak
     SampleGroupHandler& sample_group,
     SequenceHandler& sequenceHandler_IO,
     Filenames& filenames,
-    const std::vector<std::shared_ptr<SampleGroupProcessor>>& methods)
+    const std::vector<std::shared_ptr<SampleGroupProcessor>>& methods,
+    ProcessorProfileObservable* profile_observable)
   {
+    const bool profile = profile_observable && profile_observable->hasProcessorProfileObservers();
     const size_t n = methods.size();
     for (size_t i = 0; i < n; ++i) {
       LOGI << "[" << (i + 1) << "/" << n << "] steps in processing sample groups";
       try
       {
+        const auto start = profile ? ProcessorProfiler::takeSnapshot() : ProcessorProfiler::Snapshot();
         methods[i]->process(
           sample_group,
           sequenceHandler_IO,
-          (sequenceHandler_IO)
+          std::as_const(sequenceHandler_IO)
           .getSequence()
           .at(sample_group.getSampleIndices().front())
           .getRawData()
           .getParameters(),
           filenames
         );
+        if (profile)
+        {
+          profile_observable->notifyProcessorProfile(ProcessorProfiler::makeRecord(
+            start,
+            methods[i]->getName(),
+            sample_group.getSampleGroupName(),
+            ProcessorProfileRecord::ItemType::SampleGroup,
+            sample_group.getSampleIndices().size()));
+        }
       }
       catch (const std::exception& e)
       {
@@ -347,71 +341,23 @@ namespace SmartPeak
     }
   }
 
-  void SequenceSegmentProcessorMultithread::spawn_workers(unsigned int n_threads)
+  void ProcessorMultithread::spawn_workers(unsigned int n_threads, ThreadPool* thread_pool)
   {
     // Refine the # of threads based on the hardware
     size_t n_workers = getNumWorkers(n_threads);
     LOGD << "Number of workers: " << n_workers;
 
-    // Spawn the workers
-    try {
-      std::list<std::future<void>> futures;
-      LOGD << "Spawning workers...";
-      for (size_t i = 0; i < n_workers; ++i) {
-        futures.emplace_back(std::async(std::launch::async, &SequenceSegmentProcessorMultithread::run_processing, this));
-      }
-      LOGD << "Waiting for workers...";
-      for (std::future<void>& f : futures) {
-        f.wait();
-      }
-      LOGD << "Workers are done";
-    }
-    catch (const std::exception& e) {
-      LOGE << e.what();
-    }
-  }
-
-  void SampleGroupProcessorMultithread::spawn_workers(unsigned int n_threads)
-  {
-    // Refine the # of threads based on the hardware
-    size_t n_workers = getNumWorkers(n_threads);
-    LOGD << "Number of workers: " << n_workers;
-
-    // Spawn the workers
-    try {
-      std::list<std::future<void>> futures;
-      LOGD << "Spawning workers...";
-      for (size_t i = 0; i < n_workers; ++i) {
-        futures.emplace_back(std::async(std::launch::async, &SampleGroupProcessorMultithread::run_processing, this));
-      }
-      LOGD << "Waiting for workers...";
-      for (std::future<void>& f : futures) {
-        f.wait();
-      }
-      LOGD << "Workers are done";
-    }
-    catch (const std::exception& e) {
-      LOGE << e.what();
+    std::unique_ptr<ThreadPool> local_thread_pool;
+    if (!thread_pool)
+    {
+      local_thread_pool = std::make_unique<ThreadPool>(n_workers);
+      thread_pool = local_thread_pool.get();
     }
-  }
 
-  void SequenceProcessorMultithread::spawn_workers(unsigned int n_threads)
-  {
-    // Refine the # of threads based on the hardware
-    size_t n_workers = getNumWorkers(n_threads);
-    LOGD << "Number of workers: " << n_workers;
-
-    // Spawn the workers
+    // Run the workers
     try {
-      std::list<std::future<void>> futures;
-      LOGD << "Spawning workers...";
-      for (size_t i = 0; i < n_workers; ++i) {
-        futures.emplace_back(std::async(std::launch::async, &SequenceProcessorMultithread::run_processing, this));
-      }
-      LOGD << "Waiting for workers...";
-      for (std::future<void>& f : futures) {
-        f.wait();
-      }
+      LOGD << "Running workers...";
+      thread_pool->parallelFor(n_workers, [this](size_t) { run_processing(); });
       LOGD << "Workers are done";
     }
     catch (const std::exception& e) {
@@ -432,17 +378,14 @@ namespace SmartPeak
       InjectionHandler& injection { injections_[i] };
       if (observable_) observable_->notifySequenceProcessorSampleStart(injection.getMetaData().getSampleName());
       try {
-        std::future<void> f = std::async(
-          std::launch::async,
-          processInjection,
-          std::ref(injection),
-          std::ref(filenames_.at(injection.getMetaData().getInjectionName())),
-          std::cref(methods_));
-        LOGD << "Injection [" << i << "]: waiting...";
-        f.wait();
-        LOGD << "Injection [" << i << "]: done";
         try {
-          f.get(); // check for exceptions
+          // run inline, the worker is already a pool thread
+          processInjection(
+            injection,
+            filenames_.at(injection.getMetaData().getInjectionName()),
+            methods_,
+            profile_observable_);
+          LOGD << "Injection [" << i << "]: done";
         }
         catch (const WorkflowException& e)
         {
@@ -491,9 +434,11 @@ namespace SmartPeak
   void processInjection(
     InjectionHandler& injection,
     Filenames& filenames_I,
-    const std::vector<std::shared_ptr<RawDataProcessor>>& methods
+    const std::vector<std::shared_ptr<RawDataProcessor>>& methods,
+    ProcessorProfileObservable* profile_observable
   )
   {
+    const bool profile = profile_observable && profile_observable->hasProcessorProfileObservers();
     size_t i_step { 1 };
     const size_t n_steps { methods.size() };
     const std::string inj_name { injection.getMetaData().getInjectionName() };
@@ -501,11 +446,24 @@ namespace SmartPeak
       try
       {
         LOGI << "[" << (i_step++) << "/" << n_steps << "] method on injection: " << inj_name;
+        const auto start = profile ? ProcessorProfiler::takeSnapshot() : ProcessorProfiler::Snapshot();
         p->process( //TODO: (SIGABRT)
           injection.getRawData(),
-          injection.getRawData().getParameters(),
+          std::as_const(injection).getRawData().getParameters(),
           filenames_I
         );
+        if (profile)
+        {
+          // counts the resident data only, the spilled data are not loaded back for the profile
+          const RawDataHandler& raw_data = std::as_const(injection).getRawData();
+          profile_observable->notifyProcessorProfile(ProcessorProfiler::makeRecord(
+            start,
+            p->getName(),
+            inj_name,
+            ProcessorProfileRecord::ItemType::Injection,
+            raw_data.getMSDataSize(RawDataHandler::MSDataType::Experiment)
+              + raw_data.getMSDataSize(RawDataHandler::MSDataType::ChromatogramMap)));
+        }
       }
       catch (const std::exception& e)
       {
@@ -54,6 +54,7 @@ namespace SmartPeak
     if (feature_background_estimations_ != nullptr) feature_background_estimations_ = std::make_shared<OpenMS::MRMFeatureQC>(OpenMS::MRMFeatureQC());
     components_to_concentrations_.clear();
     excluded_components_to_concentrations_.clear();
+    cached_feature_maps_.clear();
   }
 
   void SequenceSegmentHandler::setSequenceSegmentName(const std::string& sequence_segment_name)
@@ -376,4 +377,25 @@ namespace SmartPeak
     return feature_concentrations_pruned;
   }
 
+
+  std::shared_ptr<const std::vector<OpenMS::FeatureMap>> SequenceSegmentHandler::getFeatureMaps(
+    const std::vector<size_t>& sample_indices,
+    const std::vector<uint64_t>& feature_map_versions,
+    const std::function<std::vector<OpenMS::FeatureMap>()>& make_feature_maps
+  )
+  {
+    CachedFeatureMaps& cached = cached_feature_maps_[sample_indices];
+    if (!cached.feature_maps || cached.feature_map_versions != feature_map_versions)
+    {
+      cached.feature_maps = nullptr; // release the outdated copy first
+      cached.feature_maps = std::make_shared<const std::vector<OpenMS::FeatureMap>>(make_feature_maps());
+      cached.feature_map_versions = feature_map_versions;
+    }
+    return cached.feature_maps;
+  }
+
+  void SequenceSegmentHandler::clearFeatureMaps()
+  {
+    cached_feature_maps_.clear();
+  }
 }
@@ -76,6 +76,26 @@ namespace SmartPeak
     }
   }
 
+  std::shared_ptr<const std::vector<OpenMS::FeatureMap>> SequenceSegmentProcessor::getFeatureMaps(
+    SequenceSegmentHandler& sequenceSegmentHandler,
+    const SequenceHandler& sequenceHandler,
+    const std::vector<size_t>& sampleIndices
+  )
+  {
+    std::vector<uint64_t> feature_map_versions;
+    for (const size_t index : sampleIndices) {
+      feature_map_versions.push_back(sequenceHandler.getSequence().at(index).getRawData().getFeatureMapVersion());
+    }
+    return sequenceSegmentHandler.getFeatureMaps(sampleIndices, feature_map_versions, [&sequenceHandler, &sampleIndices]() {
+      std::vector<OpenMS::FeatureMap> feature_maps;
+      feature_maps.reserve(sampleIndices.size());
+      for (const size_t index : sampleIndices) {
+        feature_maps.push_back(sequenceHandler.getSequence().at(index).getRawData().getFeatureMap());
+      }
+      return feature_maps;
+    });
+  }
+
   void SequenceSegmentProcessor::processForAllSegments(
     std::vector<SmartPeak::SequenceSegmentHandler>& sequence_segment_handlers,
     SequenceSegmentObservable* sequence_segment_observable,
@@ -81,10 +81,7 @@ namespace SmartPeak
       throw std::invalid_argument("blanks_indices argument is empty.");
     }
 
-    std::vector<OpenMS::FeatureMap> blanks_featureMaps;
-    for (const size_t index : blanks_indices) {
-      blanks_featureMaps.push_back(sequenceHandler_I.getSequence().at(index).getRawData().getFeatureMap());
-    }
+    const auto blanks_featureMaps = getFeatureMaps(sequenceSegmentHandler_IO, sequenceHandler_I, blanks_indices);
 
     // Initialize with a zero filter
     OpenMS::MRMFeatureFilter featureFilter;
@@ -92,7 +89,7 @@ namespace SmartPeak
 
     // Then estimate the background interferences
     featureFilter.EstimateBackgroundInterferences(
-      blanks_featureMaps,
+      *blanks_featureMaps,
       sequenceSegmentHandler_IO.getFeatureBackgroundEstimations(),
       sequenceHandler_I.getSequence().front().getRawData().getTargetedExperiment() // Targeted experiment used by all injections in the sequence
     );
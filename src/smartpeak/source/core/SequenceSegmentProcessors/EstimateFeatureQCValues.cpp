@@ -91,17 +91,13 @@ namespace SmartPeak
     }
 
     // OPTIMIZATION: it would be prefered to only use those standards that are part of the optimized calibration curve for each component
-    std::vector<OpenMS::FeatureMap> standards_featureMaps;
-    for (const size_t index : standards_indices) {
-      standards_featureMaps.push_back(sequenceHandler_I.getSequence().at(index).getRawData().getFeatureMap());
-    }
-    for (const size_t index : qcs_indices) {
-      standards_featureMaps.push_back(sequenceHandler_I.getSequence().at(index).getRawData().getFeatureMap());
-    }
+    std::vector<size_t> standards_qcs_indices = standards_indices;
+    standards_qcs_indices.insert(standards_qcs_indices.end(), qcs_indices.begin(), qcs_indices.end());
+    const auto standards_featureMaps = getFeatureMaps(sequenceSegmentHandler_IO, sequenceHandler_I, standards_qcs_indices);
 
     OpenMS::MRMFeatureFilter featureFilter;
     featureFilter.EstimateDefaultMRMFeatureQCValues(
-      standards_featureMaps,
+      *standards_featureMaps,
       sequenceSegmentHandler_IO.getFeatureQC(),
       sequenceHandler_I.getSequence().front().getRawData().getTargetedExperiment(), // Targeted experiment used by all injections in the sequence
       true
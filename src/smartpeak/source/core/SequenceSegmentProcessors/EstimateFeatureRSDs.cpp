@@ -81,15 +81,12 @@ namespace SmartPeak
       throw std::invalid_argument("qcs_indices argument is empty.");
     }
 
-    std::vector<OpenMS::FeatureMap> qcs_featureMaps;
-    for (const size_t index : qcs_indices) {
-      qcs_featureMaps.push_back(sequenceHandler_I.getSequence().at(index).getRawData().getFeatureMap());
-    }
+    const auto qcs_featureMaps = getFeatureMaps(sequenceSegmentHandler_IO, sequenceHandler_I, qcs_indices);
 
     OpenMS::MRMFeatureFilter featureFilter;
     OpenMS::MRMFeatureQC rsd_estimations = sequenceSegmentHandler_IO.getFeatureRSDFilter();
     featureFilter.EstimatePercRSD(
-      qcs_featureMaps, 
+      *qcs_featureMaps,
       rsd_estimations,
       sequenceHandler_I.getSequence().front().getRawData().getTargetedExperiment() // Targeted experiment used by all injections in the sequence
     );
@@ -88,9 +88,9 @@ namespace SmartPeak
   {
     getFilenames(filenames_I);
 
-    // Complete user parameters with schema
-    ParameterSet params(params_I);
-    params.merge(getParameterSchema());
+    // Complete user parameters with schema, resolved once for all the injections
+    const auto params_view = params_I.getView(getName(), [this]() { return getParameterSchema(); });
+    const ParameterSet& params = params_view->getParameterSet();
 
     auto excluded_points = getIncludedExcludedPointsFromParameters(params, "excluded_points");
     auto included_points = getIncludedExcludedPointsFromParameters(params, "included_points");
@@ -26,15 +26,19 @@
 #include <SmartPeak/core/MetaDataHandler.h>
 #include <SmartPeak/core/SampleType.h>
 #include <SmartPeak/core/SequenceHandler.h>
+#include <SmartPeak/core/ThreadPool.h>
 #include <SmartPeak/core/Utilities.h>
 #include <SmartPeak/core/ApplicationHandler.h>
 #include <SmartPeak/core/FeatureFiltersUtils.h>
 #include <SmartPeak/io/InputDataValidation.h>
 
 #include <OpenMS/ANALYSIS/QUANTITATION/AbsoluteQuantitation.h>
+#include <OpenMS/METADATA/AbsoluteQuantitationStandards.h>
 
 #include <plog/Log.h>
 
+#include <algorithm>
+
 namespace SmartPeak
 {
   std::set<std::string> OptimizeCalibration::getInputs() const
@@ -81,88 +85,142 @@ namespace SmartPeak
       throw std::invalid_argument("standards_indices argument is empty.");
     }
 
-    std::vector<OpenMS::FeatureMap> standards_featureMaps;
-    for (const size_t index : standards_indices) {
-      standards_featureMaps.push_back(sequenceHandler_I.getSequence().at(index).getRawData().getFeatureMap());
-    }
+    const auto standards_featureMaps = getFeatureMaps(sequenceSegmentHandler_IO, sequenceHandler_I, standards_indices);
 
     // add in the method parameters
+    // (each component is fitted by its own copy, AbsoluteQuantitation is not thread safe)
     OpenMS::AbsoluteQuantitation absoluteQuantitation;
     Utilities::setUserParameters(absoluteQuantitation, params_I);
 
-    absoluteQuantitation.setQuantMethods(sequenceSegmentHandler_IO.getQuantitationMethods());
-    std::map<std::string, std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>> components_to_concentrations;
-    std::map<std::string, std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>> excluded_components_to_concentrations;
+    // quantitation methods by component name, as kept by AbsoluteQuantitation::setQuantMethods
+    std::map<std::string, OpenMS::AbsoluteQuantitationMethod> quant_methods;
     for (const OpenMS::AbsoluteQuantitationMethod& row : sequenceSegmentHandler_IO.getQuantitationMethods()) {
-      // map standards to features
-      OpenMS::AbsoluteQuantitationStandards absoluteQuantitationStandards;
-      std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration> feature_concentrations;
+      quant_methods[row.getComponentName()] = row;
+    }
 
-      absoluteQuantitationStandards.getComponentFeatureConcentrations(
-        sequenceSegmentHandler_IO.getStandardsConcentrations(),
-        standards_featureMaps,
-        row.getComponentName(),
-        feature_concentrations
-      );
+    // map standards to features, once for all the components
+    std::map<OpenMS::String, std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>> standards_components_to_concentrations;
+    OpenMS::AbsoluteQuantitationStandards().mapComponentsToConcentrations(
+      sequenceSegmentHandler_IO.getStandardsConcentrations(),
+      *standards_featureMaps,
+      standards_components_to_concentrations
+    );
 
-      auto feature_concentrations_pruned = sequenceSegmentHandler_IO.getFeatureConcentrationsPruned(feature_concentrations);
+    struct ComponentCalibration
+    {
+      OpenMS::AbsoluteQuantitationMethod quant_method;
+      std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration> feature_concentrations;
+      std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration> excluded_feature_concentrations;
+      bool fitted = false;
+      std::string warning;
+    };
+    std::vector<ComponentCalibration> calibrations;
+    calibrations.reserve(quant_methods.size());
+    for (const auto& quant_method : quant_methods) {
+      calibrations.push_back({ quant_method.second, {}, {}, false, {} });
+    }
+
+    auto fitCalibration = [&](size_t i) {
+      ComponentCalibration& calibration = calibrations[i];
+      const std::string& component_name = calibration.quant_method.getComponentName();
+      const auto feature_concentrations = standards_components_to_concentrations.find(component_name);
+      if (feature_concentrations == standards_components_to_concentrations.end()) {
+        return;
+      }
+      auto feature_concentrations_pruned = sequenceSegmentHandler_IO.getFeatureConcentrationsPruned(feature_concentrations->second);
 
       // remove components without any points
       if (feature_concentrations_pruned.empty()) {
-        continue;
+        return;
       }
 
       // Keep a copy to compute outer points
-      auto all_feature_concentrations = feature_concentrations_pruned;
+      const auto all_feature_concentrations = feature_concentrations_pruned;
 
       try
       {
-        absoluteQuantitation.optimizeSingleCalibrationCurve(
-          row.getComponentName(),
+        OpenMS::AbsoluteQuantitation component_quantitation(absoluteQuantitation);
+        std::vector<OpenMS::AbsoluteQuantitationMethod> component_quant_methods{ calibration.quant_method };
+        component_quantitation.setQuantMethods(component_quant_methods);
+        component_quantitation.optimizeSingleCalibrationCurve(
+          component_name,
           feature_concentrations_pruned
         );
+        calibration.quant_method = component_quantitation.getQuantMethods().front();
       }
       catch (OpenMS::Exception::DivisionByZero&)
       {
-        LOGW << "Warning: '" << row.getComponentName() << "' cannot be analysed - division by zero\n";
-        continue;
+        calibration.warning = "' cannot be analysed - division by zero\n";
+        return;
       }
       catch (...)
       {
-        LOGW << "Warning: '" << row.getComponentName() << "' cannot be analysed.\n";
-        continue;
+        calibration.warning = "' cannot be analysed.\n";
+        return;
       }
-
-      // Compute outer points
-      std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration> excluded_feature_concentrations;
+      calibration.fitted = true;
+
+      // Compute outer points: the optimization removes points without reordering the others,
+      // the next remaining point is checked first
+      const auto isSamePoint = [](const auto& lhs, const auto& rhs) {
+        return (lhs.IS_feature == rhs.IS_feature)
+          && (std::abs(lhs.actual_concentration - rhs.actual_concentration) < 1e-9)
+          && (std::abs(lhs.IS_actual_concentration - rhs.IS_actual_concentration) < 1e-9)
+          && (std::abs(lhs.dilution_factor - rhs.dilution_factor) < 1e-9);
+      };
+      size_t next_pruned = 0;
       for (const auto& feature : all_feature_concentrations)
       {
         bool found = false;
-        for (const auto& feature_pruned : feature_concentrations_pruned)
+        if (next_pruned < feature_concentrations_pruned.size() && isSamePoint(feature, feature_concentrations_pruned[next_pruned]))
+        {
+          found = true;
+          ++next_pruned;
+        }
+        else
         {
-          if ((feature.IS_feature == feature_pruned.IS_feature)
-            && (std::abs(feature.actual_concentration - feature_pruned.actual_concentration) < 1e-9)
-            && (std::abs(feature.IS_actual_concentration - feature_pruned.IS_actual_concentration) < 1e-9)
-            && (std::abs(feature.dilution_factor - feature_pruned.dilution_factor) < 1e-9))
-          {
-            found = true;
-            break;
-          }
+          found = std::any_of(feature_concentrations_pruned.cbegin(), feature_concentrations_pruned.cend(),
+            [&](const auto& feature_pruned) { return isSamePoint(feature, feature_pruned); });
         }
         if (!found)
         {
-          excluded_feature_concentrations.push_back(feature);
+          calibration.excluded_feature_concentrations.push_back(feature);
         }
       }
-      components_to_concentrations.erase(row.getComponentName());
-      components_to_concentrations.insert({ row.getComponentName(), feature_concentrations_pruned });
-      excluded_components_to_concentrations.erase(row.getComponentName());
-      excluded_components_to_concentrations.insert({ row.getComponentName(), excluded_feature_concentrations });
+      calibration.feature_concentrations = std::move(feature_concentrations_pruned);
+    };
+
+    // fit the components in parallel when running on the thread pool
+    ThreadPool* thread_pool = ThreadPool::current();
+    if (thread_pool && calibrations.size() > 1) {
+      thread_pool->parallelFor(calibrations.size(), fitCalibration);
+    }
+    else {
+      for (size_t i = 0; i < calibrations.size(); ++i) {
+        fitCalibration(i);
+      }
+    }
+
+    // merge the results, by component name
+    std::map<std::string, std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>> components_to_concentrations;
+    std::map<std::string, std::vector<OpenMS::AbsoluteQuantitationStandards::featureConcentration>> excluded_components_to_concentrations;
+    std::vector<OpenMS::AbsoluteQuantitationMethod> optimized_quant_methods;
+    optimized_quant_methods.reserve(calibrations.size());
+    for (ComponentCalibration& calibration : calibrations) {
+      const std::string component_name = calibration.quant_method.getComponentName();
+      if (!calibration.warning.empty()) {
+        LOGW << "Warning: '" << component_name << calibration.warning;
+      }
+      if (calibration.fitted) {
+        components_to_concentrations.insert({ component_name, std::move(calibration.feature_concentrations) });
+        excluded_components_to_concentrations.insert({ component_name, std::move(calibration.excluded_feature_concentrations) });
+      }
+      optimized_quant_methods.push_back(std::move(calibration.quant_method));
     }
     // store results
     sequenceSegmentHandler_IO.setComponentsToConcentrations(components_to_concentrations);
     sequenceSegmentHandler_IO.setExcludedComponentsToConcentrations(excluded_components_to_concentrations);
-    sequenceSegmentHandler_IO.getQuantitationMethods() = absoluteQuantitation.getQuantMethods();
+    sequenceSegmentHandler_IO.getQuantitationMethods() = optimized_quant_methods;
   }
 
 }
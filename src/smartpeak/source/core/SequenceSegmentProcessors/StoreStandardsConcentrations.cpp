@@ -114,7 +114,10 @@ namespace SmartPeak
           concentration.dilution_factor
           );
       }
-      filenames_I.getSessionDB().endWrite(*db_context);
+      if (!filenames_I.getSessionDB().endWrite(*db_context))
+      {
+        throw std::runtime_error("Failed to save in session database");
+      }
     }
     else
     {
@@ -207,8 +207,14 @@ namespace SmartPeak {
           const auto sequence_segment_names = session_handler.getSelectSequenceSegmentNamesWorkflow(application_handler.sequenceHandler_);
           const auto sample_group_names = session_handler.getSelectSampleGroupNamesWorkflow(application_handler.sequenceHandler_);
 
-          int number_of_threads = std::thread::hardware_concurrency();
+          int number_of_threads = application_manager->nb_threads;
+          if (number_of_threads < 1) number_of_threads = std::thread::hardware_concurrency();
           if (number_of_threads < 1) number_of_threads = 1;
+          // the nested parallel loops of the processors run on the pool of the workflow, bounded by the threads of the job
+          if (!application_handler.thread_pool_ || application_handler.thread_pool_->capacity() != static_cast<size_t>(number_of_threads))
+          {
+            application_handler.thread_pool_ = std::make_shared<ThreadPool>(number_of_threads);
+          }
           workflow_manager.addWorkflow(
             application_handler,
             injection_names,
@@ -267,6 +273,9 @@ namespace SmartPeak {
               report_metadata, report_sample_types);
           }
 
+          // returned to the client along with the reports, see WorkflowResult::path_to_results
+          application_handler.processor_profiler_->writeJSON(reports_out_dir / "ProcessorProfile.json");
+
           job_done &= true;
         }
         catch(const std::exception& e)
@@ -286,6 +295,139 @@ namespace SmartPeak {
       return job_done;
     }
 
+    JobQueue::JobQueue(size_t max_running_jobs) :
+      max_running_jobs_(std::max<size_t>(max_running_jobs, 1))
+    {
+    }
+
+    JobQueue::~JobQueue()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        for (auto& job : queued_jobs_)
+        {
+          status_[job->job_id] = JobStatus::CANCELLED;
+          job->result.set_value(false);
+        }
+        queued_jobs_.clear();
+      }
+      cv_.notify_all();
+      for (auto& runner : runners_)
+      {
+        runner.join();
+      }
+    }
+
+    std::shared_future<bool> JobQueue::submit(const std::string& job_id, std::function<bool()> job)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stop_ || status_.count(job_id))
+      {
+        return std::shared_future<bool>();
+      }
+      auto queued_job = std::make_shared<Job>();
+      queued_job->job_id = job_id;
+      queued_job->run = std::move(job);
+      std::shared_future<bool> result = queued_job->result.get_future().share();
+      queued_jobs_.push_back(queued_job);
+      status_[job_id] = JobStatus::QUEUED;
+      LOGI << "Job " << job_id << " queued (" << nb_running_ << " running, " << queued_jobs_.size() << " queued)";
+      // runners are started lazily and kept for the next jobs
+      if (runners_.size() < max_running_jobs_ && runners_.size() < nb_running_ + queued_jobs_.size())
+      {
+        runners_.emplace_back(&JobQueue::runJobs, this);
+      }
+      cv_.notify_one();
+      return result;
+    }
+
+    bool JobQueue::cancel(const std::string& job_id)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::find_if(queued_jobs_.begin(), queued_jobs_.end(),
+        [&job_id](const auto& job) { return job->job_id == job_id; });
+      if (it == queued_jobs_.end())
+      {
+        return false;
+      }
+      (*it)->result.set_value(false);
+      queued_jobs_.erase(it);
+      status_[job_id] = JobStatus::CANCELLED;
+      LOGI << "Job " << job_id << " cancelled";
+      return true;
+    }
+
+    bool JobQueue::forget(const std::string& job_id)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto it = status_.find(job_id);
+      if (it == status_.end() || (it->second != JobStatus::DONE && it->second != JobStatus::CANCELLED))
+      {
+        return false;
+      }
+      status_.erase(it);
+      return true;
+    }
+
+    JobQueue::JobStatus JobQueue::getStatus(const std::string& job_id) const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto it = status_.find(job_id);
+      return (it == status_.end()) ? JobStatus::UNKNOWN : it->second;
+    }
+
+    size_t JobQueue::getNbRunningJobs() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return nb_running_;
+    }
+
+    size_t JobQueue::getNbQueuedJobs() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return queued_jobs_.size();
+    }
+
+    void JobQueue::runJobs()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true)
+      {
+        cv_.wait(lock, [this]() { return stop_ || !queued_jobs_.empty(); });
+        if (queued_jobs_.empty())
+        {
+          return;
+        }
+        auto job = queued_jobs_.front();
+        queued_jobs_.pop_front();
+        status_[job->job_id] = JobStatus::RUNNING;
+        ++nb_running_;
+        lock.unlock();
+
+        LOGI << "Job " << job->job_id << " started";
+        bool success = false;
+        try
+        {
+          success = job->run();
+        }
+        catch (const std::exception& e)
+        {
+          LOGE << "Job " << job->job_id << " failed: " << e.what();
+        }
+        catch (...)
+        {
+          LOGE << "Job " << job->job_id << " failed with an unknown exception";
+        }
+        LOGI << "Job " << job->job_id << " finished: " << (success ? "YES" : "NO");
+
+        lock.lock();
+        --nb_running_;
+        status_[job->job_id] = JobStatus::DONE;
+        job->result.set_value(success);
+      }
+    }
+
     void processRemoteWorkflow(
         std::future<std::string>& runworkflow_future, std::string& username,
         ApplicationHandler& application_handler, SessionHandler& session_handler,
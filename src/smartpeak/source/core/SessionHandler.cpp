@@ -36,14 +36,27 @@ namespace SmartPeak
   void SessionHandler::onSequenceUpdated()
   {
     sequence_table.clear();
+    feature_table_dirty_ = true;
+    feature_matrix_dirty_ = true;
+    feature_matrix_columns_.clear();
+    std::lock_guard<std::mutex> lock(plot_series_mutex_);
+    plot_series_.clear();
   }
 
   void SessionHandler::onTransitionsUpdated()
   {
     transitions_table.clear();
+    feature_table_dirty_ = true;
+    feature_matrix_dirty_ = true;
+    feature_matrix_columns_.clear();
   }
 
-  void SessionHandler::onFeaturesUpdated() {}
+  void SessionHandler::onFeaturesUpdated()
+  {
+    // the feature matrix columns are kept, and checked against the feature tables of the injections on the next update
+    feature_table_dirty_ = true;
+    feature_matrix_dirty_ = true;
+  }
 
   std::string findSampleNameFromStandardConcentration(
     const SmartPeak::SequenceSegmentHandler& sequence_segment,
@@ -136,6 +149,7 @@ namespace SmartPeak
     if (feature_table.body_.dimension(0) != n_rows) {
       LOGD << "Making feature_table.body_";
       feature_table.body_.resize(n_rows, n_cols);
+      ++feature_explorer_version_;
       int col = 0, row = 0;
       for (const auto& metadata : metadataFloatToString) {
         feature_table.body_(row, col) = metadata.second;
@@ -185,6 +199,7 @@ namespace SmartPeak
     if (table_data.body_.dimension(0) != n_rows) {
       LOGD << "Making sequence_table_body";
       table_data.body_.resize(n_rows, n_cols);
+      ++sequence_table_version_;
       int col = 0, row = 0;
       for (const auto& injection : sequence_handler.getSequence()) {
         table_data.body_(row, col) = std::to_string(injection.getMetaData().inj_number);
@@ -235,6 +250,7 @@ namespace SmartPeak
       if (table_data.body_.dimension(0) != n_rows) {
         LOGD << "Making transitions_table_body";
         table_data.body_.resize(n_rows, n_cols);
+        ++transitions_table_version_;
         int col = 0, row = 0;
         for (const auto& transition : targeted_exp.getTransitions()) {
           table_data.body_(row, col) = transition.getPeptideRef();
@@ -1530,42 +1546,26 @@ namespace SmartPeak
     if (sequence_handler.getSequence().size() > 0 &&
       sequence_handler.getSequence().at(0).getRawData().getFeatureMapHistory().size() > 0) {
       // Make the feature table headers and body
-      if (feature_table_unique_samples_transitions_ != getNSelectedSampleNamesPlot()*getNSelectedTransitionsPlot()
-          || table_data.body_.dimension(1) != 23 + getNSelectedFeatureMetaValuesTable()) {
+      const NameSelection& selected_feature_names = getFeatureMetaValuesTableSelection();
+      ExplorerSelection selection = getExplorerSelection(selected_feature_names);
+      if (feature_table_dirty_ || selection != feature_table_selection_
+          || table_data.body_.dimension(1) != 23 + static_cast<Eigen::Index>(selected_feature_names.getNbSelected())) {
         LOGD << "Making feature_table_body and feature_table_headers";
         // get the selected feature names
-        Eigen::Tensor<std::string, 1> selected_feature_names = getSelectFeatureMetaValuesTable();
-        std::vector<std::string> feature_names;
-        for (int i = 0; i < selected_feature_names.size(); ++i) {
-          if (std::count(feature_names.begin(), feature_names.end(), selected_feature_names(i)) == 0 && !selected_feature_names(i).empty())
-            feature_names.push_back(selected_feature_names(i));
-        }
+        const std::vector<std::string> feature_names = selected_feature_names.getSelectedNames();
         // get the selected sample types
         std::set<SampleType> sample_types; // TODO: options for the user to select what sample_types
         for (const std::pair<SampleType, std::string>& p : sampleTypeToString) sample_types.insert(p.first);
-        // get the selected sample names
-        Eigen::Tensor<std::string, 1> selected_sample_names = getSelectSampleNamesPlot();
-        std::set<std::string> sample_names;
-        for (int i = 0; i < selected_sample_names.size(); ++i) {
-          if (!selected_sample_names(i).empty())
-            sample_names.insert(selected_sample_names(i));
-        }
-        // get the selected transitions
-        Eigen::Tensor<std::string, 1> selected_transitions = getSelectTransitionsPlot();
-        std::set<std::string> component_names;
-        for (int i = 0; i < selected_transitions.size(); ++i) {
-          if (!selected_transitions(i).empty())
-            component_names.insert(selected_transitions(i));
-        }
-        // get the selected transition groups
-        Eigen::Tensor<std::string, 1> selected_transition_groups = getSelectTransitionGroupsPlot();
-        std::set<std::string> component_group_names;
-        for (int i = 0; i < selected_transition_groups.size(); ++i) {
-          if (!selected_transition_groups(i).empty())
-            component_group_names.insert(selected_transition_groups(i));
-        }
-        // update the number of unique samples, transitions, and feature metavalues
-        feature_table_unique_samples_transitions_ = getNSelectedSampleNamesPlot() * getNSelectedTransitionsPlot();
+        // get the selected sample names, transitions and transition groups
+        const std::vector<std::string> selected_sample_names = getSampleNamesPlotSelection().getSelectedNames();
+        const std::set<std::string> sample_names(selected_sample_names.begin(), selected_sample_names.end());
+        const std::vector<std::string> selected_transitions = getTransitionsPlotSelection().getSelectedNames();
+        const std::set<std::string> component_names(selected_transitions.begin(), selected_transitions.end());
+        const std::vector<std::string> selected_transition_groups = getTransitionGroupsPlotSelection().getSelectedNames();
+        const std::set<std::string> component_group_names(selected_transition_groups.begin(), selected_transition_groups.end());
+        // update the selection the table is made from
+        feature_table_selection_ = std::move(selection);
+        feature_table_dirty_ = false;
         std::vector<std::vector<std::string>> table;
         std::vector<std::string> headers;
         SequenceParser::makeDataTableFromMetaValue(sequence_handler, table, headers, feature_names,
@@ -1594,80 +1594,223 @@ namespace SmartPeak
   {
     if (sequence_handler.getSequence().size() > 0 &&
       sequence_handler.getSequence().at(0).getRawData().getFeatureMapHistory().size() > 0) {
-      // Make the feature_pivot table headers and body
-      if (feat_value_data.dimension(1) != getNSelectedSampleNamesPlot() || feature_matrix_unique_transitions_ != getNSelectedTransitionsPlot() * getNSelectedFeatureMetaValuesPlot()) {
-        LOGD << "Making feature matrix, line plot, and data tables";
-        // get the selected feature names
-        Eigen::Tensor<std::string, 1> selected_feature_names = getSelectFeatureMetaValuesPlot();
-        std::vector<std::string> feature_names;
-        for (int i = 0; i < selected_feature_names.size(); ++i) {
-          if (std::count(feature_names.begin(), feature_names.end(), selected_feature_names(i)) == 0 && !selected_feature_names(i).empty())
-            feature_names.push_back(selected_feature_names(i));
-        }
-        // get the selected sample types
-        std::set<SampleType> sample_types; // TODO: options for the user to select what sample_types
-        for (const std::pair<SampleType, std::string>& p : sampleTypeToString) sample_types.insert(p.first);
-        // get the selected sample names
-        Eigen::Tensor<std::string, 1> selected_sample_names = getSelectSampleNamesPlot();
-        std::set<std::string> sample_names;
-        for (int i = 0; i < selected_sample_names.size(); ++i) {
-          if (!selected_sample_names(i).empty())
-            sample_names.insert(selected_sample_names(i));
+      const NameSelection& selected_feature_names = getFeatureMetaValuesPlotSelection();
+      ExplorerSelection selection = getExplorerSelection(selected_feature_names);
+      if (!feature_matrix_dirty_ && selection == feature_matrix_selection_) {
+        return;
+      }
+      LOGD << "Making feature matrix, line plot, and data tables";
+      // the columns depend on the selected transitions and feature names, but not on the other selected samples
+      if (selection.transitions != feature_matrix_selection_.transitions || selection.feature_meta_values != feature_matrix_selection_.feature_meta_values) {
+        feature_matrix_columns_.clear();
+      }
+      feature_matrix_selection_ = std::move(selection);
+      feature_matrix_dirty_ = false;
+      // get the selected feature names
+      const std::vector<std::string> feature_names = selected_feature_names.getSelectedNames();
+      // get the selected sample names, transitions and transition groups
+      const NameSelection& sample_names = getSampleNamesPlotSelection();
+      const std::vector<std::string> selected_transitions = getTransitionsPlotSelection().getSelectedNames();
+      const std::set<std::string> component_names(selected_transitions.begin(), selected_transitions.end());
+      const std::vector<std::string> selected_transition_groups = getTransitionGroupsPlotSelection().getSelectedNames();
+      const std::set<std::string> component_group_names(selected_transition_groups.begin(), selected_transition_groups.end());
+      // get the feature tables of the selected samples
+      std::map<std::string, std::vector<SequenceParser::InjectionFeatureTable>> sample_feature_tables;
+      for (const auto& injection : sequence_handler.getSequence()) {
+        const std::string& sample_name = injection.getMetaData().getSampleName();
+        if (sample_names.getNbSelected() && !sample_names.isSelected(sample_name)) continue;
+        sample_feature_tables[sample_name].push_back({ sample_name,
+                                                       injection.getRawData().getFeatureTable(feature_names),
+                                                       &injection.getRawData().getValidationMetrics() });
+      }
+      // update the columns of the samples whose features have changed
+      std::map<std::tuple<std::string, std::string, std::string, std::string>, int> row_indices;
+      for (const auto& sample_feature_table : sample_feature_tables) {
+        FeatureMatrixColumn& column = feature_matrix_columns_[sample_feature_table.first];
+        std::vector<std::shared_ptr<const FeatureTable>> feature_tables;
+        for (const auto& injection_feature_table : sample_feature_table.second) {
+          feature_tables.push_back(injection_feature_table.feature_table);
         }
-        // get the selected transitions
-        Eigen::Tensor<std::string, 1> selected_transitions = getSelectTransitionsPlot();
-        std::set<std::string> component_names;
-        for (int i = 0; i < selected_transitions.size(); ++i) {
-          if (!selected_transitions(i).empty())
-            component_names.insert(selected_transitions(i));
+        if (column.feature_tables != feature_tables) {
+          Eigen::Tensor<float, 2> values;
+          Eigen::Tensor<std::string, 1> columns;
+          Eigen::Tensor<std::string, 2> rows;
+          SequenceParser::makeDataMatrixFromFeatureTables(sample_feature_table.second, values, columns, rows, feature_names, component_group_names, component_names);
+          // with a single sample, all the rows hold a value of the sample
+          column.rows.resize(rows.dimension(0));
+          column.values.resize(rows.dimension(0));
+          for (int row = 0; row < rows.dimension(0); ++row) {
+            column.rows[row] = { rows(row, 0), rows(row, 1), rows(row, 2) };
+            column.values[row] = values(row, 0);
+          }
+          column.feature_tables = std::move(feature_tables);
         }
-        // get the selected transition groups
-        Eigen::Tensor<std::string, 1> selected_transition_groups = getSelectTransitionGroupsPlot();
-        std::set<std::string> component_group_names;
-        for (int i = 0; i < selected_transition_groups.size(); ++i) {
-          if (!selected_transition_groups(i).empty())
-            component_group_names.insert(selected_transition_groups(i));
+        // rows are sorted on the concatenation of their names, as in the exported data matrix
+        for (const auto& row : column.rows) {
+          row_indices.emplace(std::make_tuple(row[1] + row[0] + row[2], row[1], row[0], row[2]), 0);
         }
-        // Update the unique transitions
-        feature_matrix_unique_transitions_ = getNSelectedTransitionsPlot() * getNSelectedFeatureMetaValuesPlot();
-        // get the matrix of data
-        Eigen::Tensor<std::string, 2> rows_out;
-        SequenceParser::makeDataMatrixFromMetaValue(sequence_handler, feat_value_data, feat_col_labels, rows_out, feature_names, sample_types, sample_names, component_group_names, component_names);
-        setFeatureLinePlot();
-        // update the pivot table headers with the columns for the pivot table/heatmap rows
-        feature_pivot_table.headers_.resize((int)feat_col_labels.size() + 3);
-        feature_pivot_table.headers_(0) = "feature_name";
-        feature_pivot_table.headers_(1) = "component_group_name";
-        feature_pivot_table.headers_(2) = "component_name";
-        feature_pivot_table.headers_.slice(Eigen::array<Eigen::Index, 1>({ 3 }), Eigen::array<Eigen::Index, 1>({ feat_col_labels.size() })) = feat_col_labels;
-        const int n_cols = feature_pivot_table.headers_.size();
-        const int n_rows = feat_value_data.dimension(0);
-        // allocate space for the pivot table body and heatmap row labels
-        feat_row_labels.resize(n_rows);
-        feature_pivot_table.body_.resize(n_rows, n_cols);
-        // assign the pivot table body data and heatmap row labels
-        int col = 0;
-        for (int row = 0; row < n_rows; ++row) {
-          feat_row_labels(row) = rows_out(row, 0) + "::" + rows_out(row, 2);
-          for (int j = 0; j < rows_out.dimension(1); ++j) {
-            feature_pivot_table.body_(row, col) = rows_out(row, j);
-            ++col;
-          }
-          for (int j = 0; j < feat_value_data.dimension(1); ++j) {
-            feature_pivot_table.body_(row, col) = std::to_string(feat_value_data(row, j));
-            ++col;
-          }
-          col = 0;
+      }
+      // assemble the matrix, samples without values are omitted
+      const int n_rows = row_indices.size();
+      int n_samples = 0;
+      for (auto& row_index : row_indices) {
+        row_index.second = n_samples++;
+      }
+      n_samples = 0;
+      for (const auto& sample_feature_table : sample_feature_tables) {
+        if (!feature_matrix_columns_.at(sample_feature_table.first).rows.empty()) ++n_samples;
+      }
+      feat_col_labels.resize(n_samples);
+      feat_value_data.resize(n_rows, n_samples);
+      feat_value_data.setConstant(0.0);
+      int col = 0;
+      for (const auto& sample_feature_table : sample_feature_tables) {
+        const FeatureMatrixColumn& column = feature_matrix_columns_.at(sample_feature_table.first);
+        if (column.rows.empty()) continue;
+        feat_col_labels(col) = sample_feature_table.first;
+        for (size_t i = 0; i < column.rows.size(); ++i) {
+          const auto& row = column.rows[i];
+          feat_value_data(row_indices.at(std::make_tuple(row[1] + row[0] + row[2], row[1], row[0], row[2])), col) = column.values[i];
         }
+        ++col;
+      }
+      setFeatureLinePlot();
+      // update the pivot table headers with the columns for the pivot table/heatmap rows
+      feature_pivot_table.headers_.resize((int)feat_col_labels.size() + 3);
+      feature_pivot_table.headers_(0) = "feature_name";
+      feature_pivot_table.headers_(1) = "component_group_name";
+      feature_pivot_table.headers_(2) = "component_name";
+      feature_pivot_table.headers_.slice(Eigen::array<Eigen::Index, 1>({ 3 }), Eigen::array<Eigen::Index, 1>({ feat_col_labels.size() })) = feat_col_labels;
+      // assign the pivot table body data and heatmap row labels, the values are formatted when displayed
+      feat_row_labels.resize(n_rows);
+      feature_pivot_table.body_.resize(n_rows, 3);
+      for (const auto& row_index : row_indices) {
+        const int row = row_index.second;
+        feature_pivot_table.body_(row, 0) = std::get<2>(row_index.first);
+        feature_pivot_table.body_(row, 1) = std::get<1>(row_index.first);
+        feature_pivot_table.body_(row, 2) = std::get<3>(row_index.first);
+        feat_row_labels(row) = std::get<2>(row_index.first) + "::" + std::get<3>(row_index.first);
       }
+      feature_pivot_table.values_ = feat_value_data;
+      ++feature_matrix_version_;
     }
   }
-  
+
+  SessionHandler::ExplorerSelection SessionHandler::getExplorerSelection(const NameSelection& feature_meta_values) const
+  {
+    ExplorerSelection selection;
+    selection.injections = getSampleNamesPlotSelection().getVersion();
+    selection.transitions = getTransitionsPlotSelection().getVersion() + getTransitionGroupsPlotSelection().getVersion();
+    selection.feature_meta_values = feature_meta_values.getVersion();
+    return selection;
+  }
+
+  const NameSelection& SessionHandler::syncSelection(ExplorerNameSelection& selection,
+                                                     const GenericTableData& table,
+                                                     size_t table_version,
+                                                     int name_column,
+                                                     const ExplorerData& explorer_data,
+                                                     int checkbox_column) const
+  {
+    if (selection.table_version != table_version || selection.selection.getNbRows() != table.body_.dimension(0)) {
+      selection.selection.setNames(table.body_, name_column);
+      selection.table_version = table_version;
+    }
+    selection.selection.setChecked(explorer_data.checkbox_body, checkbox_column);
+    return selection.selection;
+  }
+
+  const NameSelection& SessionHandler::getSampleNamesPlotSelection() const
+  {
+    return syncSelection(sample_names_plot_selection_, sequence_table, sequence_table_version_, 1, injection_explorer_data, 1);
+  }
+  const NameSelection& SessionHandler::getTransitionsPlotSelection() const
+  {
+    return syncSelection(transitions_plot_selection_, transitions_table, transitions_table_version_, 1, transition_explorer_data, 0);
+  }
+  const NameSelection& SessionHandler::getTransitionGroupsPlotSelection() const
+  {
+    return syncSelection(transition_groups_plot_selection_, transitions_table, transitions_table_version_, 0, transition_explorer_data, 0);
+  }
+  const NameSelection& SessionHandler::getTransitionsTableSelection() const
+  {
+    return syncSelection(transitions_table_selection_, transitions_table, transitions_table_version_, 1, transition_explorer_data, 1);
+  }
+  const NameSelection& SessionHandler::getTransitionGroupsTableSelection() const
+  {
+    return syncSelection(transition_groups_table_selection_, transitions_table, transitions_table_version_, 0, transition_explorer_data, 1);
+  }
+  const NameSelection& SessionHandler::getFeatureMetaValuesPlotSelection() const
+  {
+    return syncSelection(feature_meta_values_plot_selection_, feature_table, feature_explorer_version_, 0, feature_explorer_data, 0);
+  }
+  const NameSelection& SessionHandler::getFeatureMetaValuesTableSelection() const
+  {
+    return syncSelection(feature_meta_values_table_selection_, feature_table, feature_explorer_version_, 0, feature_explorer_data, 1);
+  }
+  size_t SessionHandler::getPlotSelectionVersion() const
+  {
+    return getSampleNamesPlotSelection().getVersion() + getTransitionsPlotSelection().getVersion() + getTransitionGroupsPlotSelection().getVersion();
+  }
+
+  bool SessionHandler::addPlotSeries(GraphVizData& result,
+                                     const std::string& key,
+                                     const std::function<void(std::vector<float>&, std::vector<float>&)>& make_series,
+                                     const std::pair<float, float>& range,
+                                     const std::optional<PlotViewport>& viewport,
+                                     const std::string& series_name) const
+  {
+    // the plots may be prepared concurrently, on the data preparation threads
+    std::shared_ptr<const DecimationPyramid> pyramid;
+    {
+      std::lock_guard<std::mutex> lock(plot_series_mutex_);
+      const auto it = plot_series_.find(key);
+      if (it != plot_series_.end())
+      {
+        pyramid = it->second;
+      }
+    }
+    if (!pyramid)
+    {
+      std::vector<float> x_data, y_data;
+      make_series(x_data, y_data);
+      pyramid = std::make_shared<const DecimationPyramid>(std::move(x_data), std::move(y_data));
+      std::lock_guard<std::mutex> lock(plot_series_mutex_);
+      plot_series_.emplace(key, pyramid);
+    }
+    const auto [first, last] = pyramid->getIndexRange(range.first, range.second);
+    std::vector<float> x_data, y_data;
+    if (!viewport)
+    {
+      pyramid->decimate(first, last, 0, x_data, y_data);
+      return result.addData(x_data, y_data, series_name);
+    }
+    // the visible points, and the ones next to them so that the lines reach the borders of the plot
+    auto [view_first, view_last] = pyramid->getIndexRange(viewport->x_min, viewport->x_max);
+    view_first = std::max(first, view_first > 0 ? view_first - 1 : view_first);
+    view_last = std::min(last, view_last + 1);
+    pyramid->decimate(view_first, view_last, 2 * static_cast<size_t>(std::max(viewport->pixel_width, 0)), x_data, y_data);
+    if (!result.addData(x_data, y_data, series_name))
+    {
+      return false;
+    }
+    // the axes extents cover the whole series, to fit the zoom to all the data
+    if (const auto extent = pyramid->getExtent(first, last))
+    {
+      result.x_min_ = std::min(result.x_min_, extent->x_min);
+      result.x_max_ = std::max(result.x_max_, extent->x_max);
+      result.y_min_ = std::min(result.y_min_, extent->y_min);
+      result.y_max_ = std::max(result.y_max_, extent->y_max);
+    }
+    return true;
+  }
+
   void SessionHandler::getChromatogramScatterPlot(const SequenceHandler & sequence_handler, 
                                                   GraphVizData& result, 
                                                   const std::pair<float, float>& chrom_time_range,
                                                   const std::set<std::string>& sample_names,
-                                                  const std::set<std::string>& component_names) const
+                                                  const std::set<std::string>& component_names,
+                                                  const std::optional<PlotViewport>& viewport) const
   {
     if (sequence_handler.getSequence().size() > 0 &&
       (sequence_handler.getSequence().at(0).getRawData().getFeatureMapHistory().size() > 0 ||
@@ -1679,15 +1822,22 @@ namespace SmartPeak
       for (const auto& injection : sequence_handler.getSequence()) {
         if (sample_names.count(injection.getMetaData().getSampleName()) == 0) continue;
         // Extract out the raw data for plotting
-        for (const auto& chromatogram : injection.getRawData().getChromatogramMap().getChromatograms()) {
+        const auto& chromatograms = injection.getRawData().getChromatogramMap().getChromatograms();
+        for (size_t i = 0; i < chromatograms.size(); ++i) {
+          const auto& chromatogram = chromatograms[i];
           if (component_names.count(chromatogram.getNativeID()) == 0) continue;
-          std::vector<float> x_data, y_data;
-          //for (const auto& point : chromatogram) {
-          for (auto point = chromatogram.PosBegin(chrom_time_range.first); point != chromatogram.PosEnd(chrom_time_range.second); ++point) {
-            x_data.push_back(point->getRT());
-            y_data.push_back(point->getIntensity());
-          }
-          if (!result.addData(x_data, y_data, injection.getMetaData().getSampleName() + "::" + chromatogram.getNativeID()))
+          auto make_series = [&chromatogram](std::vector<float>& x_data, std::vector<float>& y_data) {
+            for (const auto& point : chromatogram) {
+              x_data.push_back(point.getRT());
+              y_data.push_back(point.getIntensity());
+            }
+          };
+          if (!addPlotSeries(result,
+                             "chromatogram::" + injection.getMetaData().getInjectionName() + "::" + std::to_string(i),
+                             make_series,
+                             chrom_time_range,
+                             viewport,
+                             injection.getMetaData().getSampleName() + "::" + chromatogram.getNativeID()))
           {
             return;
           }
@@ -1721,7 +1871,8 @@ namespace SmartPeak
   void SessionHandler::getChromatogramTIC(const SequenceHandler& sequence_handler,
     GraphVizData& result,
     const std::pair<float, float>& chrom_time_range,
-    const std::set<std::string>& sample_names) const
+    const std::set<std::string>& sample_names,
+    const std::optional<PlotViewport>& viewport) const
   {
     LOGD << "Making the chromatogram TIC data for plotting";
     // Set the axes titles and min/max defaults
@@ -1729,18 +1880,23 @@ namespace SmartPeak
     for (const auto& injection : sequence_handler.getSequence())
     {
       if (sample_names.count(injection.getMetaData().getSampleName()) == 0) continue;
-      const auto& experiment = injection.getRawData().getExperiment();
-      std::vector<float> x_data, y_data;
-      for (const auto& spectrum : experiment)
-      {
-        const auto ms_level = spectrum.getMSLevel();
-        if (ms_level == 1)
+      auto make_series = [&injection](std::vector<float>& x_data, std::vector<float>& y_data) {
+        for (const auto& spectrum : injection.getRawData().getExperiment())
         {
-          x_data.push_back(spectrum.getRT());
-          y_data.push_back(spectrum.calculateTIC());
+          const auto ms_level = spectrum.getMSLevel();
+          if (ms_level == 1)
+          {
+            x_data.push_back(spectrum.getRT());
+            y_data.push_back(spectrum.calculateTIC());
+          }
         }
-      }
-      if (!result.addData(x_data, y_data, injection.getMetaData().getSampleName()))
+      };
+      if (!addPlotSeries(result,
+                         "tic::" + injection.getMetaData().getInjectionName(),
+                         make_series,
+                         chrom_time_range,
+                         viewport,
+                         injection.getMetaData().getSampleName()))
       {
         return;
       }
@@ -1816,7 +1972,8 @@ namespace SmartPeak
     GraphVizData& result,
     const std::pair<float, float>& range,
     const std::set<std::string>& sample_names,
-    const std::set<std::string>& component_group_names) const
+    const std::set<std::string>& component_group_names,
+    const std::optional<PlotViewport>& viewport) const
   {
     // Notes: PeptideRef matches the first annotation identifier
     if (sequence_handler.getSequence().size() > 0 &&
@@ -1829,13 +1986,21 @@ namespace SmartPeak
       for (const auto& injection : sequence_handler.getSequence()) {
         if (sample_names.count(injection.getMetaData().getSampleName()) == 0) continue;
         // Extract out the raw data for plotting
-        for (const auto& spectra : injection.getRawData().getExperiment().getSpectra()) {
-          std::vector<float> x_data, y_data;
-          for (auto point = spectra.PosBegin(range.first); point != spectra.PosEnd(range.second); ++point) {
-            x_data.push_back(point->getMZ());
-            y_data.push_back(point->getIntensity());
-          }
-          if (!result.addData(x_data, y_data, injection.getMetaData().getSampleName() + "::" + spectra.getNativeID()))
+        const auto& spectra_list = injection.getRawData().getExperiment().getSpectra();
+        for (size_t i = 0; i < spectra_list.size(); ++i) {
+          const auto& spectra = spectra_list[i];
+          auto make_series = [&spectra](std::vector<float>& x_data, std::vector<float>& y_data) {
+            for (const auto& point : spectra) {
+              x_data.push_back(point.getMZ());
+              y_data.push_back(point.getIntensity());
+            }
+          };
+          if (!addPlotSeries(result,
+                             "spectrum::" + injection.getMetaData().getInjectionName() + "::" + std::to_string(i),
+                             make_series,
+                             range,
+                             viewport,
+                             injection.getMetaData().getSampleName() + "::" + spectra.getNativeID()))
           {
             return;
           }
@@ -1958,6 +2123,27 @@ namespace SmartPeak
     feat_value_min = feat_value_data_minimum(0);
   }
   void SessionHandler::getHeatMap(const SequenceHandler& sequence_handler, HeatMapData& result, const std::string& feature_name)
+  {
+    // get the selected sample names, transitions and transition groups
+    const std::vector<std::string> selected_sample_names = getSampleNamesPlotSelection().getSelectedNames();
+    const std::set<std::string> sample_names(selected_sample_names.begin(), selected_sample_names.end());
+    const std::vector<std::string> selected_transitions = getTransitionsPlotSelection().getSelectedNames();
+    const std::set<std::string> component_names(selected_transitions.begin(), selected_transitions.end());
+    const std::vector<std::string> selected_transition_groups = getTransitionGroupsPlotSelection().getSelectedNames();
+    const std::set<std::string> component_group_names(selected_transition_groups.begin(), selected_transition_groups.end());
+    getHeatMap(sequence_handler, result, feature_name, sample_names, component_names, component_group_names);
+    result.selected_sample_names_ = getSelectSampleNamesPlot();
+    result.selected_transitions_ = getSelectTransitionsPlot();
+    result.selected_transition_groups_ = getSelectTransitionGroupsPlot();
+    result.selection_version_ = getPlotSelectionVersion();
+  }
+
+  void SessionHandler::getHeatMap(const SequenceHandler& sequence_handler,
+                                  HeatMapData& result,
+                                  const std::string& feature_name,
+                                  const std::set<std::string>& sample_names,
+                                  const std::set<std::string>& component_names,
+                                  const std::set<std::string>& component_group_names) const
   {
     LOGD << "Getting Heatmap data";
     std::vector<std::string> feature_names;
@@ -1965,29 +2151,6 @@ namespace SmartPeak
     // get the selected sample types
     std::set<SampleType> sample_types; // TODO: options for the user to select what sample_types
     for (const std::pair<SampleType, std::string>& p : sampleTypeToString) sample_types.insert(p.first);
-    // get the selected sample names
-    Eigen::Tensor<std::string, 1> selected_sample_names = getSelectSampleNamesPlot();
-    std::set<std::string> sample_names;
-    for (int i = 0; i < selected_sample_names.size(); ++i) {
-      if (!selected_sample_names(i).empty())
-        sample_names.insert(selected_sample_names(i));
-    }
-    // get the selected transitions
-    Eigen::Tensor<std::string, 1> selected_transitions = getSelectTransitionsPlot();
-    std::set<std::string> component_names;
-    for (int i = 0; i < selected_transitions.size(); ++i) {
-      if (!selected_transitions(i).empty())
-        component_names.insert(selected_transitions(i));
-    }
-    // get the selected transition groups
-    Eigen::Tensor<std::string, 1> selected_transition_groups = getSelectTransitionGroupsPlot();
-    std::set<std::string> component_group_names;
-    for (int i = 0; i < selected_transition_groups.size(); ++i) {
-      if (!selected_transition_groups(i).empty())
-        component_group_names.insert(selected_transition_groups(i));
-    }
-    // Update the unique transitions
-    feature_matrix_unique_transitions_ = getNSelectedTransitionsPlot() * getNSelectedFeatureMetaValuesPlot();
     // get the matrix of data
     if (sequence_handler.getSequence().size() > 0 &&
       sequence_handler.getSequence().at(0).getRawData().getFeatureMapHistory().size() > 0)
@@ -2027,9 +2190,6 @@ namespace SmartPeak
     result.feat_heatmap_x_axis_title = "Injections";
     result.feat_heatmap_y_axis_title = "Transitions";
     result.selected_feature_ = feature_name;
-    result.selected_sample_names_ = selected_sample_names;
-    result.selected_transitions_ = selected_transitions;
-    result.selected_transition_groups_ = selected_transition_groups;
   }
 
   std::tuple<
@@ -2071,12 +2231,8 @@ namespace SmartPeak
       sequence_handler.getSequenceSegments().at(0).getComponentsToConcentrations().size() > 0 &&
       sequence_handler.getSequenceSegments().at(0).getStandardsConcentrations().size() > 0) {
       // get the selected transitions
-      Eigen::Tensor<std::string, 1> selected_transitions = getSelectTransitionsPlot();
-      std::set<std::string> component_names;
-      for (int i = 0; i < selected_transitions.size(); ++i) {
-        if (!selected_transitions(i).empty())
-          component_names.insert(selected_transitions(i));
-      }
+      const std::vector<std::string> selected_transitions = getTransitionsPlotSelection().getSelectedNames();
+      const std::set<std::string> component_names(selected_transitions.begin(), selected_transitions.end());
       // LOGD << "Making the calibrators data for plotting";
       // Update the axis titles and clear the data
       result.x_axis_title = "Concentration ratio";
@@ -2279,13 +2435,10 @@ namespace SmartPeak
   Eigen::Tensor<bool, 1> SessionHandler::getFiltersTable(const Eigen::Tensor<std::string, 2>& to_filter) const
   {
     if (to_filter.size() && transition_explorer_data.checkbox_body.size()) {
-      Eigen::Tensor<std::string, 1> selected_transitions = getSelectTransitionsTable();
-      Eigen::Tensor<std::string, 1> table_transitions = to_filter.chip(0, 1);
+      const NameSelection& selected_transitions = getTransitionsTableSelection();
       Eigen::Tensor<bool, 1> table_filters(to_filter.dimension(0));
-      table_filters.setConstant(true);
       for (int row = 0; row < to_filter.dimension(0); ++row) {
-        if (std::count(selected_transitions.data(), selected_transitions.data() + selected_transitions.size(), table_transitions(row)) == 0)
-          table_filters(row) = false;
+        table_filters(row) = selected_transitions.isSelected(to_filter(row, 0));
       }
       return table_filters;
     }
@@ -2296,13 +2449,10 @@ namespace SmartPeak
   Eigen::Tensor<bool, 1> SessionHandler::getGroupFiltersTable(const Eigen::Tensor<std::string, 2>& to_filter) const
   {
     if (to_filter.size() && transition_explorer_data.checkbox_body.size()) {
-      Eigen::Tensor<std::string, 1> selected_transitions = getSelectTransitionGroupsTable();
-      Eigen::Tensor<std::string, 1> table_transitions = to_filter.chip(0, 1);
+      const NameSelection& selected_transitions = getTransitionGroupsTableSelection();
       Eigen::Tensor<bool, 1> table_filters(to_filter.dimension(0));
-      table_filters.setConstant(true);
       for (int row = 0; row < to_filter.dimension(0); ++row) {
-        if (std::count(selected_transitions.data(), selected_transitions.data() + selected_transitions.size(), table_transitions(row)) == 0)
-          table_filters(row) = false;
+        table_filters(row) = selected_transitions.isSelected(to_filter(row, 0));
       }
       return table_filters;
     }
@@ -0,0 +1,75 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/SpectraLibraryIndex.h>
+
+#include <plog/Log.h>
+
+namespace SmartPeak
+{
+  std::shared_ptr<OpenMS::MSExperiment> SpectraLibraryIndex::getLibrary(
+    const std::filesystem::path& filename,
+    const std::function<void(OpenMS::MSExperiment&)>& load)
+  {
+    std::error_code ec;
+    const auto last_write_time = std::filesystem::last_write_time(filename, ec);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (library_ && !ec && filename_ == filename && last_write_time_ == last_write_time)
+    {
+      LOGD << "Reusing spectra library " << filename.generic_string();
+      return library_;
+    }
+    auto library = std::make_shared<OpenMS::MSExperiment>();
+    load(*library);
+    library_ = library;
+    filename_ = filename;
+    last_write_time_ = ec ? std::filesystem::file_time_type::min() : last_write_time;
+    return library;
+  }
+
+  std::shared_ptr<const SpectraLibraryIndex::Comparator> SpectraLibraryIndex::getComparator(const std::shared_ptr<OpenMS::MSExperiment>& library)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (comparator_ && binned_library_.lock() == library && binned_library_size_ == library->size())
+    {
+      return comparator_;
+    }
+    auto comparator = std::make_shared<Comparator>();
+    std::map<OpenMS::String, OpenMS::DataValue> options;
+    comparator->init(library->getSpectra(), options);
+    comparator_ = comparator;
+    binned_library_ = library;
+    binned_library_size_ = library->size();
+    return comparator_;
+  }
+
+  void SpectraLibraryIndex::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    filename_.clear();
+    library_.reset();
+    binned_library_.reset();
+    binned_library_size_ = 0;
+    comparator_.reset();
+  }
+}
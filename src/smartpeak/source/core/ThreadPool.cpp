@@ -0,0 +1,223 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/ThreadPool.h>
+#include <plog/Log.h>
+
+namespace SmartPeak
+{
+  namespace
+  {
+    thread_local ThreadPool* current_pool = nullptr;
+    thread_local size_t current_worker_index = 0;
+  }
+
+  ThreadPool::ThreadPool(size_t capacity)
+  {
+    if (capacity == 0)
+    {
+      capacity = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i)
+    {
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    for (auto& thread : threads_)
+    {
+      if (thread.joinable())
+      {
+        thread.join();
+      }
+    }
+  }
+
+  void ThreadPool::reserve(size_t n_threads)
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    n_threads = std::min(n_threads, queues_.size());
+    if (threads_.size() >= n_threads)
+    {
+      return;
+    }
+    while (threads_.size() < n_threads)
+    {
+      const size_t worker_index = threads_.size();
+      threads_.emplace_back(&ThreadPool::workerLoop, this, worker_index);
+      nb_started_.store(threads_.size());
+    }
+    LOGD << "Thread pool size: " << threads_.size();
+  }
+
+  bool ThreadPool::isWorkerThread() const
+  {
+    return current_pool == this;
+  }
+
+  ThreadPool* ThreadPool::current()
+  {
+    return current_pool;
+  }
+
+  void ThreadPool::push(std::function<void()> task)
+  {
+    const size_t nb_started = std::max<size_t>(1, nb_started_.load());
+    const size_t queue_index = isWorkerThread() ? current_worker_index : (next_queue_.fetch_add(1) % nb_started);
+    {
+      // counted before being queued so that pop never sees more tasks than pending_tasks_
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      pending_tasks_.fetch_add(1);
+    }
+    {
+      std::lock_guard<std::mutex> lock(queues_[queue_index]->mutex);
+      queues_[queue_index]->tasks.push_back(std::move(task));
+    }
+    sleep_cv_.notify_one();
+  }
+
+  bool ThreadPool::pop(size_t worker_index, std::function<void()>& task)
+  {
+    // own queue first, most recently pushed task
+    {
+      auto& queue = *queues_[worker_index];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty())
+      {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        pending_tasks_.fetch_sub(1);
+        return true;
+      }
+    }
+    // then steal the oldest task from the other queues
+    const size_t nb_queues = queues_.size();
+    for (size_t i = 1; i < nb_queues; ++i)
+    {
+      auto& queue = *queues_[(worker_index + i) % nb_queues];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty())
+      {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        pending_tasks_.fetch_sub(1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void ThreadPool::workerLoop(size_t worker_index)
+  {
+    current_pool = this;
+    current_worker_index = worker_index;
+    while (true)
+    {
+      std::function<void()> task;
+      if (pop(worker_index, task))
+      {
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.wait(lock, [this]() { return stop_ || pending_tasks_.load() > 0; });
+      if (stop_ && pending_tasks_.load() == 0)
+      {
+        break;
+      }
+    }
+    current_pool = nullptr;
+  }
+
+  void ThreadPool::parallelFor(size_t n_tasks, const std::function<void(size_t)>& func)
+  {
+    if (n_tasks == 0)
+    {
+      return;
+    }
+    // shared with the helpers, which may only start once the call has returned
+    struct Batch
+    {
+      const std::function<void(size_t)>* func;
+      size_t n_tasks;
+      std::atomic_size_t next_index{ 0 };
+      std::mutex mutex;
+      std::condition_variable done_cv;
+      size_t nb_done = 0;
+      std::exception_ptr error;
+
+      void run()
+      {
+        for (size_t i = next_index.fetch_add(1); i < n_tasks; i = next_index.fetch_add(1))
+        {
+          std::exception_ptr task_error;
+          try
+          {
+            (*func)(i);
+          }
+          catch (...)
+          {
+            task_error = std::current_exception();
+          }
+          std::lock_guard<std::mutex> lock(mutex);
+          if (task_error && !error)
+          {
+            error = task_error;
+          }
+          if (++nb_done == n_tasks)
+          {
+            done_cv.notify_all();
+          }
+        }
+      }
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->func = &func;
+    batch->n_tasks = n_tasks;
+
+    const size_t n_helpers = std::min(n_tasks - 1, capacity());
+    reserve(n_helpers);
+    for (size_t i = 0; i < n_helpers; ++i)
+    {
+      submit([batch]() { batch->run(); });
+    }
+    batch->run();
+    // the remaining indices are being run by the helpers
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done_cv.wait(lock, [&batch]() { return batch->nb_done == batch->n_tasks; });
+    if (batch->error)
+    {
+      std::rethrow_exception(batch->error);
+    }
+  }
+}
@@ -45,7 +45,8 @@ namespace SmartPeak {
     if (!done_) {
       return;
     }
-    application_handler_ = source_app_handler;
+    // the injections' raw data is shared with the source and copied only when modified by the workflow
+    application_handler_ = source_app_handler.snapshot();
     done_ = false;
 
     // making local copies
@@ -96,6 +97,7 @@ namespace SmartPeak {
         sequence_processor_observer,
         sequence_segment_processor_observer,
         sample_group_processor_observer);
+      updateApplicationHandler(source_app_handler);
     }
   }
 
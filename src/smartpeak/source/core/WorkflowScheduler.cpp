@@ -0,0 +1,478 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/core/WorkflowScheduler.h>
+#include <plog/Log.h>
+#include <algorithm>
+
+namespace SmartPeak
+{
+  void WorkflowScheduler::buildGraph(
+    const std::vector<ApplicationHandler::Command>& commands,
+    const std::set<std::string>& injection_names,
+    const std::set<std::string>& sequence_segment_names,
+    const std::set<std::string>& sample_group_names)
+  {
+    stages_.clear();
+    tasks_.clear();
+
+    // group consecutive commands of the same type into stages
+    size_t i = 0;
+    while (i < commands.size()) {
+      const ApplicationHandler::Command::CommandType type = commands[i].type;
+      size_t j = i + 1;
+      for (; j < commands.size() && type == commands[j].type; ++j) {
+        // empty body
+      }
+      if (type != ApplicationHandler::Command::RawDataMethod
+        && type != ApplicationHandler::Command::SequenceSegmentMethod
+        && type != ApplicationHandler::Command::SampleGroupMethod)
+      {
+        LOGW << "Skipping a command: " << type << "\n";
+        i = j;
+        continue;
+      }
+      Stage stage;
+      stage.type = type;
+      stage.first_command_index = i;
+      std::for_each(commands.begin() + i, commands.begin() + j,
+        [&](const ApplicationHandler::Command& command)
+      {
+        if (type == ApplicationHandler::Command::RawDataMethod) stage.raw_data_methods.push_back(command.raw_data_method);
+        else if (type == ApplicationHandler::Command::SequenceSegmentMethod) stage.sequence_segment_methods.push_back(command.seq_seg_method);
+        else stage.sample_group_methods.push_back(command.sample_group_method);
+        stage.command_names.push_back(command.getName());
+        for (const auto& filename_to_merge : command.dynamic_filenames)
+        {
+          if (stage.filenames.find(filename_to_merge.first) == stage.filenames.end())
+          {
+            stage.filenames.emplace(filename_to_merge.first, filename_to_merge.second);
+          }
+          else
+          {
+            stage.filenames.at(filename_to_merge.first).merge(filename_to_merge.second);
+          }
+        }
+      });
+      stages_.push_back(stage);
+      i = j;
+    }
+    unsigned next_ms_data = RawDataResidency::NoMSData;
+    for (auto stage = stages_.rbegin(); stage != stages_.rend(); ++stage)
+    {
+      stage->next_ms_data = next_ms_data;
+      next_ms_data |= RawDataResidency::getRequiredMSData(stage->raw_data_methods);
+    }
+
+    // create the tasks, each one depending on the last tasks that touched its injections
+    const auto& sequence = sequence_handler_.getSequence();
+    std::vector<std::vector<size_t>> last_tasks(sequence.size());
+    for (size_t stage_index = 0; stage_index < stages_.size(); ++stage_index)
+    {
+      Stage& stage = stages_[stage_index];
+      std::vector<size_t> items;
+      if (stage.type == ApplicationHandler::Command::RawDataMethod)
+      {
+        for (size_t k = 0; k < sequence.size(); ++k)
+        {
+          if (injection_names.empty() || injection_names.count(sequence[k].getMetaData().getInjectionName()))
+          {
+            items.push_back(k);
+          }
+        }
+      }
+      else if (stage.type == ApplicationHandler::Command::SequenceSegmentMethod)
+      {
+        const auto& sequence_segments = sequence_handler_.getSequenceSegments();
+        for (size_t k = 0; k < sequence_segments.size(); ++k)
+        {
+          if (sequence_segment_names.empty() || sequence_segment_names.count(sequence_segments[k].getSequenceSegmentName()))
+          {
+            items.push_back(k);
+          }
+        }
+      }
+      else
+      {
+        const auto& sample_groups = sequence_handler_.getSampleGroups();
+        for (size_t k = 0; k < sample_groups.size(); ++k)
+        {
+          if (sample_group_names.empty() || sample_group_names.count(sample_groups[k].getSampleGroupName()))
+          {
+            items.push_back(k);
+          }
+        }
+      }
+      if (stage.filenames.size() < items.size()) {
+        throw std::invalid_argument("The number of provided filenames locations is not correct.");
+      }
+      if (items.empty())
+      {
+        // the stage is reported by a task running after all the previous ones, the next stages waiting for it
+        Task task;
+        task.stage_index = stage_index;
+        task.item_index = Task::no_item;
+        const size_t task_index = tasks_.size();
+        for (size_t dependency = 0; dependency < task_index; ++dependency)
+        {
+          task.dependencies.push_back(dependency);
+          tasks_[dependency].dependents.push_back(task_index);
+        }
+        tasks_.push_back(task);
+        for (auto& injection_tasks : last_tasks)
+        {
+          injection_tasks = { task_index };
+        }
+        continue;
+      }
+
+      std::map<size_t, std::vector<size_t>> stage_last_tasks;
+      for (const auto item_index : items)
+      {
+        Task task;
+        task.stage_index = stage_index;
+        task.item_index = item_index;
+        const size_t task_index = tasks_.size();
+        std::set<size_t> dependencies;
+        for (const auto injection_index : getTouchedInjections(task))
+        {
+          if (injection_index >= last_tasks.size())
+          {
+            continue;
+          }
+          dependencies.insert(last_tasks[injection_index].begin(), last_tasks[injection_index].end());
+          stage_last_tasks[injection_index].push_back(task_index);
+        }
+        task.dependencies.assign(dependencies.begin(), dependencies.end());
+        for (const auto dependency : task.dependencies)
+        {
+          tasks_[dependency].dependents.push_back(task_index);
+        }
+        tasks_.push_back(task);
+      }
+      for (auto& [injection_index, stage_tasks] : stage_last_tasks)
+      {
+        last_tasks[injection_index] = stage_tasks;
+      }
+      stage.nb_tasks = items.size();
+    }
+
+    // initial state
+    nb_done_ = 0;
+    ready_tasks_.clear();
+    remaining_dependencies_.resize(tasks_.size());
+    for (size_t task_index = 0; task_index < tasks_.size(); ++task_index)
+    {
+      remaining_dependencies_[task_index] = tasks_[task_index].dependencies.size();
+      if (remaining_dependencies_[task_index] == 0)
+      {
+        ready_tasks_.emplace(stages_.size() - tasks_[task_index].stage_index, task_index);
+      }
+    }
+  }
+
+  std::vector<size_t> WorkflowScheduler::getTouchedInjections(const Task& task) const
+  {
+    if (task.item_index == Task::no_item)
+    {
+      return {};
+    }
+    switch (stages_[task.stage_index].type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+      return { task.item_index };
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+    case ApplicationHandler::Command::SampleGroupMethod:
+    {
+      std::vector<size_t> injection_indices = (stages_[task.stage_index].type == ApplicationHandler::Command::SequenceSegmentMethod)
+        ? sequence_handler_.getSequenceSegments().at(task.item_index).getSampleIndices()
+        : sequence_handler_.getSampleGroups().at(task.item_index).getSampleIndices();
+      // the segment and group processors read the targeted experiment of the first injection
+      if (std::find(injection_indices.begin(), injection_indices.end(), 0) == injection_indices.end())
+      {
+        injection_indices.push_back(0);
+      }
+      return injection_indices;
+    }
+    default:
+      return {};
+    }
+  }
+
+  std::string WorkflowScheduler::getItemName(const Task& task) const
+  {
+    if (task.item_index == Task::no_item)
+    {
+      return "";
+    }
+    switch (stages_[task.stage_index].type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+      return sequence_handler_.getSequence().at(task.item_index).getMetaData().getSampleName();
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+      return sequence_handler_.getSequenceSegments().at(task.item_index).getSequenceSegmentName();
+    case ApplicationHandler::Command::SampleGroupMethod:
+      return sequence_handler_.getSampleGroups().at(task.item_index).getSampleGroupName();
+    default:
+      return "";
+    }
+  }
+
+  void WorkflowScheduler::processTask(const Task& task)
+  {
+    if (task.item_index == Task::no_item)
+    {
+      return;
+    }
+    Stage& stage = stages_[task.stage_index];
+    switch (stage.type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+    {
+      InjectionHandler& injection = sequence_handler_.getSequence().at(task.item_index);
+      if (!raw_data_residency_ || !raw_data_residency_->isEnabled())
+      {
+        processInjection(
+          injection,
+          stage.filenames.at(injection.getMetaData().getInjectionName()),
+          stage.raw_data_methods,
+          this);
+        break;
+      }
+      RawDataHandler& raw_data = injection.getRawData();
+      const std::string injection_name = injection.getMetaData().getInjectionName();
+      raw_data_residency_->acquire(raw_data);
+      try
+      {
+        processInjection(
+          injection,
+          stage.filenames.at(injection_name),
+          stage.raw_data_methods,
+          this);
+      }
+      catch (...)
+      {
+        raw_data_residency_->release(raw_data, injection_name, stage.next_ms_data);
+        throw;
+      }
+      raw_data_residency_->release(raw_data, injection_name, stage.next_ms_data);
+      break;
+    }
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+    {
+      SequenceSegmentHandler& sequence_segment = sequence_handler_.getSequenceSegments().at(task.item_index);
+      processSegment(
+        sequence_segment,
+        sequence_handler_,
+        stage.filenames.at(sequence_segment.getSequenceSegmentName()),
+        stage.sequence_segment_methods,
+        this);
+      break;
+    }
+    case ApplicationHandler::Command::SampleGroupMethod:
+    {
+      SampleGroupHandler& sample_group = sequence_handler_.getSampleGroups().at(task.item_index);
+      processSampleGroup(
+        sample_group,
+        sequence_handler_,
+        stage.filenames.at(sample_group.getSampleGroupName()),
+        stage.sample_group_methods,
+        this);
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  void WorkflowScheduler::run_processing()
+  {
+    while (true) {
+      size_t task_index;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return !ready_tasks_.empty() || nb_done_ == tasks_.size(); });
+        if (ready_tasks_.empty()) {
+          break;
+        }
+        task_index = ready_tasks_.begin()->second;
+        ready_tasks_.erase(ready_tasks_.begin());
+        notifyTaskStart(tasks_[task_index]);
+      }
+
+      const Task& task = tasks_[task_index];
+      try {
+        processTask(task);
+      }
+      catch (const WorkflowException& e) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notifyTaskError(task, e);
+      }
+      catch (const std::exception& e) {
+        LOGE << getItemName(task) << ": " << typeid(e).name() << " : " << e.what();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notifyTaskEnd(task);
+        for (const auto dependent : task.dependents)
+        {
+          if (--remaining_dependencies_[dependent] == 0)
+          {
+            ready_tasks_.emplace(stages_.size() - tasks_[dependent].stage_index, dependent);
+          }
+        }
+        ++nb_done_;
+      }
+      cv_.notify_all();
+    }
+    LOGD << "Worker is done";
+  }
+
+  void WorkflowScheduler::notifyStageStart(Stage& stage)
+  {
+    stage.started = true;
+    if (application_processor_observable_)
+    {
+      for (size_t i = 0; i < stage.command_names.size(); ++i)
+      {
+        application_processor_observable_->notifyApplicationProcessorCommandStart(stage.first_command_index + i, stage.command_names[i]);
+      }
+    }
+    switch (stage.type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+      notifySequenceProcessorStart(stage.nb_tasks);
+      break;
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+      notifySequenceSegmentProcessorStart(stage.nb_tasks);
+      break;
+    case ApplicationHandler::Command::SampleGroupMethod:
+      notifySampleGroupProcessorStart(stage.nb_tasks);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void WorkflowScheduler::notifyStageEnd(Stage& stage)
+  {
+    switch (stage.type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+      notifySequenceProcessorEnd();
+      break;
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+      notifySequenceSegmentProcessorEnd();
+      break;
+    case ApplicationHandler::Command::SampleGroupMethod:
+      notifySampleGroupProcessorEnd();
+      break;
+    default:
+      break;
+    }
+    if (application_processor_observable_)
+    {
+      for (size_t i = 0; i < stage.command_names.size(); ++i)
+      {
+        application_processor_observable_->notifyApplicationProcessorCommandEnd(stage.first_command_index + i, stage.command_names[i]);
+      }
+    }
+  }
+
+  void WorkflowScheduler::notifyTaskStart(const Task& task)
+  {
+    Stage& stage = stages_[task.stage_index];
+    if (!stage.started)
+    {
+      notifyStageStart(stage);
+    }
+    if (task.item_index == Task::no_item)
+    {
+      return;
+    }
+    const auto item_name = getItemName(task);
+    switch (stage.type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+      notifySequenceProcessorSampleStart(item_name);
+      break;
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+      notifySequenceSegmentProcessorSampleStart(item_name);
+      break;
+    case ApplicationHandler::Command::SampleGroupMethod:
+      notifySampleGroupProcessorSampleStart(item_name);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void WorkflowScheduler::notifyTaskEnd(const Task& task)
+  {
+    Stage& stage = stages_[task.stage_index];
+    if (task.item_index == Task::no_item)
+    {
+      notifyStageEnd(stage);
+      return;
+    }
+    const auto item_name = getItemName(task);
+    switch (stage.type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+      notifySequenceProcessorSampleEnd(item_name);
+      break;
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+      notifySequenceSegmentProcessorSampleEnd(item_name);
+      break;
+    case ApplicationHandler::Command::SampleGroupMethod:
+      notifySampleGroupProcessorSampleEnd(item_name);
+      break;
+    default:
+      break;
+    }
+    if (++stage.nb_done == stage.nb_tasks)
+    {
+      notifyStageEnd(stage);
+    }
+  }
+
+  void WorkflowScheduler::notifyTaskError(const Task& task, const WorkflowException& e)
+  {
+    switch (stages_[task.stage_index].type)
+    {
+    case ApplicationHandler::Command::RawDataMethod:
+      notifySequenceProcessorError(e.item(), e.processor(), e.what());
+      break;
+    case ApplicationHandler::Command::SequenceSegmentMethod:
+      notifySequenceSegmentProcessorError(e.item(), e.processor(), e.what());
+      break;
+    case ApplicationHandler::Command::SampleGroupMethod:
+      notifySampleGroupProcessorError(e.item(), e.processor(), e.what());
+      break;
+    default:
+      break;
+    }
+  }
+}
@@ -7,16 +7,22 @@ set(sources_list
 	ApplicationProcessor.cpp
 	CastValue.cpp
 	ConsoleHandler.cpp
+	DataPreparation.cpp
+	DecimationPyramid.cpp
 	EventDispatcher.cpp
 	FeatureFiltersUtils.cpp
 	FeatureMetadata.cpp
+	FeatureTable.cpp
 	Filenames.cpp
 	InjectionHandler.cpp
 	MetaDataHandler.cpp
+	NameSelection.cpp
 	Parameters.cpp
+	ProcessorProfiler.cpp
 	ProgessInfo.cpp
 	RawDataHandler.cpp
 	RawDataProcessor.cpp
+	RawDataResidency.cpp
 	SampleGroupHandler.cpp
 	SampleGroupProcessor.cpp
 	SampleType.cpp
@@ -28,9 +34,12 @@ set(sources_list
 	ServerAppender.cpp
 	SessionLoaderGenerator.cpp
 	SharedProcessors.cpp
+	ThreadPool.cpp
 	Server.cpp
+	SpectraLibraryIndex.cpp
 	Utilities.cpp
 	WorkflowManager.cpp
+	WorkflowScheduler.cpp
 )
 
 ### add path to the filenames
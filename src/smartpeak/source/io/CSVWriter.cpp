@@ -27,8 +27,27 @@
 
 namespace SmartPeak
 {
+  CSVWriter::~CSVWriter()
+  {
+    close();
+  }
+
+  CSVWriter& CSVWriter::operator=(CSVWriter&& other)
+  {
+    if (this != &other)
+    {
+      close();
+      filename_ = std::move(other.filename_);
+      delimeter_ = std::move(other.delimeter_);
+      line_count_ = other.line_count_;
+      stream_ = std::move(other.stream_);
+    }
+    return *this;
+  }
+
   void CSVWriter::setFilename(const std::string& filename)
   {
+    close();
     filename_ = filename;
   }
   std::string CSVWriter::getFilename() const
@@ -47,10 +66,55 @@ namespace SmartPeak
 
   void CSVWriter::setLineCount(const int line_count)
   {
+    close();
     line_count_ = line_count;
   }
   int CSVWriter::getLineCount() const
   {
     return line_count_;
   }
+
+  bool CSVWriter::open()
+  {
+    if (stream_) {
+      return true;
+    }
+    auto stream = std::make_unique<Stream>();
+    stream->buffer.resize(buffer_size_);
+    // the buffer must be set before opening the file
+    stream->ofs.rdbuf()->pubsetbuf(stream->buffer.data(), static_cast<std::streamsize>(stream->buffer.size()));
+    stream->ofs.open(filename_, line_count_ ? std::ios::app : std::ios::trunc);
+    if (!stream->ofs.is_open()) {
+      LOGE << "Cannot open file: " << filename_;
+      return false;
+    }
+    stream_ = std::move(stream);
+    return true;
+  }
+
+  bool CSVWriter::flush()
+  {
+    if (!stream_) {
+      return true;
+    }
+    if (!stream_->ofs.flush()) {
+      LOGE << "Cannot write file: " << filename_;
+      return false;
+    }
+    return true;
+  }
+
+  bool CSVWriter::close()
+  {
+    if (!stream_) {
+      return true;
+    }
+    stream_->ofs.close();
+    const bool success = !stream_->ofs.fail();
+    if (!success) {
+      LOGE << "Cannot write file: " << filename_;
+    }
+    stream_.reset();
+    return success;
+  }
 }
@@ -0,0 +1,690 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/io/FeatureMapBinaryFile.h>
+#include <plog/Log.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SmartPeak
+{
+  namespace
+  {
+    const char s_magic[8] = { 'S', 'P', 'F', 'E', 'A', 'T', 'M', 'P' };
+    const uint32_t s_byte_order = 0x01020304;
+
+    struct Block
+    {
+      uint64_t offset;
+      uint64_t count;
+    };
+
+    struct Header
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t byte_order;
+      uint64_t file_size;
+      uint64_t unique_id;
+      uint64_t source_size;
+      int64_t source_modification_time;
+      uint64_t nb_features;  // top level features, the first records of the features block
+      uint64_t meta_first;   // meta values of the feature map itself
+      uint64_t meta_n;
+      Block strings;
+      Block chars;
+      Block features;
+      Block hulls;
+      Block points;
+      Block meta_values;
+      Block list_values;
+    };
+
+    struct StringRecord
+    {
+      uint64_t offset;
+      uint64_t length;
+    };
+
+    struct FeatureRecord
+    {
+      double rt;
+      double mz;
+      double intensity;
+      double overall_quality;
+      double quality[2];
+      double width;
+      int64_t charge;
+      uint64_t unique_id;
+      uint64_t meta_first;
+      uint64_t meta_n;
+      uint64_t sub_first;
+      uint64_t sub_n;
+      uint64_t hull_first;
+      uint64_t hull_n;
+    };
+
+    struct HullRecord
+    {
+      uint64_t point_first;
+      uint64_t point_n;
+    };
+
+    struct PointRecord
+    {
+      double rt;
+      double mz;
+    };
+
+    struct MetaValueRecord
+    {
+      uint64_t key;    // string index
+      uint32_t type;   // OpenMS::DataValue::DataType
+      uint32_t unused;
+      uint64_t value;  // string index, integer, double bits, or first list value
+      uint64_t count;  // number of list values
+    };
+
+    template<typename T>
+    uint64_t toBits(T value)
+    {
+      static_assert(sizeof(T) == sizeof(uint64_t), "unexpected size");
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      return bits;
+    }
+
+    template<typename T>
+    T fromBits(uint64_t bits)
+    {
+      static_assert(sizeof(T) == sizeof(uint64_t), "unexpected size");
+      T value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    bool hasIdentifications(const OpenMS::Feature& feature)
+    {
+      if (!feature.getPeptideIdentifications().empty())
+      {
+        return true;
+      }
+      for (const auto& subordinate : feature.getSubordinates())
+      {
+        if (hasIdentifications(subordinate))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    class Writer
+    {
+    public:
+      Writer(const OpenMS::FeatureMap& feature_map, const FeatureMapBinaryFile::SourceFile& source_file)
+      {
+        std::memcpy(header_.magic, s_magic, sizeof(s_magic));
+        header_.version = FeatureMapBinaryFile::version;
+        header_.byte_order = s_byte_order;
+        header_.unique_id = feature_map.getUniqueId();
+        header_.source_size = source_file.size;
+        header_.source_modification_time = source_file.modification_time;
+        header_.nb_features = feature_map.size();
+        header_.meta_first = meta_values_.size();
+        header_.meta_n = addMetaValues(feature_map);
+
+        // features first, then subordinates level by level,
+        // so that the subordinates of a feature are contiguous
+        std::vector<const OpenMS::Feature*> features;
+        features.reserve(feature_map.size());
+        for (const auto& feature : feature_map)
+        {
+          features.push_back(&feature);
+        }
+        for (size_t i = 0; i < features.size(); ++i)
+        {
+          const OpenMS::Feature& feature = *features[i];
+          FeatureRecord record;
+          record.rt = feature.getRT();
+          record.mz = feature.getMZ();
+          record.intensity = feature.getIntensity();
+          record.overall_quality = feature.getOverallQuality();
+          record.quality[0] = feature.getQuality(0);
+          record.quality[1] = feature.getQuality(1);
+          record.width = feature.getWidth();
+          record.charge = feature.getCharge();
+          record.unique_id = feature.getUniqueId();
+          record.meta_first = meta_values_.size();
+          record.meta_n = addMetaValues(feature);
+          record.sub_first = features.size();
+          record.sub_n = feature.getSubordinates().size();
+          for (const auto& subordinate : feature.getSubordinates())
+          {
+            features.push_back(&subordinate);
+          }
+          record.hull_first = hulls_.size();
+          record.hull_n = feature.getConvexHulls().size();
+          for (const auto& hull : feature.getConvexHulls())
+          {
+            const auto& hull_points = hull.getHullPoints();
+            hulls_.push_back({ points_.size(), hull_points.size() });
+            for (const auto& point : hull_points)
+            {
+              points_.push_back({ point[0], point[1] });
+            }
+          }
+          features_.push_back(record);
+        }
+      }
+
+      void write(const std::string& filename)
+      {
+        uint64_t offset = sizeof(Header);
+        layout(header_.strings, offset, strings_);
+        layout(header_.features, offset, features_);
+        layout(header_.hulls, offset, hulls_);
+        layout(header_.points, offset, points_);
+        layout(header_.meta_values, offset, meta_values_);
+        layout(header_.list_values, offset, list_values_);
+        layout(header_.chars, offset, chars_);
+        header_.file_size = offset;
+
+        // the previous file may still be mapped by a loader: it is replaced, never overwritten
+        const std::string tmp_filename = filename + ".tmp";
+        {
+          std::ofstream stream(tmp_filename, std::ios::binary | std::ios::trunc);
+          if (!stream)
+          {
+            throw std::runtime_error("Cannot open " + tmp_filename + " for writing.");
+          }
+          stream.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+          writeBlock(stream, strings_);
+          writeBlock(stream, features_);
+          writeBlock(stream, hulls_);
+          writeBlock(stream, points_);
+          writeBlock(stream, meta_values_);
+          writeBlock(stream, list_values_);
+          writeBlock(stream, chars_);
+          stream.close();
+          if (!stream)
+          {
+            std::error_code ec;
+            std::filesystem::remove(tmp_filename, ec);
+            throw std::runtime_error("Failed to write " + tmp_filename + ".");
+          }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_filename, filename, ec);
+        if (ec)
+        {
+          std::error_code remove_ec;
+          std::filesystem::remove(tmp_filename, remove_ec);
+          throw std::runtime_error("Failed to replace " + filename + ": " + ec.message());
+        }
+      }
+
+    private:
+      uint64_t addString(const std::string& str)
+      {
+        const auto found = string_indices_.find(str);
+        if (found != string_indices_.end())
+        {
+          return found->second;
+        }
+        const uint64_t index = strings_.size();
+        strings_.push_back({ chars_.size(), str.size() });
+        chars_.insert(chars_.end(), str.begin(), str.end());
+        string_indices_.emplace(str, index);
+        return index;
+      }
+
+      uint64_t addMetaValues(const OpenMS::MetaInfoInterface& meta_info)
+      {
+        std::vector<OpenMS::String> keys;
+        meta_info.getKeys(keys);
+        for (const auto& key : keys)
+        {
+          const OpenMS::DataValue& data_value = meta_info.getMetaValue(key);
+          MetaValueRecord record{ addString(key), static_cast<uint32_t>(data_value.valueType()), 0, 0, 0 };
+          switch (data_value.valueType())
+          {
+          case OpenMS::DataValue::STRING_VALUE:
+            record.value = addString(data_value.toString());
+            break;
+          case OpenMS::DataValue::INT_VALUE:
+            record.value = toBits(static_cast<int64_t>(static_cast<long long>(data_value)));
+            break;
+          case OpenMS::DataValue::DOUBLE_VALUE:
+            record.value = toBits(static_cast<double>(data_value));
+            break;
+          case OpenMS::DataValue::STRING_LIST:
+          {
+            const OpenMS::StringList list = data_value.toStringList();
+            record.value = list_values_.size();
+            record.count = list.size();
+            for (const auto& str : list) list_values_.push_back(addString(str));
+            break;
+          }
+          case OpenMS::DataValue::INT_LIST:
+          {
+            const OpenMS::IntList list = data_value.toIntList();
+            record.value = list_values_.size();
+            record.count = list.size();
+            for (const auto i : list) list_values_.push_back(toBits(static_cast<int64_t>(i)));
+            break;
+          }
+          case OpenMS::DataValue::DOUBLE_LIST:
+          {
+            const OpenMS::DoubleList list = data_value.toDoubleList();
+            record.value = list_values_.size();
+            record.count = list.size();
+            for (const auto d : list) list_values_.push_back(toBits(d));
+            break;
+          }
+          default:
+            break;
+          }
+          meta_values_.push_back(record);
+        }
+        return keys.size();
+      }
+
+      static uint64_t padding(uint64_t size)
+      {
+        return (8 - size % 8) % 8;
+      }
+
+      template<typename T>
+      static void layout(Block& block, uint64_t& offset, const std::vector<T>& records)
+      {
+        block.offset = offset;
+        block.count = records.size();
+        offset += records.size() * sizeof(T);
+        offset += padding(offset);
+      }
+
+      template<typename T>
+      void writeBlock(std::ofstream& stream, const std::vector<T>& records)
+      {
+        const auto size = records.size() * sizeof(T);
+        stream.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(size));
+        stream.write(padding_, static_cast<std::streamsize>(padding(size)));
+      }
+
+      Header header_{};
+      std::vector<StringRecord> strings_;
+      std::vector<char> chars_;
+      std::vector<FeatureRecord> features_;
+      std::vector<HullRecord> hulls_;
+      std::vector<PointRecord> points_;
+      std::vector<MetaValueRecord> meta_values_;
+      std::vector<uint64_t> list_values_;
+      std::unordered_map<std::string, uint64_t> string_indices_;
+      const char padding_[8] = {};
+    };
+
+    class Reader
+    {
+    public:
+      Reader(const char* data, size_t size)
+        : data_(data)
+      {
+        if (size < sizeof(Header))
+        {
+          throw std::runtime_error("Feature map file is truncated.");
+        }
+        std::memcpy(&header_, data, sizeof(Header));
+        if (std::memcmp(header_.magic, s_magic, sizeof(s_magic)) != 0)
+        {
+          throw std::runtime_error("Not a feature map file.");
+        }
+        if (header_.byte_order != s_byte_order)
+        {
+          throw std::runtime_error("Feature map file has been written on a platform with a different byte order.");
+        }
+        if (header_.version != FeatureMapBinaryFile::version)
+        {
+          throw std::runtime_error("Unsupported feature map file version " + std::to_string(header_.version) + ".");
+        }
+        if (header_.file_size != size)
+        {
+          throw std::runtime_error("Feature map file is truncated.");
+        }
+        checkBlock<StringRecord>(header_.strings, size);
+        checkBlock<char>(header_.chars, size);
+        checkBlock<FeatureRecord>(header_.features, size);
+        checkBlock<HullRecord>(header_.hulls, size);
+        checkBlock<PointRecord>(header_.points, size);
+        checkBlock<MetaValueRecord>(header_.meta_values, size);
+        checkBlock<uint64_t>(header_.list_values, size);
+        if (header_.nb_features > header_.features.count)
+        {
+          throw std::runtime_error("Feature map file is corrupted.");
+        }
+      }
+
+      size_t size() const
+      {
+        return header_.nb_features;
+      }
+
+      FeatureMapBinaryFile::SourceFile getSourceFile() const
+      {
+        FeatureMapBinaryFile::SourceFile source_file;
+        source_file.size = header_.source_size;
+        source_file.modification_time = header_.source_modification_time;
+        return source_file;
+      }
+
+      void materialize(OpenMS::FeatureMap& feature_map) const
+      {
+        feature_map.clear(true);
+        feature_map.setUniqueId(header_.unique_id);
+        setMetaValues(feature_map, header_.meta_first, header_.meta_n);
+        feature_map.resize(header_.nb_features);
+        for (uint64_t i = 0; i < header_.nb_features; ++i)
+        {
+          makeFeature(i, feature_map[i]);
+        }
+      }
+
+    private:
+      template<typename T>
+      static void checkBlock(const Block& block, size_t size)
+      {
+        if (block.offset % alignof(T) != 0
+          || block.offset > size
+          || block.count > (size - block.offset) / sizeof(T))
+        {
+          throw std::runtime_error("Feature map file is corrupted.");
+        }
+      }
+
+      static void checkRange(uint64_t first, uint64_t n, const Block& block)
+      {
+        if (first > block.count || n > block.count - first)
+        {
+          throw std::runtime_error("Feature map file is corrupted.");
+        }
+      }
+
+      template<typename T>
+      const T& record(const Block& block, uint64_t index) const
+      {
+        return reinterpret_cast<const T*>(data_ + block.offset)[index];
+      }
+
+      std::string getString(uint64_t index) const
+      {
+        checkRange(index, 1, header_.strings);
+        const StringRecord& str = record<StringRecord>(header_.strings, index);
+        checkRange(str.offset, str.length, header_.chars);
+        return std::string(data_ + header_.chars.offset + str.offset, str.length);
+      }
+
+      void setMetaValues(OpenMS::MetaInfoInterface& meta_info, uint64_t first, uint64_t n) const
+      {
+        checkRange(first, n, header_.meta_values);
+        for (uint64_t i = first; i < first + n; ++i)
+        {
+          const MetaValueRecord& meta_value = record<MetaValueRecord>(header_.meta_values, i);
+          const std::string key = getString(meta_value.key);
+          switch (meta_value.type)
+          {
+          case OpenMS::DataValue::STRING_VALUE:
+            meta_info.setMetaValue(key, getString(meta_value.value));
+            break;
+          case OpenMS::DataValue::INT_VALUE:
+            meta_info.setMetaValue(key, static_cast<long long>(fromBits<int64_t>(meta_value.value)));
+            break;
+          case OpenMS::DataValue::DOUBLE_VALUE:
+            meta_info.setMetaValue(key, fromBits<double>(meta_value.value));
+            break;
+          case OpenMS::DataValue::STRING_LIST:
+          {
+            checkRange(meta_value.value, meta_value.count, header_.list_values);
+            OpenMS::StringList list;
+            list.reserve(meta_value.count);
+            for (uint64_t j = meta_value.value; j < meta_value.value + meta_value.count; ++j)
+            {
+              list.push_back(getString(record<uint64_t>(header_.list_values, j)));
+            }
+            meta_info.setMetaValue(key, list);
+            break;
+          }
+          case OpenMS::DataValue::INT_LIST:
+          {
+            checkRange(meta_value.value, meta_value.count, header_.list_values);
+            OpenMS::IntList list;
+            list.reserve(meta_value.count);
+            for (uint64_t j = meta_value.value; j < meta_value.value + meta_value.count; ++j)
+            {
+              list.push_back(static_cast<int>(fromBits<int64_t>(record<uint64_t>(header_.list_values, j))));
+            }
+            meta_info.setMetaValue(key, list);
+            break;
+          }
+          case OpenMS::DataValue::DOUBLE_LIST:
+          {
+            checkRange(meta_value.value, meta_value.count, header_.list_values);
+            OpenMS::DoubleList list;
+            list.reserve(meta_value.count);
+            for (uint64_t j = meta_value.value; j < meta_value.value + meta_value.count; ++j)
+            {
+              list.push_back(fromBits<double>(record<uint64_t>(header_.list_values, j)));
+            }
+            meta_info.setMetaValue(key, list);
+            break;
+          }
+          case OpenMS::DataValue::EMPTY_VALUE:
+            meta_info.setMetaValue(key, OpenMS::DataValue::EMPTY);
+            break;
+          default:
+            throw std::runtime_error("Feature map file is corrupted.");
+          }
+        }
+      }
+
+      void makeFeature(uint64_t index, OpenMS::Feature& feature) const
+      {
+        const FeatureRecord& r = record<FeatureRecord>(header_.features, index);
+        feature.setRT(r.rt);
+        feature.setMZ(r.mz);
+        feature.setIntensity(static_cast<OpenMS::Feature::IntensityType>(r.intensity));
+        feature.setOverallQuality(r.overall_quality);
+        feature.setQuality(0, r.quality[0]);
+        feature.setQuality(1, r.quality[1]);
+        feature.setWidth(r.width);
+        feature.setCharge(static_cast<OpenMS::Int>(r.charge));
+        feature.setUniqueId(r.unique_id);
+        setMetaValues(feature, r.meta_first, r.meta_n);
+
+        checkRange(r.hull_first, r.hull_n, header_.hulls);
+        auto& hulls = feature.getConvexHulls();
+        hulls.resize(r.hull_n);
+        for (uint64_t h = 0; h < r.hull_n; ++h)
+        {
+          const HullRecord& hull = record<HullRecord>(header_.hulls, r.hull_first + h);
+          checkRange(hull.point_first, hull.point_n, header_.points);
+          OpenMS::ConvexHull2D::PointArrayType hull_points;
+          hull_points.reserve(hull.point_n);
+          for (uint64_t p = hull.point_first; p < hull.point_first + hull.point_n; ++p)
+          {
+            const PointRecord& point = record<PointRecord>(header_.points, p);
+            hull_points.emplace_back(point.rt, point.mz);
+          }
+          hulls[h].setHullPoints(hull_points);
+        }
+
+        // subordinates are always stored after their parent, which also prevents cycles
+        checkRange(r.sub_first, r.sub_n, header_.features);
+        if (r.sub_n && r.sub_first <= index)
+        {
+          throw std::runtime_error("Feature map file is corrupted.");
+        }
+        auto& subordinates = feature.getSubordinates();
+        subordinates.resize(r.sub_n);
+        for (uint64_t s = 0; s < r.sub_n; ++s)
+        {
+          makeFeature(r.sub_first + s, subordinates[s]);
+        }
+      }
+
+      const char* data_;
+      Header header_;
+    };
+  }
+
+  FeatureMapBinaryFile::MappedFile::~MappedFile()
+  {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(mapping_handle_);
+    if (file_handle_) CloseHandle(file_handle_);
+#else
+    if (data_) munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  size_t FeatureMapBinaryFile::MappedFile::size() const
+  {
+    return Reader(data_, size_).size();
+  }
+
+  FeatureMapBinaryFile::SourceFile FeatureMapBinaryFile::MappedFile::getSourceFile() const
+  {
+    return Reader(data_, size_).getSourceFile();
+  }
+
+  FeatureMapBinaryFile::SourceFile FeatureMapBinaryFile::SourceFile::fromPath(const std::filesystem::path& pathname)
+  {
+    SourceFile source_file;
+    std::error_code size_ec, time_ec;
+    const auto size = std::filesystem::file_size(pathname, size_ec);
+    const auto modification_time = std::filesystem::last_write_time(pathname, time_ec);
+    if (!size_ec && !time_ec)
+    {
+      source_file.size = size;
+      source_file.modification_time = static_cast<int64_t>(modification_time.time_since_epoch().count());
+    }
+    return source_file;
+  }
+
+  void FeatureMapBinaryFile::MappedFile::materialize(OpenMS::FeatureMap& feature_map) const
+  {
+    Reader(data_, size_).materialize(feature_map);
+  }
+
+  bool FeatureMapBinaryFile::store(const std::string& filename, const OpenMS::FeatureMap& feature_map, const SourceFile& source_file)
+  {
+    if (!feature_map.getProteinIdentifications().empty()
+      || !feature_map.getUnassignedPeptideIdentifications().empty())
+    {
+      LOGD << "Feature map with identifications, not stored in " << filename;
+      return false;
+    }
+    for (const auto& feature : feature_map)
+    {
+      if (hasIdentifications(feature))
+      {
+        LOGD << "Feature map with identifications, not stored in " << filename;
+        return false;
+      }
+    }
+    Writer(feature_map, source_file).write(filename);
+    return true;
+  }
+
+  std::shared_ptr<const FeatureMapBinaryFile::MappedFile> FeatureMapBinaryFile::map(const std::string& filename)
+  {
+    std::shared_ptr<MappedFile> mapped_file(new MappedFile());
+#ifdef _WIN32
+    HANDLE file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+      throw std::runtime_error("Cannot open " + filename + ".");
+    }
+    mapped_file->file_handle_ = file_handle;
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(Header)))
+    {
+      throw std::runtime_error("Feature map file " + filename + " is truncated.");
+    }
+    mapped_file->size_ = static_cast<size_t>(file_size.QuadPart);
+    mapped_file->mapping_handle_ = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapped_file->mapping_handle_)
+    {
+      throw std::runtime_error("Cannot map " + filename + ".");
+    }
+    mapped_file->data_ = static_cast<const char*>(MapViewOfFile(mapped_file->mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    if (!mapped_file->data_)
+    {
+      throw std::runtime_error("Cannot map " + filename + ".");
+    }
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      throw std::runtime_error("Cannot open " + filename + ".");
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(Header)))
+    {
+      close(fd);
+      throw std::runtime_error("Feature map file " + filename + " is truncated.");
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+      throw std::runtime_error("Cannot map " + filename + ".");
+    }
+    mapped_file->data_ = static_cast<const char*>(data);
+    mapped_file->size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+    // validates the header
+    Reader(mapped_file->data_, mapped_file->size_);
+    return mapped_file;
+  }
+
+  void FeatureMapBinaryFile::load(const std::string& filename, OpenMS::FeatureMap& feature_map)
+  {
+    map(filename)->materialize(feature_map);
+    feature_map.setLoadedFilePath(filename);
+  }
+}
@@ -32,7 +32,12 @@
 #include <SmartPeak/io/csv.h>
 #include <SmartPeak/io/CSVWriter.h>
 #include <SmartPeak/io/InputDataValidation.h>
+#include <SmartPeak/core/FeatureTable.h>
 #include <ctime>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <plog/Log.h>
 
@@ -613,78 +618,236 @@ namespace SmartPeak
     LOGD << "END writeSequenceFileXcalibur";
   }
 
-  void SequenceParser::makeDataTableFromMetaValue(
-    const SequenceHandler& sequenceHandler,
-    std::vector<std::vector<std::string>>& rows_out,
-    std::vector<std::string>& headers_out,
-    const std::vector<std::string>& meta_data,
-    const std::set<SampleType>& sample_types,
-    const std::set<std::string>& sample_names,
-    const std::set<std::string>& component_group_names,
-    const std::set<std::string>& component_names) {
-    std::vector<std::string> headers = {
-      "sample_name", "sample_type", "component_group_name", "replicate_group_name", "component_name", "batch_name",
-      "rack_number", "plate_number", "pos_number", "inj_number", "dilution_factor", "inj_volume",
-      "inj_volume_units", "operator_name", "acq_method_name", "proc_method_name",
-      "original_filename", "acquisition_date_and_time", "scan_polarity", "scan_mass_low", "scan_mass_high", "injection_name", "used_"
-    };
-    headers.insert(headers.end(), meta_data.cbegin(), meta_data.cend());
-    headers_out = headers;
-
-    const std::string delimiter {"_____"};
+  namespace
+  {
+    std::vector<std::string> makeDataTableHeaders(const std::vector<std::string>& meta_data)
+    {
+      std::vector<std::string> headers = {
+        "sample_name", "sample_type", "component_group_name", "replicate_group_name", "component_name", "batch_name",
+        "rack_number", "plate_number", "pos_number", "inj_number", "dilution_factor", "inj_volume",
+        "inj_volume_units", "operator_name", "acq_method_name", "proc_method_name",
+        "original_filename", "acquisition_date_and_time", "scan_polarity", "scan_mass_low", "scan_mass_high", "injection_name", "used_"
+      };
+      headers.insert(headers.end(), meta_data.cbegin(), meta_data.cend());
+      return headers;
+    }
 
-    rows_out.clear();
-    for (const InjectionHandler& sampleHandler : sequenceHandler.getSequence()) {
-      const MetaDataHandler& mdh = sampleHandler.getMetaData();
-      if (sample_types.count(mdh.getSampleType()) == 0)
-        continue;
-      if (sample_names.size() > 0 && sample_names.count(mdh.getSampleName()) == 0)
-        continue;
+    /**
+      Calls on_row for each row of the table, the row is reused between the calls.
+    */
+    template<typename RowCallback>
+    void forEachDataTableRow(
+      const SequenceHandler& sequenceHandler,
+      const std::vector<std::string>& meta_data,
+      const std::set<SampleType>& sample_types,
+      const std::set<std::string>& sample_names,
+      const std::set<std::string>& component_group_names,
+      const std::set<std::string>& component_names,
+      RowCallback on_row)
+    {
+      const std::string delimiter {"_____"};
 
-      // feature_map_history_ is needed in order to export all "used_" = true and false features
-      for (const OpenMS::Feature& feature : sampleHandler.getRawData().getFeatureMapHistory()) {
-        if (!feature.metaValueExists(s_PeptideRef) || feature.getMetaValue(s_PeptideRef).isEmpty()) {
-          LOGV << "component_group_name is absent or empty. Skipping this feature";
+      std::vector<std::string> row;
+      for (const InjectionHandler& sampleHandler : sequenceHandler.getSequence()) {
+        const MetaDataHandler& mdh = sampleHandler.getMetaData();
+        if (sample_types.count(mdh.getSampleType()) == 0)
           continue;
-        }
-        const std::string component_group_name = feature.getMetaValue(s_PeptideRef);
-        if (component_group_names.size() > 0 && component_group_names.count(component_group_name) == 0)
+        if (sample_names.size() > 0 && sample_names.count(mdh.getSampleName()) == 0)
           continue;
 
-        // Case #1: Features only
-        if (feature.getSubordinates().size() <= 0) {
-          std::vector<std::string> row;
-          row.push_back(mdh.getSampleName());
-          row.push_back(sampleTypeToString.at(mdh.getSampleType()));
-          row.push_back(component_group_name);
-          row.push_back(mdh.getReplicateGroupName());
-          row.push_back("");
-          row.push_back(mdh.batch_name);
-          row.push_back(std::to_string(mdh.rack_number));
-          row.push_back(std::to_string(mdh.plate_number));
-          row.push_back(std::to_string(mdh.pos_number));
-          row.push_back(std::to_string(mdh.inj_number));
-          row.push_back(std::to_string(mdh.dilution_factor));
-          row.push_back(std::to_string(mdh.inj_volume));
-          row.push_back(mdh.inj_volume_units);
-          row.push_back(mdh.operator_name);
-          row.push_back(mdh.acq_method_name);
-          row.push_back(mdh.proc_method_name);
-          row.push_back(mdh.getFilename());
-          row.push_back(mdh.getAcquisitionDateAndTimeAsString());
-          row.push_back(mdh.scan_polarity);
-          row.push_back(std::to_string(mdh.scan_mass_low));
-          row.push_back(std::to_string(mdh.scan_mass_high));
-          row.push_back(mdh.getInjectionName());
-          row.push_back(feature.metaValueExists("used_") ? feature.getMetaValue("used_").toString() : "");
-          for (const std::string& meta_value_name : meta_data) {
-            if (feature.metaValueExists(meta_value_name) && meta_value_name == "QC_transition_group_message") {
-              OpenMS::StringList messages = feature.getMetaValue(meta_value_name).toStringList();
-              row.push_back(
-                Utilities::join(messages.begin(), messages.end(), delimiter)
-              );
+        // feature_map_history_ is needed in order to export all "used_" = true and false features
+        for (const OpenMS::Feature& feature : sampleHandler.getRawData().getFeatureMapHistory()) {
+          if (!feature.metaValueExists(SequenceParser::s_PeptideRef) || feature.getMetaValue(SequenceParser::s_PeptideRef).isEmpty()) {
+            LOGV << "component_group_name is absent or empty. Skipping this feature";
+            continue;
+          }
+          const std::string component_group_name = feature.getMetaValue(SequenceParser::s_PeptideRef);
+          if (component_group_names.size() > 0 && component_group_names.count(component_group_name) == 0)
+            continue;
+
+          // Case #1: Features only
+          if (feature.getSubordinates().size() <= 0) {
+            row.clear();
+            row.push_back(mdh.getSampleName());
+            row.push_back(sampleTypeToString.at(mdh.getSampleType()));
+            row.push_back(component_group_name);
+            row.push_back(mdh.getReplicateGroupName());
+            row.push_back("");
+            row.push_back(mdh.batch_name);
+            row.push_back(std::to_string(mdh.rack_number));
+            row.push_back(std::to_string(mdh.plate_number));
+            row.push_back(std::to_string(mdh.pos_number));
+            row.push_back(std::to_string(mdh.inj_number));
+            row.push_back(std::to_string(mdh.dilution_factor));
+            row.push_back(std::to_string(mdh.inj_volume));
+            row.push_back(mdh.inj_volume_units);
+            row.push_back(mdh.operator_name);
+            row.push_back(mdh.acq_method_name);
+            row.push_back(mdh.proc_method_name);
+            row.push_back(mdh.getFilename());
+            row.push_back(mdh.getAcquisitionDateAndTimeAsString());
+            row.push_back(mdh.scan_polarity);
+            row.push_back(std::to_string(mdh.scan_mass_low));
+            row.push_back(std::to_string(mdh.scan_mass_high));
+            row.push_back(mdh.getInjectionName());
+            row.push_back(feature.metaValueExists("used_") ? feature.getMetaValue("used_").toString() : "");
+            for (const std::string& meta_value_name : meta_data) {
+              if (feature.metaValueExists(meta_value_name) && meta_value_name == "QC_transition_group_message") {
+                OpenMS::StringList messages = feature.getMetaValue(meta_value_name).toStringList();
+                row.push_back(
+                  Utilities::join(messages.begin(), messages.end(), delimiter)
+                );
+              }
+              else 
+              {
+                CastValue datum = SequenceHandler::getMetaValue(feature, feature, meta_value_name);
+                if (datum.getTag() == CastValue::Type::FLOAT)
+                {
+                  if (datum.f_ != 0.0)
+                  {
+                    // NOTE: to_string() rounds at 1e-6. Therefore, some precision might be lost.
+                    row.push_back(std::to_string(datum.f_));
+                  }
+                  else
+                  {
+                    row.push_back("");
+                  }
+                }
+                else
+                {
+                  row.push_back(std::string(datum));
+                }
+              }
+            }
+            on_row(row);
+          }
+
+          // Case #2: Features and subordinates
+          for (const OpenMS::Feature& subordinate : feature.getSubordinates()) {
+            row.clear();
+            row.push_back(mdh.getSampleName());
+            row.push_back(sampleTypeToString.at(mdh.getSampleType()));
+            row.push_back(component_group_name);
+            if (!subordinate.metaValueExists(SequenceParser::s_native_id) ||
+                subordinate.getMetaValue(SequenceParser::s_native_id).isEmpty() ||
+                subordinate.getMetaValue(SequenceParser::s_native_id).toString().empty()) {
+              LOGV << "component_name is absent or empty. Skipping this subordinate";
+              continue;
+            }
+            const std::string component_name = subordinate.getMetaValue(SequenceParser::s_native_id);
+            if (component_names.size() > 0 && component_names.count(component_name) == 0)
+              continue;
+            row.push_back(mdh.getReplicateGroupName());
+            row.push_back(component_name);
+            row.push_back(mdh.batch_name);
+            row.push_back(std::to_string(mdh.rack_number));
+            row.push_back(std::to_string(mdh.plate_number));
+            row.push_back(std::to_string(mdh.pos_number));
+            row.push_back(std::to_string(mdh.inj_number));
+            row.push_back(std::to_string(mdh.dilution_factor));
+            row.push_back(std::to_string(mdh.inj_volume));
+            row.push_back(mdh.inj_volume_units);
+            row.push_back(mdh.operator_name);
+            row.push_back(mdh.acq_method_name);
+            row.push_back(mdh.proc_method_name);
+            row.push_back(mdh.getFilename());
+            row.push_back(mdh.getAcquisitionDateAndTimeAsString());
+            row.push_back(mdh.scan_polarity);
+            row.push_back(std::to_string(mdh.scan_mass_low));
+            row.push_back(std::to_string(mdh.scan_mass_high));
+            row.push_back(mdh.getInjectionName());
+            row.push_back(subordinate.metaValueExists("used_") ? subordinate.getMetaValue("used_").toString() : "");
+            for (const std::string& meta_value_name : meta_data) {
+              if (subordinate.metaValueExists(meta_value_name) && meta_value_name == "QC_transition_message") {
+                OpenMS::StringList messages = subordinate.getMetaValue(meta_value_name).toStringList();
+                row.push_back(
+                  Utilities::join(messages.begin(), messages.end(), delimiter)
+                );
+              }
+              else if (feature.metaValueExists(meta_value_name) && meta_value_name == "QC_transition_group_message") 
+              {
+                OpenMS::StringList messages = feature.getMetaValue(meta_value_name).toStringList();
+                row.push_back(
+                  Utilities::join(messages.begin(), messages.end(), delimiter)
+                );
+              }
+              else 
+              {
+                CastValue datum = SequenceHandler::getMetaValue(feature, subordinate, meta_value_name);
+                if (datum.getTag() == CastValue::Type::FLOAT)
+                {
+                  if (datum.f_ != 0.0)
+                  {
+                    // NOTE: to_string() rounds at 1e-6. Therefore, some precision might be lost.
+                    row.push_back(std::to_string(datum.f_));
+                  }
+                  else
+                  {
+                    row.push_back("");
+                  }
+                }
+                else
+                {
+                  row.push_back(std::string(datum));
+                }
+              }
             }
-            else 
+            on_row(row);
+          }
+        }
+      }
+    }
+
+    std::vector<std::string> makeGroupDataTableHeaders(const std::vector<std::string>& meta_data)
+    {
+      std::vector<std::string> headers = {
+        "sample_group_name", "component_group_name", "component_name", "used_"
+      };
+      headers.insert(headers.end(), meta_data.cbegin(), meta_data.cend());
+      return headers;
+    }
+
+    /**
+      Calls on_row for each row of the table, the row is reused between the calls.
+    */
+    template<typename RowCallback>
+    void forEachGroupDataTableRow(
+      const SequenceHandler& sequenceHandler,
+      const std::vector<std::string>& meta_data,
+      const std::set<SampleType>& sample_types,
+      const std::set<std::string>& sample_names,
+      const std::set<std::string>& component_group_names,
+      const std::set<std::string>& component_names,
+      RowCallback on_row)
+    {
+      const std::string delimiter{ "_____" };
+
+      std::vector<std::string> row;
+      for (const SampleGroupHandler& sample_handler : sequenceHandler.getSampleGroups())
+      {
+        const OpenMS::FeatureMap& feature_map = sample_handler.getFeatureMap();
+
+        if (sample_names.size() > 0 && sample_names.count(sample_handler.getSampleGroupName()) == 0)
+          continue;
+
+        for (const OpenMS::Feature& feature : feature_map)
+        {
+          if (!feature.metaValueExists(SequenceParser::s_PeptideRef) || feature.getMetaValue(SequenceParser::s_PeptideRef).isEmpty()) {
+            LOGV << "component_group_name is absent or empty. Skipping this feature";
+            continue;
+          }
+          const std::string component_group_name = feature.getMetaValue(SequenceParser::s_PeptideRef);
+          if (component_group_names.size() > 0 && component_group_names.count(component_group_name) == 0)
+            continue;
+
+          // Case #1: Features only
+          if (feature.getSubordinates().size() <= 0) {
+            row.clear();
+            row.push_back(sample_handler.getSampleGroupName());
+            row.push_back(component_group_name);
+            row.push_back("");
+            row.push_back(feature.metaValueExists("used_") ? feature.getMetaValue("used_").toString() : "");
+            for (const std::string& meta_value_name : meta_data)
             {
               CastValue datum = SequenceHandler::getMetaValue(feature, feature, meta_value_name);
               if (datum.getTag() == CastValue::Type::FLOAT)
@@ -704,60 +867,27 @@ namespace SmartPeak
                 row.push_back(std::string(datum));
               }
             }
+            on_row(row);
           }
-          rows_out.push_back(row);
-        }
 
-        // Case #2: Features and subordinates
-        for (const OpenMS::Feature& subordinate : feature.getSubordinates()) {
-          std::vector<std::string> row;
-          row.push_back(mdh.getSampleName());
-          row.push_back(sampleTypeToString.at(mdh.getSampleType()));
-          row.push_back(component_group_name);
-          if (!subordinate.metaValueExists(s_native_id) ||
-              subordinate.getMetaValue(s_native_id).isEmpty() ||
-              subordinate.getMetaValue(s_native_id).toString().empty()) {
-            LOGV << "component_name is absent or empty. Skipping this subordinate";
-            continue;
-          }
-          const std::string component_name = subordinate.getMetaValue(s_native_id);
-          if (component_names.size() > 0 && component_names.count(component_name) == 0)
-            continue;
-          row.push_back(mdh.getReplicateGroupName());
-          row.push_back(component_name);
-          row.push_back(mdh.batch_name);
-          row.push_back(std::to_string(mdh.rack_number));
-          row.push_back(std::to_string(mdh.plate_number));
-          row.push_back(std::to_string(mdh.pos_number));
-          row.push_back(std::to_string(mdh.inj_number));
-          row.push_back(std::to_string(mdh.dilution_factor));
-          row.push_back(std::to_string(mdh.inj_volume));
-          row.push_back(mdh.inj_volume_units);
-          row.push_back(mdh.operator_name);
-          row.push_back(mdh.acq_method_name);
-          row.push_back(mdh.proc_method_name);
-          row.push_back(mdh.getFilename());
-          row.push_back(mdh.getAcquisitionDateAndTimeAsString());
-          row.push_back(mdh.scan_polarity);
-          row.push_back(std::to_string(mdh.scan_mass_low));
-          row.push_back(std::to_string(mdh.scan_mass_high));
-          row.push_back(mdh.getInjectionName());
-          row.push_back(subordinate.metaValueExists("used_") ? subordinate.getMetaValue("used_").toString() : "");
-          for (const std::string& meta_value_name : meta_data) {
-            if (subordinate.metaValueExists(meta_value_name) && meta_value_name == "QC_transition_message") {
-              OpenMS::StringList messages = subordinate.getMetaValue(meta_value_name).toStringList();
-              row.push_back(
-                Utilities::join(messages.begin(), messages.end(), delimiter)
-              );
-            }
-            else if (feature.metaValueExists(meta_value_name) && meta_value_name == "QC_transition_group_message") 
-            {
-              OpenMS::StringList messages = feature.getMetaValue(meta_value_name).toStringList();
-              row.push_back(
-                Utilities::join(messages.begin(), messages.end(), delimiter)
-              );
+          // Case #2: Features and subordinates
+          for (const OpenMS::Feature& subordinate : feature.getSubordinates())
+          {
+            row.clear();
+            row.push_back(sample_handler.getSampleGroupName());
+            row.push_back(component_group_name);
+            if (!subordinate.metaValueExists(SequenceParser::s_native_id) ||
+              subordinate.getMetaValue(SequenceParser::s_native_id).isEmpty() ||
+              subordinate.getMetaValue(SequenceParser::s_native_id).toString().empty()) {
+              LOGV << "component_name is absent or empty. Skipping this subordinate";
+              continue;
             }
-            else 
+            const std::string component_name = subordinate.getMetaValue(SequenceParser::s_native_id);
+            if (component_names.size() > 0 && component_names.count(component_name) == 0)
+              continue;
+            row.push_back(component_name);
+            row.push_back(subordinate.metaValueExists("used_") ? subordinate.getMetaValue("used_").toString() : "");
+            for (const std::string& meta_value_name : meta_data)
             {
               CastValue datum = SequenceHandler::getMetaValue(feature, subordinate, meta_value_name);
               if (datum.getTag() == CastValue::Type::FLOAT)
@@ -777,14 +907,14 @@ namespace SmartPeak
                 row.push_back(std::string(datum));
               }
             }
+            on_row(row);
           }
-          rows_out.push_back(row);
         }
       }
     }
   }
 
-  void SequenceParser::makeGroupDataTableFromMetaValue(
+  void SequenceParser::makeDataTableFromMetaValue(
     const SequenceHandler& sequenceHandler,
     std::vector<std::vector<std::string>>& rows_out,
     std::vector<std::string>& headers_out,
@@ -793,103 +923,25 @@ namespace SmartPeak
     const std::set<std::string>& sample_names,
     const std::set<std::string>& component_group_names,
     const std::set<std::string>& component_names) {
-    std::vector<std::string> headers = {
-      "sample_group_name", "component_group_name", "component_name", "used_"
-    };
-    headers.insert(headers.end(), meta_data.cbegin(), meta_data.cend());
-    headers_out = headers;
-
-    const std::string delimiter{ "_____" };
-
+    headers_out = makeDataTableHeaders(meta_data);
     rows_out.clear();
-    for (const SampleGroupHandler& sample_handler : sequenceHandler.getSampleGroups())
-    {
-      auto feature_map = sample_handler.getFeatureMap();
-      
-      if (sample_names.size() > 0 && sample_names.count(sample_handler.getSampleGroupName()) == 0)
-        continue;
-
-      for (const OpenMS::Feature& feature : feature_map)
-      {
-        if (!feature.metaValueExists(s_PeptideRef) || feature.getMetaValue(s_PeptideRef).isEmpty()) {
-          LOGV << "component_group_name is absent or empty. Skipping this feature";
-          continue;
-        }
-        const std::string component_group_name = feature.getMetaValue(s_PeptideRef);
-        if (component_group_names.size() > 0 && component_group_names.count(component_group_name) == 0)
-          continue;
-
-        // Case #1: Features only
-        if (feature.getSubordinates().size() <= 0) {
-          std::vector<std::string> row;
-          row.push_back(sample_handler.getSampleGroupName());
-          row.push_back(component_group_name);
-          row.push_back("");
-          row.push_back(feature.metaValueExists("used_") ? feature.getMetaValue("used_").toString() : "");
-          for (const std::string& meta_value_name : meta_data)
-          {
-            CastValue datum = SequenceHandler::getMetaValue(feature, feature, meta_value_name);
-            if (datum.getTag() == CastValue::Type::FLOAT)
-            {
-              if (datum.f_ != 0.0)
-              {
-                // NOTE: to_string() rounds at 1e-6. Therefore, some precision might be lost.
-                row.push_back(std::to_string(datum.f_));
-              }
-              else
-              {
-                row.push_back("");
-              }
-            }
-            else
-            {
-              row.push_back(std::string(datum));
-            }
-          }
-          rows_out.push_back(row);
-        }
+    forEachDataTableRow(sequenceHandler, meta_data, sample_types, sample_names, component_group_names, component_names,
+      [&rows_out](const std::vector<std::string>& row) { rows_out.push_back(row); });
+  }
 
-        // Case #2: Features and subordinates
-        for (const OpenMS::Feature& subordinate : feature.getSubordinates())
-        {
-          std::vector<std::string> row;
-          row.push_back(sample_handler.getSampleGroupName());
-          row.push_back(component_group_name);
-          if (!subordinate.metaValueExists(s_native_id) ||
-            subordinate.getMetaValue(s_native_id).isEmpty() ||
-            subordinate.getMetaValue(s_native_id).toString().empty()) {
-            LOGV << "component_name is absent or empty. Skipping this subordinate";
-            continue;
-          }
-          const std::string component_name = subordinate.getMetaValue(s_native_id);
-          if (component_names.size() > 0 && component_names.count(component_name) == 0)
-            continue;
-          row.push_back(component_name);
-          row.push_back(subordinate.metaValueExists("used_") ? subordinate.getMetaValue("used_").toString() : "");
-          for (const std::string& meta_value_name : meta_data)
-          {
-            CastValue datum = SequenceHandler::getMetaValue(feature, subordinate, meta_value_name);
-            if (datum.getTag() == CastValue::Type::FLOAT)
-            {
-              if (datum.f_ != 0.0)
-              {
-                // NOTE: to_string() rounds at 1e-6. Therefore, some precision might be lost.
-                row.push_back(std::to_string(datum.f_));
-              }
-              else
-              {
-                row.push_back("");
-              }
-            }
-            else
-            {
-              row.push_back(std::string(datum));
-            }
-          }
-          rows_out.push_back(row);
-        }
-      }
-    }
+  void SequenceParser::makeGroupDataTableFromMetaValue(
+    const SequenceHandler& sequenceHandler,
+    std::vector<std::vector<std::string>>& rows_out,
+    std::vector<std::string>& headers_out,
+    const std::vector<std::string>& meta_data,
+    const std::set<SampleType>& sample_types,
+    const std::set<std::string>& sample_names,
+    const std::set<std::string>& component_group_names,
+    const std::set<std::string>& component_names) {
+    headers_out = makeGroupDataTableHeaders(meta_data);
+    rows_out.clear();
+    forEachGroupDataTableRow(sequenceHandler, meta_data, sample_types, sample_names, component_group_names, component_names,
+      [&rows_out](const std::vector<std::string>& row) { rows_out.push_back(row); });
   }
 
   bool SequenceParser::writeDataTableFromMetaValue(
@@ -902,13 +954,11 @@ namespace SmartPeak
     LOGD << "START writeDataTableFromMetaValue";
     LOGI << "Storing: " << filename.generic_string();
 
-    std::vector<std::vector<std::string>> rows;
-    std::vector<std::string> headers;
     std::vector<std::string> meta_data_strings;
     for (const FeatureMetadata& m : meta_data) {
       meta_data_strings.push_back(metadataToString.at(m));
     }
-    makeDataTableFromMetaValue(sequenceHandler, rows, headers, meta_data_strings, sample_types, std::set<std::string>(), std::set<std::string>(), std::set<std::string>());
+    const std::vector<std::string> headers = makeDataTableHeaders(meta_data_strings);
 
     CSVWriter writer(filename.generic_string(), ",");
     const std::optional<size_t> cnt = writer.writeDataInRow(headers.cbegin(), headers.cend());
@@ -918,12 +968,13 @@ namespace SmartPeak
       return false;
     }
 
-    for (const std::vector<std::string>& line : rows) {
-      writer.writeDataInRow(line.cbegin(), line.cend());
-    }
+    // rows are written as they are made
+    forEachDataTableRow(sequenceHandler, meta_data_strings, sample_types, std::set<std::string>(), std::set<std::string>(), std::set<std::string>(),
+      [&writer](const std::vector<std::string>& line) { writer.writeDataInRow(line.cbegin(), line.cend()); });
+    const bool stored = writer.close();
 
     LOGD << "END writeDataTableFromMetaValue";
-    return true;
+    return stored;
   }
 
   bool SequenceParser::writeGroupDataTableFromMetaValue(
@@ -936,13 +987,11 @@ namespace SmartPeak
     LOGD << "START writeDataTableFromMetaValue";
     LOGI << "Storing: " << filename.generic_string();
 
-    std::vector<std::vector<std::string>> rows;
-    std::vector<std::string> headers;
     std::vector<std::string> meta_data_strings;
     for (const FeatureMetadata& m : meta_data) {
       meta_data_strings.push_back(metadataToString.at(m));
     }
-    makeGroupDataTableFromMetaValue(sequenceHandler, rows, headers, meta_data_strings, sample_types, std::set<std::string>(), std::set<std::string>(), std::set<std::string>());
+    const std::vector<std::string> headers = makeGroupDataTableHeaders(meta_data_strings);
 
     CSVWriter writer(filename.generic_string(), ",");
     const std::optional<size_t> cnt = writer.writeDataInRow(headers.cbegin(), headers.cend());
@@ -952,41 +1001,159 @@ namespace SmartPeak
       return false;
     }
 
-    for (const std::vector<std::string>& line : rows) {
-      writer.writeDataInRow(line.cbegin(), line.cend());
-    }
+    // rows are written as they are made
+    forEachGroupDataTableRow(sequenceHandler, meta_data_strings, sample_types, std::set<std::string>(), std::set<std::string>(), std::set<std::string>(),
+      [&writer](const std::vector<std::string>& line) { writer.writeDataInRow(line.cbegin(), line.cend()); });
+    const bool stored = writer.close();
 
     LOGD << "END writeDataTableFromMetaValue";
-    return true;
+    return stored;
   }
 
-  struct Row
+  namespace
   {
-    Row() = default;
-    ~Row() = default;
-    Row(const Row&) = default;
-    Row& operator=(const Row&) = default;
-    Row(Row&&) = default;
-    Row& operator=(Row&&) = default;
-
-    Row(const std::string& cgn, const std::string& cn, const std::string& mvn) :
-      component_group_name(cgn),
-      component_name(cn),
-      meta_value_name(mvn) {}
-
-    std::string component_group_name;
-    std::string component_name;
-    std::string meta_value_name;
-  };
+    /**
+      Accumulates the float values of the data matrices, indexed by interned ids.
 
-  struct Row_less
-  {
-    bool operator()(const Row& lhs, const Row& rhs) const
+      Rows are (component group name, component name, meta value) and columns are sample names.
+      The first value set for a row and a column is kept; missing and NaN values are exported as 0.
+    */
+    class DataMatrixBuilder
     {
-      return lhs.component_group_name + lhs.component_name + lhs.meta_value_name <
-        rhs.component_group_name + rhs.component_name + rhs.meta_value_name;
-    }
-  };
+    public:
+      DataMatrixBuilder(
+        const std::vector<std::string>& meta_data,
+        const std::set<std::string>& component_group_names,
+        const std::set<std::string>& component_names
+      ) : meta_data_(meta_data)
+      {
+        for (const auto& meta_value_name : meta_data_) meta_data_ids_.push_back(FeatureTable::intern(meta_value_name));
+        for (const auto& name : component_group_names) component_group_filter_.insert(FeatureTable::intern(name));
+        for (const auto& name : component_names) component_filter_.insert(FeatureTable::intern(name));
+      }
+
+      /**
+        @param[in] validation_metrics if set, used for the "accuracy" and "n_features" meta values
+      */
+      void addFeatureTable(
+        const std::string& sample_name,
+        const FeatureTable& table,
+        const std::map<std::string, float>* validation_metrics = nullptr
+      )
+      {
+        std::vector<float>* column = nullptr;
+        const auto& component_group_ids = table.getComponentGroupIds();
+        const auto& component_ids = table.getComponentIds();
+        const auto& is_subordinate = table.getIsSubordinate();
+        for (size_t m = 0; m < meta_data_.size(); ++m) {
+          const std::string& meta_value_name = meta_data_[m];
+          const bool from_validation_metrics = validation_metrics && (meta_value_name == "accuracy" || meta_value_name == "n_features");
+          const std::vector<float>* values = table.getColumn(meta_value_name);
+          if (!from_validation_metrics && !values)
+            continue;
+          for (size_t r = 0; r < table.size(); ++r) {
+            if (component_group_filter_.size() && component_group_filter_.count(component_group_ids[r]) == 0)
+              continue;
+            if (is_subordinate[r] && component_filter_.size() && component_filter_.count(component_ids[r]) == 0)
+              continue;
+            float value = from_validation_metrics ? validation_metrics->at(meta_value_name) : (*values)[r];
+            if (std::isnan(value)) value = 0.0f; // Skip NAN (replaced by 0 later)
+            if (!column) column = &columns_[sample_name];
+            const size_t row = getRow(RowKey{ component_group_ids[r], component_ids[r], meta_data_ids_[m] });
+            if (column->size() <= row) column->resize(rows_.size(), unset_value_);
+            if (std::isnan((*column)[row])) (*column)[row] = value;
+          }
+        }
+      }
+
+      void build(
+        Eigen::Tensor<float, 2>& data_out,
+        Eigen::Tensor<std::string, 1>& columns_out,
+        Eigen::Tensor<std::string, 2>& rows_out
+      ) const
+      {
+        // Rows are sorted on the concatenation of their names, as done by the previous exports
+        std::vector<std::string> sort_keys;
+        sort_keys.reserve(rows_.size());
+        for (const RowKey& r : rows_) {
+          sort_keys.push_back(FeatureTable::getString(r.component_group) + FeatureTable::getString(r.component) + FeatureTable::getString(r.meta_value));
+        }
+        std::vector<size_t> order(rows_.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&sort_keys](size_t lhs, size_t rhs) { return sort_keys[lhs] < sort_keys[rhs]; });
+
+        // Copy over the rows
+        rows_out.resize((int)rows_.size(), 3);
+        int row = 0;
+        for (const size_t r : order) {
+          rows_out(row, 0) = FeatureTable::getString(rows_[r].component);
+          rows_out(row, 1) = FeatureTable::getString(rows_[r].component_group);
+          rows_out(row, 2) = FeatureTable::getString(rows_[r].meta_value);
+          ++row;
+        }
+
+        // Copy over the columns
+        columns_out.resize((int)columns_.size());
+        int col = 0;
+        for (const auto& c : columns_) {
+          columns_out(col) = c.first;
+          ++col;
+        }
+
+        // Copy over the data
+        data_out.resize((int)rows_.size(), (int)columns_.size());
+        data_out.setConstant(0.0); // for now, initialize to 0 instead of NAN even though there are clear benefits to using NAN in packages that support NAN
+        col = 0;
+        for (const auto& c : columns_) {
+          row = 0;
+          for (const size_t r : order) {
+            if (r < c.second.size() && !std::isnan(c.second[r])) {
+              data_out(row, col) = c.second[r];
+            }
+            ++row;
+          }
+          ++col;
+        }
+      }
+
+    protected:
+      struct RowKey
+      {
+        FeatureTable::Id component_group;
+        FeatureTable::Id component;
+        FeatureTable::Id meta_value;
+        bool operator==(const RowKey& other) const
+        {
+          return component_group == other.component_group && component == other.component && meta_value == other.meta_value;
+        }
+      };
+
+      struct RowKeyHash
+      {
+        size_t operator()(const RowKey& key) const
+        {
+          const uint64_t ids = (static_cast<uint64_t>(key.component_group) << 32) | key.component;
+          return std::hash<uint64_t>()(ids) ^ (std::hash<uint32_t>()(key.meta_value) << 1);
+        }
+      };
+
+      size_t getRow(const RowKey& key)
+      {
+        const auto inserted = row_index_.emplace(key, rows_.size());
+        if (inserted.second) rows_.push_back(key);
+        return inserted.first->second;
+      }
+
+      static constexpr float unset_value_ = std::numeric_limits<float>::quiet_NaN();
+      const std::vector<std::string>& meta_data_;
+      std::vector<FeatureTable::Id> meta_data_ids_;
+      std::unordered_set<FeatureTable::Id> component_group_filter_;
+      std::unordered_set<FeatureTable::Id> component_filter_;
+      std::vector<RowKey> rows_;
+      std::unordered_map<RowKey, size_t, RowKeyHash> row_index_;
+      std::map<std::string, std::vector<float>> columns_; ///< sorted by sample name, values indexed by row (NaN if not set)
+    };
+  }
 
   void SequenceParser::makeDataMatrixFromMetaValue(
     const SequenceHandler& sequenceHandler,
@@ -1000,133 +1167,38 @@ namespace SmartPeak
     const std::set<std::string>& component_names
   )
   {
-    std::set<std::string> columns;
-    std::set<Row,Row_less> rows;
-    std::map<std::string,std::map<Row,float,Row_less>> data_dict;
+    DataMatrixBuilder data_matrix(meta_data, component_group_names, component_names);
 
     for (const InjectionHandler& sampleHandler : sequenceHandler.getSequence()) {
       const MetaDataHandler& mdh = sampleHandler.getMetaData();
-      std::map<std::string, float> validation_metrics = sampleHandler.getRawData().getValidationMetrics();
       const std::string& sample_name = mdh.getSampleName();
       if (sample_names.size() && sample_names.count(sample_name) == 0) 
         continue;
       if (sample_types.count(mdh.getSampleType()) == 0) 
         continue;
-      data_dict.insert({ sample_name, std::map<Row,float,Row_less>() });
-      for (const std::string& meta_value_name : meta_data) {
-        // feature_map_history is not needed here as we are only interested in the current/"used" features
-        for (const OpenMS::Feature& feature : sampleHandler.getRawData().getFeatureMapHistory()) {
-          if (component_group_names.size() && component_group_names.count(feature.getMetaValue(s_PeptideRef).toString()) == 0)
-            continue;
-          if (feature.metaValueExists("used_")) {
-            const std::string used = feature.getMetaValue("used_").toString();
-            if (used.empty() || used[0] == 'f' || used[0] == 'F')
-              continue;
-          }
-
-          // Case #1 Features only
-          if (feature.getSubordinates().size() <= 0) {
-            const Row row_tuple_name(
-              feature.getMetaValue(s_PeptideRef).toString(),
-              "",
-              meta_value_name
-            );
-            CastValue datum;
-            if (meta_value_name == "accuracy" || meta_value_name == "n_features") {
-              datum = validation_metrics.at(meta_value_name);
-            }
-            else 
-            {
-              datum = SequenceHandler::getMetaValue(feature, feature, meta_value_name);
-            }
-            if (datum.getTag() == CastValue::Type::FLOAT && !std::isnan(datum.f_)) { // Skip NAN (replaced by 0 later)
-              data_dict[sample_name].emplace(row_tuple_name, datum.f_);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-            else
-            {
-              data_dict[sample_name].emplace(row_tuple_name, 0.0f);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-          }
-
-          // Case #2 Features and subordinates
-          for (const OpenMS::Feature& subordinate : feature.getSubordinates()) {
-            if (component_names.size() && component_names.count(subordinate.getMetaValue(s_native_id).toString()) == 0) 
-              continue;
-            if (subordinate.metaValueExists("used_")) {
-              const std::string used = subordinate.getMetaValue("used_").toString();
-              if (used.empty() || used[0] == 'f' || used[0] == 'F') 
-                continue;
-            }
-            const Row row_tuple_name(
-              feature.getMetaValue(s_PeptideRef).toString(),
-              subordinate.getMetaValue(s_native_id).toString(),
-              meta_value_name
-            );
-            CastValue datum;
-            if (meta_value_name == "accuracy" || meta_value_name == "n_features") {
-              datum = validation_metrics.at(meta_value_name);
-            }
-            else 
-            {
-              datum = SequenceHandler::getMetaValue(feature, subordinate, meta_value_name);
-            }
-            if (meta_value_name == "validation") {
-              if (datum.s_ == "TP") datum = static_cast<float>(1.0);
-              else if (datum.s_ == "FP") datum = static_cast<float>(-1.0);
-              else datum = static_cast<float>(-2.0);
-            }
-            if (datum.getTag() == CastValue::Type::FLOAT && !std::isnan(datum.f_)) { // Skip NAN (replaced by 0 later)
-              data_dict[sample_name].emplace(row_tuple_name, datum.f_);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-            else
-            {
-              data_dict[sample_name].emplace(row_tuple_name, 0.0f);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-          }
-        }
-      }
-    }
-
-    // Copy over the rows
-    rows_out.resize((int)rows.size(), 3);
-    int row = 0;
-    for (const auto& r: rows) {
-      rows_out(row, 0) = r.component_name;
-      rows_out(row, 1) = r.component_group_name;
-      rows_out(row, 2) = r.meta_value_name;
-      ++row;
+      // The feature table only holds the current/"used" features of the feature map history
+      const std::shared_ptr<const FeatureTable> feature_table = sampleHandler.getRawData().getFeatureTable(meta_data);
+      data_matrix.addFeatureTable(sample_name, *feature_table, &sampleHandler.getRawData().getValidationMetrics());
     }
 
-    // Copy over the columns
-    columns_out.resize((int)columns.size());
-    int col = 0;
-    for (const auto& c : columns) {
-      columns_out(col) = c;
-      ++col;
-    }
+    data_matrix.build(data_out, columns_out, rows_out);
+  }
 
-    // Copy over the data
-    data_out.resize((int)rows.size(), (int)columns.size());
-    data_out.setConstant(0.0); // for now, initialize to 0 instead of NAN even though there are clear benefits to using NAN in packages that support NAN
-    col = 0;
-    for (const auto& c : columns) {
-      row = 0;
-      for (const auto& r : rows) {
-        if (data_dict.count(c) && data_dict[c].count(r)) {
-          data_out(row,col) = data_dict[c][r];
-        }
-        ++row;
-      }
-      ++col;
+  void SequenceParser::makeDataMatrixFromFeatureTables(
+    const std::vector<InjectionFeatureTable>& feature_tables,
+    Eigen::Tensor<float, 2>& data_out,
+    Eigen::Tensor<std::string, 1>& columns_out,
+    Eigen::Tensor<std::string, 2>& rows_out,
+    const std::vector<std::string>& meta_data,
+    const std::set<std::string>& component_group_names,
+    const std::set<std::string>& component_names
+  )
+  {
+    DataMatrixBuilder data_matrix(meta_data, component_group_names, component_names);
+    for (const InjectionFeatureTable& injection : feature_tables) {
+      data_matrix.addFeatureTable(injection.sample_name, *injection.feature_table, injection.validation_metrics);
     }
+    data_matrix.build(data_out, columns_out, rows_out);
   }
 
   bool SequenceParser::writeDataMatrixFromMetaValue(
@@ -1160,20 +1232,22 @@ namespace SmartPeak
       return false;
     }
 
+    std::vector<std::string> line;
     for (size_t i = 0; i < rows.dimension(0); ++i) {
-      std::vector<std::string> line;
+      line.clear();
       for (size_t j = 0; j < rows.dimension(1); ++j) {
-        line.push_back(rows(i,j));
+        line.push_back(rows(i, j));
       }
       for (size_t j = 0; j < data.dimension(1); ++j) {
         // NOTE: to_string() rounds at 1e-6. Therefore, some precision might be lost.
-        line.emplace_back(std::to_string(data(i,j)));
+        line.emplace_back(std::to_string(data(i, j)));
       }
       writer.writeDataInRow(line.cbegin(), line.cend());
     }
+    const bool stored = writer.close();
 
     LOGD << "END writeDataMatrixFromMetaValue";
-    return true;
+    return stored;
   }
 
   void SequenceParser::makeGroupDataMatrixFromMetaValue(
@@ -1188,9 +1262,7 @@ namespace SmartPeak
     const std::set<std::string>& component_names
   )
   {
-    std::set<std::string> columns;
-    std::set<Row, Row_less> rows;
-    std::map<std::string, std::map<Row, float, Row_less>> data_dict;
+    DataMatrixBuilder data_matrix(meta_data, component_group_names, component_names);
 
     for (const SampleGroupHandler& sample_handler : sequenceHandler.getSampleGroups()) {
 
@@ -1199,109 +1271,12 @@ namespace SmartPeak
       if (sample_names.size() && sample_names.count(sample_name) == 0)
         continue;
 
-      data_dict.insert({ sample_name, std::map<Row,float,Row_less>() });
-      for (const std::string& meta_value_name : meta_data) {
-        // feature_map_history is not needed here as we are only interested in the current/"used" features
-        for (const OpenMS::Feature& feature : sample_handler.getFeatureMap()) {
-          if (component_group_names.size() && component_group_names.count(feature.getMetaValue(s_PeptideRef).toString()) == 0)
-            continue;
-          if (feature.metaValueExists("used_")) {
-            const std::string used = feature.getMetaValue("used_").toString();
-            if (used.empty() || used[0] == 'f' || used[0] == 'F')
-              continue;
-          }
-
-          // Case #1 Features only
-          if (feature.getSubordinates().size() <= 0) {
-            const Row row_tuple_name(
-              feature.getMetaValue(s_PeptideRef).toString(),
-              "",
-              meta_value_name
-            );
-            CastValue datum;
-            datum = SequenceHandler::getMetaValue(feature, feature, meta_value_name);
-            if (datum.getTag() == CastValue::Type::FLOAT && !std::isnan(datum.f_)) { // Skip NAN (replaced by 0 later)
-              data_dict[sample_name].emplace(row_tuple_name, datum.f_);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-            else
-            {
-              data_dict[sample_name].emplace(row_tuple_name, 0.0f);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-          }
-
-          // Case #2 Features and subordinates
-          for (const OpenMS::Feature& subordinate : feature.getSubordinates()) {
-            if (component_names.size() && component_names.count(subordinate.getMetaValue(s_native_id).toString()) == 0)
-              continue;
-            if (subordinate.metaValueExists("used_")) {
-              const std::string used = subordinate.getMetaValue("used_").toString();
-              if (used.empty() || used[0] == 'f' || used[0] == 'F')
-                continue;
-            }
-            const Row row_tuple_name(
-              feature.getMetaValue(s_PeptideRef).toString(),
-              subordinate.getMetaValue(s_native_id).toString(),
-              meta_value_name
-            );
-            CastValue datum;
-            datum = SequenceHandler::getMetaValue(feature, subordinate, meta_value_name);
-            if (meta_value_name == "validation") {
-              if (datum.s_ == "TP") datum = static_cast<float>(1.0);
-              else if (datum.s_ == "FP") datum = static_cast<float>(-1.0);
-              else datum = static_cast<float>(-2.0);
-            }
-            if (datum.getTag() == CastValue::Type::FLOAT && !std::isnan(datum.f_)) { // Skip NAN (replaced by 0 later)
-              data_dict[sample_name].emplace(row_tuple_name, datum.f_);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-            else
-            {
-              data_dict[sample_name].emplace(row_tuple_name, 0.0f);
-              columns.insert(sample_name);
-              rows.insert(row_tuple_name);
-            }
-          }
-        }
-      }
-    }
-
-    // Copy over the rows
-    rows_out.resize((int)rows.size(), 3);
-    int row = 0;
-    for (const auto& r : rows) {
-      rows_out(row, 0) = r.component_name;
-      rows_out(row, 1) = r.component_group_name;
-      rows_out(row, 2) = r.meta_value_name;
-      ++row;
-    }
-
-    // Copy over the columns
-    columns_out.resize((int)columns.size());
-    int col = 0;
-    for (const auto& c : columns) {
-      columns_out(col) = c;
-      ++col;
+      // Only the current/"used" features are kept in the feature table
+      const FeatureTable feature_table(sample_handler.getFeatureMap(), meta_data);
+      data_matrix.addFeatureTable(sample_name, feature_table);
     }
 
-    // Copy over the data
-    data_out.resize((int)rows.size(), (int)columns.size());
-    data_out.setConstant(0.0); // for now, initialize to 0 instead of NAN even though there are clear benefits to using NAN in packages that support NAN
-    col = 0;
-    for (const auto& c : columns) {
-      row = 0;
-      for (const auto& r : rows) {
-        if (data_dict.count(c) && data_dict[c].count(r)) {
-          data_out(row, col) = data_dict[c][r];
-        }
-        ++row;
-      }
-      ++col;
-    }
+    data_matrix.build(data_out, columns_out, rows_out);
   }
 
   bool SequenceParser::writeGroupDataMatrixFromMetaValue(
@@ -1335,8 +1310,9 @@ namespace SmartPeak
       return false;
     }
 
+    std::vector<std::string> line;
     for (size_t i = 0; i < rows.dimension(0); ++i) {
-      std::vector<std::string> line;
+      line.clear();
       for (size_t j = 0; j < rows.dimension(1); ++j) {
         line.push_back(rows(i, j));
       }
@@ -1346,9 +1322,10 @@ namespace SmartPeak
       }
       writer.writeDataInRow(line.cbegin(), line.cend());
     }
+    const bool stored = writer.close();
 
     LOGD << "END writeDataMatrixFromMetaValue";
-    return true;
+    return stored;
   }
 
   void StoreSequenceFileAnalyst::getFilenames(Filenames& filenames) const
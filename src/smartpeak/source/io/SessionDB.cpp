@@ -24,7 +24,6 @@
 #include <SmartPeak/io/SessionDB.h>
 #include <SmartPeak/core/Utilities.h>
 #include <plog/Log.h>
-#include <regex>
 
 namespace SmartPeak
 {
@@ -45,10 +44,19 @@ namespace SmartPeak
       LOGE << "Can't open database (" << session_file_name_.generic_string() << ") : " << sqlite3_errmsg(db);
       return std::nullopt;
     }
-    else
+    if (wal_journal_mode_)
     {
-      return db;
+      char* zErrMsg = nullptr;
+      const std::string sql = "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;";
+      rc = sqlite3_exec(db, sql.c_str(), NULL, 0, &zErrMsg);
+      if (rc != SQLITE_OK)
+      {
+        // not fatal, the default journal mode will be used
+        logSQLError(zErrMsg, sql);
+        sqlite3_free(zErrMsg);
+      }
     }
+    return db;
   }
 
   void SessionDB::closeSessionDB(sqlite3* db)
@@ -66,13 +74,69 @@ namespace SmartPeak
     closeSessionDB(db_context.db);
   }
 
-  void SessionDB::endWrite(SessionDB::DBContext& db_context)
+  bool SessionDB::endWrite(SessionDB::DBContext& db_context)
+  {
+    if (db_context.stmt)
+    {
+      sqlite3_finalize(db_context.stmt);
+      db_context.stmt = nullptr;
+    }
+    if (!commitTransaction(db_context))
+    {
+      abortWrite(db_context);
+      return false;
+    }
+    closeSessionDB(db_context.db);
+    return true;
+  }
+
+  bool SessionDB::beginTransaction(SessionDB::DBContext& db_context)
+  {
+    char* zErrMsg = nullptr;
+    const std::string sql = "BEGIN TRANSACTION;";
+    int rc = sqlite3_exec(db_context.db, sql.c_str(), NULL, 0, &zErrMsg);
+    if (rc != SQLITE_OK)
+    {
+      logSQLError(zErrMsg, sql);
+      sqlite3_free(zErrMsg);
+      return false;
+    }
+    db_context.in_transaction = true;
+    return true;
+  }
+
+  bool SessionDB::commitTransaction(SessionDB::DBContext& db_context)
+  {
+    if (!db_context.in_transaction)
+    {
+      return true;
+    }
+    char* zErrMsg = nullptr;
+    const std::string sql = "COMMIT;";
+    int rc = sqlite3_exec(db_context.db, sql.c_str(), NULL, 0, &zErrMsg);
+    if (rc != SQLITE_OK)
+    {
+      // the transaction is still pending, it is left to the caller to roll it back
+      logSQLError(zErrMsg, sql);
+      sqlite3_free(zErrMsg);
+      return false;
+    }
+    db_context.in_transaction = false;
+    return true;
+  }
+
+  void SessionDB::abortWrite(SessionDB::DBContext& db_context)
   {
     if (db_context.stmt)
     {
       sqlite3_finalize(db_context.stmt);
       db_context.stmt = nullptr;
     }
+    if (db_context.in_transaction)
+    {
+      db_context.in_transaction = false;
+      sqlite3_exec(db_context.db, "ROLLBACK;", NULL, 0, NULL);
+    }
     closeSessionDB(db_context.db);
   }
 
@@ -193,14 +257,6 @@ namespace SmartPeak
     value = sqlite3_column_int(db_context.stmt, column);
   }
 
-template <>
-void SessionDB::write<std::string>(std::ostringstream& os, SessionDB::DBContext& db_context, const std::string& value)
-{
-  std::string escaped_string(value);
-  escaped_string = std::regex_replace(escaped_string, std::regex("\'"), "\'\'");
-  os << "'" << escaped_string << "'";
-}
-
 void SessionDB::logSQLError(const std::string& error_message, const std::string& sql_command) const
 {
   LOGE << "SQL Error: " << error_message;
@@ -236,25 +292,25 @@ std::string valueTypeToString(const CastValue::Type value_type)
   }
 }
 
-std::string castValueToSqlString(const CastValue& cast_value)
+void bindCastValue(sqlite3_stmt* stmt, int column, const CastValue& cast_value)
 {
   switch (cast_value.getTag())
   {
   case CastValue::Type::BOOL:
-    return (cast_value.b_ ? "1" : "0");
-  case CastValue::Type::STRING:
-  case CastValue::Type::STRING_LIST:
+    sqlite3_bind_int(stmt, column, cast_value.b_ ? 1 : 0);
+    break;
+  case CastValue::Type::INT:
+    sqlite3_bind_int(stmt, column, cast_value.i_);
+    break;
+  case CastValue::Type::FLOAT:
+    sqlite3_bind_double(stmt, column, cast_value.f_);
+    break;
+  default:
   {
-    std::string escaped_string(cast_value);
-    escaped_string = std::regex_replace(escaped_string, std::regex("\'"), "\'\'");
-    return std::string("'") + escaped_string + std::string("'");
+    const std::string value(cast_value);
+    sqlite3_bind_text(stmt, column, value.c_str(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+    break;
   }
-  case CastValue::Type::BOOL_LIST:
-  case CastValue::Type::FLOAT_LIST:
-  case CastValue::Type::INT_LIST:
-    return std::string("'") + std::string(cast_value) + std::string("'");
-  default:
-    return std::string(cast_value);
   }
 }
 
@@ -280,6 +336,12 @@ bool SessionDB::writePropertiesHandler(const IPropertiesHandler& properties_hand
   db_context.table = table_name;
   db_context.db = *db;
 
+  if (!beginTransaction(db_context))
+  {
+    closeSessionDB(*db);
+    return false;
+  }
+
   // first, we delete table (to remove)
   os.str("");
   os << "DROP TABLE ";
@@ -288,6 +350,8 @@ bool SessionDB::writePropertiesHandler(const IPropertiesHandler& properties_hand
   std::string sql = os.str();
   rc = sqlite3_exec(*db, sql.c_str(), NULL, 0, &zErrMsg);
   // -- ignore error
+  sqlite3_free(zErrMsg);
+  zErrMsg = nullptr;
 
   // create table
   auto properties = properties_handler.getPropertiesSchema();
@@ -313,57 +377,70 @@ bool SessionDB::writePropertiesHandler(const IPropertiesHandler& properties_hand
   {
     logSQLError(zErrMsg, sql);
     sqlite3_free(zErrMsg);
+    abortWrite(db_context);
     return false;
   }
 
-  // write data
+  // prepare insert
   os.str("");
+  os << "INSERT INTO ";
+  os << "\"" << table_name << "\"";
+  separator = "";
+  os << " (";
+  for (const auto& [column_name, column_type] : properties)
+  {
+    os << separator;
+    os << "\"" << column_name << "\"";
+    separator = ", ";
+  }
+  os << ") ";
+  os << "VALUES (";
+  separator = "";
+  for (size_t i = 0; i < properties.size(); ++i)
+  {
+    os << separator << "?";
+    separator = ", ";
+  }
+  os << ");";
+  sql = os.str();
+  rc = sqlite3_prepare_v2(*db, sql.c_str(), sql.size(), &db_context.stmt, NULL);
+  if (rc != SQLITE_OK)
+  {
+    logSQLError(sqlite3_errmsg(*db), sql);
+    abortWrite(db_context);
+    return false;
+  }
+
+  // write data
   auto nb_rows = properties_handler.getNbRows();
   for (size_t i = 0; i < nb_rows; ++i)
   {
-    os << "INSERT INTO ";
-    os << "\"" << table_name << "\"";
-    separator = "";
-    os << " (";
+    int column = 1;
     for (const auto& [column_name, column_type] : properties)
     {
-      os << separator;
-      os << "\"" << column_name << "\"";
-      separator = ", ";
-    }
-    os << ") ";
-
-    os << "VALUES (";
-    separator = "";
-    for (const auto& [column_name, column_type] : properties)
-    {
-      os << separator;
-      auto value = properties_handler.getProperty(column_name);
+      auto value = properties_handler.getProperty(column_name, i);
       if (value)
       {
-        os << castValueToSqlString(*value);
+        bindCastValue(db_context.stmt, column, *value);
+      }
+      else
+      {
+        sqlite3_bind_null(db_context.stmt, column);
       }
-      separator = ", ";
+      ++column;
     }
-    os << "); ";
-    std::string sql = os.str();
-    rc = sqlite3_exec(db_context.db, sql.c_str(), NULL, 0, &zErrMsg);
-    if (rc != SQLITE_OK) {
-      logSQLError(zErrMsg, sql);
-      sqlite3_free(zErrMsg);
+    rc = sqlite3_step(db_context.stmt);
+    if (rc != SQLITE_DONE)
+    {
+      logSQLError(sqlite3_errmsg(db_context.db), sql);
+      abortWrite(db_context);
       return false;
     }
+    sqlite3_reset(db_context.stmt);
   }
 
   // end write
-  if (db_context.stmt)
-  {
-    sqlite3_finalize(db_context.stmt);
-    db_context.stmt = nullptr;
-  }
-  closeSessionDB(db_context.db);
-
-  return true;
+  return endWrite(db_context);
 }
 
 bool SessionDB::readPropertiesHandler(IPropertiesHandler& properties_handler)
@@ -9,6 +9,7 @@ set(sources_list
 	SequenceParser.cpp
 	SessionDB.cpp
 	InputDataValidation.cpp
+	FeatureMapBinaryFile.cpp
 )
 
 ### add path to the filenames
@@ -5,17 +5,23 @@ set(core_executables_list
 	ApplicationSettings_test
 	CastValue_test
 	ConsoleHandler_test
+	DataPreparation_test
+	DecimationPyramid_test
 	EventDispatcher_test
 	FeatureFiltersUtils_test
+	FeatureTable_test
 	Filenames_test  
 	ImEntry_test
 	InjectionHandler_test
 	MetaDataHandler_test
+	NameSelection_test
 	Parameters_test
 	ParametersObservable_test
+	ProcessorProfiler_test
 	ProgressInfo_test
 	RawDataHandler_test
 	RawDataProcessor_test
+	RawDataResidency_test
 	SampleGroupHandler_test
 	SampleGroupProcessor_test
 	SequenceHandler_test
@@ -25,6 +31,9 @@ set(core_executables_list
 	SessionDB_test
 	SessionHandler_test
 	SessionLoaderGenerator_test
+	SpectraLibraryIndex_test
+	ThreadPool_test
+	WorkflowScheduler_test
 	UIUtilities_test
 	Utilities_test
 	WorkflowObservable_test
@@ -33,6 +42,7 @@ set(core_executables_list
 
 set(io_executables_list
 	CSVWriter_test
+	FeatureMapBinaryFile_test
 	ParametersParser_test
 	PlotExporter_test
 	SelectDilutionsParser_test
@@ -82,6 +82,7 @@ TEST(CSVWriter, writeDataInRow)
   cnt = csvwriter.writeDataInRow(line.begin(), line.end());
   ASSERT_TRUE(cnt);
   EXPECT_EQ(*cnt, 3);
+  EXPECT_TRUE(csvwriter.flush()); // rows are buffered
 
   // Read the data back in
   io::CSVReader<3> test_in(filename);
@@ -98,3 +99,25 @@ TEST(CSVWriter, writeDataInRow)
   EXPECT_STREQ(col2.c_str(), "2");
   EXPECT_STREQ(col3.c_str(), "3");
 }
+
+TEST(CSVWriter, close)
+{
+  const std::string filename = SMARTPEAK_GET_TEST_DATA_PATH("output/CSVWriterTest_close.csv");
+  std::vector<std::string> headers = { "Column1", "Column2" };
+  std::vector<std::string> line = { "a", "b" };
+  {
+    CSVWriter csvwriter(filename);
+    EXPECT_TRUE(csvwriter.writeDataInRow(headers.begin(), headers.end()));
+    EXPECT_TRUE(csvwriter.close());
+    EXPECT_TRUE(csvwriter.writeDataInRow(line.begin(), line.end())); // reopened in append mode
+    EXPECT_EQ(csvwriter.getLineCount(), 2);
+  } // closed on destruction
+
+  std::ifstream ifs(filename);
+  std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  EXPECT_STREQ(content.c_str(), "Column1,Column2\na,b\n");
+
+  CSVWriter csvwriter(SMARTPEAK_GET_TEST_DATA_PATH("output/missing_directory/CSVWriterTest_close.csv"));
+  EXPECT_FALSE(csvwriter.writeDataInRow(headers.begin(), headers.end()));
+  EXPECT_TRUE(csvwriter.close()); // nothing to write
+}
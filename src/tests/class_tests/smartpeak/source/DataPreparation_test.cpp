@@ -0,0 +1,118 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/DataPreparation.h>
+
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+using namespace SmartPeak;
+
+TEST(DataPreparation, publish)
+{
+  DataPreparationPool pool;
+  DataPreparation<std::vector<int>> data_preparation(pool);
+  std::vector<int> front;
+  EXPECT_FALSE(data_preparation.publish(front));
+  EXPECT_FALSE(data_preparation.isPending());
+  EXPECT_EQ(data_preparation.getGeneration(), 0);
+
+  const size_t generation = data_preparation.submit([](std::vector<int>& result) { result = { 1, 2, 3 }; });
+  EXPECT_TRUE(data_preparation.isPending());
+  data_preparation.wait();
+  EXPECT_TRUE(data_preparation.isPending()); // complete, not published yet
+  EXPECT_TRUE(data_preparation.publish(front));
+  EXPECT_EQ(front, std::vector<int>({ 1, 2, 3 }));
+  EXPECT_FALSE(data_preparation.isPending());
+  EXPECT_EQ(data_preparation.getGeneration(), generation);
+  EXPECT_FALSE(data_preparation.publish(front));
+  EXPECT_EQ(front, std::vector<int>({ 1, 2, 3 }));
+
+  // the buffers are swapped, the task is given the older result
+  data_preparation.submit([](std::vector<int>& result) { result.push_back(4); });
+  data_preparation.wait();
+  EXPECT_TRUE(data_preparation.publish(front));
+  EXPECT_EQ(front, std::vector<int>({ 4 }));
+}
+
+TEST(DataPreparation, supersede)
+{
+  DataPreparationPool pool;
+  DataPreparation<int> data_preparation(pool);
+  std::promise<void> started, release;
+  std::shared_future<void> released = release.get_future().share();
+  data_preparation.submit([&started, released](int& result) { started.set_value(); released.wait(); result = 1; });
+  started.get_future().wait();
+  // superseded while running: the first result is dropped, the second request is dropped by the third one
+  data_preparation.submit([](int& result) { result = 2; });
+  const size_t last_generation = data_preparation.submit([](int& result) { result = 3; });
+  release.set_value();
+  data_preparation.wait();
+  int front = 0;
+  EXPECT_TRUE(data_preparation.publish(front));
+  EXPECT_EQ(front, 3);
+  EXPECT_EQ(data_preparation.getGeneration(), last_generation);
+}
+
+TEST(DataPreparation, cancel)
+{
+  DataPreparationPool pool;
+  DataPreparation<int> data_preparation(pool);
+  std::promise<void> started, release;
+  std::shared_future<void> released = release.get_future().share();
+  data_preparation.submit([&started, released](int& result) { started.set_value(); released.wait(); result = 1; });
+  started.get_future().wait();
+  data_preparation.cancel();
+  release.set_value();
+  data_preparation.wait();
+  int front = 0;
+  EXPECT_FALSE(data_preparation.publish(front));
+  EXPECT_FALSE(data_preparation.isPending());
+  EXPECT_EQ(front, 0);
+
+  // failed requests are not published
+  data_preparation.submit([](int& result) { throw std::runtime_error("failed"); });
+  data_preparation.wait();
+  EXPECT_FALSE(data_preparation.publish(front));
+  EXPECT_FALSE(data_preparation.isPending());
+}
+
+TEST(DataPreparationPool, lockData)
+{
+  DataPreparationPool pool;
+  DataPreparation<int> data_preparation(pool);
+  int data = 1;
+  {
+    // the preparations do not run while the data are modified
+    auto lock = pool.lockData();
+    data_preparation.submit([&data](int& result) { result = data; });
+    data = 2;
+  }
+  data_preparation.wait();
+  int front = 0;
+  EXPECT_TRUE(data_preparation.publish(front));
+  EXPECT_EQ(front, 2);
+}
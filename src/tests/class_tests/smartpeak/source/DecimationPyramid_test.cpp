@@ -0,0 +1,124 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/DecimationPyramid.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace SmartPeak;
+
+namespace
+{
+  DecimationPyramid makeTestSeries(size_t nb_points, std::vector<float>& x_data, std::vector<float>& y_data)
+  {
+    x_data.clear();
+    y_data.clear();
+    for (size_t i = 0; i < nb_points; ++i)
+    {
+      x_data.push_back(static_cast<float>(i));
+      y_data.push_back(100.0f * std::sin(static_cast<float>(i) * 0.01f));
+    }
+    y_data.at(nb_points / 3) = 1000.0f; // a narrow peak
+    y_data.at(2 * nb_points / 3) = -1000.0f; // a narrow valley
+    return DecimationPyramid(x_data, y_data);
+  }
+}
+
+TEST(DecimationPyramid, constructor)
+{
+  DecimationPyramid empty_series;
+  EXPECT_EQ(empty_series.size(), 0);
+  std::vector<float> x_out, y_out;
+  empty_series.decimate(0, 10, 100, x_out, y_out);
+  EXPECT_TRUE(x_out.empty());
+  EXPECT_FALSE(empty_series.getExtent(0, 10));
+
+  std::vector<float> x_data, y_data;
+  auto series = makeTestSeries(1000, x_data, y_data);
+  EXPECT_EQ(series.size(), 1000);
+  EXPECT_EQ(series.getNbLevels(), 11); // buckets of 1 to 1024 points
+}
+
+TEST(DecimationPyramid, getIndexRange)
+{
+  std::vector<float> x_data, y_data;
+  auto series = makeTestSeries(1000, x_data, y_data);
+  EXPECT_EQ(series.getIndexRange(10.5f, 20.0f), std::make_pair(size_t(11), size_t(21)));
+  EXPECT_EQ(series.getIndexRange(-10.0f, 5000.0f), std::make_pair(size_t(0), size_t(1000)));
+  EXPECT_EQ(series.getIndexRange(5000.0f, 6000.0f), std::make_pair(size_t(1000), size_t(1000)));
+}
+
+TEST(DecimationPyramid, decimate)
+{
+  std::vector<float> x_data, y_data;
+  auto series = makeTestSeries(100000, x_data, y_data);
+  std::vector<float> x_out, y_out;
+
+  // all the points
+  series.decimate(10, 20, 0, x_out, y_out);
+  EXPECT_EQ(x_out, std::vector<float>(x_data.begin() + 10, x_data.begin() + 20));
+  EXPECT_EQ(y_out, std::vector<float>(y_data.begin() + 10, y_data.begin() + 20));
+  series.decimate(10, 20, 100, x_out, y_out);
+  EXPECT_EQ(x_out.size(), 10);
+
+  // the decimated points are sorted, within the range, and keep the extrema
+  const auto [first, last] = series.getIndexRange(12.5f, 90000.0f);
+  series.decimate(first, last, 2000, x_out, y_out);
+  ASSERT_EQ(x_out.size(), y_out.size());
+  EXPECT_LE(x_out.size(), 2000);
+  EXPECT_GE(x_out.size(), 500);
+  EXPECT_TRUE(std::is_sorted(x_out.begin(), x_out.end()));
+  EXPECT_GE(x_out.front(), 13.0f);
+  EXPECT_LE(x_out.back(), 90000.0f);
+  EXPECT_FLOAT_EQ(*std::max_element(y_out.begin(), y_out.end()), 1000.0f);
+  EXPECT_FLOAT_EQ(*std::min_element(y_out.begin(), y_out.end()), -1000.0f);
+  for (size_t i = 0; i < x_out.size(); ++i)
+  {
+    EXPECT_FLOAT_EQ(y_out[i], y_data[static_cast<size_t>(x_out[i])]);
+  }
+
+  // coarse decimation
+  series.decimate(0, 100, 10, x_out, y_out);
+  EXPECT_LE(x_out.size(), 10);
+  EXPECT_LT(*std::max_element(y_out.begin(), y_out.end()), 1000.0f);
+}
+
+TEST(DecimationPyramid, getExtent)
+{
+  std::vector<float> x_data, y_data;
+  auto series = makeTestSeries(100000, x_data, y_data);
+  auto extent = series.getExtent(100, 90000);
+  ASSERT_TRUE(extent);
+  EXPECT_FLOAT_EQ(extent->x_min, 100.0f);
+  EXPECT_FLOAT_EQ(extent->x_max, 89999.0f);
+  EXPECT_FLOAT_EQ(extent->y_min, -1000.0f);
+  EXPECT_FLOAT_EQ(extent->y_max, 1000.0f);
+
+  extent = series.getExtent(0, 10);
+  ASSERT_TRUE(extent);
+  EXPECT_FLOAT_EQ(extent->y_min, 0.0f);
+  EXPECT_FLOAT_EQ(extent->y_max, *std::max_element(y_data.begin(), y_data.begin() + 10));
+}
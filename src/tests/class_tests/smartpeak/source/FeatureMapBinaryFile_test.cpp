@@ -0,0 +1,143 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2021.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/io/FeatureMapBinaryFile.h>
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <cstdio>
+#include <fstream>
+
+using namespace SmartPeak;
+using namespace std;
+
+void compareFeatures(const OpenMS::Feature& f1, const OpenMS::Feature& f2)
+{
+  EXPECT_EQ(f1.getUniqueId(), f2.getUniqueId());
+  EXPECT_DOUBLE_EQ(f1.getRT(), f2.getRT());
+  EXPECT_DOUBLE_EQ(f1.getMZ(), f2.getMZ());
+  EXPECT_FLOAT_EQ(f1.getIntensity(), f2.getIntensity());
+  EXPECT_FLOAT_EQ(f1.getOverallQuality(), f2.getOverallQuality());
+  EXPECT_EQ(f1.getCharge(), f2.getCharge());
+  EXPECT_EQ(f1.getConvexHulls().size(), f2.getConvexHulls().size());
+  std::vector<OpenMS::String> keys1, keys2;
+  f1.getKeys(keys1);
+  f2.getKeys(keys2);
+  EXPECT_EQ(keys1, keys2);
+  for (const auto& key : keys1)
+  {
+    EXPECT_EQ(f1.getMetaValue(key), f2.getMetaValue(key)) << key;
+  }
+  ASSERT_EQ(f1.getSubordinates().size(), f2.getSubordinates().size());
+  for (size_t i = 0; i < f1.getSubordinates().size(); ++i)
+  {
+    compareFeatures(f1.getSubordinates()[i], f2.getSubordinates()[i]);
+  }
+}
+
+TEST(FeatureMapBinaryFile, store_load)
+{
+  OpenMS::FeatureMap feature_map;
+  OpenMS::FeatureXMLFile().load(SMARTPEAK_GET_TEST_DATA_PATH("RawDataProcessor_serumTest.featureXML"), feature_map);
+  feature_map.setPrimaryMSRunPath({ "serum.mzML" });
+  OpenMS::ConvexHull2D hull;
+  hull.setHullPoints({ { 1.0, 100.0 }, { 2.0, 101.0 } });
+  feature_map[0].getConvexHulls().push_back(hull);
+
+  const string pathname = SMARTPEAK_GET_TEST_DATA_PATH("FeatureMapBinaryFile_store_load.featureBin");
+  ASSERT_TRUE(FeatureMapBinaryFile::store(pathname, feature_map));
+
+  auto mapped_file = FeatureMapBinaryFile::map(pathname);
+  EXPECT_EQ(mapped_file->size(), feature_map.size());
+
+  OpenMS::FeatureMap loaded_feature_map;
+  mapped_file->materialize(loaded_feature_map);
+  EXPECT_EQ(loaded_feature_map.getUniqueId(), feature_map.getUniqueId());
+  OpenMS::StringList primary_ms_run_path;
+  loaded_feature_map.getPrimaryMSRunPath(primary_ms_run_path);
+  ASSERT_EQ(primary_ms_run_path.size(), 1);
+  EXPECT_STREQ(primary_ms_run_path[0].c_str(), "serum.mzML");
+  ASSERT_EQ(loaded_feature_map.size(), feature_map.size());
+  for (size_t i = 0; i < feature_map.size(); ++i)
+  {
+    compareFeatures(feature_map[i], loaded_feature_map[i]);
+  }
+  ASSERT_EQ(loaded_feature_map[0].getConvexHulls().size(), 1);
+  EXPECT_EQ(loaded_feature_map[0].getConvexHulls()[0].getHullPoints(), hull.getHullPoints());
+
+  mapped_file.reset();
+  std::remove(pathname.c_str());
+}
+
+TEST(FeatureMapBinaryFile, store_source_file)
+{
+  const string featurexml_pathname = SMARTPEAK_GET_TEST_DATA_PATH("RawDataProcessor_serumTest.featureXML");
+  OpenMS::FeatureMap feature_map;
+  OpenMS::FeatureXMLFile().load(featurexml_pathname, feature_map);
+  const auto source_file = FeatureMapBinaryFile::SourceFile::fromPath(featurexml_pathname);
+  EXPECT_GT(source_file.size, 0);
+  EXPECT_EQ(FeatureMapBinaryFile::SourceFile::fromPath("missing.featureXML"), FeatureMapBinaryFile::SourceFile());
+
+  const string pathname = SMARTPEAK_GET_TEST_DATA_PATH("FeatureMapBinaryFile_store_source_file.featureBin");
+  ASSERT_TRUE(FeatureMapBinaryFile::store(pathname, feature_map, source_file));
+  auto mapped_file = FeatureMapBinaryFile::map(pathname);
+  EXPECT_EQ(mapped_file->getSourceFile(), source_file);
+
+  // storing again replaces the file, the mapped one remains readable
+  OpenMS::FeatureMap other_feature_map;
+  ASSERT_TRUE(FeatureMapBinaryFile::store(pathname, other_feature_map));
+  EXPECT_FALSE(std::ifstream(pathname + ".tmp").good());
+  EXPECT_EQ(mapped_file->size(), feature_map.size());
+  OpenMS::FeatureMap loaded_feature_map;
+  mapped_file->materialize(loaded_feature_map);
+  EXPECT_EQ(loaded_feature_map.size(), feature_map.size());
+  auto other_mapped_file = FeatureMapBinaryFile::map(pathname);
+  EXPECT_EQ(other_mapped_file->size(), 0);
+  EXPECT_EQ(other_mapped_file->getSourceFile(), FeatureMapBinaryFile::SourceFile());
+
+  mapped_file.reset();
+  other_mapped_file.reset();
+  std::remove(pathname.c_str());
+}
+
+TEST(FeatureMapBinaryFile, store_identifications)
+{
+  // identifications are not supported
+  OpenMS::FeatureMap feature_map;
+  OpenMS::FeatureXMLFile().load(SMARTPEAK_GET_TEST_DATA_PATH("OpenMSFile_test_1_io_FileReaderOpenMS.featureXML"), feature_map);
+  const string pathname = SMARTPEAK_GET_TEST_DATA_PATH("FeatureMapBinaryFile_store_identifications.featureBin");
+  EXPECT_FALSE(FeatureMapBinaryFile::store(pathname, feature_map));
+  EXPECT_FALSE(std::ifstream(pathname).good());
+}
+
+TEST(FeatureMapBinaryFile, map_invalid)
+{
+  const string pathname = SMARTPEAK_GET_TEST_DATA_PATH("FeatureMapBinaryFile_map_invalid.featureBin");
+  {
+    std::ofstream stream(pathname, std::ios::binary);
+    stream << "not a feature map file, but long enough to contain a header .......................................";
+  }
+  EXPECT_THROW(FeatureMapBinaryFile::map(pathname), std::runtime_error);
+  std::remove(pathname.c_str());
+  EXPECT_THROW(FeatureMapBinaryFile::map(pathname), std::runtime_error);
+}
@@ -0,0 +1,138 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/FeatureTable.h>
+
+#include <cmath>
+
+using namespace SmartPeak;
+
+namespace
+{
+  OpenMS::FeatureMap makeFeatureMap()
+  {
+    OpenMS::FeatureMap feature_map;
+
+    OpenMS::Feature feature;
+    feature.setRT(1.5);
+    feature.setMetaValue("PeptideRef", "group1");
+    feature.setMetaValue("calculated_concentration", 5.0);
+    OpenMS::Feature subordinate1;
+    subordinate1.setIntensity(10.0);
+    subordinate1.setMetaValue("native_id", "component1");
+    subordinate1.setMetaValue("calculated_concentration", 2.0);
+    subordinate1.setMetaValue("validation", "TP");
+    OpenMS::Feature subordinate2;
+    subordinate2.setIntensity(20.0);
+    subordinate2.setMetaValue("native_id", "component2");
+    subordinate2.setMetaValue("used_", "false");
+    feature.setSubordinates({ subordinate1, subordinate2 });
+    feature_map.push_back(feature);
+
+    OpenMS::Feature feature_no_subordinates;
+    feature_no_subordinates.setRT(3.0);
+    feature_no_subordinates.setMetaValue("PeptideRef", "group2");
+    feature_no_subordinates.setMetaValue("calculated_concentration", 7.0);
+    feature_no_subordinates.setMetaValue("QC_transition_message", "message");
+    feature_map.push_back(feature_no_subordinates);
+
+    OpenMS::Feature feature_not_used;
+    feature_not_used.setMetaValue("PeptideRef", "group3");
+    feature_not_used.setMetaValue("used_", "false");
+    feature_map.push_back(feature_not_used);
+
+    return feature_map;
+  }
+}
+
+TEST(FeatureTable, intern)
+{
+  const FeatureTable::Id id1 = FeatureTable::intern("feature_table_1");
+  const FeatureTable::Id id2 = FeatureTable::intern("feature_table_2");
+  EXPECT_NE(id1, id2);
+  EXPECT_EQ(FeatureTable::intern("feature_table_1"), id1);
+  EXPECT_EQ(FeatureTable::getString(id1), "feature_table_1");
+  EXPECT_EQ(FeatureTable::getString(id2), "feature_table_2");
+}
+
+TEST(FeatureTable, constructor)
+{
+  const FeatureTable feature_table(makeFeatureMap(), { "RT", "peak_area", "calculated_concentration", "validation", "QC_transition_message" });
+
+  // the unused subordinate and feature are skipped
+  ASSERT_EQ(feature_table.size(), 2);
+  EXPECT_EQ(FeatureTable::getString(feature_table.getComponentGroupIds()[0]), "group1");
+  EXPECT_EQ(FeatureTable::getString(feature_table.getComponentIds()[0]), "component1");
+  EXPECT_TRUE(feature_table.getIsSubordinate()[0]);
+  EXPECT_EQ(FeatureTable::getString(feature_table.getComponentGroupIds()[1]), "group2");
+  EXPECT_EQ(FeatureTable::getString(feature_table.getComponentIds()[1]), "");
+  EXPECT_FALSE(feature_table.getIsSubordinate()[1]);
+
+  const std::vector<float>* rt = feature_table.getColumn("RT");
+  ASSERT_TRUE(rt);
+  EXPECT_FLOAT_EQ(rt->at(0), 1.5); // from the feature
+  EXPECT_FLOAT_EQ(rt->at(1), 3.0);
+  const std::vector<float>* peak_area = feature_table.getColumn("peak_area");
+  ASSERT_TRUE(peak_area);
+  EXPECT_FLOAT_EQ(peak_area->at(0), 10.0); // from the subordinate
+  const std::vector<float>* concentration = feature_table.getColumn("calculated_concentration");
+  ASSERT_TRUE(concentration);
+  EXPECT_FLOAT_EQ(concentration->at(0), 2.0); // the subordinate has priority over the feature
+  EXPECT_FLOAT_EQ(concentration->at(1), 7.0);
+  const std::vector<float>* validation = feature_table.getColumn("validation");
+  ASSERT_TRUE(validation);
+  EXPECT_FLOAT_EQ(validation->at(0), 1.0);
+  EXPECT_TRUE(std::isnan(validation->at(1)));
+  const std::vector<float>* message = feature_table.getColumn("QC_transition_message");
+  ASSERT_TRUE(message);
+  EXPECT_TRUE(std::isnan(message->at(1))); // not a float
+
+  EXPECT_TRUE(feature_table.hasColumn("RT"));
+  EXPECT_FALSE(feature_table.hasColumn("mz"));
+  EXPECT_FALSE(feature_table.getColumn("mz"));
+}
+
+TEST(FeatureTable, FeatureTableCache)
+{
+  const OpenMS::FeatureMap feature_map = makeFeatureMap();
+  FeatureTableCache cache;
+  auto table = cache.get(feature_map, { "RT" });
+  ASSERT_TRUE(table);
+  EXPECT_EQ(cache.get(feature_map, { "RT" }), table);
+
+  // a new meta value rebuilds the table with all the meta values
+  auto extended_table = cache.get(feature_map, { "mz" });
+  EXPECT_NE(extended_table, table);
+  EXPECT_TRUE(extended_table->hasColumn("RT"));
+  EXPECT_TRUE(extended_table->hasColumn("mz"));
+
+  // copies share the table
+  FeatureTableCache cache_copy(cache);
+  EXPECT_EQ(cache_copy.get(feature_map, { "RT", "mz" }), extended_table);
+
+  cache.reset();
+  EXPECT_NE(cache.get(feature_map, { "RT" }), extended_table);
+  EXPECT_EQ(cache_copy.get(feature_map, { "RT" }), extended_table);
+}
@@ -24,6 +24,7 @@
 #include <gtest/gtest.h>
 #include <SmartPeak/core/InjectionHandler.h>
 #include <SmartPeak/core/MetaDataHandler.h>
+#include <memory>
 
 using namespace SmartPeak;
 using namespace std;
@@ -118,3 +119,64 @@ TEST(InjectionHandler, clear)
   EXPECT_STREQ(injectionHandler.getMetaData().getSampleName().c_str(), "");
   EXPECT_STREQ(injectionHandler.getRawData().getFeatureMap().getIdentifier().c_str(), "");
 }
+
+TEST(InjectionHandler, snapshot)
+{
+  InjectionHandler injectionHandler;
+  OpenMS::FeatureMap f1;
+  f1.setIdentifier("1");
+  RawDataHandler rdh1;
+  rdh1.setFeatureMap(f1);
+  injectionHandler.setRawData(rdh1);
+
+  // the snapshot shares the raw data until it is modified
+  InjectionHandler snapshot = injectionHandler.snapshot();
+  const InjectionHandler& const_snapshot = snapshot;
+  EXPECT_EQ(&const_snapshot.getRawData(), &static_cast<const InjectionHandler&>(injectionHandler).getRawData());
+
+  OpenMS::FeatureMap f2;
+  f2.setIdentifier("2");
+  snapshot.getRawData().setFeatureMap(f2);
+  EXPECT_NE(&const_snapshot.getRawData(), &static_cast<const InjectionHandler&>(injectionHandler).getRawData());
+  EXPECT_STREQ(snapshot.getRawData().getFeatureMap().getIdentifier().c_str(), "2");
+  EXPECT_STREQ(injectionHandler.getRawData().getFeatureMap().getIdentifier().c_str(), "1");
+
+  // the meta data remain shared
+  snapshot.getMetaData().setSampleName("1");
+  EXPECT_STREQ(injectionHandler.getMetaData().getSampleName().c_str(), "1");
+
+  // no copy once the source is gone
+  auto source = std::make_unique<InjectionHandler>(injectionHandler);
+  InjectionHandler snapshot2 = source->snapshot();
+  const RawDataHandler* raw_data = &static_cast<const InjectionHandler&>(snapshot2).getRawData();
+  source.reset();
+  injectionHandler = InjectionHandler();
+  EXPECT_EQ(&snapshot2.getRawData(), raw_data);
+}
+
+TEST(InjectionHandler, snapshot_payloads)
+{
+  InjectionHandler injectionHandler;
+  OpenMS::MSExperiment experiment;
+  experiment.addChromatogram(OpenMS::MSChromatogram());
+  injectionHandler.getRawData().setExperiment(experiment);
+  OpenMS::FeatureMap feature_map;
+  feature_map.setIdentifier("1");
+  injectionHandler.getRawData().setFeatureMap(feature_map);
+  const InjectionHandler& const_injection = injectionHandler;
+
+  // detaching the raw data handler of the snapshot does not copy its MS data or feature maps
+  InjectionHandler snapshot = injectionHandler.snapshot();
+  const RawDataHandler& raw_data = snapshot.getRawData();
+  EXPECT_NE(&raw_data, &const_injection.getRawData());
+  EXPECT_EQ(&raw_data.getExperiment(), &const_injection.getRawData().getExperiment());
+  EXPECT_EQ(&raw_data.getFeatureMap(), &const_injection.getRawData().getFeatureMap());
+
+  // a payload is copied once modified, the other ones remain shared
+  snapshot.getRawData().getFeatureMap().setIdentifier("2");
+  EXPECT_NE(&raw_data.getFeatureMap(), &const_injection.getRawData().getFeatureMap());
+  EXPECT_STREQ(const_injection.getRawData().getFeatureMap().getIdentifier().c_str(), "1");
+  EXPECT_STREQ(raw_data.getFeatureMap().getIdentifier().c_str(), "2");
+  EXPECT_EQ(&raw_data.getExperiment(), &const_injection.getRawData().getExperiment());
+  EXPECT_EQ(raw_data.getExperiment().getNrChromatograms(), 1);
+}
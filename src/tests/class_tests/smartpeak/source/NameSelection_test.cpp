@@ -0,0 +1,121 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/NameSelection.h>
+
+using namespace SmartPeak;
+
+namespace
+{
+  Eigen::Tensor<std::string, 2> makeTransitionsTable()
+  {
+    Eigen::Tensor<std::string, 2> table(5, 2);
+    table.setValues({
+      { "arg-L", "arg-L.arg-L_1.Light" },
+      { "arg-L", "arg-L.arg-L_1.Heavy" },
+      { "ser-L", "ser-L.ser-L_1.Light" },
+      { "", "" },
+      { "ala-L", "ala-L.ala-L_1.Light" } });
+    return table;
+  }
+}
+
+TEST(NameSelection, setNames)
+{
+  NameSelection selection;
+  selection.setNames(makeTransitionsTable(), 0);
+  EXPECT_EQ(selection.getNbRows(), 5);
+  EXPECT_EQ(selection.getNbNames(), 3);
+  EXPECT_EQ(selection.getName(0), "arg-L");
+  EXPECT_EQ(selection.getName(2), "ala-L");
+  EXPECT_EQ(selection.getId("ser-L"), std::optional<size_t>(1));
+  EXPECT_FALSE(selection.getId("").has_value());
+  EXPECT_FALSE(selection.getId("gly").has_value());
+  EXPECT_EQ(selection.getNbSelected(), 0);
+  EXPECT_FALSE(selection.isSelected("arg-L"));
+
+  // missing column
+  selection.setNames(makeTransitionsTable(), 2);
+  EXPECT_EQ(selection.getNbRows(), 0);
+  EXPECT_EQ(selection.getNbNames(), 0);
+}
+
+TEST(NameSelection, setChecked)
+{
+  NameSelection selection;
+  selection.setNames(makeTransitionsTable(), 0);
+  const size_t version = selection.getVersion();
+
+  Eigen::Tensor<bool, 2> checkbox_body(5, 2);
+  checkbox_body.setConstant(false);
+  checkbox_body(1, 1) = true;
+  checkbox_body(3, 1) = true;
+  checkbox_body(4, 1) = true;
+  EXPECT_TRUE(selection.setChecked(checkbox_body, 1));
+  EXPECT_EQ(selection.getVersion(), version + 1);
+  EXPECT_TRUE(selection.isSelected("arg-L"));
+  EXPECT_FALSE(selection.isSelected("ser-L"));
+  EXPECT_TRUE(selection.isSelected("ala-L"));
+  EXPECT_EQ(selection.getNbSelected(), 2);
+  EXPECT_EQ(selection.getSelectedNames(), std::vector<std::string>({ "arg-L", "ala-L" }));
+
+  // the same selection does not change
+  EXPECT_FALSE(selection.setChecked(checkbox_body, 1));
+  EXPECT_EQ(selection.getVersion(), version + 1);
+
+  // a name stays selected while one of its rows is checked
+  checkbox_body(0, 1) = true;
+  checkbox_body(1, 1) = false;
+  checkbox_body(2, 1) = true;
+  checkbox_body(4, 1) = false;
+  EXPECT_TRUE(selection.setChecked(checkbox_body, 1));
+  EXPECT_EQ(selection.getVersion(), version + 2);
+  EXPECT_EQ(selection.getSelectedNames(), std::vector<std::string>({ "arg-L", "ser-L" }));
+
+  // other column
+  EXPECT_TRUE(selection.setChecked(checkbox_body, 0));
+  EXPECT_EQ(selection.getNbSelected(), 0);
+
+  // missing column
+  EXPECT_FALSE(selection.setChecked(checkbox_body, 2));
+}
+
+TEST(NameSelection, manyNames)
+{
+  Eigen::Tensor<std::string, 2> table(200, 1);
+  Eigen::Tensor<bool, 2> checkbox_body(200, 1);
+  for (int row = 0; row < 200; ++row)
+  {
+    table(row, 0) = "name_" + std::to_string(row);
+    checkbox_body(row, 0) = (row % 3 == 0);
+  }
+  NameSelection selection;
+  selection.setNames(table, 0);
+  EXPECT_TRUE(selection.setChecked(checkbox_body, 0));
+  EXPECT_EQ(selection.getNbSelected(), 67);
+  EXPECT_EQ(selection.getSelectedNames().back(), "name_198");
+  EXPECT_TRUE(selection.isSelected("name_129"));
+  EXPECT_FALSE(selection.isSelected("name_130"));
+}
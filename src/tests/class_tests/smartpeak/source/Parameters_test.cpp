@@ -191,6 +191,69 @@ TEST(ParameterSet, ParameterSet_merge)
   EXPECT_STREQ(param5->getValueAsString().c_str(), "42");
 }
 
+
+TEST(ParameterSet, ParameterSet_getView)
+{
+  map<std::string, vector<map<string, string>>> user_struct({
+  {"func1", {
+    { {"name", "param1"}, {"type", "int"}, {"value", "23"} },
+    { {"name", "param2"}, {"type", "string"}, {"value", "true"} },
+    { {"name", "param5"}, {"type", "string"}, {"value", "0.25"} },
+    { {"name", "param6"}, {"type", "string"}, {"value", "not a number"} }
+  }}
+  });
+  map<std::string, vector<map<string, string>>> schema_struct({
+  {"func1", {
+    { {"name", "param1"}, {"type", "int"}, {"value", "1"} },
+    { {"name", "param3"}, {"type", "float"}, {"value", "3.5"} }
+  }},
+  {"func2", {
+    { {"name", "param4"}, {"type", "string"}, {"value", "schema"} }
+  }}
+  });
+
+  ParameterSet user_parameters(user_struct);
+  int nb_schema_built = 0;
+  auto make_schema = [&]() { ++nb_schema_built; return ParameterSet(schema_struct); };
+
+  auto view = user_parameters.getView("processor", make_schema);
+  ASSERT_TRUE(view);
+  EXPECT_EQ(nb_schema_built, 1);
+  EXPECT_EQ(view->getParameterSet().size(), 2);
+  EXPECT_TRUE(view->findParameter("func1", "param3"));
+  EXPECT_FALSE(view->findParameter("func1", "param4"));
+  EXPECT_FALSE(view->findValue("func3", "param1"));
+  EXPECT_EQ(view->getValue("func1", "param1", 0), 23); // user value is kept
+  EXPECT_TRUE(view->getValue("func1", "param2", false)); // string converted to bool
+  EXPECT_FLOAT_EQ(view->getValue("func1", "param3", 0.0f), 3.5f); // completed from the schema
+  EXPECT_FLOAT_EQ(view->getValue("func1", "param5", 0.0f), 0.25f); // string parsed as float
+  EXPECT_EQ(view->getValue("func1", "param5", 0), 0); // string parsed as int
+  EXPECT_FLOAT_EQ(view->getValue("func1", "param6", 1.5f), 1.5f); // cannot be parsed
+  EXPECT_EQ(view->getValue("func2", "param4", std::string("default")), "schema");
+  EXPECT_EQ(view->getValue("func2", "missing", std::string("default")), "default");
+  EXPECT_EQ(view->getValues("func1").size(), 5);
+  EXPECT_TRUE(view->getValues("func3").empty());
+
+  // cached as long as the parameters are not modified
+  const ParameterSet& const_user_parameters = user_parameters;
+  EXPECT_EQ(const_user_parameters.getView("processor", make_schema), view);
+  EXPECT_EQ(nb_schema_built, 1);
+  user_parameters.getView("other_processor", make_schema);
+  EXPECT_EQ(nb_schema_built, 2);
+
+  // copies do not share the cache
+  ParameterSet copied_parameters(user_parameters);
+  EXPECT_NE(copied_parameters.getView("processor", make_schema), view);
+  EXPECT_EQ(nb_schema_built, 3);
+
+  // modifications drop the cache
+  user_parameters.findParameter("func1", "param1")->setValueFromString("42");
+  auto updated_view = user_parameters.getView("processor", make_schema);
+  EXPECT_NE(updated_view, view);
+  EXPECT_EQ(nb_schema_built, 4);
+  EXPECT_EQ(updated_view->getValue("func1", "param1", 0), 42);
+  EXPECT_EQ(view->getValue("func1", "param1", 0), 23); // previous view left untouched
+}
 TEST(ParameterSet, ParameterSet_setAsSchema)
 {
   map<std::string, vector<map<string, string>>> param_struct1({
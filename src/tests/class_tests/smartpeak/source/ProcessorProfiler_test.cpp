@@ -0,0 +1,179 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/ProcessorProfiler.h>
+#include <SmartPeak/core/SequenceProcessor.h>
+#include <thread>
+
+using namespace SmartPeak;
+
+namespace
+{
+  ProcessorProfileRecord makeTestRecord(const std::string& processor_name, double wall_time_ms, size_t item_count)
+  {
+    ProcessorProfileRecord record;
+    record.processor_name = processor_name;
+    record.item_name = "injection";
+    record.wall_time_ms = wall_time_ms;
+    record.cpu_time_ms = wall_time_ms / 2;
+    record.rss_delta_kb = static_cast<long>(item_count);
+    record.peak_rss_kb = 1000;
+    record.item_count = item_count;
+    return record;
+  }
+
+  struct CountChromatograms : RawDataProcessor
+  {
+    std::string getName() const override { return "COUNT_CHROMATOGRAMS"; }
+    std::string getDescription() const override { return ""; }
+    void doProcess(RawDataHandler& rawDataHandler_IO, const ParameterSet& params_I, Filenames& filenames_I) const override
+    {
+      rawDataHandler_IO.getExperiment().addChromatogram(OpenMS::MSChromatogram());
+    }
+  };
+}
+
+TEST(ProcessorProfiler, percentile)
+{
+  std::vector<double> values;
+  EXPECT_DOUBLE_EQ(ProcessorProfiler::percentile(values, 50.0), 0.0);
+  for (int i = 1; i <= 100; ++i)
+  {
+    values.push_back(i);
+  }
+  EXPECT_DOUBLE_EQ(ProcessorProfiler::percentile(values, 0.0), 1.0);
+  EXPECT_DOUBLE_EQ(ProcessorProfiler::percentile(values, 50.0), 50.0);
+  EXPECT_DOUBLE_EQ(ProcessorProfiler::percentile(values, 90.0), 90.0);
+  EXPECT_DOUBLE_EQ(ProcessorProfiler::percentile(values, 99.0), 99.0);
+  EXPECT_DOUBLE_EQ(ProcessorProfiler::percentile(values, 100.0), 100.0);
+  EXPECT_DOUBLE_EQ(ProcessorProfiler::percentile({ 3.0 }, 99.0), 3.0);
+}
+
+TEST(ProcessorProfiler, getSummaries)
+{
+  ProcessorProfiler profiler;
+  for (int i = 1; i <= 10; ++i)
+  {
+    profiler.onProcessorProfile(makeTestRecord("PICK_MRM_FEATURES", i * 10.0, 2));
+  }
+  profiler.onProcessorProfile(makeTestRecord("LOAD_RAW_DATA", 1000.0, 5));
+  EXPECT_EQ(profiler.size(), 11);
+
+  const auto summaries = profiler.getSummaries();
+  ASSERT_EQ(summaries.size(), 2);
+  // sorted by total wall time
+  EXPECT_EQ(summaries[0].processor_name, "LOAD_RAW_DATA");
+  EXPECT_EQ(summaries[0].count, 1);
+  EXPECT_DOUBLE_EQ(summaries[0].wall_time_ms.p99, 1000.0);
+  EXPECT_EQ(summaries[0].total_item_count, 5);
+  EXPECT_EQ(summaries[1].processor_name, "PICK_MRM_FEATURES");
+  EXPECT_EQ(summaries[1].count, 10);
+  EXPECT_DOUBLE_EQ(summaries[1].wall_time_ms.total, 550.0);
+  EXPECT_DOUBLE_EQ(summaries[1].wall_time_ms.mean, 55.0);
+  EXPECT_DOUBLE_EQ(summaries[1].wall_time_ms.p50, 50.0);
+  EXPECT_DOUBLE_EQ(summaries[1].wall_time_ms.p90, 90.0);
+  EXPECT_DOUBLE_EQ(summaries[1].wall_time_ms.max, 100.0);
+  EXPECT_DOUBLE_EQ(summaries[1].cpu_time_ms.total, 275.0);
+  EXPECT_EQ(summaries[1].max_rss_delta_kb, 2);
+  EXPECT_EQ(summaries[1].peak_rss_kb, 1000);
+  EXPECT_EQ(summaries[1].total_item_count, 20);
+
+  profiler.clear();
+  EXPECT_EQ(profiler.size(), 0);
+  EXPECT_TRUE(profiler.getSummaries().empty());
+}
+
+TEST(ProcessorProfiler, toJSON)
+{
+  ProcessorProfiler profiler;
+  auto record = makeTestRecord("PICK_\"MRM\"_FEATURES", 10.0, 1);
+  record.item_type = ProcessorProfileRecord::ItemType::SequenceSegment;
+  profiler.onProcessorProfile(record);
+  const auto json = profiler.toJSON();
+  EXPECT_NE(json.find("\"summaries\""), std::string::npos);
+  EXPECT_NE(json.find("\"records\""), std::string::npos);
+  EXPECT_NE(json.find("\"processor\": \"PICK_\\\"MRM\\\"_FEATURES\""), std::string::npos);
+  EXPECT_NE(json.find("\"item_type\": \"SequenceSegment\""), std::string::npos);
+  EXPECT_NE(json.find("\"p99\""), std::string::npos);
+}
+
+TEST(ProcessorProfiler, makeRecord)
+{
+  const auto start = ProcessorProfiler::takeSnapshot();
+  const auto record = ProcessorProfiler::makeRecord(start, "PROCESSOR", "sample", ProcessorProfileRecord::ItemType::SampleGroup, 3);
+  EXPECT_EQ(record.processor_name, "PROCESSOR");
+  EXPECT_EQ(record.item_name, "sample");
+  EXPECT_EQ(record.item_type, ProcessorProfileRecord::ItemType::SampleGroup);
+  EXPECT_EQ(record.item_count, 3);
+  EXPECT_GE(record.wall_time_ms, 0.0);
+  EXPECT_GE(record.cpu_time_ms, 0.0);
+  EXPECT_GE(record.peak_rss_kb, 0);
+}
+
+TEST(ProcessorProfiler, processInjection)
+{
+  ProcessorProfiler profiler;
+  ProcessorProfileObservable observable;
+  observable.addProcessorProfileObserver(&profiler);
+
+  InjectionHandler injection;
+  MetaDataHandler meta_data;
+  meta_data.setSampleName("sample");
+  injection.setMetaData(meta_data);
+  Filenames filenames;
+  const std::vector<std::shared_ptr<RawDataProcessor>> methods = {
+    std::make_shared<CountChromatograms>(),
+    std::make_shared<CountChromatograms>()
+  };
+  processInjection(injection, filenames, methods, &observable);
+
+  const auto records = profiler.getRecords();
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].processor_name, "COUNT_CHROMATOGRAMS");
+  EXPECT_EQ(records[0].item_name, injection.getMetaData().getInjectionName());
+  EXPECT_EQ(records[0].item_type, ProcessorProfileRecord::ItemType::Injection);
+  EXPECT_EQ(records[0].item_count, 1);
+  EXPECT_EQ(records[1].item_count, 2);
+
+  // no record without observable
+  processInjection(injection, filenames, methods);
+  EXPECT_EQ(profiler.size(), 2);
+}
+
+TEST(ProcessorProfiler, getProcessCPUTimeMs)
+{
+  // CPU time spent on another thread is counted for the process
+  const double start = ProcessorProfiler::getProcessCPUTimeMs();
+  std::thread worker([] {
+    const double worker_start = ProcessorProfiler::getThreadCPUTimeMs();
+    volatile double sum = 0;
+    while (ProcessorProfiler::getThreadCPUTimeMs() - worker_start < 20.0)
+    {
+      sum = sum + 1.0;
+    }
+  });
+  worker.join();
+  EXPECT_GE(ProcessorProfiler::getProcessCPUTimeMs() - start, 20.0);
+}
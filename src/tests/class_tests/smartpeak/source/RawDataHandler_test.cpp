@@ -24,6 +24,10 @@
 #include <gtest/gtest.h>
 #include <SmartPeak/core/RawDataHandler.h>
 
+#include <set>
+#include <string>
+#include <vector>
+
 using namespace SmartPeak;
 using namespace std;
 
@@ -80,6 +84,68 @@ TEST(RawDataHandler, set_get_FeatureMapHistory)
   EXPECT_STREQ(((std::string)f3.getMetaValue("name2")).c_str(), "bar");
 }
 
+TEST(RawDataHandler, getFeatureTable)
+{
+  RawDataHandler rawDataHandler;
+
+  OpenMS::FeatureMap f1;
+  OpenMS::Feature feature;
+  feature.setRT(1.0);
+  feature.setMetaValue("PeptideRef", "foo");
+  f1.push_back(feature);
+  rawDataHandler.setFeatureMapHistory(f1);
+
+  const RawDataHandler& rawDataHandler_const = rawDataHandler;
+  auto feature_table = rawDataHandler_const.getFeatureTable({ "RT" });
+  ASSERT_TRUE(feature_table);
+  ASSERT_EQ(feature_table->size(), 1);
+  EXPECT_FLOAT_EQ(feature_table->getColumn("RT")->at(0), 1.0);
+  EXPECT_EQ(rawDataHandler_const.getFeatureTable({ "RT" }), feature_table); // cached
+
+  rawDataHandler.getFeatureMapHistory().push_back(feature); // modifying the history resets the table
+  auto updated_feature_table = rawDataHandler_const.getFeatureTable({ "RT" });
+  EXPECT_NE(updated_feature_table, feature_table);
+  EXPECT_EQ(updated_feature_table->size(), 2);
+  EXPECT_EQ(feature_table->size(), 1);
+}
+
+TEST(RawDataHandler, setFeatureMapHistoryLoader)
+{
+  RawDataHandler rawDataHandler;
+  int nb_loads = 0;
+  rawDataHandler.setFeatureMapHistoryLoader([&nb_loads](OpenMS::FeatureMap& feature_map_history)
+  {
+    ++nb_loads;
+    OpenMS::Feature feature;
+    feature.setUniqueId(1);
+    feature.setMetaValue("used_", "true");
+    feature_map_history.push_back(feature);
+    feature.setUniqueId(2);
+    feature.setMetaValue("used_", "false");
+    feature_map_history.push_back(feature);
+    feature_map_history.setPrimaryMSRunPath({ "foo.mzML" });
+  });
+  EXPECT_TRUE(rawDataHandler.isFeatureMapHistoryLoadPending());
+  EXPECT_EQ(nb_loads, 0);
+
+  const RawDataHandler& rawDataHandler_const = rawDataHandler;
+  EXPECT_EQ(rawDataHandler_const.getFeatureMap().size(), 1); // made from the history
+  EXPECT_EQ(rawDataHandler_const.getFeatureMapHistory().size(), 2);
+  EXPECT_FALSE(rawDataHandler.isFeatureMapHistoryLoadPending());
+  EXPECT_EQ(nb_loads, 1);
+  OpenMS::StringList primary_ms_run_path;
+  rawDataHandler.getFeatureMap().getPrimaryMSRunPath(primary_ms_run_path);
+  ASSERT_EQ(primary_ms_run_path.size(), 1);
+  EXPECT_STREQ(primary_ms_run_path[0].c_str(), "foo.mzML");
+
+  // clear discards the pending loader
+  rawDataHandler.setFeatureMapHistoryLoader([&nb_loads](OpenMS::FeatureMap&) { ++nb_loads; });
+  rawDataHandler.clear();
+  EXPECT_FALSE(rawDataHandler.isFeatureMapHistoryLoadPending());
+  EXPECT_EQ(rawDataHandler.getFeatureMapHistory().size(), 0);
+  EXPECT_EQ(nb_loads, 1);
+}
+
 TEST(RawDataHandler, set_get_MetaData)
 {
   RawDataHandler rawDataHandler;
@@ -865,6 +931,186 @@ TEST(RawDataHandler, updateFeatureMapHistory)
   EXPECT_TRUE(rawDataHandler.getFeatureMapHistory()[1].getSubordinates()[1].getMetaValue("used_").toBool());
 }
 
+namespace
+{
+  // history update as done before the features were indexed, one pass over the current map per history feature
+  void referenceUpdateFeatureMapHistory(OpenMS::FeatureMap& feature_map_history, const OpenMS::FeatureMap& feature_map)
+  {
+    const std::string timestamp = "now";
+    if (feature_map_history.empty()) {
+      feature_map_history = feature_map;
+      for (OpenMS::Feature& feature_new : feature_map_history) {
+        if (!feature_new.metaValueExists("used_")) feature_new.setMetaValue("used_", "true");
+        if (!feature_new.metaValueExists("timestamp_")) feature_new.setMetaValue("timestamp_", timestamp);
+        for (OpenMS::Feature& subordinate_new : feature_new.getSubordinates()) {
+          if (!subordinate_new.metaValueExists("used_")) subordinate_new.setMetaValue("used_", "true");
+          if (!subordinate_new.metaValueExists("timestamp_")) subordinate_new.setMetaValue("timestamp_", timestamp);
+        }
+      }
+      return;
+    }
+    std::vector<OpenMS::Feature> new_features;
+    std::set<OpenMS::UInt64> unique_ids_feat_history, unique_ids_feat_select;
+    for (const OpenMS::Feature& feature_copy : feature_map_history) {
+      unique_ids_feat_history.insert(feature_copy.getUniqueId());
+    }
+    for (const OpenMS::Feature& feature_select : feature_map) {
+      unique_ids_feat_select.insert(feature_select.getUniqueId());
+      if (unique_ids_feat_history.count(feature_select.getUniqueId())) continue;
+      OpenMS::Feature new_feature = feature_select;
+      new_feature.setMetaValue("used_", "true");
+      new_feature.setMetaValue("timestamp_", timestamp);
+      for (OpenMS::Feature& subordinate_new : new_feature.getSubordinates()) {
+        subordinate_new.setMetaValue("used_", "true");
+        subordinate_new.setMetaValue("timestamp_", timestamp);
+      }
+      new_features.push_back(new_feature);
+    }
+    for (OpenMS::Feature& feature_copy : feature_map_history) {
+      if (unique_ids_feat_select.count(feature_copy.getUniqueId()) == 0) {
+        feature_copy.setMetaValue("used_", "false");
+        feature_copy.setMetaValue("timestamp_", timestamp);
+        for (OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
+          subordinate_copy.setMetaValue("used_", "false");
+          subordinate_copy.setMetaValue("timestamp_", timestamp);
+        }
+        continue;
+      }
+      for (const OpenMS::Feature& feature_select : feature_map) {
+        if (feature_select.getUniqueId() != feature_copy.getUniqueId() ||
+            feature_select.getMetaValue("PeptideRef") != feature_copy.getMetaValue("PeptideRef")) {
+          continue;
+        }
+        OpenMS::Feature feature_tmp = feature_select;
+        bool update_feature = false;
+        std::vector<OpenMS::Feature> new_subordinates;
+        std::set<std::string> unique_ids_sub_history, unique_ids_sub_select;
+        for (const OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
+          unique_ids_sub_history.insert(subordinate_copy.getMetaValue("native_id"));
+        }
+        for (const OpenMS::Feature& subordinate_select : feature_select.getSubordinates()) {
+          unique_ids_sub_select.insert(subordinate_select.getMetaValue("native_id"));
+          if (unique_ids_sub_history.count(subordinate_select.getMetaValue("native_id"))) continue;
+          OpenMS::Feature new_subordinate = subordinate_select;
+          new_subordinate.setMetaValue("used_", "true");
+          new_subordinate.setMetaValue("timestamp_", timestamp);
+          new_subordinates.push_back(new_subordinate);
+          update_feature = true;
+        }
+        for (OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
+          if (unique_ids_sub_select.count(subordinate_copy.getMetaValue("native_id")) == 0) {
+            subordinate_copy.setMetaValue("used_", "false");
+            subordinate_copy.setMetaValue("timestamp_", timestamp);
+            update_feature = true;
+            continue;
+          }
+          for (const OpenMS::Feature& subordinate_select : feature_select.getSubordinates()) {
+            if (subordinate_select.getUniqueId() == subordinate_copy.getUniqueId() &&
+                subordinate_select.getMetaValue("native_id") == subordinate_copy.getMetaValue("native_id")) {
+              subordinate_copy = subordinate_select;
+              if (!subordinate_copy.metaValueExists("used_")) subordinate_copy.setMetaValue("used_", "true");
+              subordinate_copy.setMetaValue("timestamp_", timestamp);
+              update_feature = true;
+              break;
+            }
+          }
+        }
+        if (feature_select.getSubordinates().size() <= 0) update_feature = true;
+        if (update_feature) {
+          feature_tmp.setSubordinates(feature_copy.getSubordinates());
+          feature_copy = feature_tmp;
+          feature_copy.setMetaValue("used_", "true");
+          feature_copy.setMetaValue("timestamp_", timestamp);
+        }
+        if (new_subordinates.size()) {
+          for (OpenMS::Feature& subordinate_copy : feature_copy.getSubordinates()) {
+            new_subordinates.insert(new_subordinates.begin(), subordinate_copy);
+          }
+          feature_copy.setSubordinates(new_subordinates);
+        }
+        break;
+      }
+    }
+    for (OpenMS::Feature& feature_new : new_features) {
+      feature_map_history.push_back(feature_new);
+    }
+  }
+
+  // compares the features and their subordinates, except for the time stamps
+  void expectSameHistory(const OpenMS::FeatureMap& history, const OpenMS::FeatureMap& reference)
+  {
+    const auto expect_same_feature = [](const OpenMS::Feature& feature, const OpenMS::Feature& expected) {
+      EXPECT_EQ(feature.getUniqueId(), expected.getUniqueId());
+      EXPECT_EQ(feature.getIntensity(), expected.getIntensity());
+      EXPECT_EQ(feature.getRT(), expected.getRT());
+      std::vector<OpenMS::String> keys, expected_keys;
+      feature.getKeys(keys);
+      expected.getKeys(expected_keys);
+      EXPECT_EQ(keys, expected_keys);
+      for (const auto& key : expected_keys) {
+        if (key == "timestamp_") continue;
+        EXPECT_EQ(feature.getMetaValue(key), expected.getMetaValue(key)) << key;
+      }
+    };
+    ASSERT_EQ(history.size(), reference.size());
+    for (size_t i = 0; i < reference.size(); ++i) {
+      expect_same_feature(history[i], reference[i]);
+      ASSERT_EQ(history[i].getSubordinates().size(), reference[i].getSubordinates().size());
+      for (size_t j = 0; j < reference[i].getSubordinates().size(); ++j) {
+        expect_same_feature(history[i].getSubordinates()[j], reference[i].getSubordinates()[j]);
+      }
+    }
+  }
+
+  OpenMS::FeatureMap makeFeatureMap(size_t n_features, size_t pass)
+  {
+    OpenMS::FeatureMap feature_map;
+    for (size_t i = 0; i < n_features; ++i) {
+      if (pass == 1 && i % 3 == 0) continue; // removed features
+      OpenMS::Feature feature;
+      feature.setUniqueId(i + 1);
+      feature.setMetaValue("PeptideRef", "component_group_" + std::to_string(i));
+      feature.setIntensity(static_cast<float>(100 * i + pass));
+      feature.setRT(static_cast<double>(i));
+      std::vector<OpenMS::Feature> subordinates;
+      for (size_t j = 0; j < 3 + pass; ++j) { // new subordinates at each pass
+        if (pass == 1 && i % 2 == 0 && j == 1) continue; // removed subordinates
+        OpenMS::Feature subordinate;
+        subordinate.setUniqueId(1000 * (i + 1) + j);
+        subordinate.setMetaValue("native_id", "component_" + std::to_string(i) + "_" + std::to_string(j));
+        subordinate.setIntensity(static_cast<float>(10 * j + pass));
+        subordinates.push_back(subordinate);
+      }
+      if (i % 5 == 4) subordinates.clear(); // features without subordinates
+      feature.setSubordinates(subordinates);
+      feature_map.push_back(feature);
+    }
+    if (pass == 2) {
+      // a feature sharing its unique id with another one, with another peptide ref
+      OpenMS::Feature feature;
+      feature.setUniqueId(2);
+      feature.setMetaValue("PeptideRef", "component_group_other");
+      feature_map.push_back(feature);
+    }
+    return feature_map;
+  }
+}
+
+TEST(RawDataHandler, updateFeatureMapHistory_reference)
+{
+  RawDataHandler rawDataHandler;
+  OpenMS::FeatureMap reference;
+  // initial map, filtered map (removed features and subordinates), map with restored and new features and subordinates
+  for (size_t pass = 0; pass < 3; ++pass)
+  {
+    const OpenMS::FeatureMap feature_map = makeFeatureMap(pass == 2 ? 24 : 20, pass);
+    rawDataHandler.setFeatureMap(feature_map);
+    rawDataHandler.updateFeatureMapHistory();
+    referenceUpdateFeatureMapHistory(reference, feature_map);
+    expectSameHistory(rawDataHandler.getFeatureMapHistory(), reference);
+  }
+}
+
 TEST(RawDataHandler, makeFeatureMapFromHistory)
 {
   RawDataHandler rawDataHandler;
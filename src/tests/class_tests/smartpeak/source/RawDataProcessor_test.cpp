@@ -75,6 +75,7 @@
 #include <SmartPeak/core/RawDataProcessors/PlotFeatures.h>
 #include <SmartPeak/core/RawDataProcessors/ExtractSpectraNonTargeted.h>
 #include <SmartPeak/core/SequenceSegmentProcessors/LoadQuantitationMethods.h>
+#include <SmartPeak/core/ThreadPool.h>
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 #include <OpenMS/FORMAT/MRMFeatureQCFile.h>  // load featureFilter and featureQC
@@ -678,6 +679,48 @@ TEST(RawDataProcessor, processorMergeSpectraZeroPeak)
   EXPECT_NEAR(spectra2[0].getMetaValue("highest observed m/z"), 109.99994568761217, 1e-6);
 }
 
+TEST(RawDataProcessor, processorMergeSpectra_threadPool)
+{
+  // Pre-requisites: load the parameters and associated raw data
+  ParameterSet params_1;
+  ParameterSet params_2;
+  load_data(params_1, params_2);
+  RawDataHandler rawDataHandler_serial;
+  RawDataHandler rawDataHandler_parallel;
+
+  Filenames filenames;
+  filenames.setFullPath("mzML_i", SMARTPEAK_GET_TEST_DATA_PATH("RawDataProcessor_SerumTest.mzML"));
+  LoadRawData loadRawData;
+  for (RawDataHandler* rawDataHandler : { &rawDataHandler_serial, &rawDataHandler_parallel }) {
+    loadRawData.process(*rawDataHandler, params_1, filenames);
+    loadRawData.extractMetaData(*rawDataHandler);
+  }
+
+  // Test merge spectra, the bins are merged in parallel on the workers of the pool
+  MergeSpectra mergeSpectra;
+  mergeSpectra.process(rawDataHandler_serial, params_1, filenames);
+  ThreadPool thread_pool(4);
+  thread_pool.submit([&]() { mergeSpectra.process(rawDataHandler_parallel, params_1, filenames); }).get();
+
+  const vector<OpenMS::MSSpectrum>& spectra = rawDataHandler_parallel.getExperiment().getSpectra();
+  ASSERT_EQ(spectra.size(), 1);
+  EXPECT_EQ(spectra.front().size(), 240);
+  EXPECT_EQ(spectra.front().getNativeID(), "MergeSpectra");
+  EXPECT_EQ(spectra.front().front().getMZ(), 109.95009243262952);
+  EXPECT_EQ(spectra.front().back().getMZ(), 109.99988410050186);
+  EXPECT_EQ(spectra.front().front().getIntensity(), 0);
+  EXPECT_EQ(spectra.front().back().getIntensity(), 3236006.75);
+
+  // identical to the serial merge
+  const vector<OpenMS::MSSpectrum>& spectra_serial = rawDataHandler_serial.getExperiment().getSpectra();
+  ASSERT_EQ(spectra_serial.size(), 1);
+  ASSERT_EQ(spectra.front().size(), spectra_serial.front().size());
+  for (size_t i = 0; i < spectra.front().size(); ++i) {
+    EXPECT_EQ(spectra.front()[i].getMZ(), spectra_serial.front()[i].getMZ());
+    EXPECT_EQ(spectra.front()[i].getIntensity(), spectra_serial.front()[i].getIntensity());
+  }
+}
+
 /**
   LoadFeatures Tests
 */
@@ -2729,6 +2772,7 @@ TEST(RawDataProcessor, emg_processor)
   filenames.setFullPath("featureXML_i", SMARTPEAK_GET_TEST_DATA_PATH("RawDataProcessor_mzML_1.featureXML"));
   LoadFeatures loadFeatures;
   loadFeatures.process(rawDataHandler2, params_1, filenames);
+  EXPECT_TRUE(rawDataHandler2.isFeatureMapHistoryLoadPending()); // loaded from the binary cache on first access
 
   const OpenMS::FeatureMap& m2 = rawDataHandler2.getFeatureMap();
   const OpenMS::Feature sub3 { m2[0].getSubordinates()[0] };
@@ -2742,6 +2786,69 @@ TEST(RawDataProcessor, emg_processor)
   EXPECT_NEAR(static_cast<double>(sub2.getMetaValue("noise_background_level")), static_cast<double>(sub3.getMetaValue("noise_background_level")), 1e-6);
 
   std::remove(SMARTPEAK_GET_TEST_DATA_PATH("RawDataProcessor_mzML_1.featureXML"));
+  std::remove(SMARTPEAK_GET_TEST_DATA_PATH("RawDataProcessor_mzML_1.featureBin"));
+}
+
+TEST(RawDataProcessor, emg_processor_threadPool)
+{
+  // Pre-requisites: load the parameters and associated raw data
+  ParameterSet params_1;
+  ParameterSet params_2;
+  load_data(params_1, params_2);
+  RawDataHandler rawDataHandler;
+  RawDataHandler rawDataHandler_parallel;
+
+  Filenames filenames;
+  filenames.setFullPath("traML", SMARTPEAK_GET_TEST_DATA_PATH("OpenMSFile_traML_1.csv"));
+  filenames.setFullPath("mzML_i", SMARTPEAK_GET_TEST_DATA_PATH("RawDataProcessor_mzML_1.mzML"));
+  LoadTransitions loadTransitions;
+  LoadRawData loadRawData;
+  MapChromatograms mapChroms;
+  PickMRMFeatures pickFeatures;
+  for (RawDataHandler* handler : { &rawDataHandler, &rawDataHandler_parallel }) {
+    loadTransitions.process(*handler, params_1, filenames);
+    loadRawData.process(*handler, params_1, filenames);
+    loadRawData.extractMetaData(*handler);
+    mapChroms.process(*handler, params_1, filenames);
+    pickFeatures.process(*handler, params_1, filenames);
+
+    // reduce the number of features for test purposes, keeping several subordinates to fit in parallel
+    OpenMS::FeatureMap& m = handler->getFeatureMap();
+    m.erase(m.begin() + 3, m.end());
+  }
+
+  // Test the fit, the subordinates are fitted in parallel on the workers of the pool
+  FitFeaturesEMG emg;
+  emg.process(rawDataHandler, params_1, filenames);
+  ThreadPool thread_pool(4);
+  thread_pool.submit([&]() { emg.process(rawDataHandler_parallel, params_1, filenames); }).get();
+
+  const OpenMS::FeatureMap& fmap = rawDataHandler_parallel.getFeatureMap();
+  ASSERT_EQ(fmap.size(), 3);
+  ASSERT_EQ(fmap[0].getSubordinates().size(), 3);
+  const OpenMS::Feature& sub = fmap[0].getSubordinates()[0];
+  EXPECT_NEAR(static_cast<double>(sub.getIntensity()), 758053.375, 1e-6);
+  EXPECT_NEAR(static_cast<double>(sub.getMetaValue("peak_apex_position")), 953.40699999999993, 1e-6);
+  EXPECT_NEAR(static_cast<double>(sub.getMetaValue("peak_apex_int")), 202893.72550713021, 1e-6);
+  EXPECT_NEAR(static_cast<double>(sub.getMetaValue("area_background_level")), 0.0083339133585532514, 1e-6);
+  EXPECT_NEAR(static_cast<double>(sub.getMetaValue("noise_background_level")), 0.00012474754841647006, 1e-6);
+
+  // identical to the serial fit
+  const OpenMS::FeatureMap& fmap_serial = rawDataHandler.getFeatureMap();
+  ASSERT_EQ(fmap_serial.size(), fmap.size());
+  for (size_t i = 0; i < fmap.size(); ++i) {
+    ASSERT_EQ(fmap[i].getSubordinates().size(), fmap_serial[i].getSubordinates().size());
+    for (size_t j = 0; j < fmap[i].getSubordinates().size(); ++j) {
+      const OpenMS::Feature& s = fmap[i].getSubordinates()[j];
+      const OpenMS::Feature& s_serial = fmap_serial[i].getSubordinates()[j];
+      EXPECT_EQ(s.getMetaValue("native_id").toString(), s_serial.getMetaValue("native_id").toString());
+      EXPECT_EQ(s.getIntensity(), s_serial.getIntensity());
+      for (const std::string meta_value : { "peak_apex_position", "peak_apex_int", "area_background_level", "noise_background_level" }) {
+        ASSERT_TRUE(s.metaValueExists(meta_value));
+        EXPECT_EQ(static_cast<double>(s.getMetaValue(meta_value)), static_cast<double>(s_serial.getMetaValue(meta_value)));
+      }
+    }
+  }
 }
 
 TEST(RawDataProcessor, calculateMDVs)
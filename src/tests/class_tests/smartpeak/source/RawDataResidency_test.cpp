@@ -0,0 +1,224 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/RawDataResidency.h>
+
+#include <iterator>
+#include <memory>
+
+using namespace SmartPeak;
+
+namespace
+{
+  OpenMS::MSExperiment makeTestChromatograms(size_t nb_peaks)
+  {
+    OpenMS::MSChromatogram chromatogram;
+    chromatogram.setNativeID("chromatogram");
+    for (size_t i = 0; i < nb_peaks; ++i)
+    {
+      // intensities that cannot be represented exactly with 32 bits
+      chromatogram.push_back(OpenMS::ChromatogramPeak(static_cast<double>(i), static_cast<double>(i % 100) + 0.1));
+    }
+    OpenMS::MSExperiment experiment;
+    experiment.addChromatogram(chromatogram);
+    return experiment;
+  }
+
+  struct TestSpillDir
+  {
+    TestSpillDir() : path_(std::filesystem::temp_directory_path() / "SmartPeak_RawDataResidency_test")
+    {
+      std::filesystem::remove_all(path_);
+    }
+    ~TestSpillDir()
+    {
+      std::filesystem::remove_all(path_);
+    }
+    std::filesystem::path path_;
+  };
+}
+
+TEST(RawDataResidency, getRequiredMSData)
+{
+  EXPECT_EQ(RawDataResidency::getRequiredMSData(std::set<std::string>{}), RawDataResidency::NoMSData);
+  EXPECT_EQ(RawDataResidency::getRequiredMSData(std::set<std::string>{ "Features", "Targeted Experiment" }), RawDataResidency::NoMSData);
+  EXPECT_EQ(RawDataResidency::getRequiredMSData(std::set<std::string>{ "Experiment" }), RawDataResidency::ExperimentData);
+  EXPECT_EQ(RawDataResidency::getRequiredMSData(std::set<std::string>{ "Spectra" }), RawDataResidency::ExperimentData);
+  EXPECT_EQ(RawDataResidency::getRequiredMSData(std::set<std::string>{ "Extracted Spectra" }), RawDataResidency::ChromatogramMapData);
+  EXPECT_EQ(RawDataResidency::getRequiredMSData(std::set<std::string>{ "Chromatogram", "Targeted Experiment", "SWATH" }),
+    RawDataResidency::ChromatogramMapData | RawDataResidency::SWATHData);
+}
+
+TEST(RawDataResidency, spillMSData)
+{
+  TestSpillDir spill_dir;
+  std::filesystem::create_directories(spill_dir.path_);
+  const auto pathname = spill_dir.path_ / "chromatogram_map.mzML";
+
+  RawDataHandler raw_data;
+  raw_data.setChromatogramMap(makeTestChromatograms(1000));
+  EXPECT_TRUE(raw_data.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  const size_t bytes = raw_data.getMSDataMemoryUsage(RawDataHandler::MSDataType::ChromatogramMap);
+  EXPECT_GT(bytes, 1000 * sizeof(OpenMS::ChromatogramPeak) - 1);
+  EXPECT_EQ(raw_data.getMSDataSize(RawDataHandler::MSDataType::ChromatogramMap), 1);
+
+  // nothing to spill
+  EXPECT_EQ(raw_data.spillMSData(RawDataHandler::MSDataType::Experiment, pathname), 0);
+
+  EXPECT_EQ(raw_data.spillMSData(RawDataHandler::MSDataType::ChromatogramMap, pathname), bytes);
+  EXPECT_FALSE(raw_data.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_EQ(raw_data.getMSDataMemoryUsage(RawDataHandler::MSDataType::ChromatogramMap), 0);
+  EXPECT_EQ(raw_data.getMSDataSize(RawDataHandler::MSDataType::ChromatogramMap), 0);
+  EXPECT_FALSE(raw_data.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap)); // not loaded back
+  EXPECT_TRUE(std::filesystem::exists(pathname));
+
+  // loaded back by the getters, and the spilled file is removed
+  const auto& chromatogram_map = static_cast<const RawDataHandler&>(raw_data).getChromatogramMap();
+  ASSERT_EQ(chromatogram_map.getChromatograms().size(), 1);
+  ASSERT_EQ(chromatogram_map.getChromatograms()[0].size(), 1000);
+  EXPECT_DOUBLE_EQ(chromatogram_map.getChromatograms()[0][999].getRT(), 999.0);
+  EXPECT_DOUBLE_EQ(chromatogram_map.getChromatograms()[0][999].getIntensity(), 99.1);
+  EXPECT_TRUE(raw_data.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_FALSE(std::filesystem::exists(pathname));
+
+  // spilled data replaced by the setter are not loaded back
+  raw_data.spillMSData(RawDataHandler::MSDataType::ChromatogramMap, pathname);
+  raw_data.setChromatogramMap(OpenMS::MSExperiment());
+  EXPECT_TRUE(raw_data.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_TRUE(raw_data.getChromatogramMap().getChromatograms().empty());
+  EXPECT_FALSE(std::filesystem::exists(pathname));
+
+  // dropped
+  raw_data.setExperiment(makeTestChromatograms(10));
+  EXPECT_GT(raw_data.spillMSData(RawDataHandler::MSDataType::Experiment, std::filesystem::path()), 0);
+  EXPECT_TRUE(raw_data.isMSDataResident(RawDataHandler::MSDataType::Experiment));
+  EXPECT_TRUE(raw_data.getExperiment().getChromatograms().empty());
+}
+
+TEST(RawDataResidency, release)
+{
+  TestSpillDir spill_dir;
+  RawDataResidency::Options options;
+  options.memory_budget_mb = 1024;
+  options.spill_dir = spill_dir.path_;
+  RawDataResidency raw_data_residency(options);
+  EXPECT_TRUE(raw_data_residency.isEnabled());
+
+  RawDataHandler raw_data;
+  raw_data.setExperiment(makeTestChromatograms(100));
+  raw_data.setChromatogramMap(makeTestChromatograms(100));
+  raw_data_residency.acquire(raw_data);
+  raw_data_residency.release(raw_data, "injection 1", RawDataResidency::ChromatogramMapData);
+
+  // the experiment is not needed anymore
+  EXPECT_FALSE(raw_data.isMSDataResident(RawDataHandler::MSDataType::Experiment));
+  EXPECT_TRUE(raw_data.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_EQ(raw_data_residency.getResidentBytes(), raw_data.getMSDataMemoryUsage(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_GT(raw_data_residency.getSpilledBytes(), 0);
+  EXPECT_EQ(raw_data.getExperiment().getChromatograms().size(), 1);
+
+  raw_data_residency.acquire(raw_data);
+  raw_data_residency.release(raw_data, "injection 1", RawDataResidency::NoMSData);
+  EXPECT_EQ(raw_data_residency.getResidentBytes(), 0);
+  EXPECT_GT(raw_data_residency.getPeakResidentBytes(), 0);
+  EXPECT_EQ(raw_data.getChromatogramMap().getChromatograms().size(), 1);
+}
+
+TEST(RawDataResidency, spill_dir)
+{
+  TestSpillDir spill_dir;
+  RawDataResidency::Options options;
+  options.memory_budget_mb = 1024;
+  options.spill_dir = spill_dir.path_;
+  auto raw_data_residency = std::make_unique<RawDataResidency>(options);
+
+  RawDataHandler raw_data;
+  raw_data.setExperiment(makeTestChromatograms(100));
+  raw_data_residency->acquire(raw_data);
+  raw_data_residency->release(raw_data, "injection 1", RawDataResidency::NoMSData);
+  ASSERT_FALSE(raw_data.isMSDataResident(RawDataHandler::MSDataType::Experiment));
+  auto nb_spill_dirs = [&spill_dir]() {
+    return std::distance(std::filesystem::directory_iterator(spill_dir.path_), std::filesystem::directory_iterator());
+  };
+  EXPECT_EQ(nb_spill_dirs(), 1);
+
+  // the spill directory is kept while spilled data refer to it, and removed with the last spilled file
+  raw_data_residency.reset();
+  EXPECT_EQ(nb_spill_dirs(), 1);
+  EXPECT_DOUBLE_EQ(raw_data.getExperiment().getChromatograms()[0][10].getIntensity(), 10.1);
+  EXPECT_EQ(nb_spill_dirs(), 0);
+}
+
+TEST(RawDataResidency, release_drop)
+{
+  RawDataResidency::Options options;
+  options.memory_budget_mb = 1024;
+  options.spill_to_disk = false;
+  RawDataResidency raw_data_residency(options);
+
+  RawDataHandler raw_data;
+  raw_data.setExperiment(makeTestChromatograms(100));
+  raw_data.setChromatogramMap(makeTestChromatograms(100));
+  raw_data_residency.acquire(raw_data);
+  raw_data_residency.release(raw_data, "injection 1", RawDataResidency::ExperimentData);
+  EXPECT_EQ(raw_data_residency.getSpilledBytes(), 0);
+  EXPECT_EQ(raw_data.getExperiment().getChromatograms().size(), 1);
+  EXPECT_TRUE(raw_data.getChromatogramMap().getChromatograms().empty());
+}
+
+TEST(RawDataResidency, release_budget)
+{
+  TestSpillDir spill_dir;
+  RawDataResidency::Options options;
+  options.memory_budget_mb = 2;
+  options.spill_dir = spill_dir.path_;
+  RawDataResidency raw_data_residency(options);
+
+  // ~1.6 MB each
+  RawDataHandler raw_data_1, raw_data_2;
+  raw_data_1.setChromatogramMap(makeTestChromatograms(100000));
+  raw_data_2.setChromatogramMap(makeTestChromatograms(100000));
+
+  raw_data_residency.acquire(raw_data_1);
+  raw_data_residency.release(raw_data_1, "injection 1", RawDataResidency::ChromatogramMapData);
+  EXPECT_TRUE(raw_data_1.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+
+  // the least recently released raw data are spilled
+  raw_data_residency.acquire(raw_data_2);
+  raw_data_residency.release(raw_data_2, "injection 2", RawDataResidency::ChromatogramMapData);
+  EXPECT_FALSE(raw_data_1.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_TRUE(raw_data_2.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_EQ(raw_data_residency.getResidentBytes(), raw_data_2.getMSDataMemoryUsage(RawDataHandler::MSDataType::ChromatogramMap));
+
+  // raw data being processed are not spilled, even if they were released the least recently
+  raw_data_residency.acquire(raw_data_2);
+  raw_data_residency.acquire(raw_data_1);
+  EXPECT_EQ(raw_data_1.getChromatogramMap().getChromatograms()[0].size(), 100000);
+  raw_data_residency.release(raw_data_1, "injection 1", RawDataResidency::ChromatogramMapData);
+  EXPECT_FALSE(raw_data_1.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  EXPECT_TRUE(raw_data_2.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+  raw_data_residency.release(raw_data_2, "injection 2", RawDataResidency::ChromatogramMapData);
+  EXPECT_TRUE(raw_data_2.isMSDataResident(RawDataHandler::MSDataType::ChromatogramMap));
+}
@@ -489,6 +489,100 @@ TEST(SampleGroupHandler, processMergeInjections2)
   EXPECT_NEAR(static_cast<float>(sampleGroupHandler.getFeatureMap().at(0).getSubordinates().at(0).getMZ()), 100, 1e-4);
 }
 
+TEST(SampleGroupHandler, processMergeInjections_missingComponents)
+{
+  ParameterSet mergeinjs_params({ {"MergeInjections", {
+    {
+      {"name", "scan_polarity_merge_rule"},
+      {"value", "Sum"}
+    },
+    {
+      {"name", "mass_range_merge_rule"},
+      {"value", "Sum"}
+    },
+    {
+      {"name", "dilution_series_merge_rule"},
+      {"value", "Sum"}
+    },
+    {
+      {"name", "scan_polarity_merge_feature_name"},
+      {"value", "peak_apex_int"}
+    },
+    {
+      {"name", "mass_range_merge_feature_name"},
+      {"value", "peak_apex_int"}
+    },
+    {
+      {"name", "dilution_series_merge_feature_name"},
+      {"value", "peak_apex_int"}
+    },
+    {
+      {"name", "merge_subordinates"},
+      {"value", "true"}
+    }
+  }} });
+
+  // ser-L is found in all the injections, amp is missing from the second one
+  const vector<double> ser_peak_apex_int = { 1, 2, 3 };
+  const vector<int> ser_points_across_baseline = { 3, 4, 5 };
+  const vector<double> amp_peak_apex_int = { 10, 20, 30 };
+  const vector<int> amp_points_across_baseline = { 7, 8, 9 };
+  auto make_feature = [](const std::string& peptide_ref, const std::string& native_id, double peak_apex_int, int points_across_baseline) {
+    OpenMS::Feature mrm_feature, component;
+    component.setMetaValue("native_id", native_id);
+    component.setMetaValue("peak_apex_int", peak_apex_int);
+    component.setMetaValue("points_across_baseline", points_across_baseline);
+    mrm_feature.setMetaValue("PeptideRef", peptide_ref);
+    mrm_feature.setSubordinates({ component });
+    return mrm_feature;
+  };
+  SequenceHandler sequenceHandler;
+  for (size_t i = 0; i < ser_peak_apex_int.size(); ++i) {
+    OpenMS::FeatureMap feature_map;
+    feature_map.push_back(make_feature("ser-L", "ser-L.ser-L_1.Light", ser_peak_apex_int[i], ser_points_across_baseline[i]));
+    if (i != 1) feature_map.push_back(make_feature("amp", "amp.amp_1.Light", amp_peak_apex_int[i], amp_points_across_baseline[i]));
+
+    MetaDataHandler meta_data;
+    meta_data.setSampleName("level" + std::to_string(i));
+    meta_data.setSampleGroupName("group1");
+    meta_data.setSampleType(SampleType::Standard);
+    meta_data.setFilename("filename" + std::to_string(i));
+    meta_data.setSequenceSegmentName("segment1");
+    meta_data.scan_polarity = "negative";
+    meta_data.scan_mass_low = -1;
+    meta_data.scan_mass_high = -1;
+    meta_data.dilution_factor = 1;
+    sequenceHandler.addSampleToSequence(meta_data, OpenMS::FeatureMap());
+
+    RawDataHandler rawDataHandler;
+    rawDataHandler.setFeatureMap(feature_map);
+    sequenceHandler.getSequence().at(i).setRawData(rawDataHandler);
+  }
+  SampleGroupHandler sampleGroupHandler = sequenceHandler.getSampleGroups().front();
+
+  MergeInjections sampleGroupProcessor;
+  Filenames filenames;
+  sampleGroupProcessor.process(sampleGroupHandler, sequenceHandler, mergeinjs_params, filenames);
+
+  const OpenMS::FeatureMap& fmap = sampleGroupHandler.getFeatureMap();
+  ASSERT_EQ(fmap.size(), 2);
+  EXPECT_STREQ(fmap.at(0).getMetaValue("PeptideRef").toString().c_str(), "amp");
+  ASSERT_EQ(fmap.at(0).getSubordinates().size(), 1);
+  const OpenMS::Feature& amp = fmap.at(0).getSubordinates().at(0);
+  EXPECT_STREQ(amp.getMetaValue("native_id").toString().c_str(), "amp.amp_1.Light");
+  EXPECT_NEAR(static_cast<float>(amp.getMetaValue("peak_apex_int")), 40, 1e-4);
+  EXPECT_EQ(amp.getMetaValue("points_across_baseline").valueType(), OpenMS::DataValue::INT_VALUE);
+  EXPECT_EQ(static_cast<int>(amp.getMetaValue("points_across_baseline")), 16);
+
+  EXPECT_STREQ(fmap.at(1).getMetaValue("PeptideRef").toString().c_str(), "ser-L");
+  ASSERT_EQ(fmap.at(1).getSubordinates().size(), 1);
+  const OpenMS::Feature& ser = fmap.at(1).getSubordinates().at(0);
+  EXPECT_STREQ(ser.getMetaValue("native_id").toString().c_str(), "ser-L.ser-L_1.Light");
+  EXPECT_NEAR(static_cast<float>(ser.getMetaValue("peak_apex_int")), 6, 1e-4);
+  EXPECT_EQ(ser.getMetaValue("points_across_baseline").valueType(), OpenMS::DataValue::INT_VALUE);
+  EXPECT_EQ(static_cast<int>(ser.getMetaValue("points_across_baseline")), 12);
+}
+
 TEST(SampleGroupHandler, processMergeInjections_selectDilution)
 {
   // setup the parameters
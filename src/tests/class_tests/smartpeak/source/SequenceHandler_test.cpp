@@ -373,3 +373,88 @@ TEST(SequenceHandler, getSamplesInSequence)
   EXPECT_STREQ(samples[0].getMetaData().getSampleName().c_str(), "sample1");
   EXPECT_STREQ(samples[1].getMetaData().getSampleName().c_str(), "sample3");
 }
+
+TEST(SequenceHandler, findIndices)
+{
+  MetaDataHandler meta_data1;
+  meta_data1.setFilename("file1");
+  meta_data1.setSampleName("sample1");
+  meta_data1.setSampleGroupName("group1");
+  meta_data1.setSequenceSegmentName("segment1");
+  meta_data1.setReplicateGroupName("replicate_group_name");
+  meta_data1.setSampleType(SampleType::Unknown);
+  meta_data1.batch_name = "9";
+
+  MetaDataHandler meta_data2 = meta_data1;
+  meta_data2.setFilename("file2");
+  meta_data2.setSampleName("sample2");
+  meta_data2.setSampleGroupName("group2");
+
+  MetaDataHandler meta_data3 = meta_data1;
+  meta_data3.setFilename("file3");
+  meta_data3.setSampleName("sample3");
+  meta_data3.setSequenceSegmentName("segment2");
+
+  OpenMS::FeatureMap featuremap;
+
+  SequenceHandler sequenceHandler;
+  sequenceHandler.addSampleToSequence(meta_data1, featuremap);
+  EXPECT_EQ(sequenceHandler.findSequenceSegmentIndex("segment1"), 0);
+  sequenceHandler.addSampleToSequence(meta_data2, featuremap);
+  sequenceHandler.addSampleToSequence(meta_data3, featuremap);
+
+  EXPECT_EQ(sequenceHandler.findInjectionIndex("sample1_-1_9_1900-01-01_000000"), 0);
+  EXPECT_EQ(sequenceHandler.findInjectionIndex("sample3_-1_9_1900-01-01_000000"), 2);
+  EXPECT_FALSE(sequenceHandler.findInjectionIndex("foo"));
+  EXPECT_EQ(sequenceHandler.findSequenceSegmentIndex("segment1"), 0);
+  EXPECT_EQ(sequenceHandler.findSequenceSegmentIndex("segment2"), 1);
+  EXPECT_EQ(sequenceHandler.findSampleGroupIndex("group1"), 0);
+  EXPECT_EQ(sequenceHandler.findSampleGroupIndex("group2"), 1);
+  EXPECT_EQ(sequenceHandler.getSequenceSegments().at(0).getSampleIndices(), std::vector<size_t>({ 0, 1 }));
+  EXPECT_EQ(sequenceHandler.getSampleGroups().at(0).getSampleIndices(), std::vector<size_t>({ 0, 2 }));
+
+  // the index follows modifications through the non-const getters
+  sequenceHandler.getSequenceSegments().at(1).setSequenceSegmentName("segment3");
+  EXPECT_FALSE(sequenceHandler.findSequenceSegmentIndex("segment2"));
+  EXPECT_EQ(sequenceHandler.findSequenceSegmentIndex("segment3"), 1);
+  sequenceHandler.getSequence().erase(sequenceHandler.getSequence().begin());
+  EXPECT_EQ(sequenceHandler.findInjectionIndex("sample3_-1_9_1900-01-01_000000"), 1);
+
+  sequenceHandler.clear();
+  EXPECT_FALSE(sequenceHandler.findInjectionIndex("sample3_-1_9_1900-01-01_000000"));
+  EXPECT_FALSE(sequenceHandler.findSampleGroupIndex("group1"));
+}
+
+TEST(SequenceHandler, detachRawData)
+{
+  MetaDataHandler meta_data1;
+  meta_data1.setFilename("file1");
+  meta_data1.setSampleName("sample1");
+  meta_data1.setSampleGroupName("group1");
+  meta_data1.setSequenceSegmentName("segment1");
+  meta_data1.setSampleType(SampleType::Unknown);
+  meta_data1.batch_name = "9";
+
+  MetaDataHandler meta_data2 = meta_data1;
+  meta_data2.setFilename("file2");
+  meta_data2.setSampleName("sample2");
+
+  OpenMS::FeatureMap featuremap;
+
+  SequenceHandler sequenceHandler;
+  sequenceHandler.addSampleToSequence(meta_data1, featuremap);
+  sequenceHandler.addSampleToSequence(meta_data2, featuremap);
+
+  // the raw data of the snapshot is copied once, the non const accessors then keep it
+  SequenceHandler snapshot = sequenceHandler.snapshot();
+  const SequenceHandler& const_snapshot = snapshot;
+  const SequenceHandler& const_sequence = sequenceHandler;
+  EXPECT_EQ(&const_snapshot.getSequence().at(0).getRawData(), &const_sequence.getSequence().at(0).getRawData());
+  snapshot.detachRawData();
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const RawDataHandler* raw_data = &const_snapshot.getSequence().at(i).getRawData();
+    EXPECT_NE(raw_data, &const_sequence.getSequence().at(i).getRawData());
+    EXPECT_EQ(&snapshot.getSequence().at(i).getRawData(), raw_data);
+  }
+}
@@ -362,6 +362,41 @@ TEST_F(SequenceParserFixture, makeDataMatrixFromMetaValue)
   EXPECT_NEAR(data_out(0, 0), 15.6053667, 1e-3);
 }
 
+TEST_F(SequenceParserFixture, makeDataMatrixFromFeatureTables)
+{
+  const vector<string> meta_data = { "calculated_concentration", "leftWidth" };
+  std::set<SampleType> sample_types;
+  for (const std::pair<SampleType, std::string>& p : sampleTypeToString) sample_types.insert(p.first);
+  const std::string sample_name = sequence_handler_.getSequence().at(0).getMetaData().getSampleName();
+
+  Eigen::Tensor<float, 2> data_expected;
+  Eigen::Tensor<std::string, 1> columns_expected;
+  Eigen::Tensor<std::string, 2> rows_expected;
+  SequenceParser::makeDataMatrixFromMetaValue(sequence_handler_, data_expected, columns_expected, rows_expected,
+    meta_data, sample_types, std::set<std::string>({ sample_name }), std::set<std::string>(), std::set<std::string>());
+
+  std::vector<SequenceParser::InjectionFeatureTable> feature_tables;
+  for (const InjectionHandler& injection : sequence_handler_.getSequence()) {
+    if (injection.getMetaData().getSampleName() != sample_name) continue;
+    feature_tables.push_back({ sample_name, injection.getRawData().getFeatureTable(meta_data), &injection.getRawData().getValidationMetrics() });
+  }
+  Eigen::Tensor<float, 2> data_out;
+  Eigen::Tensor<std::string, 1> columns_out;
+  Eigen::Tensor<std::string, 2> rows_out;
+  SequenceParser::makeDataMatrixFromFeatureTables(feature_tables, data_out, columns_out, rows_out, meta_data, std::set<std::string>(), std::set<std::string>());
+
+  ASSERT_EQ(columns_out.size(), 1);
+  EXPECT_EQ(columns_out(0), sample_name);
+  ASSERT_EQ(rows_out.dimension(0), rows_expected.dimension(0));
+  ASSERT_GT(rows_out.dimension(0), 0);
+  for (int row = 0; row < rows_out.dimension(0); ++row) {
+    for (int col = 0; col < 3; ++col) {
+      EXPECT_EQ(rows_out(row, col), rows_expected(row, col));
+    }
+    EXPECT_FLOAT_EQ(data_out(row, 0), data_expected(row, 0));
+  }
+}
+
 TEST_F(SequenceParserFixture, writeDataMatrixFromMetaValue)
 {
   Eigen::Tensor<float, 2> data_out;
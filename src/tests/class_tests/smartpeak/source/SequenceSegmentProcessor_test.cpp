@@ -51,6 +51,7 @@
 #include <SmartPeak/core/SequenceSegmentProcessors/StoreStandardsConcentrations.h>
 #include <SmartPeak/core/SequenceSegmentProcessors/TransferLOQToFeatureFilters.h>
 #include <SmartPeak/core/SequenceSegmentProcessors/TransferLOQToFeatureQCs.h>
+#include <SmartPeak/core/ThreadPool.h>
 
 using namespace SmartPeak;
 using namespace std;
@@ -576,6 +577,52 @@ TEST(SequenceSegmentProcessor, getSampleIndicesBySampleType)
   EXPECT_EQ(sample_indices[1], 2);
 }
 
+TEST(SequenceSegmentProcessor, getFeatureMaps)
+{
+  SequenceHandler sequenceHandler;
+  for (int i = 0; i < 3; ++i) {
+    MetaDataHandler meta_data;
+    meta_data.setFilename("file" + std::to_string(i));
+    meta_data.setSampleName("sample" + std::to_string(i));
+    meta_data.setSampleGroupName("sample");
+    meta_data.setSequenceSegmentName("sequence_segment");
+    meta_data.setSampleType(SampleType::Standard);
+    OpenMS::FeatureMap feature_map;
+    feature_map.resize(i + 1);
+    sequenceHandler.addSampleToSequence(meta_data, feature_map);
+  }
+
+  SequenceSegmentHandler sequenceSegmentHandler;
+  sequenceSegmentHandler.setSampleIndices({0, 1, 2});
+
+  auto feature_maps = SequenceSegmentProcessor::getFeatureMaps(sequenceSegmentHandler, sequenceHandler, {0, 2});
+  ASSERT_EQ(feature_maps->size(), 2);
+  EXPECT_EQ(feature_maps->at(0).size(), 1);
+  EXPECT_EQ(feature_maps->at(1).size(), 3);
+
+  // reused by the next processors
+  EXPECT_EQ(SequenceSegmentProcessor::getFeatureMaps(sequenceSegmentHandler, sequenceHandler, {0, 2}), feature_maps);
+  auto other_feature_maps = SequenceSegmentProcessor::getFeatureMaps(sequenceSegmentHandler, sequenceHandler, {1});
+  ASSERT_EQ(other_feature_maps->size(), 1);
+  EXPECT_EQ(other_feature_maps->at(0).size(), 2);
+
+  // updated once a feature map is modified
+  sequenceHandler.getSequence().at(2).getRawData().getFeatureMap().resize(4);
+  auto updated_feature_maps = SequenceSegmentProcessor::getFeatureMaps(sequenceSegmentHandler, sequenceHandler, {0, 2});
+  EXPECT_NE(updated_feature_maps, feature_maps);
+  ASSERT_EQ(updated_feature_maps->size(), 2);
+  EXPECT_EQ(updated_feature_maps->at(1).size(), 4);
+  EXPECT_EQ(feature_maps->at(1).size(), 3);
+  EXPECT_EQ(SequenceSegmentProcessor::getFeatureMaps(sequenceSegmentHandler, sequenceHandler, {1}), other_feature_maps);
+
+  // released once the segment is processed
+  std::weak_ptr<const std::vector<OpenMS::FeatureMap>> released_feature_maps = updated_feature_maps;
+  updated_feature_maps.reset();
+  sequenceSegmentHandler.clearFeatureMaps();
+  EXPECT_TRUE(released_feature_maps.expired());
+  EXPECT_NE(SequenceSegmentProcessor::getFeatureMaps(sequenceSegmentHandler, sequenceHandler, {1}), other_feature_maps);
+}
+
 TEST(SequenceSegmentProcessor, processOptimizeCalibration)
 {
   // Pre-requisites: set up the parameters and data structures for testing
@@ -746,6 +793,115 @@ TEST(SequenceSegmentProcessor, processOptimizeCalibration)
 */
 }
 
+TEST(SequenceSegmentProcessor, processOptimizeCalibration_threadPool)
+{
+  // Pre-requisites: set up the parameters and data structures for testing
+  const map<string, vector<map<string, string>>> absquant_params = {{"AbsoluteQuantitation", {
+    {
+      {"name", "min_points"},
+      {"value", "4"}
+    },
+    {
+      {"name", "max_bias"},
+      {"value", "30.0"}
+    },
+    {
+      {"name", "min_correlation_coefficient"},
+      {"value", "0.9"}
+    },
+    {
+      {"name", "max_iters"},
+      {"value", "100"}
+    },
+    {
+      {"name", "outlier_detection_method"},
+      {"value", "iter_jackknife"}
+    },
+    {
+      {"name", "use_chauvenet"},
+      {"value", "false"}
+    }
+  }}};
+
+  const string feature_name = "peak_apex_int";
+  const string transformation_model = "linear";
+  OpenMS::Param param;
+  param.setValue("slope", 1.0);
+  param.setValue("intercept", 0.0);
+  param.setValue("x_weight", "ln(x)");
+  param.setValue("y_weight", "ln(y)");
+  param.setValue("x_datum_min", -1e12);
+  param.setValue("x_datum_max", 1e12);
+  param.setValue("y_datum_min", -1e12);
+  param.setValue("y_datum_max", 1e12);
+
+  vector<OpenMS::AbsoluteQuantitationMethod> quant_methods;
+
+  OpenMS::AbsoluteQuantitationMethod aqm;
+  aqm.setComponentName("ser-L.ser-L_1.Light");
+  aqm.setISName("ser-L.ser-L_1.Heavy");
+  aqm.setFeatureName(feature_name);
+  aqm.setConcentrationUnits("uM");
+  aqm.setTransformationModel(transformation_model);
+  aqm.setTransformationModelParams(param);
+  quant_methods.push_back(aqm);
+
+  aqm.setComponentName("amp.amp_1.Light");
+  aqm.setISName("amp.amp_1.Heavy");
+  quant_methods.push_back(aqm);
+
+  aqm.setComponentName("atp.atp_1.Light");
+  aqm.setISName("atp.atp_1.Heavy");
+  quant_methods.push_back(aqm);
+
+  SequenceSegmentHandler sequenceSegmentHandler;
+
+  sequenceSegmentHandler.setQuantitationMethods(quant_methods);
+  std::shared_ptr<std::vector<OpenMS::AbsoluteQuantitationMethod>> absQuantMethods_ptr = sequenceSegmentHandler.getQuantitationMethodsShared();
+
+  vector<OpenMS::AbsoluteQuantitationStandards::runConcentration> runs;
+  SequenceHandler sequenceHandler;
+  makeStandardsFeaturesAndConcentrations(sequenceHandler, runs, absQuantMethods_ptr);
+  sequenceSegmentHandler.setStandardsConcentrations(runs);
+
+  vector<size_t> indices(sequenceHandler.getSequence().size());
+  std::iota(indices.begin(), indices.end(), 0);
+
+  sequenceSegmentHandler.setSampleIndices(indices);
+
+  // Test calculate calibration, the components are fitted in parallel on the workers of the pool
+  OptimizeCalibration optimizeCalibration;
+  Filenames filenames;
+  ThreadPool thread_pool(4);
+  thread_pool.submit([&]() { optimizeCalibration.process(sequenceSegmentHandler, sequenceHandler, absquant_params, filenames); }).get();
+
+  // same results as the serial fit, in component name order
+  const vector<string> component_names = { "amp.amp_1.Light", "atp.atp_1.Light", "ser-L.ser-L_1.Light" };
+  const vector<double> slopes = { 0.957996830126945, 0.6230408240794582, 0.9011392589148208 };
+  const vector<double> intercepts = { -1.0475433871941753, 0.36130172586029285, 1.8701850759567624 };
+  const vector<int> n_points = { 11, 6, 11 };
+  const vector<double> correlation_coefficients = { 0.9991692616730385, 0.9982084021849695, 0.9993200722867581 };
+  const vector<double> lloqs = { 0.02, 0.02, 0.04 };
+  const vector<double> uloqs = { 40.0, 40.0, 200.0 };
+  for (const auto* AQMs : { &sequenceSegmentHandler.getQuantitationMethods(), &sequenceHandler.getSequence()[0].getRawData().getQuantitationMethods() }) {
+    ASSERT_EQ(AQMs->size(), 3);
+    for (size_t i = 0; i < AQMs->size(); ++i) {
+      const OpenMS::AbsoluteQuantitationMethod& aqm = AQMs->at(i);
+      EXPECT_EQ(aqm.getComponentName(), component_names[i]);
+      EXPECT_NEAR(static_cast<double>(aqm.getTransformationModelParams().getValue("slope")), slopes[i], 1e-6);
+      EXPECT_NEAR(static_cast<double>(aqm.getTransformationModelParams().getValue("intercept")), intercepts[i], 1e-6);
+      EXPECT_EQ(aqm.getNPoints(), n_points[i]);
+      EXPECT_NEAR(static_cast<double>(aqm.getCorrelationCoefficient()), correlation_coefficients[i], 1e-6);
+      EXPECT_NEAR(static_cast<double>(aqm.getLLOQ()), lloqs[i], 1e-6);
+      EXPECT_NEAR(static_cast<double>(aqm.getULOQ()), uloqs[i], 1e-6);
+    }
+  }
+  const auto& component_to_concentrations = sequenceSegmentHandler.getComponentsToConcentrations();
+  EXPECT_EQ(component_to_concentrations.size(), 3);
+  ASSERT_EQ(component_to_concentrations.count("ser-L.ser-L_1.Light"), 1);
+  EXPECT_EQ(component_to_concentrations.at("ser-L.ser-L_1.Light").size(), 11);
+}
+
 /**
   LoadStandardsConcentrations Tests
 */
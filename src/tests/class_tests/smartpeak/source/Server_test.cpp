@@ -26,6 +26,9 @@
 #include <SmartPeak/test_config.h>
 #include <SmartPeak/core/Server.h>
 
+#include <atomic>
+#include <chrono>
+
 
 TEST(Server, handleWorkflowRequest)
 {
@@ -87,3 +90,67 @@ TEST(Server, processRemoteWorkflow)
 //  EXPECT_TRUE(RawDataAndFeatures_loaded);
   EXPECT_TRUE(success);
 }
+
+TEST(Server, JobQueue_submit)
+{
+  SmartPeak::serv::JobQueue job_queue(2);
+  EXPECT_EQ(job_queue.getMaxRunningJobs(), 2);
+
+  std::atomic_int nb_running{ 0 };
+  std::atomic_int max_nb_running{ 0 };
+  std::vector<std::shared_future<bool>> results;
+  for (int i = 0; i < 6; ++i)
+  {
+    results.push_back(job_queue.submit("job_" + std::to_string(i), [&, i]()
+    {
+      const int running = ++nb_running;
+      int max_running = max_nb_running;
+      while (running > max_running && !max_nb_running.compare_exchange_weak(max_running, running));
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      --nb_running;
+      return (i % 2 == 0);
+    }));
+  }
+  // job ids are unique
+  EXPECT_FALSE(job_queue.submit("job_0", []() { return true; }).valid());
+
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_EQ(results[i].get(), (i % 2 == 0));
+    EXPECT_EQ(job_queue.getStatus("job_" + std::to_string(i)), SmartPeak::serv::JobQueue::JobStatus::DONE);
+  }
+  EXPECT_LE(max_nb_running, 2);
+  EXPECT_EQ(job_queue.getNbQueuedJobs(), 0);
+  EXPECT_EQ(job_queue.getStatus("unknown"), SmartPeak::serv::JobQueue::JobStatus::UNKNOWN);
+}
+
+TEST(Server, JobQueue_cancel)
+{
+  SmartPeak::serv::JobQueue job_queue(1);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  auto first = job_queue.submit("first", [released]() { released.wait(); return true; });
+  auto second = job_queue.submit("second", []() { return true; });
+  EXPECT_EQ(job_queue.getStatus("second"), SmartPeak::serv::JobQueue::JobStatus::QUEUED);
+  EXPECT_TRUE(job_queue.cancel("second"));
+  EXPECT_FALSE(job_queue.cancel("unknown"));
+  EXPECT_FALSE(second.get());
+  EXPECT_EQ(job_queue.getStatus("second"), SmartPeak::serv::JobQueue::JobStatus::CANCELLED);
+  release.set_value();
+  EXPECT_TRUE(first.get());
+}
+
+TEST(Server, JobQueue_forget)
+{
+  SmartPeak::serv::JobQueue job_queue(1);
+  // a job throwing anything fails without stopping the queue
+  EXPECT_FALSE(job_queue.submit("throws", []() -> bool { throw 1; }).get());
+  EXPECT_EQ(job_queue.getStatus("throws"), SmartPeak::serv::JobQueue::JobStatus::DONE);
+  EXPECT_FALSE(job_queue.submit("throws", []() { return true; }).valid());
+
+  // finished jobs can be forgotten, their id is then available again
+  EXPECT_TRUE(job_queue.forget("throws"));
+  EXPECT_FALSE(job_queue.forget("throws"));
+  EXPECT_EQ(job_queue.getStatus("throws"), SmartPeak::serv::JobQueue::JobStatus::UNKNOWN);
+  EXPECT_TRUE(job_queue.submit("throws", []() { return true; }).get());
+}
@@ -214,3 +214,75 @@ TEST(SessionDB, WriteAndReadPropertiesHandler)
   EXPECT_EQ(properties_handler_read_test.test_bool_list, properties_handler_write_test.test_bool_list);
   EXPECT_EQ(properties_handler_read_test.test_string_list, properties_handler_write_test.test_string_list);
 }
+
+TEST(SessionDB, WriteAndReadBulk)
+{
+  SessionDB session_db;
+  auto path_db = std::tmpnam(nullptr);
+  session_db.setDBFilePath(path_db);
+  session_db.setWALJournalMode(true);
+  EXPECT_TRUE(session_db.getWALJournalMode());
+
+  const int nb_rows = 10000;
+  const std::string quoted_string = "it's a 'quoted' string";
+  auto context = session_db.beginWrite("table1", "col1", "INT", "col2", "REAL", "col3", "TEXT");
+  ASSERT_TRUE(context);
+  for (int i = 0; i < nb_rows; ++i)
+  {
+    session_db.write(*context, i, 0.5 * i, quoted_string);
+  }
+  session_db.endWrite(*context);
+
+  context = session_db.beginRead("table1", "col1", "col2", "col3");
+  ASSERT_TRUE(context);
+  int db_int = 0;
+  double db_double = 0.0;
+  std::string db_string;
+  int nb_read = 0;
+  while (session_db.read(*context, db_int, db_double, db_string))
+  {
+    EXPECT_EQ(db_int, nb_read);
+    EXPECT_DOUBLE_EQ(db_double, 0.5 * nb_read);
+    EXPECT_EQ(db_string, quoted_string);
+    ++nb_read;
+  }
+  session_db.endRead(*context);
+  EXPECT_EQ(nb_read, nb_rows);
+}
+
+TEST(SessionDB, WriteCommitFailure)
+{
+  SessionDB session_db;
+  auto path_db = std::tmpnam(nullptr);
+  session_db.setDBFilePath(path_db);
+
+  auto context = session_db.beginWrite("table1", "col1", "INT");
+  ASSERT_TRUE(context);
+  session_db.write(*context, 42);
+  EXPECT_TRUE(session_db.endWrite(*context));
+
+  // rewrite the table while another connection is reading it, the commit can't get the lock
+  context = session_db.beginWrite("table1", "col1", "INT");
+  ASSERT_TRUE(context);
+  session_db.write(*context, 142);
+  session_db.write(*context, 242);
+  SessionDB reader_db;
+  reader_db.setDBFilePath(path_db);
+  auto read_context = reader_db.beginRead("table1", "col1");
+  ASSERT_TRUE(read_context);
+  int db_int = 0;
+  EXPECT_TRUE(reader_db.read(*read_context, db_int));
+  EXPECT_FALSE(session_db.endWrite(*context));
+  reader_db.endRead(*read_context);
+
+  // the failed write is rolled back
+  read_context = session_db.beginRead("table1", "col1");
+  ASSERT_TRUE(read_context);
+  std::vector<int> db_ints;
+  while (session_db.read(*read_context, db_int))
+  {
+    db_ints.push_back(db_int);
+  }
+  session_db.endRead(*read_context);
+  EXPECT_EQ(db_ints, std::vector<int>({ 42 }));
+}
@@ -26,6 +26,7 @@
 #include <SmartPeak/core/SessionHandler.h>
 #include <SmartPeak/core/SequenceProcessor.h>
 #include <SmartPeak/core/Utilities.h>
+#include <SmartPeak/io/SequenceParser.h>
 #include <SmartPeak/core/RawDataProcessors/LoadFeatures.h>
 #include <SmartPeak/core/RawDataProcessors/LoadRawData.h>
 #include <SmartPeak/core/SequenceSegmentProcessors/StoreFeatureRSDEstimations.h>
@@ -660,6 +661,44 @@ TEST(SessionHandler, sessionHandlerGetters1)
   EXPECT_TRUE(!session_handler.getGroupFiltersTable(table_data.body_)(session_handler.getGroupFiltersTable(table_data.body_).dimension(0) - 1));
 }
 
+TEST(SessionHandler, explorerSelections)
+{
+  TestData testData(true, false, true);
+  SessionHandler session_handler;
+  session_handler.setMinimalDataAndFilters(testData.application_handler.sequenceHandler_);
+  // names are interned, and selected from the checkboxes of the explorers
+  EXPECT_EQ(session_handler.getSampleNamesPlotSelection().getNbNames(), 2);
+  EXPECT_EQ(session_handler.getSampleNamesPlotSelection().getNbSelected(), 0);
+  EXPECT_EQ(session_handler.getTransitionsTableSelection().getNbNames(), 6);
+  EXPECT_EQ(session_handler.getTransitionsTableSelection().getNbSelected(), 6);
+  EXPECT_EQ(session_handler.getTransitionGroupsTableSelection().getNbNames(), 4);
+  EXPECT_EQ(session_handler.getTransitionGroupsTableSelection().getSelectedNames().front(), "arg-L");
+  EXPECT_EQ(session_handler.getFeatureMetaValuesTableSelection().getNbNames(), 22);
+  EXPECT_EQ(session_handler.getFeatureMetaValuesTableSelection().getNbSelected(), 0);
+
+  // changes of the checkboxes are picked on the next query
+  const size_t plot_selection_version = session_handler.getPlotSelectionVersion();
+  session_handler.injection_explorer_data.checkbox_body(1, 1) = true;
+  session_handler.transition_explorer_data.checkbox_body(0, 0) = true;
+  EXPECT_EQ(session_handler.getSampleNamesPlotSelection().getSelectedNames(), std::vector<std::string>({ "150516_CM1_Level10" }));
+  EXPECT_EQ(session_handler.getTransitionsPlotSelection().getSelectedNames(), std::vector<std::string>({ "arg-L.arg-L_1.Light" }));
+  EXPECT_EQ(session_handler.getTransitionGroupsPlotSelection().getSelectedNames(), std::vector<std::string>({ "arg-L" }));
+  EXPECT_NE(session_handler.getPlotSelectionVersion(), plot_selection_version);
+  EXPECT_EQ(session_handler.getPlotSelectionVersion(), session_handler.getPlotSelectionVersion());
+
+  // table filters
+  session_handler.transition_explorer_data.checkbox_body(0, 1) = false;
+  SessionHandler::GenericTableData table_data;
+  session_handler.setComponentFiltersTable(testData.application_handler.sequenceHandler_, table_data);
+  const auto filters = session_handler.getFiltersTable(table_data.body_);
+  ASSERT_EQ(filters.size(), table_data.body_.dimension(0));
+  for (int row = 0; row < table_data.body_.dimension(0); ++row)
+  {
+    EXPECT_EQ(filters(row), session_handler.getTransitionsTableSelection().isSelected(table_data.body_(row, 0)));
+  }
+  EXPECT_FALSE(session_handler.getTransitionsTableSelection().isSelected(session_handler.transitions_table.body_(0, 1)));
+}
+
 TEST(SessionHandler, setFeatureTable1)
 {
   TestData testData(true, true);
@@ -690,6 +729,62 @@ TEST(SessionHandler, setFeatureMatrix1)
   SessionHandler session_handler;
   session_handler.setFeatureMatrix(testData.application_handler.sequenceHandler_);
 }
+TEST(SessionHandler, setFeatureMatrix2)
+{
+  TestData testData(true, true);
+  SessionHandler session_handler;
+  session_handler.setMinimalDataAndFilters(testData.application_handler.sequenceHandler_);
+  for (int i = 0; i < session_handler.feature_table.body_.dimension(0); ++i) {
+    if (session_handler.feature_table.body_(i, 0) == "calculated_concentration") session_handler.feature_explorer_data.checkbox_body(i, 0) = true;
+  }
+  std::set<SampleType> sample_types;
+  for (const std::pair<SampleType, std::string>& p : sampleTypeToString) sample_types.insert(p.first);
+  auto expect_matrix = [&](const std::set<std::string>& sample_names) {
+    Eigen::Tensor<float, 2> data;
+    Eigen::Tensor<std::string, 1> columns;
+    Eigen::Tensor<std::string, 2> rows;
+    SequenceParser::makeDataMatrixFromMetaValue(testData.application_handler.sequenceHandler_, data, columns, rows, { "calculated_concentration" },
+      sample_types, sample_names, std::set<std::string>(), std::set<std::string>());
+    ASSERT_EQ(session_handler.feat_value_data.dimension(0), data.dimension(0));
+    ASSERT_EQ(session_handler.feat_value_data.dimension(1), data.dimension(1));
+    ASSERT_EQ(session_handler.feature_pivot_table.body_.dimension(1), 3);
+    ASSERT_EQ(session_handler.feature_pivot_table.values_.dimension(1), data.dimension(1));
+    for (int col = 0; col < data.dimension(1); ++col) {
+      EXPECT_EQ(session_handler.feat_col_labels(col), columns(col));
+    }
+    for (int row = 0; row < data.dimension(0); ++row) {
+      EXPECT_EQ(session_handler.feature_pivot_table.body_(row, 0), rows(row, 0));
+      EXPECT_EQ(session_handler.feature_pivot_table.body_(row, 2), rows(row, 2));
+      for (int col = 0; col < data.dimension(1); ++col) {
+        EXPECT_FLOAT_EQ(session_handler.feat_value_data(row, col), data(row, col));
+        EXPECT_FLOAT_EQ(session_handler.feature_pivot_table.values_(row, col), data(row, col));
+      }
+    }
+  };
+
+  session_handler.setFeatureMatrix(testData.application_handler.sequenceHandler_);
+  EXPECT_EQ(session_handler.getFeatureMatrixVersion(), 1);
+  EXPECT_GT(session_handler.feat_value_data.dimension(0), 0);
+  expect_matrix(std::set<std::string>());
+
+  // nothing has changed
+  session_handler.setFeatureMatrix(testData.application_handler.sequenceHandler_);
+  EXPECT_EQ(session_handler.getFeatureMatrixVersion(), 1);
+
+  // the features have changed
+  session_handler.onFeaturesUpdated();
+  session_handler.setFeatureMatrix(testData.application_handler.sequenceHandler_);
+  EXPECT_EQ(session_handler.getFeatureMatrixVersion(), 2);
+  expect_matrix(std::set<std::string>());
+
+  // the selected samples have changed
+  session_handler.injection_explorer_data.checkbox_body(0, 1) = true;
+  const std::string sample_name = session_handler.sequence_table.body_(0, 1);
+  session_handler.setFeatureMatrix(testData.application_handler.sequenceHandler_);
+  EXPECT_EQ(session_handler.getFeatureMatrixVersion(), 3);
+  EXPECT_EQ(session_handler.feat_col_labels.size(), 1);
+  expect_matrix({ sample_name });
+}
 TEST(SessionHandler, getSpectrumScatterPlot1)
 {
   TestData testData;
@@ -0,0 +1,95 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/SpectraLibraryIndex.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace SmartPeak;
+
+TEST(SpectraLibraryIndex, getLibrary)
+{
+  const std::filesystem::path filename = std::filesystem::temp_directory_path() / "SpectraLibraryIndex_getLibrary.msp";
+  {
+    std::ofstream ofs(filename);
+    ofs << "Name: test\n";
+  }
+  SpectraLibraryIndex index;
+  int n_loads = 0;
+  auto load = [&n_loads](OpenMS::MSExperiment& library)
+  {
+    ++n_loads;
+    library.addSpectrum(OpenMS::MSSpectrum());
+  };
+  const auto library1 = index.getLibrary(filename, load);
+  const auto library2 = index.getLibrary(filename, load);
+  EXPECT_EQ(n_loads, 1);
+  EXPECT_EQ(library1, library2);
+  EXPECT_EQ(library1->size(), 1);
+
+  // the file has changed
+  std::filesystem::last_write_time(filename, std::filesystem::last_write_time(filename) + std::chrono::seconds(1));
+  const auto library3 = index.getLibrary(filename, load);
+  EXPECT_EQ(n_loads, 2);
+  EXPECT_NE(library1, library3);
+
+  index.clear();
+  index.getLibrary(filename, load);
+  EXPECT_EQ(n_loads, 3);
+
+  // the library is not kept when loading fails
+  index.clear();
+  EXPECT_THROW(index.getLibrary(filename, [](OpenMS::MSExperiment&) { throw std::runtime_error("error"); }), std::runtime_error);
+  index.getLibrary(filename, load);
+  EXPECT_EQ(n_loads, 4);
+
+  std::filesystem::remove(filename);
+}
+
+TEST(SpectraLibraryIndex, getComparator)
+{
+  auto library = std::make_shared<OpenMS::MSExperiment>();
+  OpenMS::MSSpectrum spectrum;
+  spectrum.setName("spectrum1");
+  spectrum.push_back(OpenMS::Peak1D(100.0, 10.0f));
+  spectrum.push_back(OpenMS::Peak1D(200.0, 20.0f));
+  library->addSpectrum(spectrum);
+
+  SpectraLibraryIndex index;
+  const auto comparator1 = index.getComparator(library);
+  const auto comparator2 = index.getComparator(library);
+  EXPECT_EQ(comparator1, comparator2);
+
+  // another library is binned again
+  auto other_library = std::make_shared<OpenMS::MSExperiment>(*library);
+  const auto comparator3 = index.getComparator(other_library);
+  EXPECT_NE(comparator1, comparator3);
+
+  index.clear();
+  EXPECT_NE(index.getComparator(other_library), comparator3);
+}
@@ -0,0 +1,108 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Bertrand Boudaud, Ahmed Khalil, Douglas McCloskey $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/ThreadPool.h>
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace SmartPeak;
+
+TEST(ThreadPool, constructor)
+{
+  ThreadPool thread_pool(4);
+  EXPECT_EQ(thread_pool.capacity(), 4);
+  EXPECT_EQ(thread_pool.size(), 0);
+  thread_pool.reserve(2);
+  EXPECT_EQ(thread_pool.size(), 2);
+  thread_pool.reserve(10);
+  EXPECT_EQ(thread_pool.size(), 4);
+}
+
+TEST(ThreadPool, submit)
+{
+  ThreadPool thread_pool(2);
+  auto f = thread_pool.submit([]() { return 42; });
+  EXPECT_EQ(f.get(), 42);
+  EXPECT_FALSE(thread_pool.isWorkerThread());
+  auto is_worker = thread_pool.submit([&thread_pool]() { return thread_pool.isWorkerThread(); });
+  EXPECT_TRUE(is_worker.get());
+}
+
+TEST(ThreadPool, current)
+{
+  ThreadPool thread_pool(2);
+  EXPECT_EQ(ThreadPool::current(), nullptr);
+  auto current = thread_pool.submit([]() { return ThreadPool::current(); });
+  EXPECT_EQ(current.get(), &thread_pool);
+}
+
+TEST(ThreadPool, parallelFor)
+{
+  ThreadPool thread_pool(4);
+  std::atomic_int counter{ 0 };
+  // nested parallelFor must not deadlock, even when all the workers are busy
+  thread_pool.parallelFor(4, [&](size_t)
+  {
+    thread_pool.parallelFor(8, [&](size_t) { ++counter; });
+  });
+  EXPECT_EQ(counter, 32);
+}
+
+TEST(ThreadPool, parallelForNestedBlocking)
+{
+  ThreadPool thread_pool(2);
+  // the other tasks block until the nested parallelFor is done, like the workflow workers waiting
+  // for their dependencies: the nested call must not run them while waiting for its own tasks
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool nested_done = false;
+  std::atomic_int counter{ 0 };
+  thread_pool.parallelFor(3, [&](size_t i)
+  {
+    if (i == 0)
+    {
+      thread_pool.parallelFor(4, [&](size_t) { ++counter; });
+      std::lock_guard<std::mutex> lock(mutex);
+      nested_done = true;
+      cv.notify_all();
+    }
+    else
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return nested_done; });
+    }
+  });
+  EXPECT_EQ(counter, 4);
+}
+
+TEST(ThreadPool, parallelForException)
+{
+  ThreadPool thread_pool(2);
+  EXPECT_THROW(thread_pool.parallelFor(3, [](size_t) { throw std::runtime_error("error"); }), std::runtime_error);
+  // pool is still usable
+  auto f = thread_pool.submit([]() { return 1; });
+  EXPECT_EQ(f.get(), 1);
+}
@@ -205,6 +205,92 @@ TEST(Widget, GenericTableWidget_searcher)
   }
 }
 
+static SessionHandler::GenericTableData getDummyTableView()
+{
+  SessionHandler::GenericTableData table_data;
+  table_data.headers_.resize(3);
+  table_data.headers_.setValues({ "name", "inj#", "value" });
+  table_data.body_.resize(4, 2);
+  table_data.body_.setValues({
+    { "sample10", "10" },
+    { "Sample2", "2" },
+    { "blank", "" },
+    { "sample1", "100" } });
+  table_data.values_.resize(4, 1);
+  table_data.values_.setValues({ { 0.5f }, { 3.0f }, { 1.5f }, { 2.0f } });
+  return table_data;
+}
+
+TEST(TableView, filter)
+{
+  const auto table_data = getDummyTableView();
+  TableView table_view;
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0, 1, 2, 3 }));
+  EXPECT_FALSE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, {}, false));
+
+  // any column, then a single column
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "10", -1, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0, 3 }));
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "10", 0, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0 }));
+
+  // value columns are filtered on their text
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "1.5", 2, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 2 }));
+
+  // narrowing, then widening the filter
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "sample", 0, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0, 1, 3 }));
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "sample1", 0, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0, 3 }));
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "sample1,blank", 0, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0, 2, 3 }));
+
+  // checked rows
+  Eigen::Tensor<bool, 1> checked_rows(4);
+  checked_rows.setValues({ true, false, true, true });
+  EXPECT_TRUE(table_view.update(table_data, checked_rows, "", -1, {}, false));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0, 2, 3 }));
+}
+
+TEST(TableView, sort)
+{
+  auto table_data = getDummyTableView();
+  TableView table_view;
+
+  // natural order of strings
+  table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, { { 0, true } }, false);
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 2, 3, 1, 0 }));
+  table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, { { 0, false } }, false);
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 0, 1, 3, 2 }));
+
+  // numbers, empty cells last
+  table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, { { 1, true } }, false);
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 1, 0, 3, 2 }));
+
+  // value columns
+  table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, { { 2, false } }, false);
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 1, 3, 2, 0 }));
+
+  // sorted rows are kept when narrowing the filter
+  table_view.update(table_data, Eigen::Tensor<bool, 1>(), "s", -1, { { 2, false } }, false);
+  table_view.update(table_data, Eigen::Tensor<bool, 1>(), "sa", -1, { { 2, false } }, false);
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 1, 3, 0 }));
+
+  // multiple specs
+  table_data.body_(1, 0) = "sample10";
+  table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, { { 0, true }, { 2, true } }, true);
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 2, 3, 0, 1 }));
+
+  // cells are updated in place
+  table_data.values_(0, 0) = 10.0f;
+  EXPECT_FALSE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, { { 0, true }, { 2, true } }, false));
+  EXPECT_TRUE(table_view.update(table_data, Eigen::Tensor<bool, 1>(), "", -1, { { 0, true }, { 2, true } }, true));
+  EXPECT_EQ(table_view.getRows(), std::vector<size_t>({ 2, 3, 1, 0 }));
+  EXPECT_EQ(TableView::getCellText(table_data, 0, 2), std::to_string(10.0f));
+}
+
 class GraphicDataVizWidget_Test : public GraphicDataVizWidget
 {
 public:
@@ -916,10 +1002,11 @@ public:
   CalibratorsPlotWidget_Test(
     SessionHandler& session_handler,
     SequenceHandler& sequence_handler,
+    DataPreparationPool& data_preparation_pool,
     std::shared_ptr<ExplorerWidget> explorer_widget,
     std::shared_ptr<ChromatogramPlotWidget> chromatogram_widget,
     SequenceObservable& sequence_observable) :
-    CalibratorsPlotWidget(session_handler, sequence_handler, explorer_widget, chromatogram_widget, sequence_observable)
+    CalibratorsPlotWidget(session_handler, sequence_handler, data_preparation_pool, explorer_widget, chromatogram_widget, sequence_observable)
   {};
 
 public:
@@ -967,10 +1054,11 @@ TEST(CalibratorsPlotWidget, setCalibrationData)
 {
   SessionHandler session_handler;
   SequenceHandler sequence_handler;
+  DataPreparationPool data_preparation_pool;
   std::shared_ptr<ExplorerWidget> explorer_widget;
   std::shared_ptr<ChromatogramPlotWidget> chromatogram_widget;
   EventDispatcher event_dispatcher;
-  CalibratorsPlotWidget_Test calibrator_widget(session_handler, sequence_handler, explorer_widget, chromatogram_widget, event_dispatcher);
+  CalibratorsPlotWidget_Test calibrator_widget(session_handler, sequence_handler, data_preparation_pool, explorer_widget, chromatogram_widget, event_dispatcher);
   EXPECT_EQ(calibrator_widget.get_reset_zoom_(), true);
 
   SessionHandler::CalibrationData calibrator_data;
@@ -993,10 +1081,11 @@ TEST(CalibratorsPlotWidget, getSelectedPoint)
 {
   SessionHandler session_handler;
   SequenceHandler sequence_handler;
+  DataPreparationPool data_preparation_pool;
   std::shared_ptr<ExplorerWidget> explorer_widget;
   std::shared_ptr<ChromatogramPlotWidget> chromatogram_widget;
   EventDispatcher event_dispatcher;
-  CalibratorsPlotWidget_Test calibrator_widget(session_handler, sequence_handler, explorer_widget, chromatogram_widget, event_dispatcher);
+  CalibratorsPlotWidget_Test calibrator_widget(session_handler, sequence_handler, data_preparation_pool, explorer_widget, chromatogram_widget, event_dispatcher);
   EXPECT_EQ(calibrator_widget.get_reset_zoom_(), true);
 
   SessionHandler::CalibrationData calibrator_data;
@@ -1035,10 +1124,11 @@ TEST(CalibratorsPlotWidget, getSampleNameFromSelectedPoint)
 {
   SessionHandler session_handler;
   SequenceHandler sequence_handler;
+  DataPreparationPool data_preparation_pool;
   std::shared_ptr<ExplorerWidget> explorer_widget;
   std::shared_ptr<ChromatogramPlotWidget> chromatogram_widget;
   EventDispatcher event_dispatcher;
-  CalibratorsPlotWidget_Test calibrator_widget(session_handler, sequence_handler, explorer_widget, chromatogram_widget, event_dispatcher);
+  CalibratorsPlotWidget_Test calibrator_widget(session_handler, sequence_handler, data_preparation_pool, explorer_widget, chromatogram_widget, event_dispatcher);
   EXPECT_EQ(calibrator_widget.get_reset_zoom_(), true);
 
   SessionHandler::CalibrationData calibrator_data;
@@ -0,0 +1,188 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Bertrand Boudaud, Ahmed Khalil, Douglas McCloskey $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <SmartPeak/test_config.h>
+#include <SmartPeak/core/WorkflowScheduler.h>
+#include <SmartPeak/core/RawDataProcessors/PickMRMFeatures.h>
+#include <SmartPeak/core/SequenceSegmentProcessors/FitCalibration.h>
+#include <SmartPeak/core/SampleGroupProcessors/MergeInjections.h>
+
+using namespace SmartPeak;
+
+struct WorkflowSchedulerFixture : public ::testing::Test
+{
+  WorkflowSchedulerFixture()
+  {
+    // 4 injections, 2 sequence segments of 2 injections, 1 sample group with all the injections
+    std::vector<InjectionHandler> sequence;
+    for (size_t i = 0; i < 4; ++i)
+    {
+      InjectionHandler injection;
+      MetaDataHandler meta_data;
+      meta_data.setSampleName("sample_" + std::to_string(i));
+      injection.setMetaData(meta_data);
+      injection_names_.push_back(injection.getMetaData().getInjectionName());
+      sequence.push_back(injection);
+    }
+    sequence_handler_.setSequence(sequence);
+
+    std::vector<SequenceSegmentHandler> sequence_segments(2);
+    sequence_segments[0].setSequenceSegmentName("segment_0");
+    sequence_segments[0].setSampleIndices({ 0, 1 });
+    sequence_segments[1].setSequenceSegmentName("segment_1");
+    sequence_segments[1].setSampleIndices({ 2, 3 });
+    sequence_handler_.setSequenceSegments(sequence_segments);
+
+    std::vector<SampleGroupHandler> sample_groups(1);
+    sample_groups[0].setSampleGroupName("group_0");
+    sample_groups[0].setSampleIndices({ 0, 1, 2, 3 });
+    sequence_handler_.setSampleGroups(sample_groups);
+  }
+
+  ApplicationHandler::Command rawDataCommand() const
+  {
+    ApplicationHandler::Command command;
+    command.setMethod(std::make_shared<PickMRMFeatures>());
+    for (const auto& name : injection_names_) command.dynamic_filenames[name] = Filenames();
+    return command;
+  }
+
+  ApplicationHandler::Command sequenceSegmentCommand() const
+  {
+    ApplicationHandler::Command command;
+    command.setMethod(std::make_shared<FitCalibration>());
+    for (const auto& name : { "segment_0", "segment_1" }) command.dynamic_filenames[name] = Filenames();
+    return command;
+  }
+
+  ApplicationHandler::Command sampleGroupCommand() const
+  {
+    ApplicationHandler::Command command;
+    command.setMethod(std::make_shared<MergeInjections>());
+    command.dynamic_filenames["group_0"] = Filenames();
+    return command;
+  }
+
+  SequenceHandler sequence_handler_;
+  std::vector<std::string> injection_names_;
+};
+
+TEST_F(WorkflowSchedulerFixture, buildGraph_stages)
+{
+  WorkflowScheduler scheduler(sequence_handler_);
+  // consecutive commands of the same type are grouped into one stage
+  scheduler.buildGraph({ rawDataCommand(), rawDataCommand(), sequenceSegmentCommand(), sampleGroupCommand() }, {}, {}, {});
+  const auto& stages = scheduler.getStages();
+  ASSERT_EQ(stages.size(), 3);
+  EXPECT_EQ(stages[0].type, ApplicationHandler::Command::RawDataMethod);
+  EXPECT_EQ(stages[0].raw_data_methods.size(), 2);
+  EXPECT_EQ(stages[0].first_command_index, 0);
+  EXPECT_EQ(stages[0].nb_tasks, 4);
+  EXPECT_EQ(stages[1].type, ApplicationHandler::Command::SequenceSegmentMethod);
+  EXPECT_EQ(stages[1].first_command_index, 2);
+  EXPECT_EQ(stages[1].nb_tasks, 2);
+  EXPECT_EQ(stages[2].type, ApplicationHandler::Command::SampleGroupMethod);
+  EXPECT_EQ(stages[2].first_command_index, 3);
+  EXPECT_EQ(stages[2].nb_tasks, 1);
+  EXPECT_EQ(scheduler.getTasks().size(), 7);
+}
+
+TEST_F(WorkflowSchedulerFixture, buildGraph_dependencies)
+{
+  WorkflowScheduler scheduler(sequence_handler_);
+  scheduler.buildGraph({ rawDataCommand(), sequenceSegmentCommand(), sampleGroupCommand(), rawDataCommand() }, {}, {}, {});
+  const auto& tasks = scheduler.getTasks();
+  ASSERT_EQ(tasks.size(), 4 + 2 + 1 + 4);
+
+  // raw data tasks of the first stage do not wait for anything
+  for (size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(tasks[i].stage_index, 0);
+    EXPECT_EQ(tasks[i].item_index, i);
+    EXPECT_TRUE(tasks[i].dependencies.empty());
+  }
+  // each segment only waits for its own injections and the first one
+  EXPECT_EQ(tasks[4].dependencies, std::vector<size_t>({ 0, 1 }));
+  EXPECT_EQ(tasks[5].dependencies, std::vector<size_t>({ 0, 2, 3 }));
+  // the sample group waits for both segments
+  EXPECT_EQ(tasks[6].dependencies, std::vector<size_t>({ 4, 5 }));
+  // the last raw data stage waits for the sample group
+  for (size_t i = 7; i < 11; ++i)
+  {
+    EXPECT_EQ(tasks[i].dependencies, std::vector<size_t>({ 6 }));
+  }
+  EXPECT_EQ(tasks[6].dependents.size(), 4);
+}
+
+TEST_F(WorkflowSchedulerFixture, buildGraph_first_injection)
+{
+  WorkflowScheduler scheduler(sequence_handler_);
+  scheduler.buildGraph({ rawDataCommand(), sequenceSegmentCommand(), rawDataCommand() }, {}, {}, {});
+  const auto& tasks = scheduler.getTasks();
+  ASSERT_EQ(tasks.size(), 4 + 2 + 4);
+  // segment_1 does not contain the first injection but reads its targeted experiment
+  EXPECT_EQ(tasks[5].item_index, 1);
+  EXPECT_EQ(tasks[5].dependencies, std::vector<size_t>({ 0, 2, 3 }));
+  // the first injection is processed again once both segments have read it
+  EXPECT_EQ(tasks[6].item_index, 0);
+  EXPECT_EQ(tasks[6].dependencies, std::vector<size_t>({ 4, 5 }));
+  EXPECT_EQ(tasks[7].dependencies, std::vector<size_t>({ 4 }));
+  EXPECT_EQ(tasks[8].dependencies, std::vector<size_t>({ 5 }));
+}
+
+TEST_F(WorkflowSchedulerFixture, buildGraph_filter)
+{
+  WorkflowScheduler scheduler(sequence_handler_);
+  scheduler.buildGraph({ rawDataCommand(), sequenceSegmentCommand() }, { injection_names_[2] }, { "segment_1" }, {});
+  const auto& tasks = scheduler.getTasks();
+  ASSERT_EQ(tasks.size(), 2);
+  EXPECT_EQ(tasks[0].item_index, 2);
+  EXPECT_EQ(tasks[1].item_index, 1);
+  EXPECT_EQ(tasks[1].dependencies, std::vector<size_t>({ 0 }));
+}
+
+TEST_F(WorkflowSchedulerFixture, buildGraph_empty_stage)
+{
+  WorkflowScheduler scheduler(sequence_handler_);
+  // no segment is selected: the segment stage is reported by a task running between the raw data stages
+  scheduler.buildGraph({ rawDataCommand(), sequenceSegmentCommand(), rawDataCommand() }, {}, { "segment_x" }, {});
+  const auto& tasks = scheduler.getTasks();
+  ASSERT_EQ(tasks.size(), 4 + 1 + 4);
+  EXPECT_EQ(scheduler.getStages()[1].nb_tasks, 0);
+  EXPECT_EQ(tasks[4].stage_index, 1);
+  EXPECT_EQ(tasks[4].item_index, WorkflowScheduler::Task::no_item);
+  EXPECT_EQ(tasks[4].dependencies, std::vector<size_t>({ 0, 1, 2, 3 }));
+  for (size_t i = 5; i < 9; ++i)
+  {
+    EXPECT_EQ(tasks[i].dependencies, std::vector<size_t>({ 4 }));
+  }
+}
+
+TEST_F(WorkflowSchedulerFixture, buildGraph_missing_filenames)
+{
+  WorkflowScheduler scheduler(sequence_handler_);
+  auto command = rawDataCommand();
+  command.dynamic_filenames.erase(injection_names_[0]);
+  EXPECT_THROW(scheduler.buildGraph({ command }, {}, {}, {}), std::invalid_argument);
+}
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <SmartPeak/core/SessionHandler.h>
+#include <SmartPeak/core/DataPreparation.h>
 #include <SmartPeak/ui/Widget.h>
 #include <SmartPeak/ui/ParameterEditorWidget.h>
 #include <SmartPeak/ui/ExplorerWidget.h>
@@ -48,6 +49,7 @@ namespace SmartPeak
   public:
     CalibratorsPlotWidget(SessionHandler& session_handler,
                           SequenceHandler& sequence_handler,
+                          DataPreparationPool& data_preparation_pool,
                           std::shared_ptr<ExplorerWidget> explorer_widget,
                           std::shared_ptr<ChromatogramPlotWidget> chromatogram_widget,
                           SequenceObservable& sequence_observable,
@@ -55,6 +57,7 @@ namespace SmartPeak
       GenericGraphicWidget(title),
       session_handler_(session_handler),
       sequence_handler_(sequence_handler),
+      data_preparation_pool_(data_preparation_pool),
       parameter_editor_widget_(*this, false),
       explorer_widget_(explorer_widget),
       chromatogram_widget_(chromatogram_widget)
@@ -127,6 +130,7 @@ namespace SmartPeak
     bool reset_zoom_ = true;
     SessionHandler& session_handler_;
     SequenceHandler& sequence_handler_;
+    DataPreparationPool& data_preparation_pool_; ///< the sequence is modified holding its data lock
     ParameterEditorWidget parameter_editor_widget_;
     std::shared_ptr<Parameter> param_to_edit_;
     std::optional<std::tuple<int, int>> hovered_matching_point_;
@@ -58,7 +58,6 @@ namespace SmartPeak
     virtual void updateData() override;
   protected:
     // input used to create the graph
-    std::set<std::string> input_sample_names_;
-    std::set<std::string> input_component_names_;
+    size_t input_selection_version_ = 0; ///< sum of the versions of the selected sample names and transitions
   };
 }
@@ -71,7 +71,7 @@ namespace SmartPeak
 
   protected:
     // input used to create the graph
-    std::set<std::string> input_sample_names_;
+    size_t input_selection_version_ = 0; ///< sum of the versions of the selected sample names
     std::shared_ptr<SpectraMSMSPlotWidget> spectra_msms_plot_widget_;
   };
 }
@@ -83,8 +83,7 @@ namespace SmartPeak
 
   protected:
     // input used to create the graph
-    std::set<std::string> input_sample_names_;
-    std::set<std::string> input_component_names_;
+    size_t input_selection_version_ = 0; ///< sum of the versions of the selected sample names and transitions
     std::shared_ptr<SpectraMSMSPlotWidget> spectra_msms_plot_widget_;
     float current_mz_ = 0.0f;
     float input_mz_ = 0.0f;
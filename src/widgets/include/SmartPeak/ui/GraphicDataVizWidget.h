@@ -28,6 +28,7 @@
 #include <SmartPeak/ui/FilePicker.h>
 #include <SmartPeak/core/SessionHandler.h>
 #include <SmartPeak/core/ApplicationHandler.h>
+#include <SmartPeak/core/DataPreparation.h>
 
 #include <string>
 #include <utility>
@@ -54,7 +55,8 @@ namespace SmartPeak
       session_handler_(session_handler),
       sequence_handler_(application_handler.sequenceHandler_),
       application_handler_(application_handler),
-      plot_title_(id) 
+      plot_title_(id),
+      data_preparation_(*application_handler.data_preparation_pool_)
     {
       plot_limits_.X.Min = 0.0;
       plot_limits_.X.Max = 1.0;
@@ -84,6 +86,23 @@ namespace SmartPeak
     virtual std::tuple<float, float, float, float> plotLimits() const;
     virtual void updateRanges();
     virtual void plotHighestValue(int idx);
+
+    /**
+      @brief The part of the plot displayed, or the whole plot if the plot limits are about to be fitted to new data.
+    */
+    SessionHandler::PlotViewport getPlotViewport(bool whole_plot);
+    /**
+      @brief True if the plot has been zoomed, panned or resized since the data were requested with getPlotViewport.
+      False until the requested data are published, so that zooming does not supersede them.
+    */
+    bool isPlotViewportChanged() const;
+    /**
+      @brief Requests the data of the graph, published in graph_viz_data_ by draw() once prepared.
+
+      @param[in] prepare Fills the data of the graph on a worker thread, it must only read the sequence
+      @param[in] fit_ranges Fits the plot to the data once published
+    */
+    void requestData(std::function<void(SessionHandler::GraphVizData&)> prepare, bool fit_ranges);
     
     // Utility methods
     std::set<std::string> getSelectedSampleNames() const;
@@ -111,6 +130,10 @@ namespace SmartPeak
     bool update_plot_range_ = true;
     ImPlotLimits plot_limits_;
     bool restore_plot_limits_ = false;
+    SessionHandler::PlotViewport plot_viewport_ { 0.0f, 0.0f, 1920 }; ///< updated by drawGraph
+    std::optional<SessionHandler::PlotViewport> input_plot_viewport_; ///< the viewport the data were requested with
+    DataPreparation<SessionHandler::GraphVizData> data_preparation_; ///< prepares graph_viz_data_ off the UI thread
+    bool fit_ranges_ = false; ///< the plot is fitted to the requested data once published
   };
 
 }
@@ -26,6 +26,7 @@
 #include <SmartPeak/ui/Widget.h>
 #include <SmartPeak/ui/Plotter.h>
 #include <SmartPeak/ui/FilePicker.h>
+#include <SmartPeak/core/DataPreparation.h>
 
 #include <string>
 #include <utility>
@@ -52,7 +53,8 @@ namespace SmartPeak
         session_handler_(session_handler),
         sequence_handler_(application_handler.sequenceHandler_),
         application_handler_(application_handler),
-        plot_title_(id) 
+        plot_title_(id),
+        data_preparation_(*application_handler.data_preparation_pool_)
     {
       sequence_observable.addSequenceObserver(this);
     };
@@ -64,8 +66,6 @@ namespace SmartPeak
     */
     virtual void onSequenceUpdated() override;
 
-  private:
-    bool compareInput(const Eigen::Tensor<std::string, 1>& l, const Eigen::Tensor<std::string, 1>& r) const;
   protected:
     SessionHandler& session_handler_;
     SequenceHandler& sequence_handler_;
@@ -73,9 +73,13 @@ namespace SmartPeak
     SessionHandler::HeatMapData heatmap_data_;
     std::string plot_title_; // used as the ID of the plot as well so this should be unique across the different Widgets
     std::string selected_feature_;
-    bool invalid_data_;
-    bool data_mismatch_;
+    bool invalid_data_ = false;
+    bool data_mismatch_ = false;
     bool refresh_needed_ = false;
+    // input used to request the heatmap
+    std::string input_feature_;
+    size_t input_selection_version_ = 0;
+    DataPreparation<SessionHandler::HeatMapData> data_preparation_; ///< prepares heatmap_data_ off the UI thread
   };
 
 }
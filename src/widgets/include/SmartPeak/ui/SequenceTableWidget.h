@@ -29,6 +29,7 @@
 #include <functional>
 #include <imgui.h>
 #include <SmartPeak/core/SessionHandler.h>
+#include <SmartPeak/core/DataPreparation.h>
 #include <SmartPeak/ui/Widget.h>
 #include <SmartPeak/ui/SequenceGroupsEditorWidget.h>
 #include <SmartPeak/ui/SampleTypeEditorWidget.h>
@@ -44,6 +45,7 @@ namespace SmartPeak
       const std::string title,
       SessionHandler* session_handler,
       SequenceHandler* sequence_handler,
+      DataPreparationPool& data_preparation_pool,
       DataGetterMethod data_getter = nullptr,
       DataFilterMethod data_filter = nullptr)
       : GenericTableWidget(table_id,
@@ -52,6 +54,7 @@ namespace SmartPeak
         sequence_handler,
         data_getter,
         data_filter),
+      data_preparation_pool_(data_preparation_pool),
       sequence_segment_editor_("Edit Sequence Segment", "Move to existing segment", "Create new segment", "New segment", "Select segment"),
       sample_group_editor_("Edit Sample Group", "Move to existing group", "Create new group", "New group", "Select group"),
       replicate_group_name_editor_("Edit Replicate Group", "Move to existing group", "Create new group", "New group", "Select group")
@@ -80,6 +83,7 @@ namespace SmartPeak
     InjectionHandler* getInjectionFromTable(const size_t row, const size_t col);
 
   protected:
+    DataPreparationPool& data_preparation_pool_; ///< the sequence is modified holding its data lock
     SequenceGroupsEditorWidget sequence_segment_editor_;
     SequenceGroupsEditorWidget sample_group_editor_;
     SequenceGroupsEditorWidget replicate_group_name_editor_;
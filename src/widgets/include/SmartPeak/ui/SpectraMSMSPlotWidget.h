@@ -77,9 +77,8 @@ namespace SmartPeak
 
   protected:
     // input used to create the graph
-    std::set<std::string> input_sample_names_;
+    size_t input_selection_version_ = 0; ///< sum of the versions of the selected sample names and transition groups
     std::set<std::string> input_scan_names_;
-    std::set<std::string> input_component_group_names_;
     std::shared_ptr<ChromatogramXICPlotWidget> chromatogram_xic_widget_;
     int ms_level_;
     float current_rt_ = 0.0f;
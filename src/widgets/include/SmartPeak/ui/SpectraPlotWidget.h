@@ -60,9 +60,8 @@ namespace SmartPeak
 
   protected:
     // input used to create the graph
-    std::set<std::string> input_sample_names_;
+    size_t input_selection_version_ = 0; ///< sum of the versions of the selected sample names and transition groups
     std::set<std::string> input_scan_names_;
-    std::set<std::string> input_component_group_names_;
   };
 
 }
@@ -104,6 +104,8 @@ namespace SmartPeak
       std::string error_message_;
     };
     void drawChart(DashboardChartData& chart_data, const char* title, const char* x_label, const char* y_label) const;
+    void drawFeaturesCharts();
+    void drawProcessorProfile();
 
   protected:
     DashboardChartData samples_chart_;
@@ -117,5 +119,7 @@ namespace SmartPeak
     const Eigen::Tensor<std::string, 2>* transitions_ = nullptr;
     Eigen::Tensor<bool, 2> transitions_checkbox_;
     Eigen::Tensor<std::string, 2> transitions_columns_;
+    std::vector<ProcessorProfiler::Summary> processor_summaries_;
+    size_t processor_records_count_ = 0; ///< number of records processor_summaries_ was computed from
   };
 }
@@ -0,0 +1,101 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <SmartPeak/core/SessionHandler.h>
+#include <imgui.h>
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace SmartPeak
+{
+  /**
+    @brief Filtered and sorted rows of a table, kept as a permutation of the row indices of the table data.
+
+    The cells are read in place from the table data. The rows are only recomputed when the table data, the checked rows,
+    the filter or the sort specs change, and a filter that only narrows the previous one is evaluated on the displayed
+    rows only. Columns are sorted on cached typed keys: the numbers of numeric columns, the natural order
+    (see ImEntry::lexicographical_sort) ranks of the others.
+  */
+  class TableView
+  {
+  public:
+    struct SortSpec
+    {
+      size_t column;
+      bool ascending;
+      bool operator==(const SortSpec& other) const { return column == other.column && ascending == other.ascending; }
+      bool operator!=(const SortSpec& other) const { return !(*this == other); }
+    };
+
+    /**
+      @brief Updates the rows to display
+
+      @param[in] table_data The table, body_ columns followed by values_ columns
+      @param[in] checked_rows Rows that can be displayed, all if empty
+      @param[in] filter_text ImGuiTextFilter expression the displayed rows pass
+      @param[in] filter_column Column the filter applies to, any column if negative
+      @param[in] sort_specs Columns to sort on, by priority, in the table order if empty
+      @param[in] data_changed The content of the table data has changed (a change of dimensions or storage is detected anyway)
+
+      @returns true if the rows have changed
+    */
+    bool update(const SessionHandler::GenericTableData& table_data,
+                const Eigen::Tensor<bool, 1>& checked_rows,
+                const std::string& filter_text,
+                const int filter_column,
+                const std::vector<SortSpec>& sort_specs,
+                const bool data_changed);
+
+    /**
+      @brief The row indices of the table data to display, in display order
+    */
+    const std::vector<size_t>& getRows() const { return rows_; }
+
+    static size_t getNbColumns(const SessionHandler::GenericTableData& table_data);
+    static std::string getCellText(const SessionHandler::GenericTableData& table_data, const size_t row, const size_t col);
+
+  protected:
+    bool passFilter(const SessionHandler::GenericTableData& table_data, const ImGuiTextFilter& filter, const size_t row) const;
+    const std::vector<double>& getSortKeys(const SessionHandler::GenericTableData& table_data, const size_t col);
+    void sortRows(const SessionHandler::GenericTableData& table_data);
+    static bool isNarrowing(const std::string& previous_filter_text, const std::string& filter_text);
+
+    // what the rows were computed from
+    bool valid_ = false;
+    const std::string* body_storage_ = nullptr;
+    const float* values_storage_ = nullptr;
+    std::array<Eigen::Index, 4> dimensions_ = { 0, 0, 0, 0 };
+    std::vector<bool> checked_rows_;
+    std::string filter_text_;
+    int filter_column_ = -1;
+    std::vector<SortSpec> sort_specs_;
+
+    std::vector<size_t> rows_;
+    std::map<size_t, std::vector<double>> sort_keys_; ///< per column, kept until the table data change
+  };
+}
@@ -28,12 +28,14 @@
 #include <SmartPeak/core/SessionHandler.h>
 #include <SmartPeak/ui/ImEntry.h>
 #include <SmartPeak/ui/Help.h>
+#include <SmartPeak/ui/TableView.h>
 #include <unsupported/Eigen/CXX11/Tensor>
 #include <SmartPeak/iface/ISequenceSegmentObserver.h>
 #include <SmartPeak/iface/IFeaturesObserver.h>
 #include <SmartPeak/iface/IPropertiesHandler.h>
 
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <functional>
@@ -149,6 +151,25 @@ namespace SmartPeak
     void updateTableContents(std::vector<ImEntry>& Im_table_entries, bool& is_scanned,
       const Eigen::Tensor<std::string, 2>& columns, const Eigen::Tensor<bool, 2>& checkbox_columns);
 
+    /*
+    @brief Update table contents with text table entries, numeric table entries and checkboxes
+
+    @param[in,out] Im_table_entries vector of ImTableEntry
+    @param[in] is_scanned true if `columns_` and `checkbox_columns_` are in sync with `Im_table_entries`
+    @param[in] columns columns' entries
+    @param[in] value_columns numeric columns' entries, following the text columns
+    @param[in] checkbox_columns checkboxes' entries
+    */
+    void updateTableContents(std::vector<ImEntry>& Im_table_entries, bool& is_scanned,
+      const Eigen::Tensor<std::string, 2>& columns, const Eigen::Tensor<float, 2>& value_columns, const Eigen::Tensor<bool, 2>& checkbox_columns);
+
+    /*
+    @brief Replace the table data, the table entries are updated on the next draw
+
+    @param[in] table_data the new table data
+    */
+    void setTableData(const SessionHandler::GenericTableData& table_data);
+
     /*
     @brief Perform sorting on a given `vector` of `ImTableEntry` elements
 
@@ -183,6 +204,9 @@ namespace SmartPeak
 
   private:
     void selectCell(size_t row, size_t col);
+    bool isCellSelected(size_t row, size_t col) const;
+    void addSelectedCell(size_t row, size_t col);
+    void clearSelectedCells();
 
   protected:
     const std::string table_id_;
@@ -196,14 +220,16 @@ namespace SmartPeak
     bool plot_unplot_all_deactivated_ = false;
     int selected_col_ = 0;
     int plot_idx_ = -1;
-    const int max_rows_ = 100;
-    size_t print_until_ = 0;
     unsigned int table_entries_plot_col_ = 0;
     unsigned int checkbox_columns_plot_col_ = 0;
     std::string plot_switch_ = "";
     std::vector<const char*> cols_;
     bool data_changed_ = false;
-    std::vector<std::tuple<size_t, size_t>> selected_cells_;
+    std::vector<std::tuple<size_t, size_t>> selected_cells_; ///< row of table_data_, column
+    std::unordered_set<size_t> selected_rows_; ///< rows of selected_cells_, for lookups while drawing
+    TableView table_view_;
+    std::vector<TableView::SortSpec> sort_specs_;
+    ImGuiTextFilter table_filter_;
   };
 
   struct FeaturesTableWidget : public GenericTableWidget, public IFeaturesObserver
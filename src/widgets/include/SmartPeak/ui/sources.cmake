@@ -36,6 +36,7 @@ set(sources_list_h
 	SpectraPlotWidget.h
 	SplitWindow.h
 	StatisticsWidget.h
+	TableView.h
 	UIUtilities.h
 	Widget.h
 	WindowSizesAndPositions.h
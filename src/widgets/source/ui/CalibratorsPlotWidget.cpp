@@ -27,6 +27,8 @@
 #include <SmartPeak/core/Utilities.h>
 #include <implot.h>
 
+#include <utility>
+
 namespace SmartPeak
 {
   void CalibratorsPlotWidget::setIncludeExcludeParameter(const std::string& parameter_name, const std::vector<std::tuple<std::string, std::string>>& include_exclude_list)
@@ -59,19 +61,22 @@ namespace SmartPeak
 
   void CalibratorsPlotWidget::recomputeFitCalibration(const std::string& component_name)
   {
-    setIncludeExcludeParameter("excluded_points", user_excluded_points_);
-    setIncludeExcludeParameter("included_points", user_included_points_);
-    FitCalibration fit_calibration;
-    Filenames filenames; // fit_calibration actually does not use it
-    ParameterSet& user_parameters = sequence_handler_.getSequence().at(0).getRawData().getParameters();
-    auto fit_calibration_params_schema = fit_calibration.getParameterSchema();
-    user_parameters.merge(fit_calibration_params_schema);
-    user_parameters.findParameter("FitCalibration", "component_name")->setValueFromString(component_name);
-    fit_calibration.process(
-      sequence_handler_.getSequenceSegments().at(selected_sequence_segment_),
-      sequence_handler_,
-      user_parameters,
-      filenames);
+    {
+      auto data_lock = data_preparation_pool_.lockData();
+      setIncludeExcludeParameter("excluded_points", user_excluded_points_);
+      setIncludeExcludeParameter("included_points", user_included_points_);
+      FitCalibration fit_calibration;
+      Filenames filenames; // fit_calibration actually does not use it
+      ParameterSet& user_parameters = sequence_handler_.getSequence().at(0).getRawData().getParameters();
+      auto fit_calibration_params_schema = fit_calibration.getParameterSchema();
+      user_parameters.merge(fit_calibration_params_schema);
+      user_parameters.findParameter("FitCalibration", "component_name")->setValueFromString(component_name);
+      fit_calibration.process(
+        sequence_handler_.getSequenceSegments().at(selected_sequence_segment_),
+        sequence_handler_,
+        user_parameters,
+        filenames);
+    }
     onSequenceUpdated();
     user_excluded_points_.clear();
     user_included_points_.clear();
@@ -79,14 +84,17 @@ namespace SmartPeak
 
   void CalibratorsPlotWidget::recomputeOptimizeCalibration()
   {
-    OptimizeCalibration optimize_calibration;
-    Filenames filenames; // optimize_calibration actually does not use it
-    ParameterSet& user_parameters = sequence_handler_.getSequence().at(0).getRawData().getParameters();
-    optimize_calibration.process(
-      sequence_handler_.getSequenceSegments().at(selected_sequence_segment_),
-      sequence_handler_,
-      user_parameters,
-      filenames);
+    {
+      auto data_lock = data_preparation_pool_.lockData();
+      OptimizeCalibration optimize_calibration;
+      Filenames filenames; // optimize_calibration actually does not use it
+      ParameterSet& user_parameters = sequence_handler_.getSequence().at(0).getRawData().getParameters();
+      optimize_calibration.process(
+        sequence_handler_.getSequenceSegments().at(selected_sequence_segment_),
+        sequence_handler_,
+        user_parameters,
+        filenames);
+    }
     onSequenceUpdated();
   }
 
@@ -268,7 +276,7 @@ namespace SmartPeak
         {
           FitCalibration fit_calibration;
           auto fit_calibration_params_schema = fit_calibration.getParameterSchema();
-          auto user_params = sequence_handler_.getSequence().at(0).getRawData().getParameters();
+          auto user_params = std::as_const(sequence_handler_).getSequence().at(0).getRawData().getParameters();
           fit_calibration_params_schema.setAsSchema(true);
           user_params.merge(fit_calibration_params_schema);
           for (auto& fit_calibration_fct : fit_calibration_params_schema)
@@ -296,7 +304,7 @@ namespace SmartPeak
         {
           OptimizeCalibration optimize_calibration;
           auto optimize_calibration_params_schema = optimize_calibration.getParameterSchema();
-          auto user_params = sequence_handler_.getSequence().at(0).getRawData().getParameters();
+          auto user_params = std::as_const(sequence_handler_).getSequence().at(0).getRawData().getParameters();
           optimize_calibration_params_schema.setAsSchema(true);
           user_params.merge(optimize_calibration_params_schema);
           for (auto& optimize_calibration_fct : optimize_calibration_params_schema)
@@ -398,48 +406,51 @@ namespace SmartPeak
 
   void CalibratorsPlotWidget::onParameterSet(const std::string& function_parameter, const Parameter& parameter)
   {
-    // find back the parameter and set it    
-    // try to find in the quantitation methods parameters
-    auto quantitation_methods = getQuantitationMethod(calibration_data_.series_names[selected_component_]);
-    auto params = quantitation_methods->getTransformationModelParams();
-    OpenMS::Param new_params; // params iterator returns const parameters. so we need to reconstruct and set the whole list
-    for (auto & param_entry : params)
     {
-      OpenMS::Param::ParamEntry new_param_entry = param_entry;
-      if (param_entry.name == parameter.getName())
+      auto data_lock = data_preparation_pool_.lockData();
+      // find back the parameter and set it    
+      // try to find in the quantitation methods parameters
+      auto quantitation_methods = getQuantitationMethod(calibration_data_.series_names[selected_component_]);
+      auto params = quantitation_methods->getTransformationModelParams();
+      OpenMS::Param new_params; // params iterator returns const parameters. so we need to reconstruct and set the whole list
+      for (auto & param_entry : params)
       {
-        CastValue c;
-        auto value_as_string = parameter.getValueAsString();
-        // special case for x_weight and y_weight
-        if (value_as_string == "no weight")
-        {
-          value_as_string = "";
-        }
-        Utilities::parseString(value_as_string, c);
-        // try some cast
-        if ((c.getTag() == CastValue::Type::INT) && (parameter.getType() == std::string("float")))
-        {
-          new_param_entry.value = static_cast<float>(c.i_);
-        }
-        else
+        OpenMS::Param::ParamEntry new_param_entry = param_entry;
+        if (param_entry.name == parameter.getName())
         {
-          new_param_entry.value = value_as_string;
+          CastValue c;
+          auto value_as_string = parameter.getValueAsString();
+          // special case for x_weight and y_weight
+          if (value_as_string == "no weight")
+          {
+            value_as_string = "";
+          }
+          Utilities::parseString(value_as_string, c);
+          // try some cast
+          if ((c.getTag() == CastValue::Type::INT) && (parameter.getType() == std::string("float")))
+          {
+            new_param_entry.value = static_cast<float>(c.i_);
+          }
+          else
+          {
+            new_param_entry.value = value_as_string;
+          }
+          LOGD << "Set " << new_param_entry.name << " value to " << new_param_entry.value.toString();
         }
-        LOGD << "Set " << new_param_entry.name << " value to " << new_param_entry.value.toString();
+        new_params.setValue(new_param_entry.name, new_param_entry.value);
       }
-      new_params.setValue(new_param_entry.name, new_param_entry.value);
-    }
-    quantitation_methods->setTransformationModelParams(new_params);
+      quantitation_methods->setTransformationModelParams(new_params);
 
-    // try to find in the user parameters
-    ParameterSet& user_parameters = sequence_handler_.getSequence().at(0).getRawData().getParameters();
-    for (auto& user_param_functions : user_parameters)
-    {
-      for (auto& user_param : user_param_functions.second)
+      // try to find in the user parameters
+      ParameterSet& user_parameters = sequence_handler_.getSequence().at(0).getRawData().getParameters();
+      for (auto& user_param_functions : user_parameters)
       {
-        if (user_param.getName() == parameter.getName())
+        for (auto& user_param : user_param_functions.second)
         {
-          user_param.setValueFromString(parameter.getValueAsString(), false);
+          if (user_param.getName() == parameter.getName())
+          {
+            user_param.setValueFromString(parameter.getValueAsString(), false);
+          }
         }
       }
     }
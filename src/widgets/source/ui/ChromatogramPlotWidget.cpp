@@ -22,22 +22,31 @@
 // --------------------------------------------------------------------------
 
 #include <SmartPeak/ui/ChromatogramPlotWidget.h>
+#include <limits>
 
 namespace SmartPeak
 {
   void ChromatogramPlotWidget::updateData()
   {
-    const std::set<std::string> sample_names = getSelectedSampleNames();
-    const std::set<std::string> component_names = getSelectedTransitions();
+    const size_t selection_version = session_handler_.getSampleNamesPlotSelection().getVersion() + session_handler_.getTransitionsPlotSelection().getVersion();
 
-    if ((refresh_needed_) || // data changed
-       ((input_component_names_ != component_names) || (input_sample_names_ != sample_names))) // user select different items
+    const bool selection_changed = (refresh_needed_) || // data changed
+       (selection_version != input_selection_version_); // user select different items
+    if (selection_changed || isPlotViewportChanged()) // or zoomed, get the points displayed at the current resolution
     {
+      const std::set<std::string> sample_names = getSelectedSampleNames();
+      const std::set<std::string> component_names = getSelectedTransitions();
       // we may recompute the RT window, get the whole graph area
-      session_handler_.getChromatogramScatterPlot(sequence_handler_, graph_viz_data_, std::make_pair(0, 1800), sample_names, component_names);
-      updateRanges();
-      input_sample_names_ = sample_names;
-      input_component_names_ = component_names;
+      requestData([&session_handler = session_handler_, &sequence_handler = sequence_handler_,
+                   sample_names, component_names, viewport = getPlotViewport(selection_changed)](SessionHandler::GraphVizData& graph_viz_data) {
+        session_handler.getChromatogramScatterPlot(sequence_handler,
+                                                   graph_viz_data,
+                                                   std::make_pair(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max()),
+                                                   sample_names,
+                                                   component_names,
+                                                   viewport);
+      }, selection_changed);
+      input_selection_version_ = selection_version;
       refresh_needed_ = false;
     }
   };
@@ -23,6 +23,7 @@
 
 #include <SmartPeak/ui/ChromatogramTICPlotWidget.h>
 #include <implot.h>
+#include <limits>
 
 namespace SmartPeak
 {
@@ -35,15 +36,23 @@ namespace SmartPeak
       marker_position_ = getNearestPoint(rt);
     }
 
-    const std::set<std::string> sample_names = getSelectedSampleNames();
+    const size_t selection_version = session_handler_.getSampleNamesPlotSelection().getVersion();
 
-    if ((refresh_needed_) || // data changed
-       (input_sample_names_ != sample_names)) // user select different items
+    const bool selection_changed = (refresh_needed_) || // data changed
+       (selection_version != input_selection_version_); // user select different items
+    if (selection_changed || isPlotViewportChanged()) // or zoomed, get the points displayed at the current resolution
     {
+      const std::set<std::string> sample_names = getSelectedSampleNames();
       // get the whole graph area
-      session_handler_.getChromatogramTIC(sequence_handler_, graph_viz_data_, std::make_pair(0, 1800), sample_names);
-      updateRanges();
-      input_sample_names_ = sample_names;
+      requestData([&session_handler = session_handler_, &sequence_handler = sequence_handler_,
+                   sample_names, viewport = getPlotViewport(selection_changed)](SessionHandler::GraphVizData& graph_viz_data) {
+        session_handler.getChromatogramTIC(sequence_handler,
+                                           graph_viz_data,
+                                           std::make_pair(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max()),
+                                           sample_names,
+                                           viewport);
+      }, selection_changed);
+      input_selection_version_ = selection_version;
       refresh_needed_ = false;
     }
     graph_viz_data_.y_min_ = 0.0f; // bottom line will start from 0.0
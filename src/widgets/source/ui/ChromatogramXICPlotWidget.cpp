@@ -36,18 +36,20 @@ namespace SmartPeak
       marker_position_ = getNearestPoint(rt);
     }
 
-    const std::set<std::string> sample_names = getSelectedSampleNames();
-    const std::set<std::string> transitions_names = getSelectedTransitions();
+    const size_t selection_version = session_handler_.getSampleNamesPlotSelection().getVersion() + session_handler_.getTransitionsPlotSelection().getVersion();
 
     if ((refresh_needed_) || // data changed
-       ((input_component_names_ != transitions_names) || (input_sample_names_ != sample_names))) // user select different items
+       (selection_version != input_selection_version_)) // user select different items
     {
+      const std::set<std::string> sample_names = getSelectedSampleNames();
+      const std::set<std::string> transitions_names = getSelectedTransitions();
       // we may recompute the RT window, get the whole graph area
-      session_handler_.getChromatogramXIC(sequence_handler_, graph_viz_data_, std::make_pair(0, 1800), sample_names, transitions_names, current_mz_);
-      updateRanges();
+      requestData([&session_handler = session_handler_, &sequence_handler = sequence_handler_,
+                   sample_names, transitions_names, mz = current_mz_](SessionHandler::GraphVizData& graph_viz_data) {
+        session_handler.getChromatogramXIC(sequence_handler, graph_viz_data, std::make_pair(0, 1800), sample_names, transitions_names, mz);
+      }, true);
       input_mz_ = current_mz_;
-      input_sample_names_ = sample_names;
-      input_component_names_ = transitions_names;
+      input_selection_version_ = selection_version;
       refresh_needed_ = false;
     }
     graph_viz_data_.y_min_ = 0.0f; // bottom line will start from 0.0
@@ -425,6 +425,8 @@ namespace SmartPeak
     bool& loading_is_done
   )
   {
+    // the loaded files may replace the data the views are being prepared from
+    auto data_lock = application_handler_->data_preparation_pool_->lockData();
     std::future<bool> f = std::async(
       std::launch::async, 
       [this, file_picker_handler, pathname](){ return file_picker_handler->onFilePicked(pathname, application_handler_); }
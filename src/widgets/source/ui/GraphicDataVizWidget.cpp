@@ -25,6 +25,7 @@
 #include <SmartPeak/ui/FilePicker.h>
 #include <imgui.h>
 #include <imgui_internal.h>
+#include <limits>
 
 namespace SmartPeak
 {
@@ -42,6 +43,12 @@ namespace SmartPeak
 
   void GraphicDataVizWidget::draw()
   {
+    // the data requested in the previous frames
+    if (data_preparation_.publish(graph_viz_data_) && fit_ranges_)
+    {
+      updateRanges();
+      fit_ranges_ = false;
+    }
     updateData();
     drawGraphHeader();
     drawGraph();
@@ -101,6 +108,10 @@ namespace SmartPeak
     {
       ImGui::Text("Unable to draw: too much points. Please reduce scope or unselect data.");
     }
+    else if (graph_viz_data_.x_data_area_.empty() && graph_viz_data_.y_data_area_.empty() && data_preparation_.isPending())
+    {
+      ImGui::Text("Preparing the data to display...");
+    }
     else if (graph_viz_data_.x_data_area_.empty() && graph_viz_data_.y_data_area_.empty())
     {
       ImGui::Text("No data to display select data to render or adjust ranges.");
@@ -129,6 +140,10 @@ namespace SmartPeak
       plotFlags |= ImPlotFlags_Crosshairs;
       float graphic_height = window_size.y;
       if (ImPlot::BeginPlot(plot_title_.c_str(), graph_viz_data_.x_axis_title_.c_str(), graph_viz_data_.y_axis_title_.c_str(), ImVec2(window_size.x - 25, graphic_height - 85), plotFlags)) {
+        const auto displayed_limits = ImPlot::GetPlotLimits();
+        plot_viewport_.x_min = static_cast<float>(displayed_limits.X.Min);
+        plot_viewport_.x_max = static_cast<float>(displayed_limits.X.Max);
+        plot_viewport_.pixel_width = static_cast<int>(window_size.x - 25);
         int i = 0;
         for (const auto& serie_name_scatter : graph_viz_data_.series_names_area_)
         {
@@ -223,7 +238,43 @@ namespace SmartPeak
     }
   }
 
-  std::optional<float> GraphicDataVizWidget::getMarkerPosition() const
+  SessionHandler::PlotViewport GraphicDataVizWidget::getPlotViewport(bool whole_plot)
+  {
+    SessionHandler::PlotViewport viewport;
+    viewport.pixel_width = plot_viewport_.pixel_width;
+    if (!whole_plot && plot_viewport_.x_max > plot_viewport_.x_min)
+    {
+      viewport.x_min = plot_viewport_.x_min;
+      viewport.x_max = plot_viewport_.x_max;
+    }
+    input_plot_viewport_ = viewport;
+    return viewport;
+  }
+
+  bool GraphicDataVizWidget::isPlotViewportChanged() const
+  {
+    if (!input_plot_viewport_ || data_preparation_.isPending())
+    {
+      return false;
+    }
+    // the data were requested for the whole plot, before the limits were fitted: request the visible part
+    const bool whole_plot = (input_plot_viewport_->x_max == std::numeric_limits<float>::max());
+    return (input_plot_viewport_->pixel_width != plot_viewport_.pixel_width)
+      || (plot_viewport_.x_max > plot_viewport_.x_min && (whole_plot 
+        || input_plot_viewport_->x_min != plot_viewport_.x_min
+        || input_plot_viewport_->x_max != plot_viewport_.x_max));
+  }
+
+  void GraphicDataVizWidget::requestData(std::function<void(SessionHandler::GraphVizData&)> prepare, bool fit_ranges)
+  {
+    data_preparation_.submit([prepare = std::move(prepare)](SessionHandler::GraphVizData& graph_viz_data) {
+      graph_viz_data = SessionHandler::GraphVizData(); // the buffer holds an older graph
+      prepare(graph_viz_data);
+    });
+    fit_ranges_ = fit_ranges_ || fit_ranges;
+  }
+
+    std::optional<float> GraphicDataVizWidget::getMarkerPosition() const
   {
     return marker_position_;
   }
@@ -235,35 +286,20 @@ namespace SmartPeak
 
   std::set<std::string> GraphicDataVizWidget::getSelectedSampleNames() const
   {
-    std::set<std::string> sample_names;
-    Eigen::Tensor<std::string, 1> selected_sample_names = session_handler_.getSelectSampleNamesPlot();
-    for (int i = 0; i < selected_sample_names.size(); ++i) {
-      if (!selected_sample_names(i).empty())
-        sample_names.insert(selected_sample_names(i));
-    }
-    return sample_names;
+    const std::vector<std::string> selected_sample_names = session_handler_.getSampleNamesPlotSelection().getSelectedNames();
+    return std::set<std::string>(selected_sample_names.begin(), selected_sample_names.end());
   }
 
   std::set<std::string> GraphicDataVizWidget::getSelectedTransitions() const
   {
-    std::set<std::string> transitions_names;
-    Eigen::Tensor<std::string, 1> selected_transitions = session_handler_.getSelectTransitionsPlot();
-    for (int i = 0; i < selected_transitions.size(); ++i) {
-      if (!selected_transitions(i).empty())
-        transitions_names.insert(selected_transitions(i));
-    }
-    return transitions_names;
+    const std::vector<std::string> selected_transitions = session_handler_.getTransitionsPlotSelection().getSelectedNames();
+    return std::set<std::string>(selected_transitions.begin(), selected_transitions.end());
   }
 
   std::set<std::string> GraphicDataVizWidget::getSelectedTransitionGroups() const
   {
-    std::set<std::string> component_group_names;
-    Eigen::Tensor<std::string, 1> selected_transition_groups = session_handler_.getSelectTransitionGroupsPlot();
-    for (int i = 0; i < selected_transition_groups.size(); ++i) {
-      if (!selected_transition_groups(i).empty())
-        component_group_names.insert(selected_transition_groups(i));
-    }
-    return component_group_names;
+    const std::vector<std::string> selected_transition_groups = session_handler_.getTransitionGroupsPlotSelection().getSelectedNames();
+    return std::set<std::string>(selected_transition_groups.begin(), selected_transition_groups.end());
   }
 
   std::optional<float> GraphicDataVizWidget::getNearestPoint(float in_x) const
@@ -89,16 +89,38 @@ namespace SmartPeak
       }
       ImGui::Spacing();
       // Check if we need to refresh the data
-      Eigen::Tensor<std::string, 1> selected_sample_names = session_handler_.getSelectSampleNamesPlot();
-      Eigen::Tensor<std::string, 1> selected_transitions = session_handler_.getSelectTransitionsPlot();
-      Eigen::Tensor<std::string, 1> selected_transition_groups = session_handler_.getSelectTransitionGroupsPlot();
+      const size_t selection_version = session_handler_.getPlotSelectionVersion();
       if ((refresh_needed_) || // data changed
-          (selected_feature_ != heatmap_data_.selected_feature_) ||
-          !compareInput(selected_sample_names, heatmap_data_.selected_sample_names_) ||
-          !compareInput(selected_transitions, heatmap_data_.selected_transitions_) ||
-          !compareInput(selected_transition_groups, heatmap_data_.selected_transition_groups_))
+          (selected_feature_ != input_feature_) ||
+          (selection_version != input_selection_version_))
+      {
+        // the selection is read here, the heatmap is made on a worker thread
+        const std::vector<std::string> selected_sample_names = session_handler_.getSampleNamesPlotSelection().getSelectedNames();
+        const std::vector<std::string> selected_transitions = session_handler_.getTransitionsPlotSelection().getSelectedNames();
+        const std::vector<std::string> selected_transition_groups = session_handler_.getTransitionGroupsPlotSelection().getSelectedNames();
+        data_preparation_.submit([&session_handler = session_handler_, &sequence_handler = sequence_handler_,
+                                  feature_name = selected_feature_,
+                                  sample_names = std::set<std::string>(selected_sample_names.begin(), selected_sample_names.end()),
+                                  component_names = std::set<std::string>(selected_transitions.begin(), selected_transitions.end()),
+                                  component_group_names = std::set<std::string>(selected_transition_groups.begin(), selected_transition_groups.end()),
+                                  sample_names_plot = session_handler_.getSelectSampleNamesPlot(),
+                                  transitions_plot = session_handler_.getSelectTransitionsPlot(),
+                                  transition_groups_plot = session_handler_.getSelectTransitionGroupsPlot(),
+                                  selection_version](SessionHandler::HeatMapData& heatmap_data) {
+          heatmap_data = SessionHandler::HeatMapData(); // the buffer holds an older heatmap
+          session_handler.getHeatMap(sequence_handler, heatmap_data, feature_name, sample_names, component_names, component_group_names);
+          heatmap_data.selected_sample_names_ = sample_names_plot;
+          heatmap_data.selected_transitions_ = transitions_plot;
+          heatmap_data.selected_transition_groups_ = transition_groups_plot;
+          heatmap_data.selection_version_ = selection_version;
+        });
+        input_feature_ = selected_feature_;
+        input_selection_version_ = selection_version;
+        refresh_needed_ = false;
+      }
+      // the heatmap requested in the previous frames
+      if (data_preparation_.publish(heatmap_data_))
       {
-        session_handler_.getHeatMap(sequence_handler_, heatmap_data_, selected_feature_);
         // We need to handle "invalid" data - infinite values, or very high - which will crash ImPlot.
         invalid_data_ = false;
         for (int i = 0; i < heatmap_data_.feat_heatmap_row_labels.size(); ++i)
@@ -121,7 +143,6 @@ namespace SmartPeak
         {
           LOGE << "Labels and Data mismatch. Cannot display Heatmap.";
         }
-        refresh_needed_ = false;
       }
       
       if (invalid_data_)
@@ -208,25 +229,6 @@ namespace SmartPeak
     }
   }
 
-  bool Heatmap2DWidget::compareInput(const Eigen::Tensor<std::string, 1>& l, const Eigen::Tensor<std::string, 1>& r) const
-  {
-    if (l.size() != r.size())
-    {
-      return false;
-    }
-    else
-    {
-      for (int i = 0 ; i < l.size(); ++i)
-      {
-        if (l(i) != r(i))
-        {
-          return false;
-        }
-      }
-      return true;
-    }
-  }
-
   void Heatmap2DWidget::onSequenceUpdated()
   {
     refresh_needed_ = true;
@@ -22,6 +22,7 @@
 // --------------------------------------------------------------------------
 
 #include <SmartPeak/ui/ImEntry.h>
+#include <cctype>
 
 namespace SmartPeak
 {
@@ -37,21 +38,16 @@ namespace SmartPeak
     
   int ImEntry::lexicographical_sort(const char* lhs, const char* rhs)
   {
-    std::string lhs_str(lhs), rhs_str(rhs);
-    std::string lhs_str_lowercased(lhs_str.length(),' ');
-    std::string rhs_str_lowercased(rhs_str.length(),' ');
-    std::transform(lhs_str.begin(), lhs_str.end(), lhs_str_lowercased.begin(), tolower);
-    std::transform(rhs_str.begin(), rhs_str.end(), rhs_str_lowercased.begin(), tolower);
-    lhs = lhs_str_lowercased.c_str();
-    rhs = rhs_str_lowercased.c_str();
-      
+    // case insensitive, the characters are lowercased as they are compared to avoid copying the strings
+    auto lowercase = [](const char ch) { return static_cast<char>(std::tolower(static_cast<unsigned char>(ch))); };
+
     enum SearchMode { STRING, NUMBER } search_mode = STRING;
     while (*lhs && *rhs)
     {
       if (search_mode == STRING)
       {
         char lhs_char, rhs_char;
-        while ((lhs_char = *lhs) && (rhs_char = *rhs))
+        while ((lhs_char = lowercase(*lhs)) && (rhs_char = lowercase(*rhs)))
         {
           const bool lhs_digit = is_digit(lhs_char), rhs_digit = is_digit(rhs_char);
           if (lhs_digit && rhs_digit)
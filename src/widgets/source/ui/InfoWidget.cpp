@@ -28,6 +28,7 @@
 #include <SmartPeak/core/SharedProcessors.h>
 #include <implot.h>
 #include <math.h>
+#include <utility>
 
 namespace SmartPeak
 {
@@ -71,7 +72,7 @@ namespace SmartPeak
       number_of_chromatograms_ = 0;
       if (application_handler_.sequenceHandler_.getSequence().size() > 0)
       {
-        number_of_chromatograms_ = application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getChromatogramMap().getChromatograms().size();
+        number_of_chromatograms_ = std::as_const(application_handler_.sequenceHandler_).getSequence().at(0).getRawData().getChromatogramMap().getChromatograms().size();
       }
     }
     os << "Number of chromatograms: " << number_of_chromatograms_;
@@ -86,7 +87,7 @@ namespace SmartPeak
       number_of_spectrums_ = 0;
       if (application_handler_.sequenceHandler_.getSequence().size() > 0)
       {
-        number_of_spectrums_ = application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getExperiment().getSpectra().size();
+        number_of_spectrums_ = std::as_const(application_handler_.sequenceHandler_).getSequence().at(0).getRawData().getExperiment().getSpectra().size();
       }
     }
     os << "Number of spectrums: " << number_of_spectrums_;
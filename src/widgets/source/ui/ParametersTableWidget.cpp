@@ -61,27 +61,38 @@ namespace SmartPeak
 
   void ParametersTableWidget::onParameterSet(const std::string& function_parameter, const Parameter& parameter)
   {
-    ParameterSet& user_parameters = application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getParameters();
-    Parameter* existing_parameter = user_parameters.findParameter(function_parameter, parameter.getName());
-    if (existing_parameter)
     {
-      existing_parameter->setValueFromString(parameter.getValueAsString(), false);
-    }
-    else
-    {
-      Parameter new_param = parameter;
-      new_param.setAsSchema(false);
-      user_parameters.addParameter(function_parameter, new_param);
+      auto data_lock = application_handler_.data_preparation_pool_->lockData();
+      ParameterSet& user_parameters = application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getParameters();
+      Parameter* existing_parameter = user_parameters.findParameter(function_parameter, parameter.getName());
+      if (existing_parameter)
+      {
+        existing_parameter->setValueFromString(parameter.getValueAsString(), false);
+      }
+      else
+      {
+        Parameter new_param = parameter;
+        new_param.setAsSchema(false);
+        user_parameters.addParameter(function_parameter, new_param);
+      }
     }
     application_handler_.sequenceHandler_.notifyParametersUpdated();
   }
 
   void ParametersTableWidget::onParameterRemoved(const std::string& function_parameter, const Parameter& parameter)
   {
-    ParameterSet& user_parameters = application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getParameters();
-    if (user_parameters.count(function_parameter) == 1)
+    bool removed = false;
+    {
+      auto data_lock = application_handler_.data_preparation_pool_->lockData();
+      ParameterSet& user_parameters = application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getParameters();
+      if (user_parameters.count(function_parameter) == 1)
+      {
+        user_parameters[function_parameter].removeParameter(parameter.getName());
+        removed = true;
+      }
+    }
+    if (removed)
     {
-      user_parameters[function_parameter].removeParameter(parameter.getName());
       application_handler_.sequenceHandler_.notifyParametersUpdated();
     }
   }
@@ -92,7 +103,7 @@ namespace SmartPeak
     is_scanned_ = false;
     if (application_handler_.sequenceHandler_.getSequence().size() > 0)
     {
-      parameters_ = application_handler_.sequenceHandler_.getSequence().at(0).getRawData().getParameters();
+      parameters_ = std::as_const(application_handler_.sequenceHandler_).getSequence().at(0).getRawData().getParameters();
       auto schema_params = application_handler_.getWorkflowParameterSchema();
       // Construct parameters merging schema and user defined
       parameters_.merge(schema_params);
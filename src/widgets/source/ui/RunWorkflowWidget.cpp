@@ -95,6 +95,13 @@ namespace SmartPeak
       static int number_of_threads = std::thread::hardware_concurrency();
       if (number_of_threads < 1) number_of_threads = 1;
       ImGui::InputInt("Number of Threads", &number_of_threads);
+      static int memory_budget = 0;
+      ImGui::InputInt("Raw Data Memory Budget (MB)", &memory_budget);
+      if (memory_budget < 0) memory_budget = 0;
+      if (ImGui::IsItemHovered())
+      {
+        ImGui::SetTooltip("Raw MS data above the budget are spilled to disk and loaded back when needed. 0 means no budget.");
+      }
 
       ImGui::Separator();
       ImGui::Checkbox("Run on Server", &run_on_server);
@@ -144,6 +151,7 @@ namespace SmartPeak
             const std::set<std::string> injection_names = session_handler_.getSelectInjectionNamesWorkflow(application_handler_.sequenceHandler_);
             const std::set<std::string> sequence_segment_names = session_handler_.getSelectSequenceSegmentNamesWorkflow(application_handler_.sequenceHandler_);
             const std::set<std::string> sample_group_names = session_handler_.getSelectSampleGroupNamesWorkflow(application_handler_.sequenceHandler_);
+            application_handler_.raw_data_residency_options_.memory_budget_mb = memory_budget;
             workflow_manager_.addWorkflow(application_handler_,
               injection_names,
               sequence_segment_names,
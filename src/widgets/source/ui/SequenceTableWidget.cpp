@@ -61,10 +61,13 @@ namespace SmartPeak
       sequence_segment_editor_.open(getSequenceGroups(sequence_segment_col), injection->getMetaData().getSequenceSegmentName(), 
         [this](const std::string& sequence_segment_name)
       {
-        for (const auto selected_cell : selected_cells_)
         {
-          auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
-          injection->getMetaData().setSequenceSegmentName(sequence_segment_name);
+          auto data_lock = data_preparation_pool_.lockData();
+          for (const auto selected_cell : selected_cells_)
+          {
+            auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
+            injection->getMetaData().setSequenceSegmentName(sequence_segment_name);
+          }
         }
         sequence_handler_->notifySequenceUpdated();
       });
@@ -74,10 +77,13 @@ namespace SmartPeak
       sample_group_editor_.open(getSequenceGroups(sample_group_col), injection->getMetaData().getSampleGroupName(), 
         [this](const std::string& sample_group_name)
       {
-        for (const auto selected_cell : selected_cells_)
         {
-          auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
-          injection->getMetaData().setSampleGroupName(sample_group_name);
+          auto data_lock = data_preparation_pool_.lockData();
+          for (const auto selected_cell : selected_cells_)
+          {
+            auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
+            injection->getMetaData().setSampleGroupName(sample_group_name);
+          }
         }
         sequence_handler_->notifySequenceUpdated();
       });
@@ -87,10 +93,13 @@ namespace SmartPeak
       replicate_group_name_editor_.open(getSequenceGroups(replicate_group_name_col), injection->getMetaData().getReplicateGroupName(),
         [this](const std::string& replicate_group_name)
       {
-        for (const auto selected_cell : selected_cells_)
         {
-          auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
-          injection->getMetaData().setReplicateGroupName(replicate_group_name);
+          auto data_lock = data_preparation_pool_.lockData();
+          for (const auto selected_cell : selected_cells_)
+          {
+            auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
+            injection->getMetaData().setReplicateGroupName(replicate_group_name);
+          }
         }
         sequence_handler_->notifySequenceUpdated();
       });
@@ -103,11 +112,14 @@ namespace SmartPeak
         if (stringToSampleType.find(sample_type_name) != stringToSampleType.end())
         {
           const auto sample_type = stringToSampleType.at(sample_type_name);
-          for (const auto selected_cell : selected_cells_)
           {
-            auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
-            injection->getMetaData().setSampleType(sample_type);
-          }          
+            auto data_lock = data_preparation_pool_.lockData();
+            for (const auto selected_cell : selected_cells_)
+            {
+              auto injection = getInjectionFromTable(std::get<0>(selected_cell), std::get<1>(selected_cell));
+              injection->getMetaData().setSampleType(sample_type);
+            }
+          }
           sequence_handler_->notifySequenceUpdated();
         }
       });
@@ -349,6 +349,8 @@ namespace SmartPeak
       filenames.addFileName(fef.first, path);
       filenames.setEmbedded(fef.first, fef.second.embedded_);
     }
+    // the session is reloaded, replacing the data the views are being prepared from
+    auto data_lock = application_handler_.data_preparation_pool_->lockData();
     application_handler_.closeSession();
     application_handler_.filenames_ = filenames;
     application_handler_.main_dir_ = filenames_.getTagValue(Filenames::Tag::MAIN_DIR);
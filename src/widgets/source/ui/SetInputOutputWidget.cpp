@@ -147,6 +147,8 @@ namespace SmartPeak
     filenames_->setTagValue(Filenames::Tag::FEATURES_OUTPUT_PATH, features_out_dir_edit_);
     if (observer_)
     {
+      // the session may be reloaded, replacing the data the views are being prepared from
+      auto data_lock = application_handler_.data_preparation_pool_->lockData();
       observer_->onInputOutputSet();
     }
   }
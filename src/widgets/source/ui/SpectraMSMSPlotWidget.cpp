@@ -46,26 +46,28 @@ namespace SmartPeak
       marker_position_ = getNearestPoint(mz);
     }
 
-    const std::set<std::string> sample_names = getSelectedSampleNames();    
-    const std::set<std::string> component_group_names = getSelectedTransitionGroups();
+    const size_t selection_version = session_handler_.getSampleNamesPlotSelection().getVersion() + session_handler_.getTransitionGroupsPlotSelection().getVersion();
 
     static const auto init_range = std::make_pair(0, 2000);
     if ((refresh_needed_) || // data changed
-       ((input_sample_names_ != sample_names) || (input_component_group_names_ != component_group_names)) // user select different items
+       (selection_version != input_selection_version_) // user select different items
        ) 
     {
+      const std::set<std::string> sample_names = getSelectedSampleNames();
+      const std::set<std::string> component_group_names = getSelectedTransitionGroups();
       // get the whole graph area
-      session_handler_.getSpectrumMSMSPlot(sequence_handler_, 
-                                           graph_viz_data_, 
-                                           init_range, 
-                                           sample_names, 
-                                           component_group_names, 
-                                           current_rt_, 
-                                           ms_level_,
-                                           has_convex_hull_);
-      updateRanges();
-      input_sample_names_ = sample_names;
-      input_component_group_names_ = component_group_names;
+      requestData([&session_handler = session_handler_, &sequence_handler = sequence_handler_,
+                   sample_names, component_group_names, rt = current_rt_, ms_level = ms_level_, has_convex_hull = has_convex_hull_](SessionHandler::GraphVizData& graph_viz_data) {
+        session_handler.getSpectrumMSMSPlot(sequence_handler, 
+                                            graph_viz_data, 
+                                            init_range, 
+                                            sample_names, 
+                                            component_group_names, 
+                                            rt, 
+                                            ms_level,
+                                            has_convex_hull);
+      }, true);
+      input_selection_version_ = selection_version;
       refresh_needed_ = false;
     }
     graph_viz_data_.y_min_ = 0.0f; // bottom line will start from 0.0
@@ -22,23 +22,32 @@
 // --------------------------------------------------------------------------
 
 #include <SmartPeak/ui/SpectraPlotWidget.h>
+#include <limits>
 
 namespace SmartPeak
 {
 
   void SpectraPlotWidget::updateData()
   {
-    const std::set<std::string> sample_names = getSelectedSampleNames();
-    const std::set<std::string> component_group_names = getSelectedTransitionGroups();
+    const size_t selection_version = session_handler_.getSampleNamesPlotSelection().getVersion() + session_handler_.getTransitionGroupsPlotSelection().getVersion();
 
-    if ((refresh_needed_) || // data changed
-       ((input_sample_names_ != sample_names) || (input_component_group_names_ != component_group_names))) // user select different items
+    const bool selection_changed = (refresh_needed_) || // data changed
+       (selection_version != input_selection_version_); // user select different items
+    if (selection_changed || isPlotViewportChanged()) // or zoomed, get the points displayed at the current resolution
     {
+      const std::set<std::string> sample_names = getSelectedSampleNames();
+      const std::set<std::string> component_group_names = getSelectedTransitionGroups();
       // get the whole graph area
-      session_handler_.getSpectrumScatterPlot(sequence_handler_, graph_viz_data_, std::make_pair(0, 2000), sample_names, component_group_names);
-      updateRanges();
-      input_sample_names_ = sample_names;
-      input_component_group_names_ = component_group_names;
+      requestData([&session_handler = session_handler_, &sequence_handler = sequence_handler_,
+                   sample_names, component_group_names, viewport = getPlotViewport(selection_changed)](SessionHandler::GraphVizData& graph_viz_data) {
+        session_handler.getSpectrumScatterPlot(sequence_handler,
+                                               graph_viz_data,
+                                               std::make_pair(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max()),
+                                               sample_names,
+                                               component_group_names,
+                                               viewport);
+      }, selection_changed);
+      input_selection_version_ = selection_version;
       refresh_needed_ = false;
     }
   };
@@ -32,7 +32,24 @@ namespace SmartPeak
 {
   void StatisticsWidget::draw()
   {
+    if (ImGui::BeginTabBar("StatisticsTabs"))
+    {
+      if (ImGui::BeginTabItem("Features"))
+      {
+        drawFeaturesCharts();
+        ImGui::EndTabItem();
+      }
+      if (ImGui::BeginTabItem("Processors"))
+      {
+        drawProcessorProfile();
+        ImGui::EndTabItem();
+      }
+      ImGui::EndTabBar();
+    }
+  }
 
+  void StatisticsWidget::drawFeaturesCharts()
+  {
     if (!transitions_)
     {
       return;
@@ -179,7 +196,8 @@ namespace SmartPeak
     }
 
     auto window_size = ImGui::GetWindowSize();
-    if (ImPlot::BeginPlot(title, x_label, y_label, ImVec2((window_size .x/2.0f) - 10, window_size.y - 40), ImPlotFlags_Default & ~ImPlotFlags_Legend & ~ImPlotFlags_MousePos, ImPlotAxisFlags_GridLines | ImPlotAxisFlags_TickMarks)) {
+    const float plot_height = ImGui::GetContentRegionAvail().y - 10;
+    if (ImPlot::BeginPlot(title, x_label, y_label, ImVec2((window_size .x/2.0f) - 10, plot_height), ImPlotFlags_Default & ~ImPlotFlags_Legend & ~ImPlotFlags_MousePos, ImPlotAxisFlags_GridLines | ImPlotAxisFlags_TickMarks)) {
       if (chart_data.values_.size() > 0)
       {
         ImPlot::PlotBars("Unselected", &chart_data.unselected_values_.front(), chart_data.unselected_values_.size());
@@ -217,6 +235,77 @@ namespace SmartPeak
     }
   }
 
+  void StatisticsWidget::drawProcessorProfile()
+  {
+    const auto& processor_profiler = application_handler_.processor_profiler_;
+    if (!processor_profiler)
+    {
+      return;
+    }
+    // the records are appended by the workflow threads, summaries are only rebuilt when new ones came
+    const size_t records_count = processor_profiler->size();
+    if (records_count != processor_records_count_)
+    {
+      processor_summaries_ = processor_profiler->getSummaries();
+      processor_records_count_ = records_count;
+    }
+
+    if (ImGui::Button("Clear"))
+    {
+      processor_profiler->clear();
+      processor_summaries_.clear();
+      processor_records_count_ = 0;
+    }
+    ImGui::SameLine();
+    ImGui::Text("%zu processor runs", processor_records_count_);
+
+    if (processor_summaries_.empty())
+    {
+      ImGui::Text("No processor has been run yet.");
+      return;
+    }
+
+    static const std::vector<std::string> headers =
+    {
+      "Processor", "Runs", "Total (ms)", "Mean (ms)", "p50 (ms)", "p90 (ms)", "p99 (ms)", "Max (ms)",
+      "CPU total (ms)", "CPU p90 (ms)", "Max RSS delta (KB)", "Peak RSS (KB)", "Items"
+    };
+    const ImGuiTableFlags table_flags = ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+      ImGuiTableFlags_ScrollY | ImGuiTableFlags_NoSavedSettings;
+    if (ImGui::BeginTable("Processor Profile Table", headers.size(), table_flags))
+    {
+      for (const auto& header : headers)
+      {
+        ImGui::TableSetupColumn(header.c_str());
+      }
+      ImGui::TableHeadersRow();
+      for (const auto& summary : processor_summaries_)
+      {
+        ImGui::TableNextRow();
+        int column = 0;
+        ImGui::TableSetColumnIndex(column++);
+        ImGui::Text("%s", summary.processor_name.c_str());
+        ImGui::TableSetColumnIndex(column++);
+        ImGui::Text("%zu", summary.count);
+        for (const double value : {
+          summary.wall_time_ms.total, summary.wall_time_ms.mean, summary.wall_time_ms.p50,
+          summary.wall_time_ms.p90, summary.wall_time_ms.p99, summary.wall_time_ms.max,
+          summary.cpu_time_ms.total, summary.cpu_time_ms.p90 })
+        {
+          ImGui::TableSetColumnIndex(column++);
+          ImGui::Text("%.1f", value);
+        }
+        ImGui::TableSetColumnIndex(column++);
+        ImGui::Text("%ld", summary.max_rss_delta_kb);
+        ImGui::TableSetColumnIndex(column++);
+        ImGui::Text("%ld", summary.peak_rss_kb);
+        ImGui::TableSetColumnIndex(column++);
+        ImGui::Text("%zu", summary.total_item_count);
+      }
+      ImGui::EndTable();
+    }
+  }
+
   void StatisticsWidget::onSequenceUpdated()
   {
     refresh_needed_ = true;
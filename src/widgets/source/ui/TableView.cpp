@@ -0,0 +1,259 @@
+// --------------------------------------------------------------------------
+//   SmartPeak -- Fast and Accurate CE-, GC- and LC-MS(/MS) Data Processing
+// --------------------------------------------------------------------------
+// Copyright The SmartPeak Team -- Novo Nordisk Foundation 
+// Center for Biosustainability, Technical University of Denmark 2018-2022.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Douglas McCloskey, Bertrand Boudaud $
+// $Authors: Bertrand Boudaud $
+// --------------------------------------------------------------------------
+
+#include <SmartPeak/ui/TableView.h>
+#include <SmartPeak/ui/ImEntry.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+
+namespace SmartPeak
+{
+  namespace
+  {
+    // NaN (empty cells) after the numbers
+    bool lessKey(const double lhs, const double rhs)
+    {
+      if (std::isnan(lhs)) return false;
+      if (std::isnan(rhs)) return true;
+      return lhs < rhs;
+    }
+
+    bool parseNumber(const std::string& text, double& number)
+    {
+      const char* begin = text.c_str();
+      char* end = nullptr;
+      number = std::strtod(begin, &end);
+      if (end == begin)
+      {
+        return false;
+      }
+      while (*end == ' ') ++end;
+      return *end == '\0';
+    }
+  }
+
+  size_t TableView::getNbColumns(const SessionHandler::GenericTableData& table_data)
+  {
+    const bool has_values = (table_data.values_.dimension(0) == table_data.body_.dimension(0));
+    return table_data.body_.dimension(1) + (has_values ? table_data.values_.dimension(1) : 0);
+  }
+
+  std::string TableView::getCellText(const SessionHandler::GenericTableData& table_data, const size_t row, const size_t col)
+  {
+    const size_t n_body_cols = table_data.body_.dimension(1);
+    if (col < n_body_cols)
+    {
+      return table_data.body_(row, col);
+    }
+    if (col < getNbColumns(table_data))
+    {
+      return std::to_string(table_data.values_(row, col - n_body_cols));
+    }
+    return "";
+  }
+
+  bool TableView::passFilter(const SessionHandler::GenericTableData& table_data, const ImGuiTextFilter& filter, const size_t row) const
+  {
+    const size_t n_body_cols = table_data.body_.dimension(1);
+    auto pass_cell = [&](const size_t col) {
+      if (col < n_body_cols)
+      {
+        const std::string& text = table_data.body_(row, col);
+        return filter.PassFilter(text.c_str(), text.c_str() + text.size());
+      }
+      const std::string text = getCellText(table_data, row, col);
+      return filter.PassFilter(text.c_str(), text.c_str() + text.size());
+    };
+    if (filter_column_ >= 0)
+    {
+      return pass_cell(static_cast<size_t>(filter_column_));
+    }
+    const size_t n_cols = getNbColumns(table_data);
+    for (size_t col = 0; col < n_cols; ++col)
+    {
+      if (pass_cell(col))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool TableView::isNarrowing(const std::string& previous_filter_text, const std::string& filter_text)
+  {
+    // true if the rows passing filter_text pass previous_filter_text too: a single inclusive term getting longer
+    if (filter_text.size() <= previous_filter_text.size() || filter_text.compare(0, previous_filter_text.size(), previous_filter_text) != 0)
+    {
+      return false;
+    }
+    const auto first_char = filter_text.find_first_not_of(' ');
+    return filter_text.find(',') == std::string::npos && (first_char == std::string::npos || filter_text[first_char] != '-');
+  }
+
+  const std::vector<double>& TableView::getSortKeys(const SessionHandler::GenericTableData& table_data, const size_t col)
+  {
+    auto found = sort_keys_.find(col);
+    if (found != sort_keys_.end())
+    {
+      return found->second;
+    }
+    const size_t n_rows = table_data.body_.dimension(0);
+    std::vector<double> keys(n_rows, std::nan(""));
+    const size_t n_body_cols = table_data.body_.dimension(1);
+    if (col >= getNbColumns(table_data))
+    {
+      // no data, nothing to sort
+    }
+    else if (col >= n_body_cols)
+    {
+      for (size_t row = 0; row < n_rows; ++row)
+      {
+        keys[row] = table_data.values_(row, col - n_body_cols);
+      }
+    }
+    else
+    {
+      // numeric column if all its non empty cells are numbers
+      bool is_numeric = true;
+      for (size_t row = 0; row < n_rows && is_numeric; ++row)
+      {
+        const std::string& text = table_data.body_(row, col);
+        if (!text.empty())
+        {
+          is_numeric = parseNumber(text, keys[row]);
+        }
+      }
+      if (!is_numeric)
+      {
+        // rank of the cells in natural order, equal cells sharing the same rank
+        std::vector<size_t> order(n_rows);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&table_data, col](const size_t lhs, const size_t rhs) {
+          return ImEntry::lexicographical_sort(table_data.body_(lhs, col).c_str(), table_data.body_(rhs, col).c_str()) < 0;
+        });
+        double rank = 0.0;
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+          if (i > 0 && ImEntry::lexicographical_sort(table_data.body_(order[i - 1], col).c_str(), table_data.body_(order[i], col).c_str()) != 0)
+          {
+            rank += 1.0;
+          }
+          keys[order[i]] = rank;
+        }
+      }
+    }
+    return sort_keys_.emplace(col, std::move(keys)).first->second;
+  }
+
+  void TableView::sortRows(const SessionHandler::GenericTableData& table_data)
+  {
+    std::vector<std::pair<const std::vector<double>*, bool>> sort_keys;
+    for (const auto& sort_spec : sort_specs_)
+    {
+      sort_keys.emplace_back(&getSortKeys(table_data, sort_spec.column), sort_spec.ascending);
+    }
+    // ties are kept in the table order
+    std::sort(rows_.begin(), rows_.end(), [&sort_keys](const size_t lhs, const size_t rhs) {
+      for (const auto& [keys, ascending] : sort_keys)
+      {
+        const double lhs_key = (*keys)[lhs];
+        const double rhs_key = (*keys)[rhs];
+        if (lessKey(lhs_key, rhs_key)) return ascending;
+        if (lessKey(rhs_key, lhs_key)) return !ascending;
+      }
+      return lhs < rhs;
+    });
+  }
+
+  bool TableView::update(const SessionHandler::GenericTableData& table_data,
+                         const Eigen::Tensor<bool, 1>& checked_rows,
+                         const std::string& filter_text,
+                         const int filter_column,
+                         const std::vector<SortSpec>& sort_specs,
+                         const bool data_changed)
+  {
+    const size_t n_rows = table_data.body_.dimension(0);
+    const std::array<Eigen::Index, 4> dimensions = {
+      table_data.body_.dimension(0), table_data.body_.dimension(1), table_data.values_.dimension(0), table_data.values_.dimension(1) };
+    const bool table_changed = data_changed || !valid_ || dimensions != dimensions_
+      || body_storage_ != table_data.body_.data() || values_storage_ != table_data.values_.data();
+
+    std::vector<bool> checked(n_rows, true);
+    if (checked_rows.size() > 0)
+    {
+      for (size_t row = 0; row < n_rows; ++row)
+      {
+        checked[row] = (static_cast<Eigen::Index>(row) < checked_rows.size()) && checked_rows(row);
+      }
+    }
+    const bool checked_changed = (checked != checked_rows_);
+    const bool filter_changed = (filter_text != filter_text_ || filter_column != filter_column_);
+    const bool sort_changed = (sort_specs != sort_specs_);
+    if (!table_changed && !checked_changed && !filter_changed && !sort_changed)
+    {
+      return false;
+    }
+
+    const bool narrowing = !table_changed && !checked_changed && filter_column == filter_column_ && isNarrowing(filter_text_, filter_text);
+    if (table_changed)
+    {
+      valid_ = true;
+      dimensions_ = dimensions;
+      body_storage_ = table_data.body_.data();
+      values_storage_ = table_data.values_.data();
+      sort_keys_.clear();
+    }
+    checked_rows_ = std::move(checked);
+    filter_text_ = filter_text;
+    filter_column_ = filter_column;
+    sort_specs_ = sort_specs;
+
+    const ImGuiTextFilter filter(filter_text.c_str());
+    if (narrowing)
+    {
+      // the displayed rows are already sorted
+      rows_.erase(std::remove_if(rows_.begin(), rows_.end(), [&](const size_t row) { return !passFilter(table_data, filter, row); }), rows_.end());
+      if (sort_changed)
+      {
+        sortRows(table_data);
+      }
+      return true;
+    }
+    rows_.clear();
+    for (size_t row = 0; row < n_rows; ++row)
+    {
+      if (checked_rows_[row] && (!filter.IsActive() || passFilter(table_data, filter, row)))
+      {
+        rows_.push_back(row);
+      }
+    }
+    if (!sort_specs_.empty())
+    {
+      sortRows(table_data);
+    }
+    return true;
+  }
+}
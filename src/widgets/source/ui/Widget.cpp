@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <imgui.h>
@@ -84,19 +85,34 @@ namespace SmartPeak
     const Eigen::Tensor<std::string, 2>& columns,
     const Eigen::Tensor<bool, 2>& checkbox_columns)
   {
+    updateTableContents(Im_table_entries, is_scanned, columns, Eigen::Tensor<float, 2>(), checkbox_columns);
+  }
+
+  void GenericTableWidget::updateTableContents(std::vector<ImEntry>& Im_table_entries,
+    bool& is_scanned,
+    const Eigen::Tensor<std::string, 2>& columns,
+    const Eigen::Tensor<float, 2>& value_columns,
+    const Eigen::Tensor<bool, 2>& checkbox_columns)
+  {
+    const std::size_t n_columns = columns.dimension(1);
+    const std::size_t n_value_columns = (value_columns.dimension(0) == columns.dimension(0)) ? value_columns.dimension(1) : 0;
     Im_table_entries.resize(columns.dimension(0), ImEntry());
     if (!Im_table_entries.empty() && is_scanned == false) {
       for (size_t row = 0; row < columns.dimension(0); ++row) {
         ImEntry& Im_table_entry = Im_table_entries[row];
-        Im_table_entry.entry_contents.resize(columns.dimension(1) + checkbox_columns.dimension(1), "");
+        Im_table_entry.entry_contents.resize(n_columns + n_value_columns + checkbox_columns.dimension(1), "");
         Im_table_entry.ID = row;
-        for (size_t header_idx = 0; header_idx < columns.dimension(1) + checkbox_columns.dimension(1); ++header_idx) {
-          if (header_idx < columns.dimension(1)) {
+        for (size_t header_idx = 0; header_idx < n_columns + n_value_columns + checkbox_columns.dimension(1); ++header_idx) {
+          if (header_idx < n_columns) {
             Im_table_entry.entry_contents[header_idx] = columns(row, header_idx);
           }
-          else if (header_idx < columns.dimension(1) + checkbox_columns.dimension(1)) 
+          else if (header_idx < n_columns + n_value_columns)
+          {
+            Im_table_entry.entry_contents[header_idx] = std::to_string(value_columns(row, header_idx - n_columns));
+          }
+          else
           {
-            const std::size_t checkbox_idx = header_idx - static_cast<std::size_t>(columns.dimension(1));
+            const std::size_t checkbox_idx = header_idx - n_columns - n_value_columns;
             Im_table_entry.entry_contents[header_idx] = checkbox_columns(row, checkbox_idx) == true ? "true" : "false";
           }
         }
@@ -105,6 +121,12 @@ namespace SmartPeak
     }
   }
 
+  void GenericTableWidget::setTableData(const SessionHandler::GenericTableData& table_data)
+  {
+    table_data_ = table_data;
+    data_changed_ = true;
+  }
+
   void GenericTableWidget::sorter(std::vector<ImEntry>& Im_table_entries,
                                   ImGuiTableSortSpecs* sorts_specs, const bool& is_scanned)
   {
@@ -150,8 +172,7 @@ namespace SmartPeak
     static ImGuiTableColumnFlags column_0_flags = { ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_NoHide };
     static ImGuiTableColumnFlags column_any_flags = { ImGuiTableColumnFlags_NoHide };
 
-    static ImGuiTextFilter filter;
-    filter.Draw("Find");
+    table_filter_.Draw("Find");
 
     // drop-down list for search field(s)
     cols_.resize(table_data_.headers_.size() + 1);
@@ -168,31 +189,6 @@ namespace SmartPeak
 
     ImGui::Combo("In Column(s)", &selected_col_, cols_.data(), cols_.size());
 
-    table_scanned_ = (table_data_.body_.dimension(0) == table_entries_.size() && !data_changed_);
-
-    if (table_data_.body_.dimensions().TotalSize() > 0) {
-      if (max_rows_ < table_data_.body_.dimension(0)) {
-        print_until_ = max_rows_;
-        ImGui::Text("Showing first %i samples for performance, total nr. of samples : %li", max_rows_, table_data_.body_.dimension(0));
-      } else if (max_rows_ > table_data_.body_.dimension(0)) {
-        print_until_ = table_data_.body_.dimension(0);
-      }
-      updateTableContents(table_entries_, table_scanned_,
-        table_data_.body_, Eigen::Tensor<bool, 2>());
-    }
-    
-    if (table_scanned_ && table_entries_.size() > 0) {
-      if (table_data_.headers_.size() != table_entries_[0].entry_contents.size()) {
-        table_scanned_ = false;
-      }
-    }
-    data_changed_ = false;
-    
-    if (!table_scanned_) {
-      updateTableContents(table_entries_, table_scanned_,
-        table_data_.body_, Eigen::Tensor<bool, 2>());
-    }
-
     bool edit_cell = false;
     if (ImGui::BeginTable(table_id_.c_str(), table_data_.headers_.size(), table_flags)) {
       // First row entry_contents
@@ -206,97 +202,117 @@ namespace SmartPeak
       ImGui::TableSetupScrollFreeze(table_data_.headers_.size(), 1);
       ImGui::TableHeadersRow();
 
-      if (table_data_.body_.size() > 0) {
-        for (size_t row = 0; row < print_until_; ++row) {
-          if (checked_rows_.size() <= 0 || (checked_rows_.size() > 0 && checked_rows_(row))) {
+      if (ImGuiTableSortSpecs* sorts_specs = ImGui::TableGetSortSpecs())
+      {
+        if (sorts_specs->SpecsDirty)
+        {
+          sort_specs_.clear();
+          for (int n = 0; n < sorts_specs->SpecsCount; ++n)
+          {
+            const ImGuiTableColumnSortSpecs& sort_spec = sorts_specs->Specs[n];
+            sort_specs_.push_back({ static_cast<size_t>(sort_spec.ColumnIndex), sort_spec.SortDirection != ImGuiSortDirection_Descending });
+          }
+          sorts_specs->SpecsDirty = false;
+        }
+      }
 
-            if (searcher(table_entries_, selected_col_, filter, row))
+      // the rows are only filtered and sorted again when something has changed
+      if (table_view_.update(table_data_, checked_rows_, table_filter_.InputBuf, selected_col_ - 1, sort_specs_, data_changed_))
+      {
+        const auto& rows = table_view_.getRows();
+        const std::unordered_set<size_t> displayed_rows(rows.begin(), rows.end());
+        selected_cells_.erase(std::remove_if(selected_cells_.begin(), selected_cells_.end(),
+                              [&](const auto& selected) { return displayed_rows.count(std::get<0>(selected)) == 0; }),
+                              selected_cells_.end());
+        selected_rows_.clear();
+        for (const auto& selected : selected_cells_)
+        {
+          selected_rows_.insert(std::get<0>(selected));
+        }
+      }
+      data_changed_ = false;
+
+      // only the visible rows are drawn
+      const auto& rows = table_view_.getRows();
+      const size_t nb_columns = std::min<size_t>(table_data_.headers_.size(), TableView::getNbColumns(table_data_));
+      ImGuiListClipper clipper;
+      clipper.Begin(rows.size());
+      while (clipper.Step())
+      {
+        for (int display_row = clipper.DisplayStart; display_row < clipper.DisplayEnd; ++display_row)
+        {
+          const size_t row = rows[display_row];
+          ImGui::TableNextRow();
+          for (size_t col = 0; col < nb_columns; ++col)
+          {
+            ImGui::TableSetColumnIndex(col);
+            if (isCellSelected(row, col))
             {
-              selected_cells_.erase(std::remove_if(selected_cells_.begin(), selected_cells_.end(),
-                                    [&](const auto& selected) { return std::get<0>(selected) == row; }),
-                                    selected_cells_.end());
-              continue;
+              ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImColor(ImGui::GetStyle().Colors[ImGuiCol_TabActive]));
             }
-
-            ImGui::TableNextRow();
-            for (size_t col = 0; col < table_data_.headers_.size(); ++col) {
-              if (table_scanned_ == true && !table_entries_.empty())
+            const std::string cell_text = TableView::getCellText(table_data_, row, col);
+            bool is_editable = isEditable(row, col);
+            if (is_editable)
+            {
+              ImGui::PushStyleColor(ImGuiCol_Button, IM_COL32_BLACK_TRANS);
+              ImGui::PushStyleColor(ImGuiCol_ButtonHovered, IM_COL32_BLACK_TRANS);
+              ImGui::PushStyleColor(ImGuiCol_ButtonActive, IM_COL32_BLACK_TRANS);
+              ImGui::Button(cell_text.c_str(), ImVec2(ImGui::GetColumnWidth(),0));
+              ImGui::PopStyleColor(3);
+            }
+            else
+            {
+              ImGui::Text("%s", cell_text.c_str());
+            }
+            if (ImGui::IsItemHovered())
+            {
+              if (is_editable)
               {
-                ImGui::TableSetColumnIndex(col);
-                std::tuple<size_t, size_t> selected_tuple = std::make_tuple(row, col);
-                if (std::find(selected_cells_.begin(), selected_cells_.end(), selected_tuple) != selected_cells_.end())
-                {
-                  ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImColor(ImGui::GetStyle().Colors[ImGuiCol_TabActive]));
-                }
-                bool is_editable = isEditable(row, col);
-                if (is_editable)
-                {
-                  ImGui::PushStyleColor(ImGuiCol_Button, IM_COL32_BLACK_TRANS);
-                  ImGui::PushStyleColor(ImGuiCol_ButtonHovered, IM_COL32_BLACK_TRANS);
-                  ImGui::PushStyleColor(ImGuiCol_ButtonActive, IM_COL32_BLACK_TRANS);
-                  ImGui::Button(table_entries_[row].entry_contents[col].c_str(), ImVec2(ImGui::GetColumnWidth(),0));
-                  ImGui::PopStyleColor(3);
-                }
-                else
-                {
-                  ImGui::Text("%s", table_entries_[row].entry_contents[col].c_str());
-                }
-                if (ImGui::IsItemHovered())
+                ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
+              }
+            }
+            if (ImGui::IsItemClicked())
+            {
+              if (is_editable)
+              {
+                selectCell(row, col);
+              }
+              else
+              {
+                clearSelectedCells();
+              }
+            }
+            // context menu
+            if (is_editable)
+            {
+              std::ostringstream os_id;
+              os_id << "cell_" << row << "_" << col;
+              if (ImGui::BeginPopupContextItem(os_id.str().c_str()))
+              {
+                if (ImGui::MenuItem("Edit", nullptr, nullptr, !selected_cells_.empty()))
                 {
-                  if (is_editable)
-                  {
-                    ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
-                  }
+                  edit_cell = true;
                 }
-                if (ImGui::IsItemClicked())
+                ImGui::Separator();
+                if (ImGui::MenuItem("Select All"))
                 {
-                  if (is_editable)
-                  {
-                    selectCell(row, col);
-                  }
-                  else
+                  clearSelectedCells();
+                  for (const auto displayed_row : rows)
                   {
-                    selected_cells_.clear();
+                    addSelectedCell(displayed_row, col);
                   }
                 }
-                // context menu
-                if (is_editable)
+                if (ImGui::MenuItem("Unselect All"))
                 {
-                  std::ostringstream os_id;
-                  os_id << "cell_" << row << "_" << col;
-                  if (ImGui::BeginPopupContextItem(os_id.str().c_str()))
-                  {
-                    if (ImGui::MenuItem("Edit", nullptr, nullptr, !selected_cells_.empty()))
-                    {
-                      edit_cell = true;
-                    }
-                    ImGui::Separator();
-                    if (ImGui::MenuItem("Select All"))
-                    {
-                      selected_cells_.clear();
-                      for (auto i = 0; i < table_data_.body_.dimension(0); ++i)
-                      {
-                        selected_cells_.push_back(std::make_tuple(i, col));
-                      }
-                    }
-                    if (ImGui::MenuItem("Unselect All"))
-                    {
-                      selected_cells_.clear();
-                    }
-                    ImGui::EndPopup();
-                  }
+                  clearSelectedCells();
                 }
+                ImGui::EndPopup();
               }
             }
           }
         }
       }
 
-      if (ImGuiTableSortSpecs* sorts_specs = ImGui::TableGetSortSpecs())
-      {
-        sorter(table_entries_, sorts_specs, table_scanned_);
-      }
-
       // we need to call onEdit outside the drawing of the table
       if (edit_cell)
       {
@@ -314,29 +330,34 @@ namespace SmartPeak
     if ((selected_cells_.size() > 0) && (std::get<1>(selected_cells_[0]) != col))
     {
       // we have selected another column
-      selected_cells_.clear();
+      clearSelectedCells();
     }
     
     if (io.KeyShift)
     {
-      size_t starting_row = 0;
       if (selected_cells_.size() > 0)
       {
-        starting_row = std::get<0>(selected_cells_.back());
-        if (starting_row < row)
+        // select the displayed rows in between, in the displayed order
+        const auto& rows = table_view_.getRows();
+        const auto starting_row = std::find(rows.begin(), rows.end(), std::get<0>(selected_cells_.back()));
+        const auto ending_row = std::find(rows.begin(), rows.end(), row);
+        if (starting_row != rows.end() && ending_row != rows.end())
         {
-          // Shift-select top to bottom
-          for (auto i = starting_row + 1; i < row; ++i)
+          if (starting_row < ending_row)
           {
-            selected_cells_.push_back(std::make_tuple(i, col));
+            // Shift-select top to bottom
+            for (auto i = starting_row + 1; i < ending_row; ++i)
+            {
+              addSelectedCell(*i, col);
+            }
           }
-        }
-        else
-        {
-          // Shift-select bottom to top
-          for (auto i = starting_row - 1; i > row; --i)
+          else
           {
-            selected_cells_.push_back(std::make_tuple(i, col));
+            // Shift-select bottom to top
+            for (auto i = starting_row; i > ending_row + 1; --i)
+            {
+              addSelectedCell(*(i - 1), col);
+            }
           }
         }
       }
@@ -344,9 +365,29 @@ namespace SmartPeak
     else if (!io.KeyCtrl)
     {
       // simple click, unselect all
-      selected_cells_.clear();
+      clearSelectedCells();
     }
-    selected_cells_.push_back(std::make_tuple(row, col));
+    addSelectedCell(row, col);
+  }
+
+  bool GenericTableWidget::isCellSelected(size_t row, size_t col) const
+  {
+    // all the selected cells are in the same column
+    return selected_rows_.count(row) > 0 && std::get<1>(selected_cells_.front()) == col;
+  }
+
+  void GenericTableWidget::addSelectedCell(size_t row, size_t col)
+  {
+    if (selected_rows_.insert(row).second)
+    {
+      selected_cells_.push_back(std::make_tuple(row, col));
+    }
+  }
+
+  void GenericTableWidget::clearSelectedCells()
+  {
+    selected_cells_.clear();
+    selected_rows_.clear();
   }
 
   void GenericGraphicWidget::draw()
@@ -36,6 +36,7 @@ set(sources_list
 	SpectraPlotWidget.cpp
 	SplitWindow.cpp
 	StatisticsWidget.cpp
+	TableView.cpp
 	UIUtilities.cpp
 	Widget.cpp
 	WindowSizesAndPositions.cpp